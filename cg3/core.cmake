@@ -26,6 +26,7 @@ set(CG3_CORE_HEADERS
 	${CMAKE_CURRENT_LIST_DIR}/geometry/point3.h
 	${CMAKE_CURRENT_LIST_DIR}/geometry/point3.inl
 	${CMAKE_CURRENT_LIST_DIR}/geometry/polygon2.h
+	${CMAKE_CURRENT_LIST_DIR}/geometry/polygon_triangulator.h
 	${CMAKE_CURRENT_LIST_DIR}/geometry/quaternion.h
 	${CMAKE_CURRENT_LIST_DIR}/geometry/segment.h
 	${CMAKE_CURRENT_LIST_DIR}/geometry/segment.inl
@@ -45,15 +46,29 @@ set(CG3_CORE_HEADERS
 	${CMAKE_CURRENT_LIST_DIR}/geometry/utils3.inl
 
 	#io
+	${CMAKE_CURRENT_LIST_DIR}/io/ascii_numbers.h
+	${CMAKE_CURRENT_LIST_DIR}/io/ascii_numbers.inl
+	${CMAKE_CURRENT_LIST_DIR}/io/ascii_writer.h
+	${CMAKE_CURRENT_LIST_DIR}/io/ascii_writer.inl
 	${CMAKE_CURRENT_LIST_DIR}/io/file_commons.h
 	${CMAKE_CURRENT_LIST_DIR}/io/load_save_obj.h
 	${CMAKE_CURRENT_LIST_DIR}/io/load_save_obj.inl
 	${CMAKE_CURRENT_LIST_DIR}/io/load_save_ply.h
 	${CMAKE_CURRENT_LIST_DIR}/io/load_save_ply.inl
+	${CMAKE_CURRENT_LIST_DIR}/io/load_save_async.h
+	${CMAKE_CURRENT_LIST_DIR}/io/load_save_async.inl
 	${CMAKE_CURRENT_LIST_DIR}/io/load_save_file.h
+	${CMAKE_CURRENT_LIST_DIR}/io/mapped_file.h
+	${CMAKE_CURRENT_LIST_DIR}/io/mapped_file.inl
+	${CMAKE_CURRENT_LIST_DIR}/io/mesh_stream_reader.h
+	${CMAKE_CURRENT_LIST_DIR}/io/mesh_stream_reader.inl
 	${CMAKE_CURRENT_LIST_DIR}/io/serializable_object.h
 	${CMAKE_CURRENT_LIST_DIR}/io/serialize.h
 	${CMAKE_CURRENT_LIST_DIR}/io/serialize.inl
+	${CMAKE_CURRENT_LIST_DIR}/io/serialize_archive.h
+	${CMAKE_CURRENT_LIST_DIR}/io/serialize_archive.inl
+	${CMAKE_CURRENT_LIST_DIR}/io/serialize_compressed.h
+	${CMAKE_CURRENT_LIST_DIR}/io/serialize_compressed.inl
 	${CMAKE_CURRENT_LIST_DIR}/io/serialize_eigen.h
 	${CMAKE_CURRENT_LIST_DIR}/io/serialize_eigen.inl
 	${CMAKE_CURRENT_LIST_DIR}/io/serialize_qt.h
@@ -62,6 +77,8 @@ set(CG3_CORE_HEADERS
 	${CMAKE_CURRENT_LIST_DIR}/io/serialize_std.inl
 	${CMAKE_CURRENT_LIST_DIR}/io/ply/ply.h
 	${CMAKE_CURRENT_LIST_DIR}/io/ply/ply.inl
+	${CMAKE_CURRENT_LIST_DIR}/io/ply/ply_binary.h
+	${CMAKE_CURRENT_LIST_DIR}/io/ply/ply_binary.inl
 	${CMAKE_CURRENT_LIST_DIR}/io/ply/ply_header.h
 	${CMAKE_CURRENT_LIST_DIR}/io/ply/ply_edge.h
 	${CMAKE_CURRENT_LIST_DIR}/io/ply/ply_edge.inl
@@ -87,12 +104,16 @@ set(CG3_CORE_HEADERS
 	${CMAKE_CURRENT_LIST_DIR}/utilities/nested_initializer_lists.inl
 	${CMAKE_CURRENT_LIST_DIR}/utilities/pair.h
 	${CMAKE_CURRENT_LIST_DIR}/utilities/pair.inl
+	${CMAKE_CURRENT_LIST_DIR}/utilities/parallel.h
+	${CMAKE_CURRENT_LIST_DIR}/utilities/parallel.inl
 	${CMAKE_CURRENT_LIST_DIR}/utilities/set.h
 	${CMAKE_CURRENT_LIST_DIR}/utilities/set.inl
 	${CMAKE_CURRENT_LIST_DIR}/utilities/string.h
 	${CMAKE_CURRENT_LIST_DIR}/utilities/string.inl
 	${CMAKE_CURRENT_LIST_DIR}/utilities/system.h
 	${CMAKE_CURRENT_LIST_DIR}/utilities/system.inl
+	${CMAKE_CURRENT_LIST_DIR}/utilities/thread_pool.h
+	${CMAKE_CURRENT_LIST_DIR}/utilities/thread_pool.inl
 	${CMAKE_CURRENT_LIST_DIR}/utilities/timer.h
 	${CMAKE_CURRENT_LIST_DIR}/utilities/timer.inl
 	${CMAKE_CURRENT_LIST_DIR}/utilities/tokenizer.h
@@ -142,6 +163,8 @@ set(CG3_CORE_HEADERS
 
 	#trees
 	${CMAKE_CURRENT_LIST_DIR}/data_structures/trees/includes/tree_common.h  #tree common
+	${CMAKE_CURRENT_LIST_DIR}/data_structures/trees/includes/tree_batch_helpers.h
+	${CMAKE_CURRENT_LIST_DIR}/data_structures/trees/includes/tree_batch_helpers.inl
 	${CMAKE_CURRENT_LIST_DIR}/data_structures/trees/includes/iterators/tree_genericiterator.h
 	${CMAKE_CURRENT_LIST_DIR}/data_structures/trees/includes/iterators/tree_insertiterator.h
 	${CMAKE_CURRENT_LIST_DIR}/data_structures/trees/includes/iterators/tree_insertiterator.inl
@@ -176,11 +199,17 @@ set(CG3_CORE_HEADERS
 	${CMAKE_CURRENT_LIST_DIR}/data_structures/trees/rangetree.inl
 	${CMAKE_CURRENT_LIST_DIR}/data_structures/trees/includes/nodes/rangetree_node.h
 	${CMAKE_CURRENT_LIST_DIR}/data_structures/trees/includes/nodes/rangetree_node.inl
+	${CMAKE_CURRENT_LIST_DIR}/data_structures/trees/includes/rangetree_static_helpers.h
+	${CMAKE_CURRENT_LIST_DIR}/data_structures/trees/includes/rangetree_static_helpers.inl
+	${CMAKE_CURRENT_LIST_DIR}/data_structures/trees/static_rangetree.h
+	${CMAKE_CURRENT_LIST_DIR}/data_structures/trees/static_rangetree.inl
 	${CMAKE_CURRENT_LIST_DIR}/data_structures/trees/includes/rangetree_types.h  #aabb tree
 	${CMAKE_CURRENT_LIST_DIR}/data_structures/trees/aabbtree.h
 	${CMAKE_CURRENT_LIST_DIR}/data_structures/trees/aabbtree.inl
 	${CMAKE_CURRENT_LIST_DIR}/data_structures/trees/includes/nodes/aabb_node.h
 	${CMAKE_CURRENT_LIST_DIR}/data_structures/trees/includes/nodes/aabb_node.inl
+	${CMAKE_CURRENT_LIST_DIR}/data_structures/trees/includes/aabb_flat_helpers.h
+	${CMAKE_CURRENT_LIST_DIR}/data_structures/trees/includes/aabb_flat_helpers.inl
 
 	#algorithms
 	${CMAKE_CURRENT_LIST_DIR}/algorithms/convex_hull2.h
@@ -208,6 +237,7 @@ set(CG3_CORE_HEADERS
 	${CMAKE_CURRENT_LIST_DIR}/meshes/dcel/dcel_face_iterators.h
 	${CMAKE_CURRENT_LIST_DIR}/meshes/dcel/dcel_half_edge.h
 	${CMAKE_CURRENT_LIST_DIR}/meshes/dcel/dcel_iterators.h
+	${CMAKE_CURRENT_LIST_DIR}/meshes/dcel/dcel_pool.h
 	${CMAKE_CURRENT_LIST_DIR}/meshes/dcel/dcel_struct.h
 	${CMAKE_CURRENT_LIST_DIR}/meshes/dcel/dcel_struct.inl
 	${CMAKE_CURRENT_LIST_DIR}/meshes/dcel/dcel_vertex.h
@@ -240,6 +270,7 @@ set(CG3_CORE_SOURCES
 	${CMAKE_CURRENT_LIST_DIR}/geometry/line3.cpp
 	${CMAKE_CURRENT_LIST_DIR}/geometry/plane.cpp
 	${CMAKE_CURRENT_LIST_DIR}/geometry/polygon2.cpp
+	${CMAKE_CURRENT_LIST_DIR}/geometry/polygon_triangulator.cpp
 	${CMAKE_CURRENT_LIST_DIR}/geometry/quaternion.cpp
 	${CMAKE_CURRENT_LIST_DIR}/geometry/sphere.cpp
 	${CMAKE_CURRENT_LIST_DIR}/geometry/transformations3.cpp
@@ -281,7 +312,8 @@ endif()
 target_include_directories(cg3-core ${CG3_TARGET_MOD} ${CG3_INCLUDE_DIR})
 target_compile_definitions(cg3-core ${CG3_TARGET_MOD} CG3_QMAKE)
 
-target_link_libraries(cg3-core ${CG3_TARGET_MOD} Eigen)
+find_package(Threads REQUIRED)
+target_link_libraries(cg3-core ${CG3_TARGET_MOD} Eigen Threads::Threads)
 if (TARGET Qt5::Gui)
 	target_link_libraries(cg3-core ${CG3_TARGET_MOD} Qt5::Gui)
 endif()
@@ -44,6 +44,7 @@ HEADERS += \
 	$$PWD/geometry/point3.h \
 	$$PWD/geometry/point3.inl \
 	$$PWD/geometry/polygon2.h \
+	$$PWD/geometry/polygon_triangulator.h \
 	$$PWD/geometry/quaternion.h \
 	$$PWD/geometry/segment.h \
 	$$PWD/geometry/segment.inl \
@@ -61,15 +62,29 @@ HEADERS += \
 	$$PWD/geometry/utils2.inl \
 	$$PWD/geometry/utils3.h \
 	$$PWD/geometry/utils3.inl \
-	$$PWD/io/file_commons.h \ #io
+	$$PWD/io/ascii_numbers.h \ #io
+	$$PWD/io/ascii_numbers.inl \
+	$$PWD/io/ascii_writer.h \
+	$$PWD/io/ascii_writer.inl \
+	$$PWD/io/file_commons.h \
 	$$PWD/io/load_save_obj.h \
 	$$PWD/io/load_save_obj.inl \
 	$$PWD/io/load_save_ply.h \
 	$$PWD/io/load_save_ply.inl \
+	$$PWD/io/load_save_async.h \
+	$$PWD/io/load_save_async.inl \
 	$$PWD/io/load_save_file.h \
+	$$PWD/io/mapped_file.h \
+	$$PWD/io/mapped_file.inl \
+	$$PWD/io/mesh_stream_reader.h \
+	$$PWD/io/mesh_stream_reader.inl \
 	$$PWD/io/serializable_object.h \
 	$$PWD/io/serialize.h \
 	$$PWD/io/serialize.inl \
+	$$PWD/io/serialize_archive.h \
+	$$PWD/io/serialize_archive.inl \
+	$$PWD/io/serialize_compressed.h \
+	$$PWD/io/serialize_compressed.inl \
 	$$PWD/io/serialize_eigen.h \
 	$$PWD/io/serialize_eigen.inl \
 	$$PWD/io/serialize_qt.h \
@@ -78,6 +93,8 @@ HEADERS += \
 	$$PWD/io/serialize_std.inl \
 	$$PWD/io/ply/ply.h \
 	$$PWD/io/ply/ply.inl \
+	$$PWD/io/ply/ply_binary.h \
+	$$PWD/io/ply/ply_binary.inl \
 	$$PWD/io/ply/ply_header.h \
 	$$PWD/io/ply/ply_edge.h \
 	$$PWD/io/ply/ply_edge.inl \
@@ -101,12 +118,16 @@ HEADERS += \
 	$$PWD/utilities/nested_initializer_lists.inl \
 	$$PWD/utilities/pair.h \
 	$$PWD/utilities/pair.inl \
+	$$PWD/utilities/parallel.h \
+	$$PWD/utilities/parallel.inl \
 	$$PWD/utilities/set.h \
 	$$PWD/utilities/set.inl \
 	$$PWD/utilities/string.h \
 	$$PWD/utilities/string.inl \
 	$$PWD/utilities/system.h \
 	$$PWD/utilities/system.inl \
+	$$PWD/utilities/thread_pool.h \
+	$$PWD/utilities/thread_pool.inl \
 	$$PWD/utilities/timer.h \
 	$$PWD/utilities/timer.inl \
 	$$PWD/utilities/tokenizer.h \
@@ -140,6 +161,8 @@ HEADERS += \
 	$$PWD/data_structures/lattices/regular_lattice_iterators.h \
 	$$PWD/data_structures/lattices/regular_lattice_iterators.inl \
 	$$PWD/data_structures/trees/includes/tree_common.h \ #tree common
+	$$PWD/data_structures/trees/includes/tree_batch_helpers.h \
+	$$PWD/data_structures/trees/includes/tree_batch_helpers.inl \
 	$$PWD/data_structures/trees/includes/iterators/tree_genericiterator.h \
 	$$PWD/data_structures/trees/includes/iterators/tree_insertiterator.h \
 	$$PWD/data_structures/trees/includes/iterators/tree_insertiterator.inl \
@@ -174,11 +197,17 @@ HEADERS += \
 	$$PWD/data_structures/trees/rangetree.inl \
 	$$PWD/data_structures/trees/includes/nodes/rangetree_node.h \
 	$$PWD/data_structures/trees/includes/nodes/rangetree_node.inl \
+	$$PWD/data_structures/trees/includes/rangetree_static_helpers.h \
+	$$PWD/data_structures/trees/includes/rangetree_static_helpers.inl \
+	$$PWD/data_structures/trees/static_rangetree.h \
+	$$PWD/data_structures/trees/static_rangetree.inl \
 	$$PWD/data_structures/trees/includes/rangetree_types.h \ #aabb tree
 	$$PWD/data_structures/trees/aabbtree.h \
 	$$PWD/data_structures/trees/aabbtree.inl \
 	$$PWD/data_structures/trees/includes/nodes/aabb_node.h \
-	$$PWD/data_structures/trees/includes/nodes/aabb_node.inl
+	$$PWD/data_structures/trees/includes/nodes/aabb_node.inl \
+	$$PWD/data_structures/trees/includes/aabb_flat_helpers.h \
+	$$PWD/data_structures/trees/includes/aabb_flat_helpers.inl
 
 #algorithms
 HEADERS += \
@@ -208,6 +237,7 @@ HEADERS += \
 	$$PWD/meshes/dcel/dcel_face_iterators.h \
 	$$PWD/meshes/dcel/dcel_half_edge.h \
 	$$PWD/meshes/dcel/dcel_iterators.h \
+	$$PWD/meshes/dcel/dcel_pool.h \
 	$$PWD/meshes/dcel/dcel_struct.h \
 	$$PWD/meshes/dcel/dcel_struct.inl \
 	$$PWD/meshes/dcel/dcel_vertex.h \
@@ -239,6 +269,7 @@ SOURCES += \
 	$$PWD/geometry/line3.cpp \
 	$$PWD/geometry/plane.cpp \
 	$$PWD/geometry/polygon2.cpp \
+	$$PWD/geometry/polygon_triangulator.cpp \
 	$$PWD/geometry/quaternion.cpp \
 	$$PWD/geometry/sphere.cpp \
 	$$PWD/geometry/transformations3.cpp \
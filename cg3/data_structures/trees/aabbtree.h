@@ -19,6 +19,9 @@
 
 #include "includes/nodes/aabb_node.h"
 
+#include "includes/aabb_flat_helpers.h"
+#include "includes/tree_batch_helpers.h"
+
 namespace cg3 {
 
 /* Types */
@@ -32,6 +35,17 @@ enum AABBValueType { MIN, MAX };
  * No duplicates are allowed. It has been implemented as
  * a FAT AABB tree: the AABB of each node is the AABB
  * containing the entire childhood AABBs.
+ *
+ * For static workloads (many queries on a tree that does not change),
+ * buildStatic() creates a flat hierarchy of the stored AABBs, built with
+ * the surface area heuristic and stored in a contiguous array, which is
+ * then used by aabbOverlapQuery and aabbOverlapCheck. Any change of the
+ * tree discards the flat hierarchy.
+ *
+ * The const query methods do not change the tree: they can be called
+ * concurrently by many threads, as long as no thread changes the tree.
+ * batchOverlapQuery executes a list of queries on the threads of a
+ * ThreadPool (defaultThreadPool() if none is given).
  */
 template <int D, class K, class T = K, class C = DefaultComparatorType<K>>
 class AABBTree
@@ -99,12 +113,12 @@ public:
     iterator find(const K& key);
 
 
-    TreeSize size();
-    bool empty();
+    TreeSize size() const;
+    bool empty() const;
 
     void clear();
 
-    TreeSize getHeight();
+    TreeSize getHeight() const;
 
 
     template <class OutputIterator>
@@ -118,10 +132,39 @@ public:
             OutputIterator out,
             KeyOverlapChecker keyOverlapChecker = nullptr);
 
-    bool aabbOverlapCheck(
+    template <class Callback>
+    void aabbOverlapQueryCallback(
             const K& key,
+            Callback callback,
             KeyOverlapChecker keyOverlapChecker = nullptr);
 
+    template <class OutputIterator>
+    void aabbOverlapQuery(
+            const K& key,
+            OutputIterator out,
+            KeyOverlapChecker keyOverlapChecker = nullptr) const;
+
+    template <class Callback>
+    void aabbOverlapQueryCallback(
+            const K& key,
+            Callback callback,
+            KeyOverlapChecker keyOverlapChecker = nullptr) const;
+
+    bool aabbOverlapCheck(
+            const K& key,
+            KeyOverlapChecker keyOverlapChecker = nullptr) const;
+
+    void batchOverlapQuery(
+            const std::vector<K>& keys,
+            std::vector<size_t>& offsets,
+            std::vector<const_iterator>& results,
+            KeyOverlapChecker keyOverlapChecker = nullptr,
+            ThreadPool& pool = defaultThreadPool()) const;
+
+
+    void buildStatic(unsigned int maxLeafSize = 4);
+    bool isStatic() const;
+
 
     /* Iterator Min/Max Next/Prev */
 
@@ -173,26 +216,51 @@ protected:
 
     AABBValueExtractor aabbValueExtractor;
 
+    std::vector<internal::AABBFlatNode<D>> flatNodes;
+    std::vector<internal::AABBFlatPacket<D>> flatPackets;
+    std::vector<Node*> flatEntries;
+
 
     /* Protected methods */
 
     void initialize();
 
+    void clearStatic();
+
 
     /* AABB helpers */
 
+    template <class Callback>
+    inline void aabbOverlapQueryNodeHelper(
+            const K& key,
+            Callback& callback,
+            KeyOverlapChecker keyOverlapChecker) const;
+
+    template <class Callback>
     inline void aabbOverlapQueryHelper(
             Node* node,
             const K& key,
             const typename Node::AABB& aabb,
-            std::vector<Node*> &out,
-            KeyOverlapChecker keyOverlapChecker);
+            Callback& callback,
+            KeyOverlapChecker keyOverlapChecker) const;
 
     inline bool aabbOverlapCheckHelper(
             Node* node,
             const K& key,
             const typename Node::AABB& aabb,
-            KeyOverlapChecker keyOverlapChecker);
+            KeyOverlapChecker keyOverlapChecker) const;
+
+    template <class Callback>
+    inline void aabbFlatOverlapQueryHelper(
+            const K& key,
+            const typename Node::AABB& aabb,
+            Callback& callback,
+            KeyOverlapChecker keyOverlapChecker) const;
+
+    inline bool aabbFlatOverlapCheckHelper(
+            const K& key,
+            const typename Node::AABB& aabb,
+            KeyOverlapChecker keyOverlapChecker) const;
 
     inline void updateAABBHelper(
             Node* node,
@@ -223,12 +291,12 @@ protected:
 
     inline bool aabbOverlapsHelper(
             const typename Node::AABB& a,
-            const typename Node::AABB& b);
+            const typename Node::AABB& b) const;
 
     inline void setAABBFromKeyHelper(
             const K& k,
             typename Node::AABB& aabb,
-            AABBValueExtractor aabbValueExtractor);
+            AABBValueExtractor aabbValueExtractor) const;
 
 };
 
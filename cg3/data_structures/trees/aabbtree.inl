@@ -9,6 +9,8 @@
 #include <stdexcept>
 #include <algorithm>
 #include <utility>
+#include <iterator>
+#include <unordered_map>
 
 #include "includes/bstleaf_helpers.h"
 #include "includes/avl_helpers.h"
@@ -88,10 +90,33 @@ AABBTree<D,K,T,C>::AABBTree(
 template <int D, class K, class T, class C>
 AABBTree<D,K,T,C>::AABBTree(const AABBTree<D,K,T,C>& bst) :
     comparator(bst.comparator),
-    aabbValueExtractor(bst.aabbValueExtractor)
+    aabbValueExtractor(bst.aabbValueExtractor),
+    flatNodes(bst.flatNodes),
+    flatPackets(bst.flatPackets)
 {
     this->root = internal::copySubtreeHelper<Node,T>(bst.root);
     this->entries = bst.entries;
+
+    //The copied tree has the same leaves in the same order
+    if (!bst.flatEntries.empty()) {
+        std::unordered_map<const Node*, Node*> copiedLeaves;
+        copiedLeaves.reserve(bst.flatEntries.size());
+        Node* node = internal::getMinimumHelperLeaf(this->root);
+        Node* bstNode = internal::getMinimumHelperLeaf(bst.root);
+        while (bstNode != nullptr) {
+            copiedLeaves[bstNode] = node;
+            node = internal::getSuccessorHelperLeaf(node);
+            bstNode = internal::getSuccessorHelperLeaf(bstNode);
+        }
+
+        this->flatEntries.resize(bst.flatEntries.size());
+        for (size_t i = 0; i < bst.flatEntries.size(); i++) {
+            if (bst.flatEntries[i] != nullptr)
+                this->flatEntries[i] = copiedLeaves[bst.flatEntries[i]];
+            else
+                this->flatEntries[i] = nullptr;
+        }
+    }
 }
 
 /**
@@ -101,7 +126,10 @@ AABBTree<D,K,T,C>::AABBTree(const AABBTree<D,K,T,C>& bst) :
 template <int D, class K, class T, class C>
 AABBTree<D,K,T,C>::AABBTree(AABBTree<D,K,T,C>&& bst) :
     comparator(bst.comparator),
-    aabbValueExtractor(bst.aabbValueExtractor)
+    aabbValueExtractor(bst.aabbValueExtractor),
+    flatNodes(std::move(bst.flatNodes)),
+    flatPackets(std::move(bst.flatPackets)),
+    flatEntries(std::move(bst.flatEntries))
 {
     this->root = bst.root;
     bst.root = nullptr;
@@ -230,6 +258,9 @@ typename AABBTree<D,K,T,C>::iterator AABBTree<D,K,T,C>::insert(
 
     //If node has been inserted
     if (result != nullptr) {
+        //The flat hierarchy is not valid anymore
+        this->clearStatic();
+
         //Update height and rebalance
         this->updateHeightAndRebalanceAABBHelper(newNode, aabbValueExtractor);
 
@@ -266,6 +297,9 @@ bool AABBTree<D,K,T,C>::erase(const K& key)
 
     //If the node has been found
     if (node != nullptr) {
+        //The flat hierarchy is not valid anymore
+        this->clearStatic();
+
         //Erase node
         Node* replacingNode = internal::eraseNodeHelperLeaf(node, this->root);
 
@@ -302,6 +336,9 @@ void AABBTree<D,K,T,C>::erase(generic_iterator it)
 
 
     if (node != nullptr) {
+        //The flat hierarchy is not valid anymore
+        this->clearStatic();
+
         //Erase node
         Node* replacingNode = internal::eraseNodeHelperLeaf(node, this->root);
 
@@ -348,6 +385,9 @@ void AABBTree<D,K,T,C>::clear()
     //Clear entire tree
     internal::clearHelper(this->root);
 
+    //Clear the flat hierarchy
+    this->clearStatic();
+
     //Decreasing entries
     this->entries = 0;
 }
@@ -361,7 +401,7 @@ void AABBTree<D,K,T,C>::clear()
  * @return Number of entries in the BST
  */
 template <int D, class K, class T, class C>
-TreeSize AABBTree<D,K,T,C>::size()
+TreeSize AABBTree<D,K,T,C>::size() const
 {
     return this->entries;
 }
@@ -372,7 +412,7 @@ TreeSize AABBTree<D,K,T,C>::size()
  * @return True if the BST is empty, false otherwise
  */
 template <int D, class K, class T, class C>
-bool AABBTree<D,K,T,C>::empty()
+bool AABBTree<D,K,T,C>::empty() const
 {
     return (this->size() == 0);
 }
@@ -385,7 +425,7 @@ bool AABBTree<D,K,T,C>::empty()
  * @return Max height of the tree
  */
 template <int D, class K, class T, class C>
-TreeSize AABBTree<D,K,T,C>::getHeight()
+TreeSize AABBTree<D,K,T,C>::getHeight() const
 {
     return internal::getHeightHelper(this->root);
 }
@@ -431,19 +471,84 @@ void AABBTree<D,K,T,C>::aabbOverlapQuery(
         OutputIterator out,
         KeyOverlapChecker keyOverlapChecker)
 {
-    //Get the AABB
-    typename Node::AABB aabb;
-    this->setAABBFromKeyHelper(key, aabb, aabbValueExtractor);
+    //Pushing out the results while they are found
+    this->aabbOverlapQueryCallback(
+                key,
+                [&out](iterator it) {
+                    *out = it;
+                    out++;
+                },
+                keyOverlapChecker);
+}
 
-    //Query the AABB tree
-    std::vector<Node*> nodeOutput;
-    this->aabbOverlapQueryHelper(this->root, key, aabb, nodeOutput, keyOverlapChecker);
+/**
+ * @brief Find elements for which the input bounding box overlaps with the one of the values,
+ * calling callback(it) for each of them, where it is the iterator pointing to the element.
+ * No memory is allocated by the query.
+ *
+ * @param[in] key Input key
+ * @param[in] callback Function called for each element that overlaps
+ * @param[in] keyOverlapChecker Key overlap filter function
+ */
+template <int D, class K, class T, class C> template <class Callback>
+void AABBTree<D,K,T,C>::aabbOverlapQueryCallback(
+        const K& key,
+        Callback callback,
+        KeyOverlapChecker keyOverlapChecker)
+{
+    auto nodeCallback = [this, &callback](Node* node) {
+        callback(iterator(this, node));
+    };
 
-    //Pushing out the results
-    for (Node* node : nodeOutput) {
-        *out = iterator(this, node);
-        out++;
-    }
+    this->aabbOverlapQueryNodeHelper(key, nodeCallback, keyOverlapChecker);
+}
+
+/**
+ * @brief Find elements for which the input bounding box overlaps with the one of the values
+ * (const version, it can be called concurrently by multiple threads)
+ *
+ * @param[in] key Input key
+ * @param[out] out Vector of const iterators pointing to elements that overlap
+ * @param[in] keyOverlapChecker Key overlap filter function
+ */
+template <int D, class K, class T, class C> template <class OutputIterator>
+void AABBTree<D,K,T,C>::aabbOverlapQuery(
+        const K& key,
+        OutputIterator out,
+        KeyOverlapChecker keyOverlapChecker) const
+{
+    //Pushing out the results while they are found
+    this->aabbOverlapQueryCallback(
+                key,
+                [&out](const_iterator it) {
+                    *out = it;
+                    out++;
+                },
+                keyOverlapChecker);
+}
+
+/**
+ * @brief Find elements for which the input bounding box overlaps with the one of the values,
+ * calling callback(it) for each of them, where it is the const iterator pointing to the element
+ * (const version, it can be called concurrently by multiple threads)
+ *
+ * @param[in] key Input key
+ * @param[in] callback Function called for each element that overlaps
+ * @param[in] keyOverlapChecker Key overlap filter function
+ */
+template <int D, class K, class T, class C> template <class Callback>
+void AABBTree<D,K,T,C>::aabbOverlapQueryCallback(
+        const K& key,
+        Callback callback,
+        KeyOverlapChecker keyOverlapChecker) const
+{
+    //Const iterators need the (non-const) tree, which is never changed through them
+    AABBTree<D,K,T,C>* tree = const_cast<AABBTree<D,K,T,C>*>(this);
+    auto nodeCallback = [tree, &callback](Node* node) {
+        callback(const_iterator(tree, node));
+    };
+
+    this->aabbOverlapQueryNodeHelper(key, nodeCallback, keyOverlapChecker);
 }
 
 
@@ -456,16 +561,140 @@ void AABBTree<D,K,T,C>::aabbOverlapQuery(
 template <int D, class K, class T, class C>
 bool AABBTree<D,K,T,C>::aabbOverlapCheck(
         const K& key,
-        KeyOverlapChecker keyOverlapChecker)
+        KeyOverlapChecker keyOverlapChecker) const
 {
     //Get the AABB
     typename Node::AABB aabb;
     this->setAABBFromKeyHelper(key, aabb, aabbValueExtractor);
 
-    //Query the AABB tree
+    //Query the AABB tree (or its flat hierarchy)
+    if (!this->flatNodes.empty())
+        return this->aabbFlatOverlapCheckHelper(key, aabb, keyOverlapChecker);
     return this->aabbOverlapCheckHelper(this->root, key, aabb, keyOverlapChecker);
 }
 
+/**
+ * @brief Execute a list of overlap queries, distributing them among multiple
+ * threads. The results are stored in compressed sparse row format: the
+ * elements which overlap with keys[i] are pointed by
+ * results[offsets[i]], ..., results[offsets[i+1]-1], in the same order
+ * given by aabbOverlapQuery.
+ *
+ * The tree must not be changed while the queries are executed.
+ *
+ * @param[in] keys Input keys
+ * @param[out] offsets Offsets of the results of each key (keys.size()+1 values)
+ * @param[out] results Const iterators pointing to the elements that overlap
+ * @param[in] keyOverlapChecker Key overlap filter function
+ * @param[in] pool Thread pool which executes the queries, together with the
+ * calling thread
+ */
+template <int D, class K, class T, class C>
+void AABBTree<D,K,T,C>::batchOverlapQuery(
+        const std::vector<K>& keys,
+        std::vector<size_t>& offsets,
+        std::vector<const_iterator>& results,
+        KeyOverlapChecker keyOverlapChecker,
+        ThreadPool& pool) const
+{
+    internal::batchQueryHelper(
+                keys.size(),
+                [this, &keys, keyOverlapChecker](size_t i, std::vector<const_iterator>& out) {
+                    this->aabbOverlapQuery(keys[i], std::back_inserter(out), keyOverlapChecker);
+                },
+                offsets,
+                results,
+                pool);
+}
+
+
+/**
+ * @brief Build the flat hierarchy used by the AABB queries, for trees that
+ * are queried many times without being changed.
+ *
+ * The AABBs of the entries are split with a binned surface area heuristic,
+ * and the resulting binary hierarchy is collapsed in nodes with 4 children.
+ * Nodes and entries are stored in contiguous arrays. The AABBs of the
+ * children of a node, and of the entries of a leaf, are stored in packets
+ * which are compared with the query AABB using SIMD instructions. Insert,
+ * erase, construction and clear discard the flat hierarchy: queries then use
+ * the AVL tree until buildStatic() is called again.
+ *
+ * @param[in] maxLeafSize Maximum number of entries in a leaf of the
+ * hierarchy
+ */
+template <int D, class K, class T, class C>
+void AABBTree<D,K,T,C>::buildStatic(unsigned int maxLeafSize)
+{
+    this->clearStatic();
+
+    if (this->root == nullptr)
+        return;
+
+    //Entries and their AABBs, already computed in the AVL leaves
+    std::vector<Node*> leaves;
+    std::vector<typename Node::AABB> boxes;
+    leaves.reserve(this->entries);
+    boxes.reserve(this->entries);
+    for (Node* node = internal::getMinimumHelperLeaf(this->root);
+         node != nullptr;
+         node = internal::getSuccessorHelperLeaf(node))
+    {
+        leaves.push_back(node);
+        boxes.push_back(node->aabb);
+    }
+
+    //Binary hierarchy, collapsed in nodes with 4 children
+    std::vector<internal::AABBBuildNode<D>> buildNodes;
+    std::vector<unsigned int> order;
+    internal::buildFlatAABBHelper<D>(boxes, buildNodes, order, maxLeafSize);
+    internal::collapseFlatAABBHelper<D>(buildNodes, this->flatNodes);
+
+    //Store entries in the order of the leaves of the hierarchy: entries of
+    //each leaf start in a new packet, unused slots are left empty
+    const unsigned int packetSize = internal::AABB_FLAT_PACKET_SIZE;
+    unsigned int nSlots = 0;
+    for (const internal::AABBFlatNode<D>& node : this->flatNodes) {
+        for (unsigned int c = 0; c < packetSize; c++)
+            nSlots += (node.count[c] + packetSize - 1) / packetSize * packetSize;
+    }
+
+    this->flatPackets.resize(nSlots / packetSize);
+    for (internal::AABBFlatPacket<D>& packet : this->flatPackets)
+        internal::clearAABBFlatPacketHelper<D>(packet);
+    this->flatEntries.assign(nSlots, nullptr);
+
+    unsigned int slot = 0;
+    for (internal::AABBFlatNode<D>& node : this->flatNodes) {
+        for (unsigned int c = 0; c < packetSize; c++) {
+            for (unsigned int i = 0; i < node.count[c]; i++) {
+                unsigned int entry = order[node.index[c] + i];
+                internal::setAABBFlatPacketBoxHelper<D>(
+                            this->flatPackets[(slot + i) / packetSize],
+                            (slot + i) % packetSize,
+                            boxes[entry]);
+                this->flatEntries[slot + i] = leaves[entry];
+            }
+            if (node.count[c] > 0) {
+                node.index[c] = slot;
+                slot += (node.count[c] + packetSize - 1) / packetSize * packetSize;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Check if the flat hierarchy of the tree has been built and it is
+ * used by the AABB queries
+ *
+ * @return True if the flat hierarchy is valid
+ */
+template <int D, class K, class T, class C>
+bool AABBTree<D,K,T,C>::isStatic() const
+{
+    return !this->flatNodes.empty();
+}
+
 
 
 
@@ -694,6 +923,9 @@ void AABBTree<D,K,T,C>::swap(AABBTree<D,K,T,C>& bst)
     swap(this->entries, bst.entries);
     swap(this->comparator, bst.comparator);
     swap(this->aabbValueExtractor, bst.aabbValueExtractor);
+    swap(this->flatNodes, bst.flatNodes);
+    swap(this->flatPackets, bst.flatPackets);
+    swap(this->flatEntries, bst.flatEntries);
 }
 
 
@@ -721,11 +953,48 @@ void AABBTree<D,K,T,C>::initialize()
     this->entries = 0;
 }
 
+/**
+ * @brief Discard the flat hierarchy
+ */
+template <int D, class K, class T, class C>
+void AABBTree<D,K,T,C>::clearStatic()
+{
+    this->flatNodes.clear();
+    this->flatPackets.clear();
+    this->flatEntries.clear();
+}
+
 
 
 
 /* ----- AABB HELPERS ----- */
 
+/**
+ * @brief Find the nodes of the elements for which the input bounding box
+ * overlaps with the one of the values, visiting the flat hierarchy if it
+ * has been built, and the AABB tree otherwise.
+ *
+ * @param[in] key Input key
+ * @param[in] callback Function called with the nodes of the elements that overlap
+ * @param[in] keyOverlapChecker Key overlap filter function
+ */
+template <int D, class K, class T, class C> template <class Callback>
+void AABBTree<D,K,T,C>::aabbOverlapQueryNodeHelper(
+        const K& key,
+        Callback& callback,
+        KeyOverlapChecker keyOverlapChecker) const
+{
+    //Get the AABB
+    typename Node::AABB aabb;
+    this->setAABBFromKeyHelper(key, aabb, aabbValueExtractor);
+
+    //Query the AABB tree (or its flat hierarchy)
+    if (!this->flatNodes.empty())
+        this->aabbFlatOverlapQueryHelper(key, aabb, callback, keyOverlapChecker);
+    else
+        this->aabbOverlapQueryHelper(this->root, key, aabb, callback, keyOverlapChecker);
+}
+
 /**
  * @brief Find elements for which the input bounding box overlaps with the one of the values.
  * Output can be filtered by another optional key overlap filter function.
@@ -733,16 +1002,16 @@ void AABBTree<D,K,T,C>::initialize()
  * @param[in] node Starting node
  * @param[in] key Input key
  * @param[in] aabb Axis-aligned bounding box of the key
- * @param[out] out Vector of iterators pointing to elements that overlap
+ * @param[in] callback Function called with the nodes of the elements that overlap
  * @param[in] keyOverlapChecker Key overlap filter function
  */
-template <int D, class K, class T, class C>
+template <int D, class K, class T, class C> template <class Callback>
 void AABBTree<D,K,T,C>::aabbOverlapQueryHelper(
         Node* node,
         const K& key,
         const typename Node::AABB& aabb,
-        std::vector<Node*> &out,
-        KeyOverlapChecker keyOverlapChecker)
+        Callback& callback,
+        KeyOverlapChecker keyOverlapChecker) const
 {
     if (node == nullptr)
         return;
@@ -751,18 +1020,18 @@ void AABBTree<D,K,T,C>::aabbOverlapQueryHelper(
     if (node->isLeaf()) {
         if (aabbOverlapsHelper(aabb, node->aabb)) {
             if (keyOverlapChecker == nullptr || keyOverlapChecker(key, node->key)) {
-                out.push_back(node);
+                callback(node);
             }
         }
     }
     //If node is not a leaf, search on left and right subtrees if the AABB overlaps
     else {
         if (node->right != nullptr && aabbOverlapsHelper(aabb, node->right->aabb)) {
-            aabbOverlapQueryHelper(node->right, key, aabb, out, keyOverlapChecker);
+            aabbOverlapQueryHelper(node->right, key, aabb, callback, keyOverlapChecker);
         }
 
         if (node->left != nullptr && aabbOverlapsHelper(aabb, node->left->aabb)) {
-            aabbOverlapQueryHelper(node->left, key, aabb, out, keyOverlapChecker);
+            aabbOverlapQueryHelper(node->left, key, aabb, callback, keyOverlapChecker);
         }
     }
 }
@@ -783,7 +1052,7 @@ bool AABBTree<D,K,T,C>::aabbOverlapCheckHelper(
         Node* node,
         const K& key,
         const typename Node::AABB& aabb,
-        KeyOverlapChecker keyOverlapChecker)
+        KeyOverlapChecker keyOverlapChecker) const
 {
     if (node == nullptr)
         return false;
@@ -813,6 +1082,127 @@ bool AABBTree<D,K,T,C>::aabbOverlapCheckHelper(
 
 
 
+/**
+ * @brief Find elements for which the input bounding box overlaps with the one
+ * of the values, visiting the flat hierarchy.
+ * Output can be filtered by another optional key overlap filter function.
+ *
+ * @param[in] key Input key
+ * @param[in] aabb Axis-aligned bounding box of the key
+ * @param[in] callback Function called with the nodes of the elements that overlap
+ * @param[in] keyOverlapChecker Key overlap filter function
+ */
+template <int D, class K, class T, class C> template <class Callback>
+void AABBTree<D,K,T,C>::aabbFlatOverlapQueryHelper(
+        const K& key,
+        const typename Node::AABB& aabb,
+        Callback& callback,
+        KeyOverlapChecker keyOverlapChecker) const
+{
+    //Same tolerance of aabbOverlapsHelper, applied once to the query box
+    double eps = cg3::CG3_EPSILON*200;
+    std::array<double, D> queryMin, queryMax;
+    for (int i = 0; i < D; i++) {
+        queryMin[i] = aabb.min[i] - eps;
+        queryMax[i] = aabb.max[i] + eps;
+    }
+
+    const unsigned int packetSize = internal::AABB_FLAT_PACKET_SIZE;
+
+    unsigned int stack[internal::AABB_FLAT_STACK_SIZE];
+    unsigned int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        const internal::AABBFlatNode<D>& node = flatNodes[stack[--stackSize]];
+
+        //Boxes of the children are compared together
+        unsigned int childMask = internal::aabbFlatPacketOverlapsHelper<D>(queryMin, queryMax, node.boxes);
+        for (unsigned int c = 0; childMask != 0; c++, childMask >>= 1) {
+            if (!(childMask & 1))
+                continue;
+
+            if (node.count[c] == 0) {
+                stack[stackSize++] = node.index[c];
+                continue;
+            }
+
+            //Entries of the leaf are compared a packet at a time
+            unsigned int end = node.index[c] + node.count[c];
+            for (unsigned int p = node.index[c] / packetSize; p * packetSize < end; p++) {
+                unsigned int mask = internal::aabbFlatPacketOverlapsHelper<D>(queryMin, queryMax, flatPackets[p]);
+                for (unsigned int i = 0; mask != 0; i++, mask >>= 1) {
+                    Node* entry = flatEntries[p * packetSize + i];
+                    if ((mask & 1) && (keyOverlapChecker == nullptr || keyOverlapChecker(key, entry->key))) {
+                        callback(entry);
+                    }
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Check if the given bounding box overlaps with at least one of the values,
+ * visiting the flat hierarchy. If the optional key overlap filter function is
+ * specified, then true is returned iff the bounding box overlaps and the filter
+ * function returns true.
+ *
+ * @param[in] key Input key
+ * @param[in] aabb Axis-aligned bounding box of the key
+ * @param[in] keyOverlapChecker Key overlap filter function
+ * @return True if there is an overlapping bounding box in the stored values
+ */
+template <int D, class K, class T, class C>
+bool AABBTree<D,K,T,C>::aabbFlatOverlapCheckHelper(
+        const K& key,
+        const typename Node::AABB& aabb,
+        KeyOverlapChecker keyOverlapChecker) const
+{
+    double eps = cg3::CG3_EPSILON*200;
+    std::array<double, D> queryMin, queryMax;
+    for (int i = 0; i < D; i++) {
+        queryMin[i] = aabb.min[i] - eps;
+        queryMax[i] = aabb.max[i] + eps;
+    }
+
+    const unsigned int packetSize = internal::AABB_FLAT_PACKET_SIZE;
+
+    unsigned int stack[internal::AABB_FLAT_STACK_SIZE];
+    unsigned int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        const internal::AABBFlatNode<D>& node = flatNodes[stack[--stackSize]];
+
+        unsigned int childMask = internal::aabbFlatPacketOverlapsHelper<D>(queryMin, queryMax, node.boxes);
+        for (unsigned int c = 0; childMask != 0; c++, childMask >>= 1) {
+            if (!(childMask & 1))
+                continue;
+
+            if (node.count[c] == 0) {
+                stack[stackSize++] = node.index[c];
+                continue;
+            }
+
+            unsigned int end = node.index[c] + node.count[c];
+            for (unsigned int p = node.index[c] / packetSize; p * packetSize < end; p++) {
+                unsigned int mask = internal::aabbFlatPacketOverlapsHelper<D>(queryMin, queryMax, flatPackets[p]);
+                if (mask != 0 && keyOverlapChecker == nullptr)
+                    return true;
+                for (unsigned int i = 0; mask != 0; i++, mask >>= 1) {
+                    if ((mask & 1) && keyOverlapChecker(key, flatEntries[p * packetSize + i]->key)) {
+                        return true;
+                    }
+                }
+            }
+        }
+    }
+    return false;
+}
+
+
+
 /**
  * @brief Update AABBs climbing on the parents
  *
@@ -1028,7 +1418,7 @@ typename AABBTree<D,K,T,C>::Node* AABBTree<D,K,T,C>::rightRotateAABBHelper(
 template <int D, class K, class T, class C>
 bool AABBTree<D,K,T,C>::aabbOverlapsHelper(
         const typename Node::AABB& a,
-        const typename Node::AABB& b)
+        const typename Node::AABB& b) const
 {
     double eps = cg3::CG3_EPSILON*100;
 
@@ -1054,7 +1444,7 @@ template <int D, class K, class T, class C>
 void AABBTree<D,K,T,C>::setAABBFromKeyHelper(
         const K& k,
         typename Node::AABB& aabb,
-        AABBValueExtractor aabbValueExtractor)
+        AABBValueExtractor aabbValueExtractor) const
 {
     for (int i = 0; i < D; i++) {
         aabb.min[i] = aabbValueExtractor(k, MIN, i+1);
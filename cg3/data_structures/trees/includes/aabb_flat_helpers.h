@@ -0,0 +1,143 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Stefano Nuvoli (stefano.nuvoli@gmail.com)
+ */
+#ifndef CG3_AABBFLATHELPERS_H
+#define CG3_AABBFLATHELPERS_H
+
+#include <array>
+#include <vector>
+
+namespace cg3 {
+
+namespace internal {
+
+/* Flat AABB hierarchy */
+
+/**
+ * @brief Node of the binary hierarchy built by buildFlatAABBHelper, stored
+ * in depth-first order: the left child of an inner node is the next node
+ * in the array.
+ */
+template <int D>
+struct AABBBuildNode {
+    std::array<double, D> min;
+    std::array<double, D> max;
+
+    //Inner node: index of the right child. Leaf: index of the first entry
+    unsigned int index;
+
+    //Number of entries of a leaf, 0 for inner nodes
+    unsigned int count;
+
+    inline bool isLeaf() const { return count > 0; }
+};
+
+/**
+ * @brief Number of boxes stored in a packet, and number of children of
+ * the nodes of a flat AABB hierarchy
+ */
+const unsigned int AABB_FLAT_PACKET_SIZE = 4;
+
+/**
+ * @brief AABB_FLAT_PACKET_SIZE boxes stored by coordinate (structure of
+ * arrays), so that they can be tested against a query box with a few SIMD
+ * instructions. Only the first size slots are used: the other ones contain
+ * empty boxes (min > max), but they are excluded from the tests by their
+ * index, since a query box with infinite or NaN coordinates would overlap
+ * them.
+ */
+template <int D>
+struct AABBFlatPacket {
+    double min[D][AABB_FLAT_PACKET_SIZE];
+    double max[D][AABB_FLAT_PACKET_SIZE];
+
+    //Number of used slots
+    unsigned int size;
+};
+
+/**
+ * @brief Node of a flat (static) AABB hierarchy, with up to
+ * AABB_FLAT_PACKET_SIZE children. The boxes of the children are stored in
+ * the node, so they are tested together when the node is visited.
+ */
+template <int D>
+struct AABBFlatNode {
+    AABBFlatPacket<D> boxes;
+
+    //Inner child: index of the node. Leaf child: index of its first entry
+    unsigned int index[AABB_FLAT_PACKET_SIZE];
+
+    //Number of entries of a leaf child, 0 for inner children
+    unsigned int count[AABB_FLAT_PACKET_SIZE];
+};
+
+/**
+ * @brief Maximum depth of the binary hierarchy built by buildFlatAABBHelper
+ */
+const unsigned int AABB_FLAT_MAX_DEPTH = 96;
+
+/**
+ * @brief Size of the stack needed to visit a flat AABB hierarchy without
+ * allocations
+ */
+const unsigned int AABB_FLAT_STACK_SIZE = AABB_FLAT_MAX_DEPTH * (AABB_FLAT_PACKET_SIZE - 1) + 1;
+
+/**
+ * @brief Depth after which the nodes of a flat AABB hierarchy are split
+ * by count (median) instead of using the surface area heuristic
+ */
+const unsigned int AABB_FLAT_MAX_SAH_DEPTH = 48;
+
+const unsigned int AABB_FLAT_SAH_BINS = 16;
+
+
+/* Flat AABB helpers */
+
+template <int D, class Box>
+inline void buildFlatAABBHelper(
+        const std::vector<Box>& boxes,
+        std::vector<AABBBuildNode<D>>& nodes,
+        std::vector<unsigned int>& order,
+        unsigned int maxLeafSize);
+
+template <int D>
+inline void collapseFlatAABBHelper(
+        const std::vector<AABBBuildNode<D>>& buildNodes,
+        std::vector<AABBFlatNode<D>>& nodes);
+
+template <int D>
+inline unsigned int collapseFlatAABBNodeHelper(
+        const std::vector<AABBBuildNode<D>>& buildNodes,
+        unsigned int buildNode,
+        std::vector<AABBFlatNode<D>>& nodes);
+
+template <int D>
+inline double aabbFlatHalfAreaHelper(
+        const std::array<double, D>& min,
+        const std::array<double, D>& max);
+
+template <int D, class Box>
+inline void setAABBFlatPacketBoxHelper(
+        AABBFlatPacket<D>& packet,
+        unsigned int slot,
+        const Box& box);
+
+template <int D>
+inline void clearAABBFlatPacketHelper(AABBFlatPacket<D>& packet);
+
+template <int D>
+inline unsigned int aabbFlatPacketOverlapsHelper(
+        const std::array<double, D>& queryMin,
+        const std::array<double, D>& queryMax,
+        const AABBFlatPacket<D>& packet);
+
+}
+
+}
+
+#include "aabb_flat_helpers.inl"
+
+#endif // CG3_AABBFLATHELPERS_H
@@ -0,0 +1,464 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Stefano Nuvoli (stefano.nuvoli@gmail.com)
+ */
+#include "aabb_flat_helpers.h"
+
+#include <algorithm>
+#include <limits>
+
+#if defined(__AVX__) && !defined(CG3_AABB_NO_SIMD)
+#define CG3_AABB_AVX
+#include <immintrin.h>
+#elif (defined(__SSE2__) || defined(_M_X64)) && !defined(CG3_AABB_NO_SIMD)
+#define CG3_AABB_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace cg3 {
+
+namespace internal {
+
+/* ----- FLAT AABB HELPERS ----- */
+
+/**
+ * @brief Build a flat AABB hierarchy on a set of bounding boxes.
+ *
+ * Nodes are split with a binned surface area heuristic on the centroids
+ * of the boxes, until they contain at most maxLeafSize boxes. Nodes
+ * deeper than AABB_FLAT_MAX_SAH_DEPTH are split by count, so the depth
+ * of the hierarchy never exceeds AABB_FLAT_MAX_DEPTH.
+ *
+ * @param[in] boxes Bounding boxes (with min and max arrays)
+ * @param[out] nodes Nodes of the hierarchy, in depth-first order
+ * @param[out] order Permutation of the boxes: the entries of a leaf are
+ * order[index], ..., order[index+count-1]
+ * @param[in] maxLeafSize Maximum number of boxes of a leaf
+ */
+template <int D, class Box>
+void buildFlatAABBHelper(
+        const std::vector<Box>& boxes,
+        std::vector<AABBBuildNode<D>>& nodes,
+        std::vector<unsigned int>& order,
+        unsigned int maxLeafSize)
+{
+    struct Task {
+        unsigned int begin;
+        unsigned int end;
+        unsigned int parent; //parent of a right child, noParent otherwise
+        unsigned int depth;
+    };
+
+    //Boxes are copied and permuted in place, so that every pass on a node
+    //reads contiguous memory
+    struct Entry {
+        std::array<double, D> min;
+        std::array<double, D> max;
+        std::array<double, D> centroid;
+        unsigned int index;
+    };
+
+    struct Bin {
+        std::array<double, D> min;
+        std::array<double, D> max;
+        unsigned int count;
+    };
+
+    const double inf = std::numeric_limits<double>::max();
+    const unsigned int noParent = std::numeric_limits<unsigned int>::max();
+
+    if (maxLeafSize == 0)
+        maxLeafSize = 1;
+
+    unsigned int n = (unsigned int) boxes.size();
+
+    nodes.clear();
+    order.resize(n);
+    if (n == 0)
+        return;
+    nodes.reserve(2 * ((n + maxLeafSize - 1) / maxLeafSize));
+
+    std::vector<Entry> entries(n);
+    for (unsigned int i = 0; i < n; i++) {
+        entries[i].index = i;
+        for (int d = 0; d < D; d++) {
+            entries[i].min[d] = boxes[i].min[d];
+            entries[i].max[d] = boxes[i].max[d];
+            entries[i].centroid[d] = (boxes[i].min[d] + boxes[i].max[d]) * 0.5;
+        }
+    }
+
+    std::vector<Task> stack;
+    stack.push_back(Task{0, n, noParent, 0});
+
+    while (!stack.empty()) {
+        Task task = stack.back();
+        stack.pop_back();
+
+        unsigned int nodeIndex = (unsigned int) nodes.size();
+        if (task.parent != noParent)
+            nodes[task.parent].index = nodeIndex;
+
+        //Bounding box of the node and of the centroids
+        AABBBuildNode<D> node;
+        std::array<double, D> cMin, cMax;
+        node.min.fill(inf);
+        node.max.fill(-inf);
+        cMin.fill(inf);
+        cMax.fill(-inf);
+        for (unsigned int i = task.begin; i < task.end; i++) {
+            const Entry& e = entries[i];
+            for (int d = 0; d < D; d++) {
+                node.min[d] = std::min(node.min[d], e.min[d]);
+                node.max[d] = std::max(node.max[d], e.max[d]);
+                cMin[d] = std::min(cMin[d], e.centroid[d]);
+                cMax[d] = std::max(cMax[d], e.centroid[d]);
+            }
+        }
+
+        unsigned int size = task.end - task.begin;
+
+        //Leaf
+        if (size <= maxLeafSize) {
+            node.index = task.begin;
+            node.count = size;
+            nodes.push_back(node);
+            continue;
+        }
+
+        node.index = 0;
+        node.count = 0;
+        nodes.push_back(node);
+
+        unsigned int mid = task.begin;
+
+        //Binned surface area heuristic: choose the axis and the bin boundary
+        //which minimize the sum of the areas of the children weighted with
+        //the number of their boxes
+        if (task.depth < AABB_FLAT_MAX_SAH_DEPTH) {
+            double bestCost = inf;
+            int bestAxis = -1;
+            unsigned int bestBin = 0;
+
+            //Small nodes do not need more bins than boxes
+            unsigned int nBins = std::min(size, AABB_FLAT_SAH_BINS);
+
+            for (int d = 0; d < D; d++) {
+                double extent = cMax[d] - cMin[d];
+                if (extent <= 0)
+                    continue;
+
+                double scale = nBins / extent;
+
+                Bin bins[AABB_FLAT_SAH_BINS];
+                for (unsigned int b = 0; b < nBins; b++) {
+                    bins[b].min.fill(inf);
+                    bins[b].max.fill(-inf);
+                    bins[b].count = 0;
+                }
+                for (unsigned int i = task.begin; i < task.end; i++) {
+                    const Entry& e = entries[i];
+                    unsigned int b = std::min(
+                                (unsigned int) ((e.centroid[d] - cMin[d]) * scale),
+                                nBins - 1);
+                    for (int k = 0; k < D; k++) {
+                        bins[b].min[k] = std::min(bins[b].min[k], e.min[k]);
+                        bins[b].max[k] = std::max(bins[b].max[k], e.max[k]);
+                    }
+                    bins[b].count++;
+                }
+
+                //Sweep from the right to compute the costs of the right sides
+                double rightCost[AABB_FLAT_SAH_BINS];
+                std::array<double, D> rMin, rMax;
+                rMin.fill(inf);
+                rMax.fill(-inf);
+                unsigned int rCount = 0;
+                for (unsigned int b = nBins - 1; b > 0; b--) {
+                    for (int k = 0; k < D; k++) {
+                        rMin[k] = std::min(rMin[k], bins[b].min[k]);
+                        rMax[k] = std::max(rMax[k], bins[b].max[k]);
+                    }
+                    rCount += bins[b].count;
+                    rightCost[b] = rCount == 0 ? inf : rCount * aabbFlatHalfAreaHelper<D>(rMin, rMax);
+                }
+
+                //Sweep from the left: split between bins b and b+1
+                std::array<double, D> lMin, lMax;
+                lMin.fill(inf);
+                lMax.fill(-inf);
+                unsigned int lCount = 0;
+                for (unsigned int b = 0; b < nBins - 1; b++) {
+                    for (int k = 0; k < D; k++) {
+                        lMin[k] = std::min(lMin[k], bins[b].min[k]);
+                        lMax[k] = std::max(lMax[k], bins[b].max[k]);
+                    }
+                    lCount += bins[b].count;
+                    if (lCount == 0 || lCount == size)
+                        continue;
+
+                    double cost = lCount * aabbFlatHalfAreaHelper<D>(lMin, lMax) + rightCost[b+1];
+                    if (cost < bestCost) {
+                        bestCost = cost;
+                        bestAxis = d;
+                        bestBin = b;
+                    }
+                }
+            }
+
+            if (bestAxis >= 0) {
+                double scale = nBins / (cMax[bestAxis] - cMin[bestAxis]);
+                Entry* split = std::partition(
+                            entries.data() + task.begin, entries.data() + task.end,
+                            [&](const Entry& e) {
+                    unsigned int b = std::min(
+                                (unsigned int) ((e.centroid[bestAxis] - cMin[bestAxis]) * scale),
+                                nBins - 1);
+                    return b <= bestBin;
+                });
+                mid = (unsigned int) (split - entries.data());
+            }
+        }
+
+        //Median split on the largest axis of the centroids
+        if (mid == task.begin || mid == task.end) {
+            int axis = 0;
+            for (int d = 1; d < D; d++) {
+                if (cMax[d] - cMin[d] > cMax[axis] - cMin[axis])
+                    axis = d;
+            }
+            mid = task.begin + size / 2;
+            std::nth_element(
+                        entries.data() + task.begin, entries.data() + mid, entries.data() + task.end,
+                        [&](const Entry& a, const Entry& b) {
+                return a.centroid[axis] < b.centroid[axis];
+            });
+        }
+
+        //The left child is visited first, so it is stored after its parent
+        stack.push_back(Task{mid, task.end, nodeIndex, task.depth + 1});
+        stack.push_back(Task{task.begin, mid, noParent, task.depth + 1});
+    }
+
+    for (unsigned int i = 0; i < n; i++)
+        order[i] = entries[i].index;
+}
+
+/**
+ * @brief Collapse a binary hierarchy built by buildFlatAABBHelper in a flat
+ * hierarchy with AABB_FLAT_PACKET_SIZE children per node. The root of the
+ * flat hierarchy is the first node.
+ *
+ * Leaf children keep the index and the count of the binary leaves, which
+ * refer to the order computed by buildFlatAABBHelper.
+ *
+ * @param[in] buildNodes Binary hierarchy
+ * @param[out] nodes Flat hierarchy
+ */
+template <int D>
+void collapseFlatAABBHelper(
+        const std::vector<AABBBuildNode<D>>& buildNodes,
+        std::vector<AABBFlatNode<D>>& nodes)
+{
+    nodes.clear();
+    if (buildNodes.empty())
+        return;
+    nodes.reserve(buildNodes.size() / 2 + 1);
+    collapseFlatAABBNodeHelper<D>(buildNodes, 0, nodes);
+}
+
+/**
+ * @brief Create the flat node that replaces a binary node and its
+ * descendants: the inner descendant with the largest area is replaced by
+ * its children until there are AABB_FLAT_PACKET_SIZE of them.
+ *
+ * @return The index of the created node
+ */
+template <int D>
+unsigned int collapseFlatAABBNodeHelper(
+        const std::vector<AABBBuildNode<D>>& buildNodes,
+        unsigned int buildNode,
+        std::vector<AABBFlatNode<D>>& nodes)
+{
+    unsigned int children[AABB_FLAT_PACKET_SIZE];
+    unsigned int nChildren = 0;
+
+    const AABBBuildNode<D>& root = buildNodes[buildNode];
+    if (root.isLeaf()) {
+        children[nChildren++] = buildNode;
+    }
+    else {
+        children[nChildren++] = buildNode + 1;
+        children[nChildren++] = root.index;
+    }
+
+    while (nChildren < AABB_FLAT_PACKET_SIZE) {
+        int largest = -1;
+        double largestArea = -1;
+        for (unsigned int i = 0; i < nChildren; i++) {
+            const AABBBuildNode<D>& child = buildNodes[children[i]];
+            if (!child.isLeaf()) {
+                double area = aabbFlatHalfAreaHelper<D>(child.min, child.max);
+                if (area > largestArea) {
+                    largestArea = area;
+                    largest = (int) i;
+                }
+            }
+        }
+        if (largest < 0)
+            break;
+
+        unsigned int opened = children[largest];
+        children[largest] = opened + 1;
+        children[nChildren++] = buildNodes[opened].index;
+    }
+
+    unsigned int nodeIndex = (unsigned int) nodes.size();
+    nodes.emplace_back();
+    clearAABBFlatPacketHelper<D>(nodes[nodeIndex].boxes);
+    for (unsigned int i = 0; i < AABB_FLAT_PACKET_SIZE; i++) {
+        nodes[nodeIndex].index[i] = 0;
+        nodes[nodeIndex].count[i] = 0;
+    }
+
+    for (unsigned int i = 0; i < nChildren; i++) {
+        const AABBBuildNode<D>& child = buildNodes[children[i]];
+        setAABBFlatPacketBoxHelper<D>(nodes[nodeIndex].boxes, i, child);
+        if (child.isLeaf()) {
+            nodes[nodeIndex].index[i] = child.index;
+            nodes[nodeIndex].count[i] = child.count;
+        }
+        else {
+            //The vector may be reallocated by the recursive call
+            unsigned int childIndex = collapseFlatAABBNodeHelper<D>(buildNodes, children[i], nodes);
+            nodes[nodeIndex].index[i] = childIndex;
+        }
+    }
+
+    return nodeIndex;
+}
+
+/**
+ * @brief Half of the surface area of a D-dimensional box (perimeter for
+ * D = 2, length for D = 1)
+ */
+template <int D>
+double aabbFlatHalfAreaHelper(
+        const std::array<double, D>& min,
+        const std::array<double, D>& max)
+{
+    if (D == 1)
+        return max[0] - min[0];
+
+    double area = 0;
+    for (int i = 0; i < D; i++) {
+        double face = 1;
+        for (int j = 0; j < D; j++) {
+            if (j != i)
+                face *= max[j] - min[j];
+        }
+        area += face;
+    }
+    return area;
+}
+
+/**
+ * @brief Store a box in a slot of a packet. Slots must be filled in order.
+ */
+template <int D, class Box>
+void setAABBFlatPacketBoxHelper(
+        AABBFlatPacket<D>& packet,
+        unsigned int slot,
+        const Box& box)
+{
+    for (int d = 0; d < D; d++) {
+        packet.min[d][slot] = box.min[d];
+        packet.max[d][slot] = box.max[d];
+    }
+    packet.size = std::max(packet.size, slot + 1);
+}
+
+/**
+ * @brief Fill all the slots of a packet with empty boxes, and mark them
+ * as unused
+ */
+template <int D>
+void clearAABBFlatPacketHelper(AABBFlatPacket<D>& packet)
+{
+    for (int d = 0; d < D; d++) {
+        for (unsigned int i = 0; i < AABB_FLAT_PACKET_SIZE; i++) {
+            packet.min[d][i] = std::numeric_limits<double>::max();
+            packet.max[d][i] = -std::numeric_limits<double>::max();
+        }
+    }
+    packet.size = 0;
+}
+
+/**
+ * @brief Check which boxes of a packet overlap with a query box. The query
+ * box must be already enlarged by the tolerance of the comparison.
+ *
+ * The boxes of the packet are compared together, with AVX (4 boxes per
+ * instruction) or SSE2 (2 boxes per instruction) when they are enabled
+ * at compile time. Defining CG3_AABB_NO_SIMD forces the scalar comparison.
+ *
+ * @return A mask with the i-th bit set if the i-th box is used and overlaps
+ */
+template <int D>
+unsigned int aabbFlatPacketOverlapsHelper(
+        const std::array<double, D>& queryMin,
+        const std::array<double, D>& queryMax,
+        const AABBFlatPacket<D>& packet)
+{
+    //Unused slots are never returned, whatever the query box is
+    const unsigned int used = (1u << packet.size) - 1;
+#if defined(CG3_AABB_AVX)
+    //Lanes are set when the boxes are separated on some axis
+    __m256d separated = _mm256_setzero_pd();
+    for (int d = 0; d < D; d++) {
+        __m256d qMin = _mm256_set1_pd(queryMin[d]);
+        __m256d qMax = _mm256_set1_pd(queryMax[d]);
+        __m256d bMin = _mm256_loadu_pd(packet.min[d]);
+        __m256d bMax = _mm256_loadu_pd(packet.max[d]);
+        separated = _mm256_or_pd(separated, _mm256_cmp_pd(qMin, bMax, _CMP_GT_OQ));
+        separated = _mm256_or_pd(separated, _mm256_cmp_pd(bMin, qMax, _CMP_GT_OQ));
+    }
+    return ~(unsigned int) _mm256_movemask_pd(separated) & used;
+#elif defined(CG3_AABB_SSE2)
+    __m128d separatedLow = _mm_setzero_pd();
+    __m128d separatedHigh = _mm_setzero_pd();
+    for (int d = 0; d < D; d++) {
+        __m128d qMin = _mm_set1_pd(queryMin[d]);
+        __m128d qMax = _mm_set1_pd(queryMax[d]);
+        separatedLow = _mm_or_pd(separatedLow, _mm_cmpgt_pd(qMin, _mm_loadu_pd(packet.max[d])));
+        separatedLow = _mm_or_pd(separatedLow, _mm_cmpgt_pd(_mm_loadu_pd(packet.min[d]), qMax));
+        separatedHigh = _mm_or_pd(separatedHigh, _mm_cmpgt_pd(qMin, _mm_loadu_pd(packet.max[d] + 2)));
+        separatedHigh = _mm_or_pd(separatedHigh, _mm_cmpgt_pd(_mm_loadu_pd(packet.min[d] + 2), qMax));
+    }
+    unsigned int separated =
+            (unsigned int) _mm_movemask_pd(separatedLow) |
+            ((unsigned int) _mm_movemask_pd(separatedHigh) << 2);
+    return ~separated & used;
+#else
+    unsigned int mask = 0;
+    for (unsigned int i = 0; i < AABB_FLAT_PACKET_SIZE; i++) {
+        bool overlaps = true;
+        for (int d = 0; d < D; d++) {
+            if (queryMin[d] > packet.max[d][i] || packet.min[d][i] > queryMax[d])
+                overlaps = false;
+        }
+        if (overlaps)
+            mask |= 1u << i;
+    }
+    return mask & used;
+#endif
+}
+
+}
+
+}
+
+#undef CG3_AABB_AVX
+#undef CG3_AABB_SSE2
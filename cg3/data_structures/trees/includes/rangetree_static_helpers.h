@@ -0,0 +1,126 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Stefano Nuvoli (stefano.nuvoli@gmail.com)
+ */
+#ifndef CG3_RANGETREESTATICHELPERS_H
+#define CG3_RANGETREESTATICHELPERS_H
+
+#include <vector>
+
+namespace cg3 {
+
+namespace internal {
+
+/* Static layered range tree */
+
+/**
+ * @brief Node of a static (layered) range tree, stored in depth-first
+ * order: the left child of an inner node is the next node in the array.
+ *
+ * The node contains the entries [begin, end) of the array of its layer,
+ * which is sorted by the dimension of the layer. In the layer of the second
+ * to last dimension, next is the position of the list of the entries of the
+ * node sorted by the last dimension; in the other layers, it is the root of
+ * the layer of the next dimension built on the entries of the node.
+ */
+struct RangeTreeStaticNode {
+    unsigned int begin;
+    unsigned int end;
+
+    //Index of the right child (inner nodes only)
+    unsigned int right;
+
+    unsigned int next;
+
+    inline bool isLeaf() const { return end - begin == 1; }
+};
+
+/**
+ * @brief Arrays of a static (layered) range tree on entries of type E.
+ *
+ * The layers of all the dimensions but the last one are stored in nodes,
+ * and their entries, sorted by the dimension of each layer, in entries.
+ * The sorted lists of the nodes of the second to last layer, sorted by the
+ * last dimension, are stored in lists, and their fractional cascading
+ * pointers in leftCounts.
+ */
+template <class E>
+struct RangeTreeStaticLayers {
+    std::vector<RangeTreeStaticNode> nodes;
+    std::vector<E> entries;
+    std::vector<E> lists;
+    std::vector<unsigned int> leftCounts;
+
+    inline void clear();
+};
+
+
+/* Static range tree helpers */
+
+template <class E, class Less>
+inline void mergeRangeTreeStaticHelper(
+        const std::vector<E>& left,
+        const std::vector<E>& right,
+        std::vector<E>& merged,
+        std::vector<unsigned int>* leftCounts,
+        Less less);
+
+template <class E, class Less>
+inline unsigned int buildLayerRangeTreeStaticHelper(
+        RangeTreeStaticLayers<E>& layers,
+        unsigned int dimensions,
+        unsigned int layer,
+        const std::vector<E>& sortedEntries,
+        Less& less);
+
+template <class E, class Less>
+inline unsigned int buildNodeRangeTreeStaticHelper(
+        RangeTreeStaticLayers<E>& layers,
+        unsigned int dimensions,
+        unsigned int layer,
+        unsigned int begin,
+        unsigned int end,
+        std::vector<E>& nextSortedEntries,
+        Less& less);
+
+template <class E, class Before, class After, class Callback>
+inline void rangeQueryLayerRangeTreeStaticHelper(
+        const RangeTreeStaticLayers<E>& layers,
+        unsigned int dimensions,
+        unsigned int layer,
+        unsigned int layerRoot,
+        Before& before,
+        After& after,
+        Callback& callback);
+
+template <class E, class Before, class After, class Callback>
+inline void rangeQueryNodeRangeTreeStaticHelper(
+        const RangeTreeStaticLayers<E>& layers,
+        unsigned int dimensions,
+        unsigned int layer,
+        unsigned int node,
+        unsigned int first,
+        unsigned int last,
+        Before& before,
+        After& after,
+        Callback& callback);
+
+template <class E, class Callback>
+inline void rangeQueryCascadingRangeTreeStaticHelper(
+        const RangeTreeStaticLayers<E>& layers,
+        unsigned int node,
+        unsigned int first,
+        unsigned int last,
+        unsigned int lower,
+        unsigned int upper,
+        Callback& callback);
+
+}
+
+}
+
+#include "rangetree_static_helpers.inl"
+
+#endif // CG3_RANGETREESTATICHELPERS_H
@@ -0,0 +1,345 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Stefano Nuvoli (stefano.nuvoli@gmail.com)
+ */
+#include "rangetree_static_helpers.h"
+
+#include <algorithm>
+
+namespace cg3 {
+
+namespace internal {
+
+/* ----- STATIC RANGE TREE HELPERS ----- */
+
+/**
+ * @brief Clear the arrays of the static range tree
+ */
+template <class E>
+void RangeTreeStaticLayers<E>::clear()
+{
+    this->nodes.clear();
+    this->entries.clear();
+    this->lists.clear();
+    this->leftCounts.clear();
+}
+
+/**
+ * @brief Merge the entries of the children of a node, sorted by a
+ * dimension, in the sorted entries of the node. Equal entries of the left
+ * child come first, so the entries of each child keep their order in the
+ * merged array.
+ *
+ * If leftCounts is not null, the number of entries of the left child which
+ * precede each position of the merged array is appended to it: these are
+ * the fractional cascading pointers from the node to its children.
+ *
+ * @param[in] left Sorted entries of the left child
+ * @param[in] right Sorted entries of the right child
+ * @param[out] merged Sorted entries of the node
+ * @param[out] leftCounts Number of entries of the left child before each position
+ * @param[in] less Comparator of the entries in the dimension
+ */
+template <class E, class Less>
+void mergeRangeTreeStaticHelper(
+        const std::vector<E>& left,
+        const std::vector<E>& right,
+        std::vector<E>& merged,
+        std::vector<unsigned int>* leftCounts,
+        Less less)
+{
+    merged.clear();
+    merged.reserve(left.size() + right.size());
+
+    size_t i = 0, j = 0;
+    while (i < left.size() || j < right.size()) {
+        if (leftCounts != nullptr)
+            leftCounts->push_back((unsigned int) i);
+
+        if (j == right.size() || (i < left.size() && !less(right[j], left[i])))
+            merged.push_back(left[i++]);
+        else
+            merged.push_back(right[j++]);
+    }
+}
+
+
+/* ----- STATIC RANGE TREE BUILD HELPERS ----- */
+
+/*
+ * The layers of a static range tree are numbered from 0 to dimensions-2,
+ * and the layer l is sorted by the dimension l. The comparison of the
+ * entries in each dimension is given by less(dimension, a, b), which
+ * returns true if the entry a precedes the entry b in the dimension.
+ */
+
+/**
+ * @brief Build a layer of the static range tree, and the layers of the
+ * next dimensions on the entries of its nodes
+ *
+ * @param[out] layers Arrays of the static range tree
+ * @param[in] dimensions Number of dimensions (greater than 1)
+ * @param[in] layer Layer to be built
+ * @param[in] sortedEntries Entries of the layer, sorted by its dimension
+ * @param[in] less Comparator of the entries in a dimension
+ * @return Index of the root node of the layer
+ */
+template <class E, class Less>
+unsigned int buildLayerRangeTreeStaticHelper(
+        RangeTreeStaticLayers<E>& layers,
+        unsigned int dimensions,
+        unsigned int layer,
+        const std::vector<E>& sortedEntries,
+        Less& less)
+{
+    unsigned int begin = (unsigned int) layers.entries.size();
+    layers.entries.insert(layers.entries.end(), sortedEntries.begin(), sortedEntries.end());
+
+    std::vector<E> nextSortedEntries;
+    return buildNodeRangeTreeStaticHelper(
+                layers,
+                dimensions,
+                layer,
+                begin,
+                begin + (unsigned int) sortedEntries.size(),
+                nextSortedEntries,
+                less);
+}
+
+/**
+ * @brief Build a node of a layer of the static range tree, and its
+ * subtree, bottom-up
+ *
+ * @param[out] layers Arrays of the static range tree
+ * @param[in] dimensions Number of dimensions
+ * @param[in] layer Layer of the node
+ * @param[in] begin First entry of the node
+ * @param[in] end End of the entries of the node
+ * @param[out] nextSortedEntries Entries of the node, sorted by the
+ * next dimension
+ * @param[in] less Comparator of the entries in a dimension
+ * @return Index of the node
+ */
+template <class E, class Less>
+unsigned int buildNodeRangeTreeStaticHelper(
+        RangeTreeStaticLayers<E>& layers,
+        unsigned int dimensions,
+        unsigned int layer,
+        unsigned int begin,
+        unsigned int end,
+        std::vector<E>& nextSortedEntries,
+        Less& less)
+{
+    const bool lastLayer = (layer + 2 == dimensions);
+    const unsigned int nextDimension = layer + 1;
+
+    unsigned int index = (unsigned int) layers.nodes.size();
+    RangeTreeStaticNode node;
+    node.begin = begin;
+    node.end = end;
+    node.right = 0;
+    node.next = 0;
+    layers.nodes.push_back(node);
+
+    //The sorted lists of the last layer and their cascading pointers are
+    //stored in parallel
+    std::vector<unsigned int>* leftCounts = (lastLayer ? &layers.leftCounts : nullptr);
+
+    if (end - begin == 1) {
+        nextSortedEntries.assign(1, layers.entries[begin]);
+        if (leftCounts != nullptr)
+            leftCounts->push_back(0);
+    }
+    else {
+        unsigned int mid = (begin + end) / 2;
+
+        std::vector<E> leftSortedEntries, rightSortedEntries;
+        buildNodeRangeTreeStaticHelper(layers, dimensions, layer, begin, mid, leftSortedEntries, less);
+        unsigned int right = buildNodeRangeTreeStaticHelper(layers, dimensions, layer, mid, end, rightSortedEntries, less);
+        layers.nodes[index].right = right;
+
+        mergeRangeTreeStaticHelper(
+                    leftSortedEntries,
+                    rightSortedEntries,
+                    nextSortedEntries,
+                    leftCounts,
+                    [&less, nextDimension](const E& a, const E& b) {
+                        return less(nextDimension, a, b);
+                    });
+    }
+
+    if (lastLayer) {
+        layers.nodes[index].next = (unsigned int) layers.lists.size();
+        layers.lists.insert(layers.lists.end(), nextSortedEntries.begin(), nextSortedEntries.end());
+    }
+    else {
+        unsigned int next = buildLayerRangeTreeStaticHelper(layers, dimensions, layer + 1, nextSortedEntries, less);
+        layers.nodes[index].next = next;
+    }
+
+    return index;
+}
+
+
+
+/* ----- STATIC RANGE TREE QUERY HELPERS ----- */
+
+/*
+ * The range of a query is given by before(dimension, e), which returns
+ * true if the entry e precedes the start of the range in the dimension,
+ * and after(dimension, e), which returns true if e follows its end.
+ */
+
+/**
+ * @brief Find the entries of a layer of the static range tree that are
+ * enclosed in the range, calling callback(e) for each of them
+ *
+ * @param[in] layers Arrays of the static range tree
+ * @param[in] dimensions Number of dimensions (greater than 1)
+ * @param[in] layer Layer to be searched
+ * @param[in] layerRoot Root node of the layer
+ * @param[in] before Check if an entry precedes the range in a dimension
+ * @param[in] after Check if an entry follows the range in a dimension
+ * @param[in] callback Function called for each entry in the range
+ */
+template <class E, class Before, class After, class Callback>
+void rangeQueryLayerRangeTreeStaticHelper(
+        const RangeTreeStaticLayers<E>& layers,
+        unsigned int dimensions,
+        unsigned int layer,
+        unsigned int layerRoot,
+        Before& before,
+        After& after,
+        Callback& callback)
+{
+    const RangeTreeStaticNode& root = layers.nodes[layerRoot];
+
+    //Entries of the layer in the range of its dimension
+    const E* entries = layers.entries.data();
+    unsigned int first = (unsigned int) (std::partition_point(
+            entries + root.begin, entries + root.end, [&before, layer](const E& e) {
+        return before(layer, e);
+    }) - entries);
+    unsigned int last = (unsigned int) (std::partition_point(
+            entries + first, entries + root.end, [&after, layer](const E& e) {
+        return !after(layer, e);
+    }) - entries);
+    if (first >= last)
+        return;
+
+    if (layer + 2 == dimensions) {
+        //The last dimension is searched only in the list of the root
+        const unsigned int lastDimension = dimensions - 1;
+        const E* list = layers.lists.data() + root.next;
+        const E* listEnd = list + (root.end - root.begin);
+        unsigned int lower = (unsigned int) (std::partition_point(list, listEnd, [&before, lastDimension](const E& e) {
+            return before(lastDimension, e);
+        }) - list);
+        unsigned int upper = (unsigned int) (std::partition_point(list + lower, listEnd, [&after, lastDimension](const E& e) {
+            return !after(lastDimension, e);
+        }) - list);
+
+        rangeQueryCascadingRangeTreeStaticHelper(layers, layerRoot, first, last, lower, upper, callback);
+    }
+    else {
+        rangeQueryNodeRangeTreeStaticHelper(layers, dimensions, layer, layerRoot, first, last, before, after, callback);
+    }
+}
+
+/**
+ * @brief Search the nodes of a layer of the static range tree which are
+ * enclosed in the range [first, last) of the entries of the layer, and
+ * search the next dimension in their layers
+ *
+ * @param[in] layers Arrays of the static range tree
+ * @param[in] dimensions Number of dimensions
+ * @param[in] layer Layer of the node
+ * @param[in] node Node of the layer
+ * @param[in] first First entry in the range
+ * @param[in] last End of the entries in the range
+ * @param[in] before Check if an entry precedes the range in a dimension
+ * @param[in] after Check if an entry follows the range in a dimension
+ * @param[in] callback Function called for each entry in the range
+ */
+template <class E, class Before, class After, class Callback>
+void rangeQueryNodeRangeTreeStaticHelper(
+        const RangeTreeStaticLayers<E>& layers,
+        unsigned int dimensions,
+        unsigned int layer,
+        unsigned int node,
+        unsigned int first,
+        unsigned int last,
+        Before& before,
+        After& after,
+        Callback& callback)
+{
+    const RangeTreeStaticNode& n = layers.nodes[node];
+
+    if (n.end <= first || n.begin >= last)
+        return;
+
+    if (first <= n.begin && n.end <= last) {
+        rangeQueryLayerRangeTreeStaticHelper(layers, dimensions, layer + 1, n.next, before, after, callback);
+        return;
+    }
+
+    rangeQueryNodeRangeTreeStaticHelper(layers, dimensions, layer, node+1, first, last, before, after, callback);
+    rangeQueryNodeRangeTreeStaticHelper(layers, dimensions, layer, n.right, first, last, before, after, callback);
+}
+
+/**
+ * @brief Search the nodes of the last layer which are enclosed in the range
+ * [first, last) of the entries of the layer, and report their entries in
+ * the range of the last dimension.
+ *
+ * The entries of a node in the range of the last dimension are the
+ * positions [lower, upper) of its sorted list: the positions in the lists
+ * of the children are given by the cascading pointers, without searching.
+ *
+ * @param[in] layers Arrays of the static range tree
+ * @param[in] node Node of the layer
+ * @param[in] first First entry in the range
+ * @param[in] last End of the entries in the range
+ * @param[in] lower First position of the list of the node in the range
+ * @param[in] upper End of the positions of the list of the node in the range
+ * @param[in] callback Function called for each entry in the range
+ */
+template <class E, class Callback>
+void rangeQueryCascadingRangeTreeStaticHelper(
+        const RangeTreeStaticLayers<E>& layers,
+        unsigned int node,
+        unsigned int first,
+        unsigned int last,
+        unsigned int lower,
+        unsigned int upper,
+        Callback& callback)
+{
+    if (lower >= upper)
+        return;
+
+    const RangeTreeStaticNode& n = layers.nodes[node];
+
+    if (n.end <= first || n.begin >= last)
+        return;
+
+    if (first <= n.begin && n.end <= last) {
+        for (unsigned int i = n.next + lower; i < n.next + upper; i++)
+            callback(layers.lists[i]);
+        return;
+    }
+
+    //Positions in the list of the left child (the others are in the right one)
+    unsigned int size = n.end - n.begin;
+    unsigned int leftSize = (n.end + n.begin) / 2 - n.begin;
+    unsigned int leftLower = (lower == size ? leftSize : layers.leftCounts[n.next + lower]);
+    unsigned int leftUpper = (upper == size ? leftSize : layers.leftCounts[n.next + upper]);
+
+    rangeQueryCascadingRangeTreeStaticHelper(layers, node+1, first, last, leftLower, leftUpper, callback);
+    rangeQueryCascadingRangeTreeStaticHelper(layers, n.right, first, last, lower - leftLower, upper - leftUpper, callback);
+}
+
+}
+
+}
@@ -7,6 +7,7 @@
 #include "cg3/geometry/point2.h"
 
 #include "cg3/data_structures/trees/rangetree.h"
+#include "cg3/data_structures/trees/static_rangetree.h"
 
 namespace cg3 {
 
@@ -51,6 +52,12 @@ public:
         : RangeTree<Point3d>(3, vec, internal::getComparatorsForPoint3D()) {}
 };
 
+/**
+ * Static range trees of 2D and 3D points (double components)
+ */
+typedef StaticRangeTree<2, Point2d> StaticRangeTree2D;
+typedef StaticRangeTree<3, Point3d> StaticRangeTree3D;
+
 } //namespace cg3
 
 #ifndef CG3_STATIC
@@ -0,0 +1,35 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Stefano Nuvoli (stefano.nuvoli@gmail.com)
+ */
+#ifndef CG3_TREEBATCHHELPERS_H
+#define CG3_TREEBATCHHELPERS_H
+
+#include <cstddef>
+#include <vector>
+
+#include "../../../utilities/thread_pool.h"
+
+namespace cg3 {
+
+namespace internal {
+
+/* Batch query helpers */
+
+template <class Result, class Query>
+inline void batchQueryHelper(
+        std::size_t nQueries,
+        Query query,
+        std::vector<std::size_t>& offsets,
+        std::vector<Result>& results,
+        ThreadPool& pool);
+
+}
+
+}
+
+#include "tree_batch_helpers.inl"
+
+#endif // CG3_TREEBATCHHELPERS_H
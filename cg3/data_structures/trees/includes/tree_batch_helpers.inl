@@ -0,0 +1,74 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Stefano Nuvoli (stefano.nuvoli@gmail.com)
+ */
+#include "tree_batch_helpers.h"
+
+#include <algorithm>
+
+namespace cg3 {
+
+namespace internal {
+
+/* ----- BATCH QUERY HELPERS ----- */
+
+/**
+ * @brief Execute a batch of queries in parallel, storing the results in
+ * compressed sparse row format: the results of the i-th query are
+ * results[offsets[i]], ..., results[offsets[i+1]-1].
+ *
+ * Queries are split in chunks of consecutive queries, distributed among the
+ * threads of the pool and the calling thread. Each chunk collects its
+ * results in a local array, and the arrays are then appended in order to
+ * the output: the output does not depend on the number of threads.
+ *
+ * @param[in] nQueries Number of queries
+ * @param[in] query Function query(i, out) which appends to the vector out
+ * the results of the i-th query. It is called concurrently by the threads
+ * @param[out] offsets Offsets of the results of each query (nQueries+1 values)
+ * @param[out] results Results of all the queries
+ * @param[in] pool Thread pool which executes the chunks
+ */
+template <class Result, class Query>
+void batchQueryHelper(
+        std::size_t nQueries,
+        Query query,
+        std::vector<std::size_t>& offsets,
+        std::vector<Result>& results,
+        ThreadPool& pool)
+{
+    const std::size_t grainSize = 256;
+
+    offsets.assign(nQueries + 1, 0);
+    results.clear();
+    if (nQueries == 0)
+        return;
+
+    //Each chunk collects its results, and the number of results of its queries
+    std::vector<std::vector<Result>> chunkResults(numberOfChunks(nQueries, grainSize));
+    parallelForChunks(pool, nQueries, grainSize, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+        std::vector<Result>& out = chunkResults[chunk];
+        for (std::size_t i = begin; i < end; i++) {
+            std::size_t size = out.size();
+            query(i, out);
+            offsets[i + 1] = out.size() - size;
+        }
+    });
+
+    //Prefix sum of the number of results
+    for (std::size_t i = 0; i < nQueries; i++)
+        offsets[i + 1] += offsets[i];
+
+    //Copy the results of the chunks (results may not be default constructible)
+    results.reserve(offsets[nQueries]);
+    for (std::vector<Result>& out : chunkResults) {
+        results.insert(results.end(), out.begin(), out.end());
+        std::vector<Result>().swap(out);
+    }
+}
+
+}
+
+}
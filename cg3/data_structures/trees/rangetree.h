@@ -19,6 +19,9 @@
 
 #include "includes/nodes/rangetree_node.h"
 
+#include "includes/tree_batch_helpers.h"
+#include "includes/rangetree_static_helpers.h"
+
 
 namespace cg3 {
 
@@ -33,6 +36,16 @@ namespace cg3 {
  * been made because we prefer to allow the user, if needed, to easily implement range
  * searches in just a subset of the dimensions of the object.
  *
+ * For static workloads (many queries on a tree that does not change),
+ * buildStatic() creates a layered range tree of the entries, stored in
+ * contiguous arrays and searched with fractional cascading on the last
+ * dimension, which is then used by rangeQuery. Any change of the tree
+ * discards the static structure.
+ *
+ * The const query methods do not change the tree: they can be called
+ * concurrently by many threads, as long as no thread changes the tree.
+ * batchRangeQuery executes a list of range queries on the threads of a
+ * ThreadPool (defaultThreadPool() if none is given).
  */
 template <class K, class T = K, class C = DefaultComparatorType<K>>
 class RangeTree
@@ -95,12 +108,12 @@ public:
     iterator find(const K& key);
 
 
-    size_t size();
-    bool empty();
+    size_t size() const;
+    bool empty() const;
 
     void clear();
 
-    size_t getHeight();
+    size_t getHeight() const;
 
 
 
@@ -109,6 +122,22 @@ public:
             const K& start, const K& end,
             OutputIterator out);
 
+    template <class OutputIterator>
+    void rangeQuery(
+            const K& start, const K& end,
+            OutputIterator out) const;
+
+    void batchRangeQuery(
+            const std::vector<K>& starts,
+            const std::vector<K>& ends,
+            std::vector<size_t>& offsets,
+            std::vector<const_iterator>& results,
+            ThreadPool& pool = defaultThreadPool()) const;
+
+
+    void buildStatic();
+    bool isStatic() const;
+
 
 
     /* Iterator Min/Max Next/Prev */
@@ -160,11 +189,15 @@ protected:
     C comparator;
     std::vector<C> customComparators;
 
+    internal::RangeTreeStaticLayers<Node*> staticTree;
+
 
     /* Protected methods */
 
     void initialize();
 
+    void clearStatic();
+
     Node* copyRangeTreeSubtree(
             const Node* rootNode,
             Node* parent = nullptr);
@@ -174,13 +207,21 @@ protected:
 
     inline void rangeQueryHelper(
             const K& start, const K& end,
-            std::vector<Node*>& out);
+            std::vector<Node*>& out) const;
 
     inline void rangeSearchInNextDimensionHelper(
             Node* node,
             const K& start,
             const K& end,
-            std::vector<Node*>& out);
+            std::vector<Node*>& out) const;
+
+
+    /* Static range tree helpers */
+
+    inline void rangeQueryStaticHelper(
+            const K& start,
+            const K& end,
+            std::vector<Node*>& out) const;
 
 
 
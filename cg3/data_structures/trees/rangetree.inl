@@ -7,6 +7,8 @@
 #include "rangetree.h"
 
 #include "assert.h"
+#include <iterator>
+#include <unordered_map>
 
 #include "includes/bstleaf_helpers.h"
 #include "includes/avl_helpers.h"
@@ -91,6 +93,28 @@ RangeTree<K,T,C>::RangeTree(const RangeTree<K,T,C>& bst) :
 {
     this->root = this->copyRangeTreeSubtree(bst.root);
     this->entries = bst.entries;
+
+    //The copied tree has the same leaves in the same order
+    if (!bst.staticTree.entries.empty()) {
+        std::unordered_map<const Node*, Node*> copiedLeaves;
+        copiedLeaves.reserve(bst.entries);
+        Node* node = internal::getMinimumHelperLeaf(this->root);
+        Node* bstNode = internal::getMinimumHelperLeaf(bst.root);
+        while (bstNode != nullptr) {
+            copiedLeaves[bstNode] = node;
+            node = internal::getSuccessorHelperLeaf(node);
+            bstNode = internal::getSuccessorHelperLeaf(bstNode);
+        }
+
+        this->staticTree.nodes = bst.staticTree.nodes;
+        this->staticTree.leftCounts = bst.staticTree.leftCounts;
+        this->staticTree.entries.reserve(bst.staticTree.entries.size());
+        for (Node* entry : bst.staticTree.entries)
+            this->staticTree.entries.push_back(copiedLeaves[entry]);
+        this->staticTree.lists.reserve(bst.staticTree.lists.size());
+        for (Node* entry : bst.staticTree.lists)
+            this->staticTree.lists.push_back(copiedLeaves[entry]);
+    }
 }
 
 /**
@@ -101,7 +125,8 @@ template <class K, class T, class C>
 RangeTree<K,T,C>::RangeTree(RangeTree<K,T,C>&& bst) :
     dim(bst.dim),
     comparator(bst.comparator),
-    customComparators(bst.customComparators)
+    customComparators(bst.customComparators),
+    staticTree(std::move(bst.staticTree))
 {
     this->root = bst.root;
     bst.root = nullptr;
@@ -233,6 +258,9 @@ typename RangeTree<K,T,C>::iterator RangeTree<K,T,C>::insert(
 
     //If node has been inserted
     if (result != nullptr) {
+        //The static range tree is not valid anymore
+        this->clearStatic();
+
         //New node parent
         Node* newParent = newNode->parent;
 
@@ -291,6 +319,8 @@ bool RangeTree<K,T,C>::erase(const K& key)
 
     //If the node has been found
     if (node != nullptr) {
+        //The static range tree is not valid anymore
+        this->clearStatic();
 
         //Update associated trees
         this->eraseFromParentAssociatedTreesHelper(node->parent, node->key);
@@ -345,6 +375,7 @@ void RangeTree<K,T,C>::clear()
 {
     //Clear entire tree
     internal::clearHelper(this->root);
+    this->clearStatic();
 
     //Decreasing entries
     this->entries = 0;
@@ -359,7 +390,7 @@ void RangeTree<K,T,C>::clear()
  * @return Number of entries
  */
 template <class K, class T, class C>
-size_t RangeTree<K,T,C>::size()
+size_t RangeTree<K,T,C>::size() const
 {
     return this->entries;
 }
@@ -370,7 +401,7 @@ size_t RangeTree<K,T,C>::size()
  * @return True if the range tree is empty
  */
 template <class K, class T, class C>
-bool RangeTree<K,T,C>::empty()
+bool RangeTree<K,T,C>::empty() const
 {
     return (this->size() == 0);
 }
@@ -383,7 +414,7 @@ bool RangeTree<K,T,C>::empty()
  * @return Max height of the tree
  */
 template <class K, class T, class C>
-size_t RangeTree<K,T,C>::getHeight()
+size_t RangeTree<K,T,C>::getHeight() const
 {
     return internal::getHeightHelper(this->root);
 }
@@ -409,8 +440,11 @@ void RangeTree<K,T,C>::rangeQuery(
     //Output
     std::vector<Node*> nodeOutput;
 
-    //Execute range query
-    this->rangeQueryHelper(start, end, nodeOutput);
+    //Execute range query (on the static range tree if it has been built)
+    if (this->isStatic())
+        this->rangeQueryStaticHelper(start, end, nodeOutput);
+    else
+        this->rangeQueryHelper(start, end, nodeOutput);
 
     for (Node* node : nodeOutput) {
         *out = iterator(this, node);
@@ -418,6 +452,139 @@ void RangeTree<K,T,C>::rangeQuery(
     }
 }
 
+/**
+ * @brief Find entries in the range tree that are enclosed in a given range
+ * (const version, it can be called concurrently by multiple threads).
+ * Start and end are included bounds of the range.
+ *
+ * @param[in] start Starting value of the range
+ * @param[in] end End value of the range
+ * @param[out] out Output iterator for the container containing the const
+ * iterators pointing to the nodes in the deepest range tree which have keys
+ * enclosed in the input range
+ */
+template <class K, class T, class C>template <class OutputIterator>
+void RangeTree<K,T,C>::rangeQuery(
+        const K& start, const K& end,
+        OutputIterator out) const
+{
+    //Output
+    std::vector<Node*> nodeOutput;
+
+    //Execute range query (on the static range tree if it has been built)
+    if (this->isStatic())
+        this->rangeQueryStaticHelper(start, end, nodeOutput);
+    else
+        this->rangeQueryHelper(start, end, nodeOutput);
+
+    //Const iterators need the (non-const) tree, which is never changed through them
+    RangeTree<K,T,C>* tree = const_cast<RangeTree<K,T,C>*>(this);
+    for (Node* node : nodeOutput) {
+        *out = const_iterator(tree, node);
+        out++;
+    }
+}
+
+/**
+ * @brief Execute a list of range queries, distributing them among multiple
+ * threads. The results are stored in compressed sparse row format: the
+ * entries enclosed in the range [starts[i], ends[i]] are pointed by
+ * results[offsets[i]], ..., results[offsets[i+1]-1], in the same order
+ * given by rangeQuery.
+ *
+ * The tree must not be changed while the queries are executed.
+ *
+ * @param[in] starts Starting values of the ranges
+ * @param[in] ends End values of the ranges
+ * @param[out] offsets Offsets of the results of each range (starts.size()+1 values)
+ * @param[out] results Const iterators pointing to the entries enclosed in the ranges
+ * @param[in] pool Thread pool which executes the queries, together with the
+ * calling thread
+ */
+template <class K, class T, class C>
+void RangeTree<K,T,C>::batchRangeQuery(
+        const std::vector<K>& starts,
+        const std::vector<K>& ends,
+        std::vector<size_t>& offsets,
+        std::vector<const_iterator>& results,
+        ThreadPool& pool) const
+{
+    assert(starts.size() == ends.size());
+    internal::batchQueryHelper(
+                starts.size(),
+                [this, &starts, &ends](size_t i, std::vector<const_iterator>& out) {
+                    this->rangeQuery(starts[i], ends[i], std::back_inserter(out));
+                },
+                offsets,
+                results,
+                pool);
+}
+
+
+/**
+ * @brief Build the static range tree used by the range queries, for trees
+ * that are queried many times without being changed.
+ *
+ * The static range tree is a layered range tree: in each dimension but the
+ * last one, a balanced tree on the entries sorted by the dimension, whose
+ * nodes point to a tree of the next dimension built on their entries. In
+ * the layer of the second to last dimension, each node stores its entries
+ * sorted by the last dimension, with pointers to the positions in the
+ * sorted entries of its children (fractional cascading): the last
+ * dimension is searched once per query, and a query costs
+ * O(log^(d-1) n + k) instead of O(log^d n + k). The layers are built
+ * bottom-up by merging the sorted entries of the children, and all of them
+ * are stored in contiguous arrays. The memory needed is O(n log^(d-1) n).
+ *
+ * The results of rangeQuery on the static range tree are the leaves of
+ * the range tree (the ones of the first dimension), in any order.
+ * Insert, erase, construction and clear discard the static range tree:
+ * queries then use the dynamic tree until buildStatic() is called again.
+ */
+template <class K, class T, class C>
+void RangeTree<K,T,C>::buildStatic()
+{
+    this->clearStatic();
+
+    if (this->root == nullptr)
+        return;
+
+    //Leaves are already sorted by the first dimension
+    std::vector<Node*> leaves;
+    leaves.reserve(this->entries);
+    for (Node* node = internal::getMinimumHelperLeaf(this->root);
+         node != nullptr;
+         node = internal::getSuccessorHelperLeaf(node))
+    {
+        leaves.push_back(node);
+    }
+
+    if (this->dim == 1) {
+        this->staticTree.entries.swap(leaves);
+        return;
+    }
+
+    //The layer of the dimension d is sorted by the comparator dim-1-d
+    const std::vector<C>& comparators = this->customComparators;
+    const unsigned int lastComparator = this->dim - 1;
+    auto less = [&comparators, lastComparator](unsigned int dimension, const Node* a, const Node* b) {
+        return internal::isLess(a->key, b->key, comparators[lastComparator - dimension]);
+    };
+    internal::buildLayerRangeTreeStaticHelper(this->staticTree, this->dim, 0, leaves, less);
+}
+
+/**
+ * @brief Check if the static range tree has been built and it is used by
+ * the range queries
+ *
+ * @return True if the static range tree is valid
+ */
+template <class K, class T, class C>
+bool RangeTree<K,T,C>::isStatic() const
+{
+    return !this->staticTree.entries.empty();
+}
+
 
 
 /* ----- ITERATOR MIN/MAX NEXT/PREV ----- */
@@ -663,6 +830,7 @@ void RangeTree<K,T,C>::swap(RangeTree<K,T,C>& bst)
     swap(this->comparator, bst.comparator);
     swap(this->customComparators, bst.customComparators);
     swap(this->dim, bst.dim);
+    swap(this->staticTree, bst.staticTree);
 }
 
 
@@ -690,6 +858,15 @@ void RangeTree<K,T,C>::initialize()
     this->entries = 0;
 }
 
+/**
+ * @brief Discard the static range tree
+ */
+template <class K, class T, class C>
+void RangeTree<K,T,C>::clearStatic()
+{
+    this->staticTree.clear();
+}
+
 
 template <class K, class T, class C>
 typename RangeTree<K,T,C>::Node* RangeTree<K,T,C>::copyRangeTreeSubtree(
@@ -727,7 +904,7 @@ typename RangeTree<K,T,C>::Node* RangeTree<K,T,C>::copyRangeTreeSubtree(
 template <class K, class T, class C>
 void RangeTree<K,T,C>::rangeQueryHelper(
         const K& start, const K& end,
-        std::vector<Node*>& out)
+        std::vector<Node*>& out) const
 {
     //Find split node
     Node* splitNode = internal::findSplitNodeHelperLeaf(start, end, this->root, comparator);
@@ -799,7 +976,7 @@ void RangeTree<K,T,C>::rangeSearchInNextDimensionHelper(
         Node* node,
         const K& start,
         const K& end,
-        std::vector<Node*>& out)
+        std::vector<Node*>& out) const
 {
 
     if (this->dim > 1) {
@@ -812,6 +989,54 @@ void RangeTree<K,T,C>::rangeSearchInNextDimensionHelper(
 
 
 
+/* ----- STATIC RANGE TREE HELPERS ----- */
+
+/**
+ * @brief Find entries of the static range tree that are enclosed in a
+ * given range
+ *
+ * @param[in] start Starting value of the range
+ * @param[in] end End value of the range
+ * @param[out] out Container containing the nodes which have keys enclosed
+ * in the input range
+ */
+template <class K, class T, class C>
+void RangeTree<K,T,C>::rangeQueryStaticHelper(
+        const K& start,
+        const K& end,
+        std::vector<Node*>& out) const
+{
+    const std::vector<C>& comparators = this->customComparators;
+
+    //One-dimensional tree: entries are a sorted array
+    if (this->dim == 1) {
+        const std::vector<Node*>& entries = this->staticTree.entries;
+        auto first = std::partition_point(entries.begin(), entries.end(), [&](const Node* node) {
+            return internal::isLess(node->key, start, comparators[0]);
+        });
+        auto last = std::partition_point(first, entries.end(), [&](const Node* node) {
+            return !internal::isLess(end, node->key, comparators[0]);
+        });
+        out.insert(out.end(), first, last);
+        return;
+    }
+
+    //The layer of the dimension d is sorted by the comparator dim-1-d
+    const unsigned int lastComparator = this->dim - 1;
+    auto before = [&comparators, &start, lastComparator](unsigned int dimension, const Node* node) {
+        return internal::isLess(node->key, start, comparators[lastComparator - dimension]);
+    };
+    auto after = [&comparators, &end, lastComparator](unsigned int dimension, const Node* node) {
+        return internal::isLess(end, node->key, comparators[lastComparator - dimension]);
+    };
+    auto callback = [&out](Node* node) {
+        out.push_back(node);
+    };
+    internal::rangeQueryLayerRangeTreeStaticHelper(this->staticTree, this->dim, 0, 0, before, after, callback);
+}
+
+
+
 /* ----- HELPERS FOR ASSOCIATED RANGE TREE ----- */
 
 /**
@@ -0,0 +1,216 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Stefano Nuvoli (stefano.nuvoli@gmail.com)
+ */
+#ifndef CG3_STATICRANGETREE_H
+#define CG3_STATICRANGETREE_H
+
+#include <array>
+#include <vector>
+#include <utility>
+#include <type_traits>
+
+#include "includes/tree_batch_helpers.h"
+#include "includes/rangetree_static_helpers.h"
+
+namespace cg3 {
+
+namespace internal {
+
+/**
+ * @brief Default coordinate extractor of StaticRangeTree: the i-th
+ * coordinate of a key is key[i]
+ */
+template <class K>
+struct RangeTreeCoordinateExtractor {
+    inline double operator()(const K& key, unsigned int i) const { return key[i]; }
+};
+
+}
+
+/**
+ * @brief A static range tree, with the dimension D known at compile time
+ *
+ * Entries are given at construction, and the tree cannot be changed
+ * afterwards (construction can be called again). Duplicates are allowed.
+ * The coordinates of the keys are read through the extractor E, a functor
+ * such that extractor(key, i) is the i-th coordinate (0 <= i < D) of the
+ * key; the range [start, end] of a query contains the keys whose i-th
+ * coordinate is between the ones of start and end, for each i.
+ *
+ * The tree is a layered range tree, stored in the same arrays of
+ * RangeTree::buildStatic(), with fractional cascading on the last
+ * dimension: a query costs O(log^(D-1) n + k). The recursion on the layers
+ * is instantiated for each dimension L at compile time, and each layer
+ * compares the coordinates L of the entries directly, instead of calling
+ * comparators through pointers. Coordinates are extracted once, at
+ * construction, and all the layers are stored in contiguous arrays of
+ * indices.
+ *
+ * The const query methods can be called concurrently by multiple threads.
+ */
+template <int D, class K, class T = K, class E = internal::RangeTreeCoordinateExtractor<K>>
+class StaticRangeTree
+{
+    static_assert(D > 0, "The dimension of a StaticRangeTree must be greater than zero");
+
+public:
+
+    /* Typedefs */
+
+    typedef typename std::vector<T>::const_iterator const_iterator;
+
+
+    /* Constructors */
+
+    explicit StaticRangeTree(const E& extractor = E());
+    explicit StaticRangeTree(
+            const std::vector<K>& vec,
+            const E& extractor = E());
+    explicit StaticRangeTree(
+            const std::vector<std::pair<K,T>>& vec,
+            const E& extractor = E());
+
+
+    /* Public methods */
+
+    void construction(const std::vector<K>& vec);
+    void construction(const std::vector<std::pair<K,T>>& vec);
+
+    size_t size() const;
+    bool empty() const;
+
+    void clear();
+
+    template <class OutputIterator>
+    void rangeQuery(
+            const K& start, const K& end,
+            OutputIterator out) const;
+
+    template <class Callback>
+    void rangeQueryCallback(
+            const K& start, const K& end,
+            Callback callback) const;
+
+    void batchRangeQuery(
+            const std::vector<K>& starts,
+            const std::vector<K>& ends,
+            std::vector<size_t>& offsets,
+            std::vector<const_iterator>& results,
+            ThreadPool& pool = defaultThreadPool()) const;
+
+
+    /* Iterators */
+
+    const_iterator begin() const;
+    const_iterator end() const;
+
+
+protected:
+
+    /* Typedefs */
+
+    typedef std::array<double, D> Coordinates;
+
+
+    /* Protected fields */
+
+    E extractor;
+
+    //Entries, sorted by the first coordinate
+    std::vector<K> keys;
+    std::vector<T> values;
+    std::vector<Coordinates> coordinates;
+
+    //Layers of the entries (indices in the arrays above)
+    internal::RangeTreeStaticLayers<unsigned int> layers;
+
+
+    /* Protected methods */
+
+    inline void setCoordinatesHelper(
+            const K& key,
+            Coordinates& c) const;
+
+
+    /* Build helpers */
+
+    inline void buildHelper(std::true_type oneDimension);
+    inline void buildHelper(std::false_type oneDimension);
+
+    template <int L>
+    inline unsigned int buildLayerHelper(
+            const std::vector<unsigned int>& sortedEntries);
+
+    template <int L>
+    inline unsigned int buildNodeHelper(
+            unsigned int begin,
+            unsigned int end,
+            std::vector<unsigned int>& nextSortedEntries);
+
+    template <int L>
+    inline void setNextLayerHelper(
+            unsigned int node,
+            const std::vector<unsigned int>& nextSortedEntries,
+            std::true_type lastLayer);
+
+    template <int L>
+    inline void setNextLayerHelper(
+            unsigned int node,
+            const std::vector<unsigned int>& nextSortedEntries,
+            std::false_type lastLayer);
+
+
+    /* Range query helpers */
+
+    template <class Callback>
+    inline void rangeQueryHelper(
+            const Coordinates& min,
+            const Coordinates& max,
+            Callback& callback,
+            std::true_type oneDimension) const;
+
+    template <class Callback>
+    inline void rangeQueryHelper(
+            const Coordinates& min,
+            const Coordinates& max,
+            Callback& callback,
+            std::false_type oneDimension) const;
+
+    template <int L, class Callback>
+    inline void rangeQueryLayerHelper(
+            unsigned int layerRoot,
+            const Coordinates& min,
+            const Coordinates& max,
+            Callback& callback) const;
+
+    template <int L, class Callback>
+    inline void rangeQueryNodeHelper(
+            unsigned int node,
+            unsigned int first,
+            unsigned int last,
+            const Coordinates& min,
+            const Coordinates& max,
+            Callback& callback,
+            std::true_type lastLayer) const;
+
+    template <int L, class Callback>
+    inline void rangeQueryNodeHelper(
+            unsigned int node,
+            unsigned int first,
+            unsigned int last,
+            const Coordinates& min,
+            const Coordinates& max,
+            Callback& callback,
+            std::false_type lastLayer) const;
+
+};
+
+}
+
+
+#include "static_rangetree.inl"
+
+#endif // CG3_STATICRANGETREE_H
@@ -0,0 +1,552 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Stefano Nuvoli (stefano.nuvoli@gmail.com)
+ */
+#include "static_rangetree.h"
+
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <cassert>
+
+namespace cg3 {
+
+
+/* --------- CONSTRUCTORS --------- */
+
+/**
+ * @brief Default constructor, creates an empty range tree
+ *
+ * @param[in] extractor Coordinate extractor of the keys
+ */
+template <int D, class K, class T, class E>
+StaticRangeTree<D,K,T,E>::StaticRangeTree(const E& extractor) :
+    extractor(extractor)
+{
+}
+
+/**
+ * @brief Constructor with a vector of values to be inserted
+ *
+ * @param[in] vec Vector of values
+ * @param[in] extractor Coordinate extractor of the keys
+ */
+template <int D, class K, class T, class E>
+StaticRangeTree<D,K,T,E>::StaticRangeTree(
+        const std::vector<K>& vec,
+        const E& extractor) :
+    extractor(extractor)
+{
+    this->construction(vec);
+}
+
+/**
+ * @brief Constructor with a vector of entries (key/value pairs) to be inserted
+ *
+ * @param[in] vec Vector of pairs of keys/values
+ * @param[in] extractor Coordinate extractor of the keys
+ */
+template <int D, class K, class T, class E>
+StaticRangeTree<D,K,T,E>::StaticRangeTree(
+        const std::vector<std::pair<K,T>>& vec,
+        const E& extractor) :
+    extractor(extractor)
+{
+    this->construction(vec);
+}
+
+
+
+/* --------- PUBLIC METHODS --------- */
+
+/**
+ * @brief Construction of the range tree given the values
+ *
+ * A clear operation is performed before the construction
+ *
+ * @param[in] vec Vector of values
+ */
+template <int D, class K, class T, class E>
+void StaticRangeTree<D,K,T,E>::construction(const std::vector<K>& vec)
+{
+    std::vector<std::pair<K,T>> pairVec;
+    pairVec.reserve(vec.size());
+
+    for (const K& entry : vec) {
+        pairVec.push_back(std::make_pair(entry, entry));
+    }
+
+    construction(pairVec);
+}
+
+/**
+ * @brief Construction of the range tree given the entries
+ * (pairs of keys/values)
+ *
+ * A clear operation is performed before the construction
+ *
+ * @param[in] vec Vector of pairs of keys/values
+ */
+template <int D, class K, class T, class E>
+void StaticRangeTree<D,K,T,E>::construction(const std::vector<std::pair<K,T>>& vec)
+{
+    this->clear();
+
+    if (vec.size() == 0)
+        return;
+
+    //Extract the coordinates once
+    std::vector<Coordinates> vecCoordinates(vec.size());
+    for (size_t i = 0; i < vec.size(); i++)
+        this->setCoordinatesHelper(vec[i].first, vecCoordinates[i]);
+
+    //Sort the entries by the first coordinate
+    std::vector<unsigned int> order(vec.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&vecCoordinates](unsigned int a, unsigned int b) {
+        return vecCoordinates[a][0] < vecCoordinates[b][0];
+    });
+
+    this->keys.reserve(vec.size());
+    this->values.reserve(vec.size());
+    this->coordinates.reserve(vec.size());
+    for (unsigned int i : order) {
+        this->keys.push_back(vec[i].first);
+        this->values.push_back(vec[i].second);
+        this->coordinates.push_back(vecCoordinates[i]);
+    }
+
+    this->buildHelper(std::integral_constant<bool, D == 1>());
+}
+
+/**
+ * @brief Get the number of entries in the range tree
+ *
+ * @return Number of entries
+ */
+template <int D, class K, class T, class E>
+size_t StaticRangeTree<D,K,T,E>::size() const
+{
+    return this->keys.size();
+}
+
+/**
+ * @brief Check if the tree is empty
+ *
+ * @return True if the range tree is empty
+ */
+template <int D, class K, class T, class E>
+bool StaticRangeTree<D,K,T,E>::empty() const
+{
+    return (this->size() == 0);
+}
+
+/**
+ * @brief Clear the tree, delete all its elements
+ */
+template <int D, class K, class T, class E>
+void StaticRangeTree<D,K,T,E>::clear()
+{
+    this->keys.clear();
+    this->values.clear();
+    this->coordinates.clear();
+    this->layers.clear();
+}
+
+/**
+ * @brief Find entries in the range tree that are enclosed in a given range.
+ * Start and end are included bounds of the range.
+ *
+ * @param[in] start Starting value of the range
+ * @param[in] end End value of the range
+ * @param[out] out Output iterator for the container containing the
+ * iterators pointing to the values which have keys enclosed in the
+ * input range (in any order)
+ */
+template <int D, class K, class T, class E> template <class OutputIterator>
+void StaticRangeTree<D,K,T,E>::rangeQuery(
+        const K& start, const K& end,
+        OutputIterator out) const
+{
+    //Pushing out the results while they are found
+    this->rangeQueryCallback(
+                start, end,
+                [&out](const_iterator it) {
+                    *out = it;
+                    out++;
+                });
+}
+
+/**
+ * @brief Find entries in the range tree that are enclosed in a given range,
+ * calling callback(it) for each of them, where it is the iterator pointing
+ * to the value. No memory is allocated by the query.
+ *
+ * @param[in] start Starting value of the range
+ * @param[in] end End value of the range
+ * @param[in] callback Function called for each entry in the range
+ */
+template <int D, class K, class T, class E> template <class Callback>
+void StaticRangeTree<D,K,T,E>::rangeQueryCallback(
+        const K& start, const K& end,
+        Callback callback) const
+{
+    if (this->empty())
+        return;
+
+    Coordinates min, max;
+    this->setCoordinatesHelper(start, min);
+    this->setCoordinatesHelper(end, max);
+
+    const_iterator valuesBegin = this->values.begin();
+    auto entryCallback = [&callback, &valuesBegin](unsigned int entry) {
+        callback(valuesBegin + entry);
+    };
+
+    this->rangeQueryHelper(min, max, entryCallback, std::integral_constant<bool, D == 1>());
+}
+
+/**
+ * @brief Execute a list of range queries, distributing them among multiple
+ * threads. The results are stored in compressed sparse row format: the
+ * entries enclosed in the range [starts[i], ends[i]] are pointed by
+ * results[offsets[i]], ..., results[offsets[i+1]-1], in the same order
+ * given by rangeQuery.
+ *
+ * @param[in] starts Starting values of the ranges
+ * @param[in] ends End values of the ranges
+ * @param[out] offsets Offsets of the results of each range (starts.size()+1 values)
+ * @param[out] results Iterators pointing to the values enclosed in the ranges
+ * @param[in] pool Thread pool which executes the queries, together with the
+ * calling thread
+ */
+template <int D, class K, class T, class E>
+void StaticRangeTree<D,K,T,E>::batchRangeQuery(
+        const std::vector<K>& starts,
+        const std::vector<K>& ends,
+        std::vector<size_t>& offsets,
+        std::vector<const_iterator>& results,
+        ThreadPool& pool) const
+{
+    assert(starts.size() == ends.size());
+    internal::batchQueryHelper(
+                starts.size(),
+                [this, &starts, &ends](size_t i, std::vector<const_iterator>& out) {
+                    this->rangeQuery(starts[i], ends[i], std::back_inserter(out));
+                },
+                offsets,
+                results,
+                pool);
+}
+
+
+
+/* --------- ITERATORS --------- */
+
+/**
+ * @brief Begin iterator of the values, sorted by the first coordinate
+ * of their keys
+ */
+template <int D, class K, class T, class E>
+typename StaticRangeTree<D,K,T,E>::const_iterator StaticRangeTree<D,K,T,E>::begin() const
+{
+    return this->values.begin();
+}
+
+/**
+ * @brief End iterator of the values
+ */
+template <int D, class K, class T, class E>
+typename StaticRangeTree<D,K,T,E>::const_iterator StaticRangeTree<D,K,T,E>::end() const
+{
+    return this->values.end();
+}
+
+
+
+/* --------- PROTECTED METHODS --------- */
+
+/**
+ * @brief Extract the coordinates of a key
+ *
+ * @param[in] key Key
+ * @param[out] c Coordinates of the key
+ */
+template <int D, class K, class T, class E>
+void StaticRangeTree<D,K,T,E>::setCoordinatesHelper(
+        const K& key,
+        Coordinates& c) const
+{
+    for (unsigned int i = 0; i < D; i++)
+        c[i] = extractor(key, i);
+}
+
+
+
+/* --------- BUILD HELPERS --------- */
+
+/**
+ * @brief Build the range tree of one dimension: the entries, sorted by
+ * their coordinate, are already the tree
+ */
+template <int D, class K, class T, class E>
+void StaticRangeTree<D,K,T,E>::buildHelper(std::true_type)
+{
+}
+
+/**
+ * @brief Build the layers of the range tree, starting from the first one
+ * on the entries sorted by the first coordinate
+ */
+template <int D, class K, class T, class E>
+void StaticRangeTree<D,K,T,E>::buildHelper(std::false_type)
+{
+    std::vector<unsigned int> sortedEntries(this->size());
+    std::iota(sortedEntries.begin(), sortedEntries.end(), 0);
+    this->buildLayerHelper<0>(sortedEntries);
+}
+
+/**
+ * @brief Build a layer of the range tree
+ *
+ * @param[in] sortedEntries Entries of the layer, sorted by the coordinate L
+ * @return Index of the root node of the layer
+ */
+template <int D, class K, class T, class E> template <int L>
+unsigned int StaticRangeTree<D,K,T,E>::buildLayerHelper(
+        const std::vector<unsigned int>& sortedEntries)
+{
+    unsigned int begin = (unsigned int) this->layers.entries.size();
+    this->layers.entries.insert(this->layers.entries.end(), sortedEntries.begin(), sortedEntries.end());
+
+    std::vector<unsigned int> nextSortedEntries;
+    return this->buildNodeHelper<L>(
+                begin,
+                begin + (unsigned int) sortedEntries.size(),
+                nextSortedEntries);
+}
+
+/**
+ * @brief Build a node of a layer, and its subtree, bottom-up
+ *
+ * @param[in] begin First entry of the node
+ * @param[in] end End of the entries of the node
+ * @param[out] nextSortedEntries Entries of the node, sorted by the
+ * coordinate L+1
+ * @return Index of the node
+ */
+template <int D, class K, class T, class E> template <int L>
+unsigned int StaticRangeTree<D,K,T,E>::buildNodeHelper(
+        unsigned int begin,
+        unsigned int end,
+        std::vector<unsigned int>& nextSortedEntries)
+{
+    const bool lastLayer = (L + 2 == D);
+
+    unsigned int index = (unsigned int) this->layers.nodes.size();
+    internal::RangeTreeStaticNode node;
+    node.begin = begin;
+    node.end = end;
+    node.right = 0;
+    node.next = 0;
+    this->layers.nodes.push_back(node);
+
+    //The sorted lists of the last layer and their cascading pointers are
+    //stored in parallel
+    std::vector<unsigned int>* leftCounts = (lastLayer ? &this->layers.leftCounts : nullptr);
+
+    if (end - begin == 1) {
+        nextSortedEntries.assign(1, this->layers.entries[begin]);
+        if (leftCounts != nullptr)
+            leftCounts->push_back(0);
+    }
+    else {
+        unsigned int mid = (begin + end) / 2;
+
+        std::vector<unsigned int> leftSortedEntries, rightSortedEntries;
+        this->buildNodeHelper<L>(begin, mid, leftSortedEntries);
+        unsigned int right = this->buildNodeHelper<L>(mid, end, rightSortedEntries);
+        this->layers.nodes[index].right = right;
+
+        const std::vector<Coordinates>& c = this->coordinates;
+        internal::mergeRangeTreeStaticHelper(
+                    leftSortedEntries,
+                    rightSortedEntries,
+                    nextSortedEntries,
+                    leftCounts,
+                    [&c](unsigned int a, unsigned int b) {
+                        return c[a][L+1] < c[b][L+1];
+                    });
+    }
+
+    this->setNextLayerHelper<L>(index, nextSortedEntries, std::integral_constant<bool, lastLayer>());
+
+    return index;
+}
+
+/**
+ * @brief Store the entries of a node of the last layer, sorted by the last
+ * coordinate
+ */
+template <int D, class K, class T, class E> template <int L>
+void StaticRangeTree<D,K,T,E>::setNextLayerHelper(
+        unsigned int node,
+        const std::vector<unsigned int>& nextSortedEntries,
+        std::true_type)
+{
+    this->layers.nodes[node].next = (unsigned int) this->layers.lists.size();
+    this->layers.lists.insert(this->layers.lists.end(), nextSortedEntries.begin(), nextSortedEntries.end());
+}
+
+/**
+ * @brief Build the layer of the next coordinate on the entries of a node
+ */
+template <int D, class K, class T, class E> template <int L>
+void StaticRangeTree<D,K,T,E>::setNextLayerHelper(
+        unsigned int node,
+        const std::vector<unsigned int>& nextSortedEntries,
+        std::false_type)
+{
+    unsigned int next = this->buildLayerHelper<L+1>(nextSortedEntries);
+    this->layers.nodes[node].next = next;
+}
+
+
+
+/* --------- RANGE QUERY HELPERS --------- */
+
+/**
+ * @brief Find the entries in the range, for the range tree of one
+ * dimension: the entries are sorted by their coordinate
+ */
+template <int D, class K, class T, class E> template <class Callback>
+void StaticRangeTree<D,K,T,E>::rangeQueryHelper(
+        const Coordinates& min,
+        const Coordinates& max,
+        Callback& callback,
+        std::true_type) const
+{
+    auto begin = this->coordinates.begin();
+    auto end = this->coordinates.end();
+    unsigned int first = (unsigned int) (std::partition_point(begin, end, [&min](const Coordinates& c) {
+        return c[0] < min[0];
+    }) - begin);
+    unsigned int last = (unsigned int) (std::partition_point(begin, end, [&max](const Coordinates& c) {
+        return c[0] <= max[0];
+    }) - begin);
+
+    for (unsigned int i = first; i < last; i++)
+        callback(i);
+}
+
+/**
+ * @brief Find the entries in the range, starting from the first layer
+ */
+template <int D, class K, class T, class E> template <class Callback>
+void StaticRangeTree<D,K,T,E>::rangeQueryHelper(
+        const Coordinates& min,
+        const Coordinates& max,
+        Callback& callback,
+        std::false_type) const
+{
+    this->rangeQueryLayerHelper<0>(0, min, max, callback);
+}
+
+/**
+ * @brief Find the entries of a layer in the range
+ *
+ * @param[in] layerRoot Root node of the layer
+ * @param[in] min Minimum coordinates of the range
+ * @param[in] max Maximum coordinates of the range
+ * @param[in] callback Function called with the entries in the range
+ */
+template <int D, class K, class T, class E> template <int L, class Callback>
+void StaticRangeTree<D,K,T,E>::rangeQueryLayerHelper(
+        unsigned int layerRoot,
+        const Coordinates& min,
+        const Coordinates& max,
+        Callback& callback) const
+{
+    const internal::RangeTreeStaticNode& root = this->layers.nodes[layerRoot];
+    const std::vector<Coordinates>& c = this->coordinates;
+
+    //Entries of the layer in the range of the coordinate L
+    const unsigned int* entries = this->layers.entries.data();
+    unsigned int first = (unsigned int) (std::partition_point(
+            entries + root.begin, entries + root.end, [&c, &min](unsigned int i) {
+        return c[i][L] < min[L];
+    }) - entries);
+    unsigned int last = (unsigned int) (std::partition_point(
+            entries + first, entries + root.end, [&c, &max](unsigned int i) {
+        return c[i][L] <= max[L];
+    }) - entries);
+    if (first >= last)
+        return;
+
+    this->rangeQueryNodeHelper<L>(
+                layerRoot, first, last, min, max, callback,
+                std::integral_constant<bool, L + 2 == D>());
+}
+
+/**
+ * @brief Find the entries in the range of the root of the last layer: the
+ * last coordinate is searched in the list of the root, and the positions
+ * in the lists of the other nodes are given by the cascading pointers
+ */
+template <int D, class K, class T, class E> template <int L, class Callback>
+void StaticRangeTree<D,K,T,E>::rangeQueryNodeHelper(
+        unsigned int node,
+        unsigned int first,
+        unsigned int last,
+        const Coordinates& min,
+        const Coordinates& max,
+        Callback& callback,
+        std::true_type) const
+{
+    const internal::RangeTreeStaticNode& n = this->layers.nodes[node];
+    const std::vector<Coordinates>& c = this->coordinates;
+
+    const unsigned int* list = this->layers.lists.data() + n.next;
+    const unsigned int* listEnd = list + (n.end - n.begin);
+    unsigned int lower = (unsigned int) (std::partition_point(list, listEnd, [&c, &min](unsigned int i) {
+        return c[i][D-1] < min[D-1];
+    }) - list);
+    unsigned int upper = (unsigned int) (std::partition_point(list + lower, listEnd, [&c, &max](unsigned int i) {
+        return c[i][D-1] <= max[D-1];
+    }) - list);
+
+    internal::rangeQueryCascadingRangeTreeStaticHelper(this->layers, node, first, last, lower, upper, callback);
+}
+
+/**
+ * @brief Search the nodes of a layer which are enclosed in the range
+ * [first, last) of the entries of the layer, and search the next
+ * coordinate in their layers
+ */
+template <int D, class K, class T, class E> template <int L, class Callback>
+void StaticRangeTree<D,K,T,E>::rangeQueryNodeHelper(
+        unsigned int node,
+        unsigned int first,
+        unsigned int last,
+        const Coordinates& min,
+        const Coordinates& max,
+        Callback& callback,
+        std::false_type lastLayer) const
+{
+    const internal::RangeTreeStaticNode& n = this->layers.nodes[node];
+
+    if (n.end <= first || n.begin >= last)
+        return;
+
+    if (first <= n.begin && n.end <= last) {
+        this->rangeQueryLayerHelper<L+1>(n.next, min, max, callback);
+        return;
+    }
+
+    this->rangeQueryNodeHelper<L>(node+1, first, last, min, max, callback, lastLayer);
+    this->rangeQueryNodeHelper<L>(n.right, first, last, min, max, callback, lastLayer);
+}
+
+}
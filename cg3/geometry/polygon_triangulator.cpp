@@ -0,0 +1,370 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+#include "polygon_triangulator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace cg3 {
+
+CG3_INLINE PolygonTriangulator::PolygonTriangulator()
+{
+}
+
+/**
+ * @brief Triangulates a planar polygon with holes.
+ *
+ * @param[in] points: points of the outer border, followed by the points of the
+ * borders of the holes
+ * @param[in] borderSizes: number of points of the outer border (first element)
+ * and of each hole
+ * @param[out] triangles: the indices of the points of the triangles are appended
+ * to this vector, three for each triangle
+ * @param[in] normal: normal of the polygon; if it is null, it is computed from
+ * the outer border
+ * @return the number of triangles appended; 0 if the polygon cannot be
+ * triangulated (e.g. its borders intersect each other, or a hole has less than
+ * three points or cannot be connected to the outer border), in which case
+ * triangles is left unchanged
+ *
+ * @par Complexity:
+ *      \e O(n) for convex polygons without holes, \e O(n^3) in the worst case
+ *      otherwise (\e O(n^2) when ears are found quickly, as usual)
+ */
+CG3_INLINE unsigned int PolygonTriangulator::triangulate(
+        const std::vector<Point3d>& points,
+        const std::vector<unsigned int>& borderSizes,
+        std::vector<unsigned int>& triangles,
+        const Vec3d& normal)
+{
+    const std::size_t before = triangles.size();
+    const unsigned int n = borderSizes.empty() ? 0 : borderSizes[0];
+    if (n < 3)
+        return 0;
+    const bool hasHoles = borderSizes.size() > 1;
+    if (n == 3 && !hasHoles){
+        triangles.insert(triangles.end(), {0, 1, 2});
+        return 1;
+    }
+
+    project(points, n, normal);
+
+    if (!hasHoles){
+        //convexity test: no reflex vertices and, along both the axes, at most
+        //two changes of direction (excludes self intersecting star polygons)
+        int reflex = -1;
+        unsigned int xChanges = 0, yChanges = 0;
+        double lastDx = 0, lastDy = 0;
+        for (unsigned int i = 0; i < n && reflex < 0; ++i){
+            unsigned int p = (i + n - 1) % n, q = (i + 1) % n;
+            double c = (px[i] - px[p]) * (py[q] - py[p]) - (py[i] - py[p]) * (px[q] - px[p]);
+            if (c < 0)
+                reflex = i;
+            double dx = px[q] - px[i], dy = py[q] - py[i];
+            if (dx != 0){
+                if (dx * lastDx < 0) xChanges++;
+                lastDx = dx;
+            }
+            if (dy != 0){
+                if (dy * lastDy < 0) yChanges++;
+                lastDy = dy;
+            }
+        }
+        if (n == 4){
+            unsigned int d;
+            if (reflex >= 0) //the diagonal must start from the reflex vertex
+                d = reflex;
+            else //the shorter diagonal
+                d = points[0].dist(points[2]) <= points[1].dist(points[3]) ? 0 : 1;
+            triangles.insert(triangles.end(), {d, (d+1)%4, (d+2)%4, (d+2)%4, (d+3)%4, d});
+            return 2;
+        }
+        if (reflex < 0 && xChanges <= 2 && yChanges <= 2){
+            for (unsigned int i = 1; i + 1 < n; ++i)
+                triangles.insert(triangles.end(), {0, i, i+1});
+            return n - 2;
+        }
+    }
+
+    nodes.clear();
+    int outer = linkBorder(0, n, true);
+    unsigned int size = n;
+    if (hasHoles){
+        holes.clear();
+        unsigned int begin = n;
+        for (unsigned int k = 1; k < borderSizes.size(); ++k){
+            if (borderSizes[k] < 3)
+                return 0;
+            //the node with maximum x of the hole is the one that will be bridged
+            int h = linkBorder(begin, borderSizes[k], false), m = h;
+            for (int i = nodes[h].next; i != h; i = nodes[i].next)
+                if (nodes[i].x > nodes[m].x)
+                    m = i;
+            holes.push_back(m);
+            begin += borderSizes[k];
+        }
+        std::sort(holes.begin(), holes.end(), [&](int a, int b){
+            return nodes[a].x > nodes[b].x;
+        });
+        for (int h : holes){
+            unsigned int hs = 1;
+            for (int i = nodes[h].next; i != h; i = nodes[i].next)
+                hs++;
+            if (!bridgeHole(h, outer))
+                return 0;
+            size += hs + 2;
+        }
+    }
+    if (!earClipping(outer, size, triangles)){
+        triangles.resize(before);
+        return 0;
+    }
+    return (triangles.size() - before) / 3;
+}
+
+/**
+ * @brief Triangulates a planar polygon without holes.
+ * @see triangulate(const std::vector<Point3d>&, const std::vector<unsigned int>&, std::vector<unsigned int>&, const Vec3d&)
+ */
+CG3_INLINE unsigned int PolygonTriangulator::triangulate(
+        const std::vector<Point3d>& points,
+        std::vector<unsigned int>& triangles,
+        const Vec3d& normal)
+{
+    return triangulate(points, {(unsigned int)points.size()}, triangles, normal);
+}
+
+/**
+ * @brief Projects the points on the coordinate plane most orthogonal to the
+ * normal. The x axis is mirrored if needed to make the outer border (the first
+ * outerSize points) counterclockwise.
+ */
+CG3_INLINE void PolygonTriangulator::project(
+        const std::vector<Point3d>& points,
+        unsigned int outerSize,
+        const Vec3d& normal)
+{
+    Vec3d nn = normal;
+    const unsigned int n = outerSize;
+    if (nn.x() == 0 && nn.y() == 0 && nn.z() == 0){ //Newell's normal
+        for (unsigned int i = 0; i < n; ++i){
+            const Point3d& a = points[i];
+            const Point3d& b = points[(i+1)%n];
+            nn += Vec3d((a.y() - b.y()) * (a.z() + b.z()),
+                        (a.z() - b.z()) * (a.x() + b.x()),
+                        (a.x() - b.x()) * (a.y() + b.y()));
+        }
+    }
+    unsigned int u = 0, v = 1; //drop z
+    double ax = std::abs(nn.x()), ay = std::abs(nn.y()), az = std::abs(nn.z());
+    if (ax >= ay && ax >= az){ //drop x
+        u = 1; v = 2;
+    }
+    else if (ay >= ax && ay >= az){ //drop y
+        u = 2; v = 0;
+    }
+    px.resize(points.size());
+    py.resize(points.size());
+    const Point3d& o = points[0]; //translated to reduce cancellation
+    for (unsigned int i = 0; i < points.size(); ++i){
+        px[i] = points[i][u] - o[u];
+        py[i] = points[i][v] - o[v];
+    }
+    double area = 0;
+    for (unsigned int i = 0, j = n - 1; i < n; j = i++)
+        area += px[j] * py[i] - px[i] * py[j];
+    if (area < 0)
+        for (double& x : px)
+            x = -x;
+}
+
+/**
+ * @brief Creates a circular list of nodes for the border composed by size points
+ * starting from begin, with the given orientation.
+ * @return the index of a node of the border
+ */
+CG3_INLINE int PolygonTriangulator::linkBorder(
+        unsigned int begin,
+        unsigned int size,
+        bool ccw)
+{
+    double area = 0;
+    for (unsigned int i = 0, j = size - 1; i < size; j = i++)
+        area += px[begin+j] * py[begin+i] - px[begin+i] * py[begin+j];
+    const bool reverse = (area >= 0) != ccw;
+    const int first = nodes.size();
+    for (unsigned int k = 0; k < size; ++k){
+        unsigned int i = begin + (reverse ? size - 1 - k : k);
+        int id = first + k;
+        nodes.push_back({i, px[i], py[i],
+                         k == 0 ? first + (int)size - 1 : id - 1,
+                         k == size - 1 ? first : id + 1});
+    }
+    return first;
+}
+
+/**
+ * @brief Connects the hole to the outer border, with two coincident bridge edges
+ * from the node hole to the nearest visible node of the outer border.
+ *
+ * A point of the outer border can have several coincident nodes, copies made by
+ * the bridges of other holes: each one has a different sector, and the bridge
+ * starts from the one whose sector contains the hole (see locallyInside()).
+ * @return false if no visible node has been found (e.g. the hole lies outside
+ * the outer border): the polygon cannot be triangulated
+ */
+CG3_INLINE bool PolygonTriangulator::bridgeHole(int hole, int outer)
+{
+    candidates.clear();
+    int i = outer;
+    do {
+        double dx = nodes[i].x - nodes[hole].x, dy = nodes[i].y - nodes[hole].y;
+        candidates.push_back(std::make_pair(dx * dx + dy * dy, i));
+        i = nodes[i].next;
+    } while (i != outer);
+    std::sort(candidates.begin(), candidates.end());
+    for (const std::pair<double, int>& c : candidates){
+        int a = c.second;
+        if (locallyInside(a, hole) && locallyInside(hole, a) && !intersectsBorders(a, hole)){
+            int a2 = nodes.size();
+            nodes.push_back(nodes[a]);
+            int b2 = nodes.size();
+            nodes.push_back(nodes[hole]);
+            int an = nodes[a].next, bp = nodes[hole].prev;
+            nodes[a].next = hole;
+            nodes[hole].prev = a;
+            nodes[a2].next = an;
+            nodes[an].prev = a2;
+            nodes[b2].next = a2;
+            nodes[a2].prev = b2;
+            nodes[bp].next = b2;
+            nodes[b2].prev = bp;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Triangulates the border of size nodes containing start.
+ * When no valid ear exists, a vertex aligned between two distinct neighbours is
+ * clipped (the triangle has zero area and cannot overlap the others). Triangles
+ * with two coincident copies of a point are never emitted: they would become
+ * self loops in a mesh.
+ * @return false if no triangle can be clipped (e.g. self intersecting borders):
+ * the triangles appended so far are not a valid triangulation
+ */
+CG3_INLINE bool PolygonTriangulator::earClipping(
+        int start,
+        unsigned int size,
+        std::vector<unsigned int>& triangles)
+{
+    int ear = start;
+    while (size > 3){
+        int found = -1;
+        int e = ear;
+        for (unsigned int k = 0; k < size && found < 0; ++k, e = nodes[e].next)
+            if (isEar(e))
+                found = e;
+        for (unsigned int k = 0; k < size && found < 0; ++k, e = nodes[e].next)
+            if (cross(nodes[e].prev, e, nodes[e].next) == 0 &&
+                    nodes[nodes[e].prev].i != nodes[nodes[e].next].i)
+                found = e;
+        if (found < 0)
+            return false;
+        triangles.insert(triangles.end(), {nodes[nodes[found].prev].i, nodes[found].i, nodes[nodes[found].next].i});
+        ear = nodes[found].next;
+        remove(found);
+        size--;
+    }
+    if (nodes[nodes[ear].prev].i == nodes[nodes[ear].next].i)
+        return false;
+    triangles.insert(triangles.end(), {nodes[nodes[ear].prev].i, nodes[ear].i, nodes[nodes[ear].next].i});
+    return true;
+}
+
+CG3_INLINE bool PolygonTriangulator::isEar(int ear) const
+{
+    const int a = nodes[ear].prev, c = nodes[ear].next;
+    if (cross(a, ear, c) <= 0)
+        return false;
+    auto same = [&](int p, int q) {
+        return nodes[p].x == nodes[q].x && nodes[p].y == nodes[q].y;
+    };
+    for (int p = nodes[c].next; p != a; p = nodes[p].next){
+        if (same(p, a) || same(p, ear) || same(p, c))
+            continue;
+        //only reflex vertices can be inside an ear of a simple polygon
+        if (cross(a, ear, p) >= 0 && cross(ear, c, p) >= 0 && cross(c, a, p) >= 0 &&
+                cross(nodes[p].prev, p, nodes[p].next) <= 0)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Checks if the segment from the node a to the point b starts inside the
+ * polygon, in the neighbourhood of a: b must lie strictly inside the sector of a,
+ * between the edges to its previous and next nodes.
+ *
+ * The test is strict, so that among coincident nodes (which have adjacent sectors)
+ * at most one accepts b when b is not aligned with their edges.
+ */
+CG3_INLINE bool PolygonTriangulator::locallyInside(int a, int b) const
+{
+    const int prev = nodes[a].prev, next = nodes[a].next;
+    if (cross(prev, a, next) >= 0)
+        return cross(a, next, b) > 0 && cross(a, prev, b) < 0;
+    else
+        return cross(a, next, b) > 0 || cross(a, prev, b) < 0;
+}
+
+/**
+ * @brief Checks if the segment ab properly intersects an edge of the borders, or
+ * passes through one of their nodes.
+ */
+CG3_INLINE bool PolygonTriangulator::intersectsBorders(int a, int b) const
+{
+    auto same = [&](int p, int q) {
+        return nodes[p].x == nodes[q].x && nodes[p].y == nodes[q].y;
+    };
+    const double dx = nodes[b].x - nodes[a].x, dy = nodes[b].y - nodes[a].y;
+    for (unsigned int p = 0; p < nodes.size(); ++p){
+        int q = nodes[p].next;
+        if (same(p, a) || same(p, b))
+            continue;
+        //nodes aligned with ab, between a and b
+        const double t = (nodes[p].x - nodes[a].x) * dx + (nodes[p].y - nodes[a].y) * dy;
+        if (cross(a, b, p) == 0 && t > 0 && t < dx * dx + dy * dy)
+            return true;
+        if (same(q, a) || same(q, b))
+            continue;
+        double o1 = cross(a, b, p), o2 = cross(a, b, q);
+        double o3 = cross(p, q, a), o4 = cross(p, q, b);
+        if (((o1 > 0 && o2 < 0) || (o1 < 0 && o2 > 0)) &&
+                ((o3 > 0 && o4 < 0) || (o3 < 0 && o4 > 0)))
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Twice the signed area of the triangle abc: positive if abc is counterclockwise.
+ */
+CG3_INLINE double PolygonTriangulator::cross(int a, int b, int c) const
+{
+    return (nodes[b].x - nodes[a].x) * (nodes[c].y - nodes[a].y) -
+           (nodes[b].y - nodes[a].y) * (nodes[c].x - nodes[a].x);
+}
+
+CG3_INLINE void PolygonTriangulator::remove(int n)
+{
+    nodes[nodes[n].prev].next = nodes[n].next;
+    nodes[nodes[n].next].prev = nodes[n].prev;
+}
+
+} //namespace cg3
@@ -0,0 +1,83 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+#ifndef CG3_POLYGON_TRIANGULATOR_H
+#define CG3_POLYGON_TRIANGULATOR_H
+
+#include "point3.h"
+#include <utility>
+#include <vector>
+
+namespace cg3 {
+
+/**
+ * @ingroup cg3core
+ * @brief Triangulates planar 3D polygons, possibly with holes, by ear clipping.
+ *
+ * A polygon is given as a sequence of points, composed by the outer border
+ * followed by the borders of the holes, and by the sizes of the borders.
+ * Triangles are returned as triplets of indices in the sequence of points, and
+ * have the same orientation of the outer border.
+ *
+ * Triangles, quads and convex polygons are triangulated without ear clipping.
+ * Holes are connected to the outer border with bridge edges before ear clipping.
+ * Polygons that cannot be triangulated (e.g. with intersecting borders, or with
+ * a hole that cannot be connected to the outer border) produce no triangles:
+ * holes are never silently discarded. The geometric tests are computed in floating point: borders
+ * that touch or are aligned only up to rounding errors may still produce
+ * overlapping triangles.
+ *
+ * The triangulator keeps its working buffers between calls: a single instance
+ * should be reused to triangulate many polygons (one instance for each thread).
+ */
+class PolygonTriangulator
+{
+public:
+    PolygonTriangulator();
+
+    unsigned int triangulate(
+            const std::vector<Point3d>& points,
+            const std::vector<unsigned int>& borderSizes,
+            std::vector<unsigned int>& triangles,
+            const Vec3d& normal = Vec3d());
+
+    unsigned int triangulate(
+            const std::vector<Point3d>& points,
+            std::vector<unsigned int>& triangles,
+            const Vec3d& normal = Vec3d());
+
+private:
+    struct Node {
+        unsigned int i; //index of the point
+        double x, y;
+        int prev, next;
+    };
+
+    void project(const std::vector<Point3d>& points, unsigned int outerSize, const Vec3d& normal);
+    int linkBorder(unsigned int begin, unsigned int size, bool ccw);
+    bool bridgeHole(int hole, int outer);
+    bool earClipping(int start, unsigned int size, std::vector<unsigned int>& triangles);
+    bool isEar(int ear) const;
+    bool locallyInside(int a, int b) const;
+    bool intersectsBorders(int a, int b) const;
+    double cross(int a, int b, int c) const;
+    void remove(int n);
+
+    std::vector<double> px, py;
+    std::vector<Node> nodes;
+    std::vector<int> holes;
+    std::vector<std::pair<double, int>> candidates;
+};
+
+} //namespace cg3
+
+#ifndef CG3_STATIC
+#define CG3_POLYGON_TRIANGULATOR_CPP "polygon_triangulator.cpp"
+#include CG3_POLYGON_TRIANGULATOR_CPP
+#undef CG3_POLYGON_TRIANGULATOR_CPP
+#endif //CG3_STATIC
+
+#endif // CG3_POLYGON_TRIANGULATOR_H
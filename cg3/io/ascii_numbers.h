@@ -0,0 +1,46 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+#ifndef CG3_ASCII_NUMBERS_H
+#define CG3_ASCII_NUMBERS_H
+
+namespace cg3 {
+namespace internal {
+
+/*
+ * Locale independent parsing of numbers in ASCII mesh files.
+ *
+ * The functions work on a range of characters [p, end) which is not required
+ * to be null terminated (e.g. a memory mapped file), and move p after the
+ * parsed characters. The decimal separator is always '.', regardless of the
+ * locale of the application.
+ */
+
+bool isAsciiBlank(char c);
+const char* skipAsciiBlanks(const char* p, const char* end);
+const char* skipAsciiToken(const char* p, const char* end);
+const char* skipAsciiLine(const char* p, const char* end);
+bool parseAsciiDouble(const char*& p, const char* end, double& value);
+bool parseAsciiInteger(const char*& p, const char* end, long long& value);
+
+/*
+ * Locale independent formatting of numbers: the functions write the number
+ * starting at out, and return the position after the last written character.
+ */
+
+const unsigned int ASCII_NUMBER_BUFFER_SIZE = 32; //max characters written
+
+char* formatAsciiInteger(unsigned long long value, char* out);
+char* formatAsciiInteger(long long value, char* out);
+char* formatAsciiDouble(double value, char* out, unsigned int precision = 0);
+char* formatAsciiFloat(float value, char* out, unsigned int precision = 0);
+
+} //namespace cg3::internal
+} //namespace cg3
+
+#include "ascii_numbers.inl"
+
+#endif // CG3_ASCII_NUMBERS_H
@@ -0,0 +1,592 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+#include "ascii_numbers.h"
+
+#include <algorithm>
+#include <clocale>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+
+namespace cg3 {
+namespace internal {
+
+/**
+ * @brief Returns true if c is a space, a tab or a carriage return
+ * (new lines are not blanks: they terminate the lines of the file).
+ */
+inline bool isAsciiBlank(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+inline const char* skipAsciiBlanks(const char* p, const char* end)
+{
+	while (p != end && isAsciiBlank(*p))
+		++p;
+	return p;
+}
+
+/**
+ * @brief Skips the characters up to the next blank or new line.
+ */
+inline const char* skipAsciiToken(const char* p, const char* end)
+{
+	while (p != end && *p != '\n' && !isAsciiBlank(*p))
+		++p;
+	return p;
+}
+
+/**
+ * @brief Returns the first character of the next line.
+ */
+inline const char* skipAsciiLine(const char* p, const char* end)
+{
+	while (p != end && *p != '\n')
+		++p;
+	return p != end ? p + 1 : p;
+}
+
+/**
+ * @brief If the characters starting at p are the given (lower case) word,
+ * ignoring the case, returns the position after the word; otherwise nullptr.
+ */
+inline const char* matchAsciiWord(const char* p, const char* end, const char* word)
+{
+	for (; *word != '\0'; ++p, ++word){
+		if (p == end || (*p | 0x20) != *word)
+			return nullptr;
+	}
+	return p;
+}
+
+/**
+ * @brief Parses a floating point number, in decimal or scientific notation.
+ *
+ * Numbers having at most 15 significant digits and a decimal exponent in
+ * [-22, 22] (which are all the numbers written with the usual fixed precision
+ * by mesh exporters) are computed with a single multiplication or division,
+ * which is exact. The other numbers fall back on a (slower) std::strtod, with
+ * the decimal separator of the current locale.
+ *
+ * As std::strtod, "inf", "infinity" and "nan" (case insensitive, possibly
+ * signed) are accepted, numbers too large for a double are parsed as
+ * infinity and numbers too small as zero (or a denormal number).
+ *
+ * @return false if p does not point to a number
+ */
+inline bool parseAsciiDouble(const char*& p, const char* end, double& value)
+{
+	static const double POW10[] = {
+		1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+	const char* start = p;
+	const char* s = p;
+	bool negative = false;
+	if (s != end && (*s == '-' || *s == '+')){
+		negative = *s == '-';
+		++s;
+	}
+	const char* unsignedBegin = s;
+	uint64_t mantissa = 0;
+	int digits = 0;      //significant digits stored in mantissa
+	int exponent = 0;
+	bool anyDigit = false;
+	bool truncated = false;
+	for (; s != end && *s >= '0' && *s <= '9'; ++s){
+		anyDigit = true;
+		if (digits < 19){
+			mantissa = mantissa * 10 + (*s - '0');
+			if (mantissa != 0)
+				digits++;
+		}
+		else {
+			exponent++;
+			truncated |= *s != '0';
+		}
+	}
+	if (s != end && *s == '.'){
+		++s;
+		for (; s != end && *s >= '0' && *s <= '9'; ++s){
+			anyDigit = true;
+			if (digits < 19){
+				mantissa = mantissa * 10 + (*s - '0');
+				if (mantissa != 0)
+					digits++;
+				exponent--;
+			}
+			else {
+				truncated |= *s != '0';
+			}
+		}
+	}
+	if (!anyDigit){
+		if (s != unsignedBegin)
+			return false; //a '.' without digits
+		const char* w = matchAsciiWord(s, end, "inf");
+		if (w != nullptr){
+			const char* w2 = matchAsciiWord(w, end, "inity");
+			p = w2 != nullptr ? w2 : w;
+			value = negative ? -std::numeric_limits<double>::infinity() :
+							   std::numeric_limits<double>::infinity();
+			return true;
+		}
+		w = matchAsciiWord(s, end, "nan");
+		if (w != nullptr){
+			p = w;
+			value = negative ? -std::numeric_limits<double>::quiet_NaN() :
+							   std::numeric_limits<double>::quiet_NaN();
+			return true;
+		}
+		return false;
+	}
+	if (s != end && (*s == 'e' || *s == 'E')){
+		const char* e = s + 1;
+		bool negativeExp = false;
+		if (e != end && (*e == '-' || *e == '+')){
+			negativeExp = *e == '-';
+			++e;
+		}
+		if (e != end && *e >= '0' && *e <= '9'){
+			int exp = 0;
+			for (; e != end && *e >= '0' && *e <= '9'; ++e){
+				if (exp < 100000)
+					exp = exp * 10 + (*e - '0');
+			}
+			exponent += negativeExp ? -exp : exp;
+			s = e;
+		}
+	}
+	p = s;
+
+	if (mantissa == 0){
+		value = negative ? -0.0 : 0.0;
+		return true;
+	}
+	if (!truncated && digits <= 15 && exponent >= -22 && exponent <= 22){
+		double d = (double)mantissa;
+		d = exponent < 0 ? d / POW10[-exponent] : d * POW10[exponent];
+		value = negative ? -d : d;
+		return true;
+	}
+
+	//strtod requires the decimal separator of the current locale
+	std::string number(start, s);
+	const char decimalPoint = *std::localeconv()->decimal_point;
+	std::replace(number.begin(), number.end(), '.', decimalPoint);
+	char* parsed = nullptr;
+	value = std::strtod(number.c_str(), &parsed);
+	return parsed == number.c_str() + number.size();
+}
+
+/**
+ * @brief Parses a (possibly signed) integer number.
+ * @return false if p does not point to a number, or if the number is out of
+ * the range of long long
+ */
+inline bool parseAsciiInteger(const char*& p, const char* end, long long& value)
+{
+	const char* s = p;
+	bool negative = false;
+	if (s != end && (*s == '-' || *s == '+')){
+		negative = *s == '-';
+		++s;
+	}
+	if (s == end || *s < '0' || *s > '9')
+		return false;
+	//the absolute value is accumulated in an unsigned number, which can store
+	//the absolute value of the minimum long long
+	const unsigned long long limit = negative ?
+				(unsigned long long)std::numeric_limits<long long>::max() + 1 :
+				(unsigned long long)std::numeric_limits<long long>::max();
+	unsigned long long v = 0;
+	for (; s != end && *s >= '0' && *s <= '9'; ++s){
+		const unsigned int d = *s - '0';
+		if (v > (limit - d) / 10)
+			return false;
+		v = v * 10 + d;
+	}
+	value = negative ? (long long)(0ULL - v) : (long long)v;
+	p = s;
+	return true;
+}
+
+/*
+ * Formatting of numbers: doubles and floats are written with a round-trip
+ * representation, which is parsed back to the same value (Grisu2 algorithm by
+ * F. Loitsch, "Printing floating-point numbers quickly and accurately with
+ * integers", PLDI 2010), without using streams or the C locale. Grisu2 always
+ * gives a round-trip representation, and usually the shortest one: according
+ * to the paper, a shorter one exists for about 0.1% of the doubles.
+ */
+
+struct DiyFp {
+	uint64_t f;
+	int e;
+};
+
+inline DiyFp diyFpMultiply(const DiyFp& x, const DiyFp& y)
+{
+	const uint64_t M32 = 0xFFFFFFFFu;
+	const uint64_t a = x.f >> 32, b = x.f & M32, c = y.f >> 32, d = y.f & M32;
+	const uint64_t ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+	uint64_t tmp = (bd >> 32) + (ad & M32) + (bc & M32);
+	tmp += 1U << 31; //round
+	DiyFp r;
+	r.f = ac + (ad >> 32) + (bc >> 32) + (tmp >> 32);
+	r.e = x.e + y.e + 64;
+	return r;
+}
+
+inline DiyFp diyFpNormalize(DiyFp x)
+{
+	while (!(x.f & 0xFFC0000000000000ULL)){
+		x.f <<= 10;
+		x.e -= 10;
+	}
+	while (!(x.f & 0x8000000000000000ULL)){
+		x.f <<= 1;
+		x.e--;
+	}
+	return x;
+}
+
+/**
+ * @brief Returns a cached power of ten c = 10^-K such that the exponent of the
+ * product between c and a number having binary exponent e is in [-60, -32].
+ */
+inline DiyFp cachedPowerOfTen(int e, int& K)
+{
+	static const uint64_t F[] = {
+		0xfa8fd5a0081c0288ULL, 0xbaaee17fa23ebf76ULL, 0x8b16fb203055ac76ULL,
+		0xcf42894a5dce35eaULL, 0x9a6bb0aa55653b2dULL, 0xe61acf033d1a45dfULL,
+		0xab70fe17c79ac6caULL, 0xff77b1fcbebcdc4fULL, 0xbe5691ef416bd60cULL,
+		0x8dd01fad907ffc3cULL, 0xd3515c2831559a83ULL, 0x9d71ac8fada6c9b5ULL,
+		0xea9c227723ee8bcbULL, 0xaecc49914078536dULL, 0x823c12795db6ce57ULL,
+		0xc21094364dfb5637ULL, 0x9096ea6f3848984fULL, 0xd77485cb25823ac7ULL,
+		0xa086cfcd97bf97f4ULL, 0xef340a98172aace5ULL, 0xb23867fb2a35b28eULL,
+		0x84c8d4dfd2c63f3bULL, 0xc5dd44271ad3cdbaULL, 0x936b9fcebb25c996ULL,
+		0xdbac6c247d62a584ULL, 0xa3ab66580d5fdaf6ULL, 0xf3e2f893dec3f126ULL,
+		0xb5b5ada8aaff80b8ULL, 0x87625f056c7c4a8bULL, 0xc9bcff6034c13053ULL,
+		0x964e858c91ba2655ULL, 0xdff9772470297ebdULL, 0xa6dfbd9fb8e5b88fULL,
+		0xf8a95fcf88747d94ULL, 0xb94470938fa89bcfULL, 0x8a08f0f8bf0f156bULL,
+		0xcdb02555653131b6ULL, 0x993fe2c6d07b7facULL, 0xe45c10c42a2b3b06ULL,
+		0xaa242499697392d3ULL, 0xfd87b5f28300ca0eULL, 0xbce5086492111aebULL,
+		0x8cbccc096f5088ccULL, 0xd1b71758e219652cULL, 0x9c40000000000000ULL,
+		0xe8d4a51000000000ULL, 0xad78ebc5ac620000ULL, 0x813f3978f8940984ULL,
+		0xc097ce7bc90715b3ULL, 0x8f7e32ce7bea5c70ULL, 0xd5d238a4abe98068ULL,
+		0x9f4f2726179a2245ULL, 0xed63a231d4c4fb27ULL, 0xb0de65388cc8ada8ULL,
+		0x83c7088e1aab65dbULL, 0xc45d1df942711d9aULL, 0x924d692ca61be758ULL,
+		0xda01ee641a708deaULL, 0xa26da3999aef774aULL, 0xf209787bb47d6b85ULL,
+		0xb454e4a179dd1877ULL, 0x865b86925b9bc5c2ULL, 0xc83553c5c8965d3dULL,
+		0x952ab45cfa97a0b3ULL, 0xde469fbd99a05fe3ULL, 0xa59bc234db398c25ULL,
+		0xf6c69a72a3989f5cULL, 0xb7dcbf5354e9beceULL, 0x88fcf317f22241e2ULL,
+		0xcc20ce9bd35c78a5ULL, 0x98165af37b2153dfULL, 0xe2a0b5dc971f303aULL,
+		0xa8d9d1535ce3b396ULL, 0xfb9b7cd9a4a7443cULL, 0xbb764c4ca7a44410ULL,
+		0x8bab8eefb6409c1aULL, 0xd01fef10a657842cULL, 0x9b10a4e5e9913129ULL,
+		0xe7109bfba19c0c9dULL, 0xac2820d9623bf429ULL, 0x80444b5e7aa7cf85ULL,
+		0xbf21e44003acdd2dULL, 0x8e679c2f5e44ff8fULL, 0xd433179d9c8cb841ULL,
+		0x9e19db92b4e31ba9ULL, 0xeb96bf6ebadf77d9ULL, 0xaf87023b9bf0ee6bULL,
+	};
+	static const int16_t E[] = {
+		-1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980,
+		-954, -927, -901, -874, -847, -821, -794, -768, -741, -715,
+		-688, -661, -635, -608, -582, -555, -529, -502, -475, -449,
+		-422, -396, -369, -343, -316, -289, -263, -236, -210, -183,
+		-157, -130, -103, -77, -50, -24, 3, 30, 56, 83,
+		109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+		375, 402, 428, 455, 481, 508, 534, 561, 588, 614,
+		641, 667, 694, 720, 747, 774, 800, 827, 853, 880,
+		907, 933, 960, 986, 1013, 1039, 1066,
+	};
+
+	double dk = (-61 - e) * 0.30102999566398114 + 347;
+	int k = (int)dk;
+	if (dk - k > 0.0)
+		k++;
+	unsigned int index = (unsigned int)((k >> 3) + 1);
+	K = -(-348 + (int)(index << 3));
+	DiyFp c;
+	c.f = F[index];
+	c.e = E[index];
+	return c;
+}
+
+inline void grisuRound(
+		char* buffer,
+		int length,
+		uint64_t delta,
+		uint64_t rest,
+		uint64_t tenKappa,
+		uint64_t wpW)
+{
+	while (rest < wpW && delta - rest >= tenKappa &&
+		   (rest + tenKappa < wpW || wpW - rest > rest + tenKappa - wpW)) {
+		buffer[length - 1]--;
+		rest += tenKappa;
+	}
+}
+
+/**
+ * @brief Generates the digits of a number w in the interval (mp - delta, mp],
+ * stopping as soon as they identify a number of the interval. The number is
+ * buffer * 10^K.
+ */
+inline int grisuDigits(const DiyFp& w, const DiyFp& mp, uint64_t delta, char* buffer, int& K)
+{
+	static const uint64_t POW10[] = {
+		1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+		100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL,
+		1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+		1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL,
+		1000000000000000000ULL, 10000000000000000000ULL};
+	const int shift = -mp.e;
+	const uint64_t one = (uint64_t)1 << shift;
+	const uint64_t wpW = mp.f - w.f;
+	uint32_t p1 = (uint32_t)(mp.f >> shift);
+	uint64_t p2 = mp.f & (one - 1);
+	int kappa = 1;
+	while (kappa < 10 && p1 >= POW10[kappa])
+		kappa++;
+	int length = 0;
+	while (kappa > 0) {
+		uint32_t d = (uint32_t)(p1 / POW10[kappa-1]);
+		p1 %= POW10[kappa-1];
+		if (d || length)
+			buffer[length++] = (char)('0' + d);
+		kappa--;
+		uint64_t tmp = ((uint64_t)p1 << shift) + p2;
+		if (tmp <= delta) {
+			K += kappa;
+			grisuRound(buffer, length, delta, tmp, POW10[kappa] << shift, wpW);
+			return length;
+		}
+	}
+	for (;;) {
+		p2 *= 10;
+		delta *= 10;
+		char d = (char)(p2 >> shift);
+		if (d || length)
+			buffer[length++] = (char)('0' + d);
+		p2 &= one - 1;
+		kappa--;
+		if (p2 < delta) {
+			K += kappa;
+			int index = -kappa;
+			grisuRound(buffer, length, delta, p2, one, wpW * (index < 20 ? POW10[index] : 0));
+			return length;
+		}
+	}
+}
+
+/**
+ * @brief Computes round-trip (usually shortest) digits of the positive number
+ * f * 2^e, which is halfway between its neighbours on the (lower and upper)
+ * boundaries.
+ * @param lowerCloser: true if the lower neighbour is closer than the upper one
+ * (f is a power of two)
+ * @return the number of digits, the number is buffer * 10^K
+ */
+inline int grisu2(uint64_t f, int e, bool lowerCloser, char* buffer, int& K)
+{
+	DiyFp v = {f, e};
+	DiyFp wp = {(f << 1) + 1, e - 1};
+	wp = diyFpNormalize(wp);
+	DiyFp wm = lowerCloser ? DiyFp{(f << 2) - 1, e - 2} : DiyFp{(f << 1) - 1, e - 1};
+	wm.f <<= wm.e - wp.e;
+	wm.e = wp.e;
+
+	const DiyFp c = cachedPowerOfTen(wp.e, K);
+	const DiyFp w = diyFpMultiply(diyFpNormalize(v), c);
+	DiyFp mp = diyFpMultiply(wp, c);
+	DiyFp mm = diyFpMultiply(wm, c);
+	mm.f++;
+	mp.f--;
+	return grisuDigits(w, mp, mp.f - mm.f, buffer, K);
+}
+
+/**
+ * @brief Writes the number digits * 10^K in fixed notation if its exponent
+ * is small enough, in scientific notation otherwise.
+ */
+inline char* writeAsciiDigits(const char* digits, int length, int K, char* out)
+{
+	const int kk = length + K; //10^(kk-1) <= v < 10^kk
+	if (kk > 0 && kk <= 17){
+		if (length <= kk){ //1234e2 -> 123400
+			for (int i = 0; i < length; i++)
+				*out++ = digits[i];
+			for (int i = length; i < kk; i++)
+				*out++ = '0';
+		}
+		else { //1234e-2 -> 12.34
+			for (int i = 0; i < kk; i++)
+				*out++ = digits[i];
+			*out++ = '.';
+			for (int i = kk; i < length; i++)
+				*out++ = digits[i];
+		}
+	}
+	else if (kk > -5 && kk <= 0){ //1234e-6 -> 0.001234
+		*out++ = '0';
+		*out++ = '.';
+		for (int i = kk; i < 0; i++)
+			*out++ = '0';
+		for (int i = 0; i < length; i++)
+			*out++ = digits[i];
+	}
+	else { //1234e30 -> 1.234e33
+		*out++ = digits[0];
+		if (length > 1){
+			*out++ = '.';
+			for (int i = 1; i < length; i++)
+				*out++ = digits[i];
+		}
+		*out++ = 'e';
+		int exp = kk - 1;
+		if (exp < 0){
+			*out++ = '-';
+			exp = -exp;
+		}
+		out = formatAsciiInteger((unsigned long long)exp, out);
+	}
+	return out;
+}
+
+/**
+ * @brief Formats a number with a fixed number of significant digits, as
+ * printf("%.*g") in the classic locale.
+ */
+inline char* formatAsciiPrecision(double value, unsigned int precision, char* out)
+{
+	char tmp[ASCII_NUMBER_BUFFER_SIZE + 16];
+	int n = std::snprintf(tmp, sizeof(tmp), "%.*g", (int)std::min(precision, 17u), value);
+	const char decimalPoint = *std::localeconv()->decimal_point;
+	for (int i = 0; i < n; i++)
+		*out++ = tmp[i] == decimalPoint ? '.' : tmp[i];
+	return out;
+}
+
+/**
+ * @brief Common part of formatAsciiDouble and formatAsciiFloat: bits are
+ * the (biased) exponent and the significand of the number.
+ */
+inline char* formatAsciiBits(
+		bool negative,
+		uint64_t significand,
+		int biasedExponent,
+		int maxExponent,
+		int significandBits,
+		int bias,
+		double value,
+		unsigned int precision,
+		char* out)
+{
+	if (biasedExponent == maxExponent){
+		if (significand != 0){
+			std::memcpy(out, "nan", 3);
+			return out + 3;
+		}
+		if (negative)
+			*out++ = '-';
+		std::memcpy(out, "inf", 3);
+		return out + 3;
+	}
+	if (negative)
+		*out++ = '-';
+	if (biasedExponent == 0 && significand == 0){
+		*out++ = '0';
+		return out;
+	}
+	const uint64_t hiddenBit = (uint64_t)1 << significandBits;
+	uint64_t f;
+	int e;
+	if (biasedExponent != 0){
+		f = significand | hiddenBit;
+		e = biasedExponent - bias;
+	}
+	else {
+		f = significand;
+		e = 1 - bias;
+	}
+	char digits[24];
+	int K;
+	int length = grisu2(f, e, significand == 0 && biasedExponent > 1, digits, K);
+	if (precision > 0 && (unsigned int)length > precision)
+		return formatAsciiPrecision(value, precision, out - (negative ? 1 : 0));
+	return writeAsciiDigits(digits, length, K, out);
+}
+
+/**
+ * @brief Writes the decimal representation of value starting at out, and
+ * returns the position after the last written character. At most
+ * ASCII_NUMBER_BUFFER_SIZE characters are written.
+ */
+inline char* formatAsciiInteger(unsigned long long value, char* out)
+{
+	char tmp[24];
+	int n = 0;
+	do {
+		tmp[n++] = (char)('0' + value % 10);
+		value /= 10;
+	} while (value != 0);
+	while (n > 0)
+		*out++ = tmp[--n];
+	return out;
+}
+
+inline char* formatAsciiInteger(long long value, char* out)
+{
+	if (value < 0){
+		*out++ = '-';
+		return formatAsciiInteger(0ULL - (unsigned long long)value, out);
+	}
+	return formatAsciiInteger((unsigned long long)value, out);
+}
+
+/**
+ * @brief Writes value starting at out, and returns the position after the
+ * last written character. At most ASCII_NUMBER_BUFFER_SIZE characters are
+ * written.
+ *
+ * With precision 0, the number is written with a round-trip (usually the
+ * shortest) sequence of digits, which parseAsciiDouble() (or strtod) converts
+ * back to value.
+ * Otherwise, at most precision significant digits are written.
+ * The decimal separator is always '.'.
+ */
+inline char* formatAsciiDouble(double value, char* out, unsigned int precision)
+{
+	uint64_t bits;
+	std::memcpy(&bits, &value, sizeof(double));
+	return formatAsciiBits(
+				(bits >> 63) != 0,
+				bits & 0x000FFFFFFFFFFFFFULL,
+				(int)((bits >> 52) & 0x7FF),
+				0x7FF, 52, 1075, value, precision, out);
+}
+
+/**
+ * @brief As formatAsciiDouble(), but with a round-trip (usually the shortest)
+ * sequence of digits that is converted back to the float value.
+ */
+inline char* formatAsciiFloat(float value, char* out, unsigned int precision)
+{
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(float));
+	return formatAsciiBits(
+				(bits >> 31) != 0,
+				bits & 0x007FFFFFu,
+				(int)((bits >> 23) & 0xFF),
+				0xFF, 23, 150, value, precision, out);
+}
+
+} //namespace cg3::internal
+} //namespace cg3
@@ -0,0 +1,96 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+#ifndef CG3_ASCII_WRITER_H
+#define CG3_ASCII_WRITER_H
+
+#include <cg3/utilities/parallel.h>
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace cg3 {
+
+/**
+ * @ingroup cg3core
+ * @brief Buffered writer of ASCII files, which formats numbers without using
+ * the (locale aware) formatting of the streams.
+ *
+ * Floating point numbers are written with a round-trip (usually the shortest)
+ * representation, which is parsed back to the same value, or with a fixed number of significant digits
+ * if a precision is given. The decimal separator is always '.'.
+ *
+ * The content is written on the stream in blocks, when the buffer is full and
+ * when the writer is destroyed (or flush() is called). A writer constructed
+ * without a stream just accumulates its content in memory.
+ * A writer cannot be copied (the buffered content would be written twice):
+ * a moved writer leaves the source without stream and content.
+ *
+ * Example:
+ * @code
+ * std::ofstream file("points.xyz");
+ * cg3::AsciiWriter out(file);
+ * out.writeParallel(points.size(), [&](cg3::AsciiWriter& w, std::size_t i) {
+ *     w << points[i].x() << ' ' << points[i].y() << ' ' << points[i].z() << '\n';
+ * });
+ * @endcode
+ */
+class AsciiWriter
+{
+public:
+	AsciiWriter(unsigned int precision = 0);
+	AsciiWriter(std::ostream& stream, unsigned int precision = 0);
+	AsciiWriter(const AsciiWriter& other) = delete;
+	AsciiWriter(AsciiWriter&& other) noexcept;
+	~AsciiWriter();
+
+	AsciiWriter& operator=(const AsciiWriter& other) = delete;
+	AsciiWriter& operator=(AsciiWriter&& other);
+
+	unsigned int precision() const;
+	void setPrecision(unsigned int precision);
+
+	AsciiWriter& operator<<(char c);
+	AsciiWriter& operator<<(const char* s);
+	AsciiWriter& operator<<(const std::string& s);
+	AsciiWriter& operator<<(int value);
+	AsciiWriter& operator<<(unsigned int value);
+	AsciiWriter& operator<<(long value);
+	AsciiWriter& operator<<(unsigned long value);
+	AsciiWriter& operator<<(long long value);
+	AsciiWriter& operator<<(unsigned long long value);
+	AsciiWriter& operator<<(float value);
+	AsciiWriter& operator<<(double value);
+	AsciiWriter& operator<<(const AsciiWriter& other);
+
+	template <typename F>
+	void writeParallel(
+			std::size_t n,
+			F f,
+			std::size_t grainSize = 4096,
+			unsigned int nThreads = numberOfThreads());
+
+	void flush();
+	std::string str() const;
+
+private:
+	static const std::size_t BUFFER_SIZE = 1 << 16;
+
+	char* reserve(std::size_t n);
+	void clear();
+
+	std::ostream* stream;
+	unsigned int prec;
+	std::vector<char> buffer;
+	std::size_t size;
+};
+
+} //namespace cg3
+
+#include "ascii_writer.inl"
+
+#endif // CG3_ASCII_WRITER_H
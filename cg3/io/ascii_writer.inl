@@ -0,0 +1,260 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+#include "ascii_writer.h"
+
+#include "ascii_numbers.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace cg3 {
+
+/**
+ * @brief Creates a writer that accumulates its content in memory.
+ * @param precision: significant digits of floating point numbers, 0 for a
+ * round-trip (usually the shortest) representation
+ */
+inline AsciiWriter::AsciiWriter(unsigned int precision) :
+	stream(nullptr),
+	prec(precision),
+	size(0)
+{
+}
+
+/**
+ * @brief Creates a writer on the given stream.
+ * @param precision: significant digits of floating point numbers, 0 for a
+ * round-trip (usually the shortest) representation
+ */
+inline AsciiWriter::AsciiWriter(std::ostream& stream, unsigned int precision) :
+	stream(&stream),
+	prec(precision),
+	buffer(BUFFER_SIZE),
+	size(0)
+{
+}
+
+/**
+ * @brief Takes the stream and the content of other, which is left without
+ * stream and content.
+ */
+inline AsciiWriter::AsciiWriter(AsciiWriter&& other) noexcept :
+	stream(other.stream),
+	prec(other.prec),
+	buffer(std::move(other.buffer)),
+	size(other.size)
+{
+	other.stream = nullptr;
+	other.buffer.clear();
+	other.size = 0;
+}
+
+inline AsciiWriter::~AsciiWriter()
+{
+	flush();
+}
+
+/**
+ * @brief Flushes the content of this writer, and then takes the stream and
+ * the content of other, which is left without stream and content.
+ */
+inline AsciiWriter& AsciiWriter::operator=(AsciiWriter&& other)
+{
+	if (this != &other){
+		flush();
+		stream = other.stream;
+		prec = other.prec;
+		buffer = std::move(other.buffer);
+		size = other.size;
+		other.stream = nullptr;
+		other.buffer.clear();
+		other.size = 0;
+	}
+	return *this;
+}
+
+inline unsigned int AsciiWriter::precision() const
+{
+	return prec;
+}
+
+inline void AsciiWriter::setPrecision(unsigned int precision)
+{
+	prec = precision;
+}
+
+inline AsciiWriter& AsciiWriter::operator<<(char c)
+{
+	*reserve(1) = c;
+	size++;
+	return *this;
+}
+
+inline AsciiWriter& AsciiWriter::operator<<(const char* s)
+{
+	std::size_t n = std::strlen(s);
+	std::memcpy(reserve(n), s, n);
+	size += n;
+	return *this;
+}
+
+inline AsciiWriter& AsciiWriter::operator<<(const std::string& s)
+{
+	std::memcpy(reserve(s.size()), s.data(), s.size());
+	size += s.size();
+	return *this;
+}
+
+inline AsciiWriter& AsciiWriter::operator<<(int value)
+{
+	return *this << (long long)value;
+}
+
+inline AsciiWriter& AsciiWriter::operator<<(unsigned int value)
+{
+	return *this << (unsigned long long)value;
+}
+
+inline AsciiWriter& AsciiWriter::operator<<(long value)
+{
+	return *this << (long long)value;
+}
+
+inline AsciiWriter& AsciiWriter::operator<<(unsigned long value)
+{
+	return *this << (unsigned long long)value;
+}
+
+inline AsciiWriter& AsciiWriter::operator<<(long long value)
+{
+	char* p = reserve(internal::ASCII_NUMBER_BUFFER_SIZE);
+	size += internal::formatAsciiInteger(value, p) - p;
+	return *this;
+}
+
+inline AsciiWriter& AsciiWriter::operator<<(unsigned long long value)
+{
+	char* p = reserve(internal::ASCII_NUMBER_BUFFER_SIZE);
+	size += internal::formatAsciiInteger(value, p) - p;
+	return *this;
+}
+
+inline AsciiWriter& AsciiWriter::operator<<(float value)
+{
+	char* p = reserve(internal::ASCII_NUMBER_BUFFER_SIZE);
+	size += internal::formatAsciiFloat(value, p, prec) - p;
+	return *this;
+}
+
+inline AsciiWriter& AsciiWriter::operator<<(double value)
+{
+	char* p = reserve(internal::ASCII_NUMBER_BUFFER_SIZE);
+	size += internal::formatAsciiDouble(value, p, prec) - p;
+	return *this;
+}
+
+/**
+ * @brief Appends the content accumulated by another writer.
+ */
+inline AsciiWriter& AsciiWriter::operator<<(const AsciiWriter& other)
+{
+	if (stream != nullptr && other.size > BUFFER_SIZE){
+		flush();
+		stream->write(other.buffer.data(), other.size);
+	}
+	else {
+		std::memcpy(reserve(other.size), other.buffer.data(), other.size);
+		size += other.size;
+	}
+	return *this;
+}
+
+/**
+ * @brief Calls f(writer, i) for every i in [0, n), where f writes the i-th
+ * element (e.g. a line of the file) on writer.
+ *
+ * The elements are formatted in parallel, in chunks of grainSize elements:
+ * every chunk is written in its own buffer, and the buffers are then appended
+ * in order. The result is the same for any number of threads.
+ * To bound the used memory, the elements are processed in blocks of a few
+ * chunks for each thread.
+ */
+template <typename F>
+void AsciiWriter::writeParallel(std::size_t n, F f, std::size_t grainSize, unsigned int nThreads)
+{
+	if (grainSize == 0)
+		grainSize = 1;
+	if (nThreads <= 1 || n <= grainSize){
+		for (std::size_t i = 0; i < n; ++i)
+			f(*this, i);
+		return;
+	}
+	const std::size_t chunksPerBlock = (std::size_t)nThreads * 4;
+	const std::size_t blockSize = grainSize * chunksPerBlock;
+	std::vector<AsciiWriter> chunks;
+	chunks.reserve(chunksPerBlock);
+	for (std::size_t c = 0; c < chunksPerBlock; ++c)
+		chunks.emplace_back(prec);
+	for (std::size_t start = 0; start < n; start += blockSize){
+		const std::size_t m = std::min(blockSize, n - start);
+		parallelForChunks(
+			m,
+			grainSize,
+			[&](std::size_t c, std::size_t b, std::size_t e) {
+				AsciiWriter& w = chunks[c];
+				w.clear();
+				for (std::size_t i = start + b; i < start + e; ++i)
+					f(w, i);
+			},
+			nThreads);
+		const std::size_t nChunks = numberOfChunks(m, grainSize);
+		for (std::size_t c = 0; c < nChunks; ++c)
+			*this << chunks[c];
+	}
+}
+
+/**
+ * @brief Writes on the stream the buffered content.
+ */
+inline void AsciiWriter::flush()
+{
+	if (stream != nullptr && size > 0){
+		stream->write(buffer.data(), size);
+		size = 0;
+	}
+}
+
+/**
+ * @brief Returns the content which has not been written on the stream yet
+ * (all the content if the writer has no stream).
+ */
+inline std::string AsciiWriter::str() const
+{
+	return std::string(buffer.data(), size);
+}
+
+/**
+ * @brief Returns a pointer to at least n free characters at the end of the
+ * buffer, flushing or enlarging the buffer if necessary.
+ */
+inline char* AsciiWriter::reserve(std::size_t n)
+{
+	if (size + n > buffer.size()){
+		flush();
+		if (size + n > buffer.size())
+			buffer.resize(std::max(buffer.size() * 2, size + n));
+	}
+	return buffer.data() + size;
+}
+
+inline void AsciiWriter::clear()
+{
+	size = 0;
+}
+
+} //namespace cg3
@@ -0,0 +1,120 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#ifndef CG3_LOAD_SAVE_ASYNC_H
+#define CG3_LOAD_SAVE_ASYNC_H
+
+#include "../utilities/thread_pool.h"
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace cg3 {
+namespace io {
+
+/**
+ * @ingroup cg3core
+ * @brief Exception stored in the future of an asynchronous load or save
+ * operation that has been canceled before its completion.
+ */
+class AsyncCanceled : public std::runtime_error
+{
+public:
+    AsyncCanceled(const std::string& filename);
+};
+
+/**
+ * @ingroup cg3core
+ * @brief Handle shared between the caller and a group of asynchronous load
+ * and save operations, used to cancel them and to follow their progress.
+ *
+ * Copies of an AsyncToken refer to the same state. Every operation started
+ * with a token is counted as a task of the token; when a task ends (with
+ * success, failure or cancellation) the progress callback, if any, is called
+ * with the number of ended tasks, the number of tasks and the name of the
+ * file. The callback is called by the worker threads, but never concurrently.
+ *
+ * cancel() makes the pending tasks end without touching their file, and
+ * discards the result of the running ones: in both cases their future throws
+ * AsyncCanceled.
+ */
+class AsyncToken
+{
+public:
+    typedef std::function<void(unsigned int, unsigned int, const std::string&)> ProgressCallback;
+
+    AsyncToken();
+    AsyncToken(ProgressCallback callback);
+
+    void cancel();
+    bool isCanceled() const;
+
+    unsigned int numberTasks() const;
+    unsigned int numberEndedTasks() const;
+    double progress() const;
+
+    void addTask();
+    void endTask(const std::string& filename);
+
+private:
+    struct State {
+        std::atomic<bool> canceled;
+        std::atomic<unsigned int> nTasks;
+        std::atomic<unsigned int> nEnded;
+        std::mutex mutex;
+        ProgressCallback callback;
+    };
+
+    std::shared_ptr<State> state;
+};
+
+void prefetchFile(const std::string& filename);
+
+template <typename Mesh>
+std::future<Mesh> loadAsync(
+        const std::string& filename,
+        AsyncToken token = AsyncToken(),
+        ThreadPool& pool = defaultThreadPool());
+
+template <typename Mesh>
+std::vector<std::future<Mesh>> loadAsync(
+        const std::vector<std::string>& filenames,
+        AsyncToken token = AsyncToken(),
+        ThreadPool& pool = defaultThreadPool());
+
+template <typename Mesh>
+std::future<void> saveAsync(
+        Mesh mesh,
+        const std::string& filename,
+        AsyncToken token = AsyncToken(),
+        ThreadPool& pool = defaultThreadPool());
+
+namespace internal {
+
+template <typename Mesh>
+Mesh loadTask(
+        const std::string& filename,
+        const std::string& nextFilename,
+        AsyncToken token);
+
+template <typename Mesh>
+void saveMesh(const Mesh& mesh, const std::string& filename);
+
+} //namespace cg3::io::internal
+
+} //namespace cg3::io
+} //namespace cg3
+
+#include "load_save_async.inl"
+
+#endif // CG3_LOAD_SAVE_ASYNC_H
@@ -0,0 +1,299 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#include "load_save_async.h"
+
+#include <algorithm>
+#include <cctype>
+#include <ios>
+#include <utility>
+
+#if defined(__linux__)
+#define CG3_ASYNC_FADVISE
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace cg3 {
+namespace io {
+
+inline AsyncCanceled::AsyncCanceled(const std::string& filename) :
+    std::runtime_error("Operation on " + filename + " canceled")
+{
+}
+
+/**
+ * @brief Creates a new token, without progress callback.
+ */
+inline AsyncToken::AsyncToken() :
+    AsyncToken(ProgressCallback())
+{
+}
+
+/**
+ * @brief Creates a new token that calls callback(ended, total, filename)
+ * every time one of its tasks ends.
+ */
+inline AsyncToken::AsyncToken(ProgressCallback callback) :
+    state(std::make_shared<State>())
+{
+    state->canceled = false;
+    state->nTasks = 0;
+    state->nEnded = 0;
+    state->callback = std::move(callback);
+}
+
+/**
+ * @brief Cancels all the tasks started with this token that are not ended.
+ */
+inline void AsyncToken::cancel()
+{
+    state->canceled = true;
+}
+
+inline bool AsyncToken::isCanceled() const
+{
+    return state->canceled;
+}
+
+inline unsigned int AsyncToken::numberTasks() const
+{
+    return state->nTasks;
+}
+
+inline unsigned int AsyncToken::numberEndedTasks() const
+{
+    return state->nEnded;
+}
+
+/**
+ * @brief Returns the fraction, in [0, 1], of the ended tasks. Returns 1 when
+ * no tasks have been started with the token.
+ */
+inline double AsyncToken::progress() const
+{
+    unsigned int n = state->nTasks;
+    return n == 0 ? 1.0 : (double)state->nEnded / n;
+}
+
+/**
+ * @brief Counts a new task of the token. Called by the functions that start
+ * an asynchronous operation.
+ */
+inline void AsyncToken::addTask()
+{
+    ++state->nTasks;
+}
+
+/**
+ * @brief Marks the end of a task of the token, and calls the progress
+ * callback.
+ */
+inline void AsyncToken::endTask(const std::string& filename)
+{
+    std::lock_guard<std::mutex> lock(state->mutex);
+    unsigned int ended = ++state->nEnded;
+    if (state->callback)
+        state->callback(ended, state->nTasks, filename);
+}
+
+/**
+ * @ingroup cg3core
+ * @brief Asks the operating system to start reading the given file in the
+ * page cache, without waiting for the read. Later reads of the file (or
+ * accesses to its memory mapping) will not wait for the disk.
+ *
+ * Does nothing on systems that do not support it, or if the file does not
+ * exist.
+ */
+inline void prefetchFile(const std::string& filename)
+{
+    #ifdef CG3_ASYNC_FADVISE
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+    posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+    ::close(fd);
+    #else
+    (void)filename;
+    #endif
+}
+
+/**
+ * @ingroup cg3core
+ * @brief Loads a mesh from file on a thread of the pool, using
+ * Mesh::loadFromFile(filename), and returns the future of the loaded mesh.
+ *
+ * Mesh can be any mesh type of the library that has a loadFromFile method
+ * (Dcel, SimpleEigenMesh, EigenMesh...):
+ *
+ * @code
+ * std::future<cg3::Dcel> f = cg3::io::loadAsync<cg3::Dcel>("bunny.obj");
+ * ... //something else
+ * cg3::Dcel d = f.get();
+ * @endcode
+ *
+ * If the file cannot be loaded, the future throws std::ios_base::failure;
+ * if the token is canceled, the future throws AsyncCanceled.
+ */
+template <typename Mesh>
+std::future<Mesh> loadAsync(
+        const std::string& filename,
+        AsyncToken token,
+        ThreadPool& pool)
+{
+    token.addTask();
+    prefetchFile(filename);
+    return pool.submit([filename, token]() {
+        return internal::loadTask<Mesh>(filename, "", token);
+    });
+}
+
+/**
+ * @ingroup cg3core
+ * @brief Loads concurrently a list of meshes on the threads of the pool,
+ * and returns the futures of the loaded meshes, in the same order of the
+ * input filenames.
+ *
+ * The read of the files from disk is overlapped with the parsing: when a
+ * thread starts loading a file, the file that will be loaded after all the
+ * running ones is prefetched.
+ *
+ * @code
+ * cg3::io::AsyncToken token(
+ *         [](unsigned int ended, unsigned int total, const std::string& f) {
+ *     std::cout << ended << "/" << total << ": " << f << "\n";
+ * });
+ * std::vector<std::future<cg3::Dcel>> meshes =
+ *         cg3::io::loadAsync<cg3::Dcel>(filenames, token);
+ * @endcode
+ */
+template <typename Mesh>
+std::vector<std::future<Mesh>> loadAsync(
+        const std::vector<std::string>& filenames,
+        AsyncToken token,
+        ThreadPool& pool)
+{
+    std::vector<std::future<Mesh>> futures;
+    futures.reserve(filenames.size());
+    std::size_t window = std::min<std::size_t>(pool.size(), filenames.size());
+    for (std::size_t i = 0; i < window; ++i)
+        prefetchFile(filenames[i]);
+    for (std::size_t i = 0; i < filenames.size(); ++i) {
+        token.addTask();
+        std::string filename = filenames[i];
+        std::string next = i + window < filenames.size() ? filenames[i + window] : "";
+        futures.push_back(pool.submit([filename, next, token]() {
+            return internal::loadTask<Mesh>(filename, next, token);
+        }));
+    }
+    return futures;
+}
+
+/**
+ * @ingroup cg3core
+ * @brief Saves a mesh on file on a thread of the pool, and returns a future
+ * that becomes ready when the file has been written.
+ *
+ * The format is chosen by the extension of the filename: obj, ply (binary)
+ * and, for the meshes that support it (Dcel), dcel.
+ *
+ * The mesh is taken by value: pass it with std::move if it is not used
+ * anymore by the caller, to avoid its copy.
+ *
+ * If the file cannot be saved or the extension is not supported, the future
+ * throws std::ios_base::failure; if the token is canceled before the save
+ * starts, the future throws AsyncCanceled and the file is not written.
+ */
+template <typename Mesh>
+std::future<void> saveAsync(
+        Mesh mesh,
+        const std::string& filename,
+        AsyncToken token,
+        ThreadPool& pool)
+{
+    token.addTask();
+    std::shared_ptr<Mesh> m = std::make_shared<Mesh>(std::move(mesh));
+    return pool.submit([m, filename, token]() {
+        AsyncToken t = token;
+        try {
+            if (t.isCanceled())
+                throw AsyncCanceled(filename);
+            internal::saveMesh(*m, filename);
+        }
+        catch(...) {
+            t.endTask(filename);
+            throw;
+        }
+        t.endTask(filename);
+    });
+}
+
+namespace internal {
+
+template <typename Mesh>
+Mesh loadTask(
+        const std::string& filename,
+        const std::string& nextFilename,
+        AsyncToken token)
+{
+    Mesh mesh;
+    try {
+        if (token.isCanceled())
+            throw AsyncCanceled(filename);
+        if (!nextFilename.empty())
+            prefetchFile(nextFilename);
+        if (!mesh.loadFromFile(filename))
+            throw std::ios_base::failure("Unable to load " + filename);
+        if (token.isCanceled())
+            throw AsyncCanceled(filename);
+    }
+    catch(...) {
+        token.endTask(filename);
+        throw;
+    }
+    token.endTask(filename);
+    return mesh;
+}
+
+template <typename Mesh>
+auto saveOnDcelFile(const Mesh& mesh, const std::string& filename, int)
+        -> decltype(mesh.saveOnDcelFile(filename))
+{
+    return mesh.saveOnDcelFile(filename);
+}
+
+template <typename Mesh>
+bool saveOnDcelFile(const Mesh&, const std::string&, long)
+{
+    return false;
+}
+
+template <typename Mesh>
+void saveMesh(const Mesh& mesh, const std::string& filename)
+{
+    std::string ext = filename.substr(filename.find_last_of(".") + 1);
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    bool ok;
+    if (ext == "obj")
+        ok = mesh.saveOnObj(filename);
+    else if (ext == "ply")
+        ok = mesh.saveOnPly(filename);
+    else if (ext == "dcel")
+        ok = saveOnDcelFile(mesh, filename, 0);
+    else
+        ok = false;
+    if (!ok)
+        throw std::ios_base::failure("Unable to save " + filename);
+}
+
+} //namespace cg3::io::internal
+
+} //namespace cg3::io
+} //namespace cg3
+
+#undef CG3_ASYNC_FADVISE
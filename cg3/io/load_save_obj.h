@@ -8,13 +8,14 @@
 #define CG3_LOAD_SAVE_OBJ_H
 
 #include "file_commons.h"
+#include "ascii_writer.h"
 #include <map>
 
 namespace cg3 {
 namespace internal {
 
 void manageObjFileColor(
-		std::ofstream &fp,
+		AsciiWriter &fp,
 		std::ofstream &fmtu,
 		const Color &c,
 		io::FileColorMode colorMod,
@@ -31,6 +32,41 @@ bool loadMtlFile(
 		const std::string &mtuFile,
 		std::map<std::string, Color> &mapColors);
 
+bool objKeyword(const char* p, const char* end, const char* keyword);
+
+bool parseObjVertex(
+		const char*& p,
+		const char* end,
+		double coords[],
+		double extra[],
+		unsigned int& nExtra);
+
+bool parseObjFace(
+		const char*& p,
+		const char* end,
+		unsigned long long nVertices,
+		std::vector<unsigned int>& faces,
+		unsigned int& nVert);
+
+/*
+ * Contents of an obj file, stored in contiguous arrays:
+ * faces contains the (0-based) vertex indices of all the faces, one face after
+ * the other, and faceSizes the number of vertices of each face.
+ */
+struct ObjData {
+	std::vector<double> coords;
+	std::vector<double> verticesNormals;
+	std::vector<Color> verticesColors;
+	std::vector<unsigned int> faces;
+	std::vector<unsigned int> faceSizes;
+	std::vector<Color> faceColors;
+};
+
+bool loadObjData(
+		const std::string& filename,
+		ObjData& data,
+		io::FileMeshMode& modality);
+
 } //namespace cg3::internal
 
 /*
@@ -88,7 +124,8 @@ bool saveMeshOnObj(
 		io::FileColorMode colorMod = io::RGB,
 		const T verticesColors[] = internal::dummyVectorFloat.data(),
 		const V triangleColors[] = internal::dummyVectorFloat.data(),
-		const W polygonSizes[] = internal::dummyVectorUnsignedInt.data());
+		const W polygonSizes[] = internal::dummyVectorUnsignedInt.data(),
+		unsigned int precision = 0);
 
 } //namespace cg3
 
@@ -5,18 +5,21 @@
  * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
  */
 #include "load_save_obj.h"
+#include "ascii_numbers.h"
+#include "mapped_file.h"
 #include "../utilities/tokenizer.h"
 
 #include <fstream>
 #include <sstream>
 #include <iostream>
-#include <clocale>
+#include <locale>
+#include <typeinfo>
 
 namespace cg3 {
 namespace internal {
 
 inline void manageObjFileColor(
-		std::ofstream &fp,
+		AsciiWriter &fp,
 		std::ofstream &fmtu,
 		const Color &c,
 		io::FileColorMode colorMod,
@@ -73,7 +76,6 @@ inline bool loadMtlFile(
 		const std::string &mtuFile,
 		std::map<std::string, Color> &mapColors)
 {
-	std::setlocale(LC_NUMERIC, "en_US.UTF-8"); // makes sure "." is the decimal separator
 	std::ifstream mtufile(mtuFile.c_str());
 	std::string line;
 	if (mtufile.is_open()){
@@ -96,6 +98,9 @@ inline bool loadMtlFile(
 					std::string b = *(++token);
 
 					std::istringstream rstr(r), gstr(g), bstr(b);
+					rstr.imbue(std::locale::classic()); // "." is the decimal separator
+					gstr.imbue(std::locale::classic());
+					bstr.imbue(std::locale::classic());
 					float  rf, gf, bf;
 					rstr >> rf;
 					gstr >> gf;
@@ -110,133 +115,180 @@ inline bool loadMtlFile(
 	return false;
 }
 
-} //namespace cg3::internal
+/**
+ * @brief Returns true if the line starting at p begins with the given keyword,
+ * followed by a blank.
+ */
+inline bool objKeyword(const char* p, const char* end, const char* keyword)
+{
+	for (; *keyword != '\0'; ++keyword, ++p){
+		if (p == end || *p != *keyword)
+			return false;
+	}
+	return p != end && isAsciiBlank(*p);
+}
 
 /**
- * @ingroup cg3core
- * @brief loadMeshFromObj
- * @param filename
- * @param coords
- * @param faces
- * @param meshType
- * @param modality
- * @param verticesNormals
- * @param verticesColors
- * @param faceColors
- * @param faceSizes
- * @return
+ * @brief Returns the rest of the line starting at p, without the trailing blanks.
  */
-template <typename T, typename V, typename C, typename W>
-bool loadMeshFromObj(
-		const std::string& filename,
-		std::list<T>& coords,
-		std::list<V>& faces,
-		io::FileMeshMode& modality,
-		std::list<C> &verticesNormals,
-		std::list<Color> &verticesColors,
-		std::list<Color> &faceColors,
-		std::list<W> &faceSizes)
+inline std::string objLineArgument(const char* p, const char* end)
 {
-	std::setlocale(LC_NUMERIC, "en_US.UTF-8"); // makes sure "." is the decimal separator
+	p = skipAsciiBlanks(p, end);
+	const char* e = p;
+	while (e != end && *e != '\n')
+		++e;
+	while (e != p && isAsciiBlank(*(e-1)))
+		--e;
+	return std::string(p, e);
+}
 
-	static const std::string vertex = "v";
-	static const std::string vertexNormal = "vn";
-	static const std::string face   = "f";
+/**
+ * @brief Parses the coordinates of a "v" line, starting after the keyword.
+ * Up to four optional values (color and alpha) following the coordinates are
+ * stored in extra.
+ */
+inline bool parseObjVertex(
+		const char*& p,
+		const char* end,
+		double coords[],
+		double extra[],
+		unsigned int& nExtra)
+{
+	for (unsigned int i = 0; i < 3; i++){
+		p = skipAsciiBlanks(p, end);
+		if (!parseAsciiDouble(p, end, coords[i]))
+			return false;
+	}
+	nExtra = 0;
+	p = skipAsciiBlanks(p, end);
+	while (nExtra < 4 && parseAsciiDouble(p, end, extra[nExtra])){
+		nExtra++;
+		p = skipAsciiBlanks(p, end);
+	}
+	return true;
+}
 
-	std::ifstream file(filename.c_str());
-	std::string   line;
-	bool usemtu = false;
-	bool first = true;
-	std::map<std::string, Color> mapColors;
-	Color actualColor;
+/**
+ * @brief Parses the vertex indices of a "f" line, starting after the keyword,
+ * and appends them (0-based) to faces.
+ * @param nVertices: number of vertices that precede the line, used to resolve
+ * negative (relative) indices
+ * @param nVert: number of vertices of the face
+ * @return false if the line is malformed or refers to a vertex that does not
+ * precede it
+ */
+inline bool parseObjFace(
+		const char*& p,
+		const char* end,
+		unsigned long long nVertices,
+		std::vector<unsigned int>& faces,
+		unsigned int& nVert)
+{
+	nVert = 0;
+	for (;;) {
+		p = skipAsciiBlanks(p, end);
+		if (p == end || *p == '\n' || *p == '#')
+			break;
+		long long id;
+		if (!parseAsciiInteger(p, end, id) || id == 0)
+			return false;
+		id = id > 0 ? id - 1 : (long long)nVertices + id;
+		if (id < 0 || id >= (long long)nVertices)
+			return false;
+		faces.push_back((unsigned int)id);
+		nVert++;
+		p = skipAsciiToken(p, end); //texture and normal indices
+	}
+	return true;
+}
 
-	coords.clear();
-	faces.clear();
-	verticesNormals.clear();
-	verticesColors.clear();
-	faceColors.clear();
+/**
+ * @brief Loads the content of an obj file in contiguous arrays.
+ *
+ * The file is memory mapped and parsed in a single pass, without splitting the
+ * lines in strings: the numbers are parsed in place with the locale independent
+ * functions of ascii_numbers.h, and stored directly in the arrays of data.
+ *
+ * Handles:
+ * - v x y z, v x y z w, v x y z r g b, v x y z r g b a
+ * - vn x y z
+ * - f v1 v2 v3 ..., where every vertex can be in the form v, v/vt, v//vn or
+ *   v/vt/vn and negative (relative) indices are allowed
+ * - mtllib and usemtl, for face colors
+ *
+ * @return false if the file cannot be opened or contains a malformed element
+ * (e.g. a face with an index out of the range of the preceding vertices)
+ */
+inline bool loadObjData(
+		const std::string& filename,
+		ObjData& data,
+		io::FileMeshMode& modality)
+{
+	data = ObjData();
 	modality.reset();
 
-	if(!file.is_open()) {
+	MappedFile file(filename);
+	if (!file.isOpen())
 		return false;
-	}
-	while(std::getline(file,line)) {
-
-		cg3::Tokenizer spaceTokenizer(line, ' ');
-
-		if (spaceTokenizer.begin() != spaceTokenizer.end()) {
-
-			cg3::Tokenizer::iterator token = spaceTokenizer.begin();
-			std::string header = *token;
 
-			if (header == "mtllib"){
-				modality.setFaceColors();
-				usemtu = true;
-				std::string mtufilename = *(++token);
-				size_t lastSlash = filename.find_last_of("/");
-				if (lastSlash < filename.size()){
-					std::string path = filename.substr(0, lastSlash);
-					mtufilename = path + "/" + mtufilename;
-				}
-				if (! internal::loadMtlFile(mtufilename, mapColors))
-					usemtu = false;
-			}
-
-			if (header == vertexNormal) {
-				modality.setVertexNormals();
-				std::string x = *(++token);
-				std::string y = *(++token);
-				std::string z = *(++token);
+	bool usemtu = false;
+	bool first = true;
+	std::map<std::string, Color> mapColors;
+	Color actualColor;
 
-				verticesNormals.push_back(std::stod(x));
-				verticesNormals.push_back(std::stod(y));
-				verticesNormals.push_back(std::stod(z));
+	const char* p = file.data();
+	const char* end = p + file.size();
+	//cheap estimate (~30 bytes for each vertex and face line) that avoids
+	//most of the reallocations of the arrays
+	data.coords.reserve(file.size() / 30);
+	data.faces.reserve(file.size() / 30);
+
+	while (p != end){
+		p = skipAsciiBlanks(p, end);
+		if (p == end)
+			break;
+
+		// Handle
+		//
+		// v 0.123 0.234 0.345
+		// v 0.123 0.234 0.345 1.0
+		// v 0.123 0.234 0.345 0.5 0.5 0.5
+		if (objKeyword(p, end, "v")) {
+			p += 1;
+			double c[3], extra[4];
+			unsigned int nExtra;
+			if (!parseObjVertex(p, end, c, extra, nExtra))
+				return false;
+			data.coords.insert(data.coords.end(), c, c + 3);
+			if (nExtra >= 3){
+				modality.setVertexColors();
+				int alpha = nExtra == 4 ? (int)extra[3] : 255;
+				data.verticesColors.push_back(Color(extra[0]*255, extra[1]*255, extra[2]*255, alpha));
 			}
-
-			// Handle
-			//
-			// v 0.123 0.234 0.345
-			// v 0.123 0.234 0.345 1.0
-			if (header == vertex) {
-				std::string x = *(++token);
-				std::string y = *(++token);
-				std::string z = *(++token);
-
-				coords.push_back(std::stod(x));
-				coords.push_back(std::stod(y));
-				coords.push_back(std::stod(z));
-
-				++token;
-
-				if (token != spaceTokenizer.end()){
-					modality.setVertexColors();
-					std::string r = *(token);
-					std::string g = *(++token);
-					std::string b = *(++token);
-					++token;
-					double alpha = 255;
-					if (token != spaceTokenizer.end()){
-						alpha = std::stoi(*token);
-					}
-					Color c(std::stod(r)*255, std::stod(g)*255, std::stod(b)*255, alpha);
-					verticesColors.push_back(c);
-				}
+		}
+		else if (objKeyword(p, end, "vn")) {
+			modality.setVertexNormals();
+			p += 2;
+			for (unsigned int i = 0; i < 3; i++){
+				p = skipAsciiBlanks(p, end);
+				double c;
+				if (!parseAsciiDouble(p, end, c))
+					return false;
+				data.verticesNormals.push_back(c);
 			}
-			// Handle
-			//
-			// f 1 2 3
-			// f 3/1 4/2 5/3
-			// f 6/4/1 3/5/3 7/6/5
-
-			else if (header == face) {
-				std::vector<std::string> dummy;
-				token++;
-				for (unsigned int i = 0; token != spaceTokenizer.end(); i++) {
-					dummy.push_back(*(token));
-					token++;
-				}
-				unsigned int nVert = (unsigned int)dummy.size();
-				faceSizes.push_back(nVert);
+		}
+		// Handle
+		//
+		// f 1 2 3
+		// f 3/1 4/2 5/3
+		// f 6/4/1 3/5/3 7/6/5
+		else if (objKeyword(p, end, "f")) {
+			p += 1;
+			unsigned int nVert;
+			if (!parseObjFace(p, end, data.coords.size() / 3, data.faces, nVert))
+				return false;
+			if (nVert > 0){
+				data.faceSizes.push_back(nVert);
 
 				if (first == true){
 					first = false;
@@ -254,32 +306,80 @@ bool loadMeshFromObj(
 						modality.setPolygonMesh();
 				}
 
-				std::vector<cg3::Tokenizer> slashTokenizer;
-				for (unsigned int i=0; i<dummy.size(); i++){
-					cg3::Tokenizer t(dummy[i], '/');
-					slashTokenizer.push_back(t);
-				}
-
-				for (unsigned int i=0; i<dummy.size(); i++){
-					std::string ids = *(slashTokenizer[i].begin());
-					faces.push_back(std::stoi(ids)-1);
-				}
-
 				if (usemtu){
-					faceColors.push_back(actualColor);
+					data.faceColors.push_back(actualColor);
 				}
 			}
-			else if (header == "usemtl" && usemtu){
-				std::string color = *(++token);
-				if (mapColors.find(color) == mapColors.end()) {
-					actualColor = cg3::Color(128,128,128);
-				}
-				else
-					actualColor = mapColors[color];
+		}
+		else if (objKeyword(p, end, "mtllib")) {
+			modality.setFaceColors();
+			usemtu = true;
+			std::string mtufilename = objLineArgument(p + 6, end);
+			size_t lastSlash = filename.find_last_of("/");
+			if (lastSlash < filename.size()){
+				std::string path = filename.substr(0, lastSlash);
+				mtufilename = path + "/" + mtufilename;
+			}
+			if (! internal::loadMtlFile(mtufilename, mapColors))
+				usemtu = false;
+		}
+		else if (usemtu && objKeyword(p, end, "usemtl")) {
+			std::string color = objLineArgument(p + 6, end);
+			std::map<std::string, Color>::iterator it = mapColors.find(color);
+			if (it == mapColors.end()) {
+				actualColor = cg3::Color(128,128,128);
 			}
+			else
+				actualColor = it->second;
 		}
+		p = skipAsciiLine(p, end);
 	}
-	file.close();
+	return true;
+}
+
+} //namespace cg3::internal
+
+/**
+ * @ingroup cg3core
+ * @brief loadMeshFromObj
+ * @param filename
+ * @param coords
+ * @param faces
+ * @param meshType
+ * @param modality
+ * @param verticesNormals
+ * @param verticesColors
+ * @param faceColors
+ * @param faceSizes
+ * @return
+ */
+template <typename T, typename V, typename C, typename W>
+bool loadMeshFromObj(
+		const std::string& filename,
+		std::list<T>& coords,
+		std::list<V>& faces,
+		io::FileMeshMode& modality,
+		std::list<C> &verticesNormals,
+		std::list<Color> &verticesColors,
+		std::list<Color> &faceColors,
+		std::list<W> &faceSizes)
+{
+	internal::ObjData data;
+	coords.clear();
+	faces.clear();
+	verticesNormals.clear();
+	verticesColors.clear();
+	faceColors.clear();
+
+	if (!internal::loadObjData(filename, data, modality))
+		return false;
+
+	coords.assign(data.coords.begin(), data.coords.end());
+	faces.assign(data.faces.begin(), data.faces.end());
+	verticesNormals.assign(data.verticesNormals.begin(), data.verticesNormals.end());
+	verticesColors.assign(data.verticesColors.begin(), data.verticesColors.end());
+	faceColors.assign(data.faceColors.begin(), data.faceColors.end());
+	faceSizes.insert(faceSizes.end(), data.faceSizes.begin(), data.faceSizes.end());
 	return true;
 }
 
@@ -305,43 +405,82 @@ bool loadTriangleMeshFromObj(
 		std::vector<Color> &verticesColors,
 		std::vector<Color> &triangleColors)
 {
-	std::list<T> dummyc;
-	std::list<V> dummyt;
-	modality.reset();
-	std::list<C> dummyvn;
-	std::list<Color> dummycv;
-	std::list<Color> dummyct;
-	bool r = loadMeshFromObj(filename, dummyc, dummyt, modality, dummyvn, dummycv, dummyct);
-	if (r == true && dummyt.size() > 0 && !modality.isTriangleMesh()){
+	internal::ObjData data;
+	bool r = internal::loadObjData(filename, data, modality);
+	if (r == true && data.faces.size() > 0 && !modality.isTriangleMesh()){
 		std::cerr << "Error: mesh contained on " << filename << " is not a triangle mesh\n";
 		r = false;
 	}
 	if (r) {
-		coords.clear();
-		triangles.clear();
-		coords = std::vector<T>{ std::make_move_iterator(std::begin(dummyc)),
-									  std::make_move_iterator(std::end(dummyc)) };
-		triangles = std::vector<V>{ std::make_move_iterator(std::begin(dummyt)),
-										 std::make_move_iterator(std::end(dummyt)) };
-		if (modality.hasVertexNormals() && dummyc.size() == dummyvn.size()){
-			verticesNormals.clear();
-			verticesNormals = std::vector<C>{ std::make_move_iterator(std::begin(dummyvn)),
-										  std::make_move_iterator(std::end(dummyvn)) };
+		coords.assign(data.coords.begin(), data.coords.end());
+		triangles.assign(data.faces.begin(), data.faces.end());
+		if (modality.hasVertexNormals() && data.coords.size() == data.verticesNormals.size()){
+			verticesNormals.assign(data.verticesNormals.begin(), data.verticesNormals.end());
 		}
-		if (modality.hasVertexColors() && dummyc.size() == dummycv.size()*3){
-			verticesColors.clear();
-			verticesColors = std::vector<Color>{ std::make_move_iterator(std::begin(dummycv)),
-													  std::make_move_iterator(std::end(dummycv)) };
+		if (modality.hasVertexColors() && data.coords.size() == data.verticesColors.size()*3){
+			verticesColors = std::move(data.verticesColors);
 		}
-		if (modality.hasFaceColors() && dummyt.size() == dummyct.size()*3){
-			triangleColors.clear();
-			triangleColors = std::vector<Color>{ std::make_move_iterator(std::begin(dummyct)),
-													  std::make_move_iterator(std::end(dummyct)) };
+		if (modality.hasFaceColors() && data.faces.size() == data.faceColors.size()*3){
+			triangleColors = std::move(data.faceColors);
 		}
 	}
 	return r;
 }
 
+namespace internal {
+
+/**
+ * @brief Copies the coordinates and the first three vertices of every face
+ * of data in the given matrices.
+ */
+template <typename T, typename V>
+void objDataToEigen(
+		const ObjData& data,
+		Eigen::PlainObjectBase<T>& coords,
+		Eigen::PlainObjectBase<V>& triangles)
+{
+	typedef typename Eigen::PlainObjectBase<T>::Scalar CS;
+	typedef typename Eigen::PlainObjectBase<V>::Scalar TS;
+	const size_t nv = data.coords.size() / 3;
+	coords.resize(nv, 3);
+	for (size_t v = 0; v < nv; v++){
+		coords(v,0) = (CS)data.coords[v*3];
+		coords(v,1) = (CS)data.coords[v*3+1];
+		coords(v,2) = (CS)data.coords[v*3+2];
+	}
+	triangles.resize(data.faceSizes.size(), 3);
+	size_t base = 0;
+	for (size_t t = 0; t < data.faceSizes.size(); t++){
+		for (unsigned int id = 0; id < 3 && id < data.faceSizes[t]; id++)
+			triangles(t,id) = (TS)data.faces[base + id];
+		base += data.faceSizes[t];
+	}
+}
+
+template <typename W>
+void colorsToEigen(
+		const std::vector<Color>& colors,
+		Eigen::PlainObjectBase<W>& matrix)
+{
+	matrix.resize(colors.size(), 3);
+	for (size_t i = 0; i < colors.size(); i++) {
+		const Color& c = colors[i];
+		if (typeid(typename Eigen::PlainObjectBase<W>::Scalar) == typeid(float) ||
+				typeid(typename Eigen::PlainObjectBase<W>::Scalar) == typeid(double)) {
+			matrix(i, 0) = c.redF();
+			matrix(i, 1) = c.greenF();
+			matrix(i, 2) = c.blueF();
+		}
+		else {
+			matrix(i, 0) = c.red();
+			matrix(i, 1) = c.green();
+			matrix(i, 2) = c.blue();
+		}
+	}
+}
+
+} //namespace cg3::internal
+
 /**
  * @ingroup cg3core
  * @brief loadTriangleMeshFromObj
@@ -356,37 +495,14 @@ bool loadTriangleMeshFromObj(
 		Eigen::PlainObjectBase<T>& coords,
 		Eigen::PlainObjectBase<V>& triangles)
 {
-	std::list<typename Eigen::PlainObjectBase<T>::Scalar> dummyc;
-	std::list<typename Eigen::PlainObjectBase<V>::Scalar> dummyt;
+	internal::ObjData data;
 	io::FileMeshMode modality;
-	std::list<unsigned int> faceSizes;
-	bool r = loadMeshFromObj(filename, dummyc, dummyt, modality,
-							 internal::dummyListDouble,
-							 internal::dummyListColor, internal::dummyListColor, faceSizes);
-    if (r == true && dummyt.size() > 0 && !modality.isTriangleMesh()){
+	bool r = internal::loadObjData(filename, data, modality);
+    if (r == true && data.faces.size() > 0 && !modality.isTriangleMesh()){
         std::cerr << "Warning: mesh contained on " << filename << " is not a triangle mesh\n";
     }
 	if (r) {
-		coords.resize(dummyc.size()/3, 3);
-		triangles.resize(faceSizes.size(), 3);
-		int v = 0;
-		for (typename std::list<typename Eigen::PlainObjectBase<T>::Scalar>::iterator it = dummyc.begin(); it != dummyc.end();){
-			coords(v,0) = *it++;
-			coords(v,1) = *it++;
-			coords(v,2) = *it++;
-			v++;
-		}
-		int t = 0;
-		std::list<unsigned int>::iterator fsit = faceSizes.begin();
-		for (typename std::list<typename Eigen::PlainObjectBase<V>::Scalar>::iterator it = dummyt.begin(); it != dummyt.end();){
-			for (unsigned int id = 0; id < *fsit; id++){
-				if (id < 3)
-					triangles(t,id) = *it++;
-				else it++;
-			}
-			t++;
-			fsit++;
-		}
+		internal::objDataToEigen(data, coords, triangles);
 	}
 	return r;
 }
@@ -413,86 +529,28 @@ bool loadTriangleMeshFromObj(
 		Eigen::PlainObjectBase<W> &verticesColors,
 		Eigen::PlainObjectBase<X> &triangleColors)
 {
-	std::list<typename Eigen::PlainObjectBase<T>::Scalar> dummyc;
-	std::list<typename Eigen::PlainObjectBase<V>::Scalar> dummyt;
-	modality.reset();
-	std::list<typename Eigen::PlainObjectBase<C>::Scalar> dummyvn;
-	std::list<Color> dummycv;
-	std::list<Color> dummyct;
-	std::list<unsigned int> faceSizes;
-	bool r = loadMeshFromObj(filename, dummyc, dummyt, modality, dummyvn, dummycv, dummyct, faceSizes);
-    if (r == true && dummyt.size() > 0 && !modality.isTriangleMesh()){
+	internal::ObjData data;
+	bool r = internal::loadObjData(filename, data, modality);
+    if (r == true && data.faces.size() > 0 && !modality.isTriangleMesh()){
         std::cerr << "Warning: mesh contained on " << filename << " is not a triangle mesh\n";
     }
 	if (r) {
-		coords.resize(dummyc.size()/3, 3);
-		triangles.resize(faceSizes.size(), 3);
-		int v = 0;
-		for (typename std::list<typename Eigen::PlainObjectBase<T>::Scalar>::iterator it = dummyc.begin(); it != dummyc.end(); ){
-			coords(v,0) = *it++;
-			coords(v,1) = *it++;
-			coords(v,2) = *it++;
-			v++;
-		}
-		int t = 0;
-		std::list<unsigned int>::iterator fsit = faceSizes.begin();
-		for (typename std::list<typename Eigen::PlainObjectBase<V>::Scalar>::iterator it = dummyt.begin(); it != dummyt.end(); ){
-			for (unsigned int id = 0; id < *fsit; id++){
-				if (id < 3)
-					triangles(t,id) = *it++;
-				else it++;
-			}
-			t++;
-			fsit++;
-		}
+		internal::objDataToEigen(data, coords, triangles);
 		if (modality.hasVertexNormals()
-				&& dummyc.size() == dummyvn.size()) {
-			verticesNormals.resize(dummyc.size()/3, 3);
-			int vn = 0;
-			for (typename std::list<typename Eigen::PlainObjectBase<C>::Scalar>::iterator it = dummyvn.begin(); it != dummyvn.end(); ){
-				verticesNormals(vn, 0) = *it++;
-				verticesNormals(vn, 1) = *it++;
-				verticesNormals(vn, 2) = *it++;
-				vn++;
+				&& data.coords.size() == data.verticesNormals.size()) {
+			const size_t nv = data.coords.size() / 3;
+			verticesNormals.resize(nv, 3);
+			for (size_t vn = 0; vn < nv; vn++){
+				verticesNormals(vn, 0) = data.verticesNormals[vn*3];
+				verticesNormals(vn, 1) = data.verticesNormals[vn*3+1];
+				verticesNormals(vn, 2) = data.verticesNormals[vn*3+2];
 			}
 		}
-		if (modality.hasVertexColors() && dummyc.size() == dummycv.size()*3){
-			verticesColors.resize(dummyc.size()/3, 3);
-			int vc = 0;
-			for (typename std::list<Color>::iterator it = dummycv.begin(); it != dummycv.end(); ++it) {
-				Color c = *it;
-				if (typeid(typename Eigen::PlainObjectBase<W>::Scalar) == typeid(float) ||
-						typeid(typename Eigen::PlainObjectBase<W>::Scalar) == typeid(double)) {
-					verticesColors(vc, 0) = c.redF();
-					verticesColors(vc, 1) = c.greenF();
-					verticesColors(vc, 2) = c.blueF();
-				}
-				else {
-					verticesColors(vc, 0) = c.red();
-					verticesColors(vc, 1) = c.green();
-					verticesColors(vc, 2) = c.blue();
-				}
-				vc++;
-			}
+		if (modality.hasVertexColors() && data.coords.size() == data.verticesColors.size()*3){
+			internal::colorsToEigen(data.verticesColors, verticesColors);
 		}
-		if (modality.hasFaceColors() && faceSizes.size() == dummyct.size()){
-			triangleColors.resize(faceSizes.size(), 3);
-			int vc = 0;
-			for (typename std::list<Color>::iterator it = dummyct.begin(); it != dummyct.end(); ++it) {
-				Color c = *it;
-				if (typeid(typename Eigen::PlainObjectBase<X>::Scalar) == typeid(float) ||
-						typeid(typename Eigen::PlainObjectBase<X>::Scalar) == typeid(double)) {
-					triangleColors(vc, 0) = c.redF();
-					triangleColors(vc, 1) = c.greenF();
-					triangleColors(vc, 2) = c.blueF();
-				}
-				else {
-					triangleColors(vc, 0) = c.red();
-					triangleColors(vc, 1) = c.green();
-					triangleColors(vc, 2) = c.blue();
-				}
-				vc++;
-			}
+		if (modality.hasFaceColors() && data.faceSizes.size() == data.faceColors.size()){
+			internal::colorsToEigen(data.faceColors, triangleColors);
 		}
 	}
 	return r;
@@ -520,6 +578,9 @@ bool loadTriangleMeshFromObj(
  * indicating the colors of the vertices
  * @param faceColors
  * @param polygonSizes
+ * @param precision: significant digits of the written floating point numbers.
+ * If 0 (default), every number is written with a round-trip (usually the
+ * shortest) representation, which is parsed back to the same value
  * @return
  */
 template <typename A, typename B, typename C , typename T , typename V , typename W>
@@ -534,11 +595,11 @@ bool saveMeshOnObj(
 		io::FileColorMode colorMod,
 		const T verticesColors[],
 		const V faceColors[],
-		const W polygonSizes[])
+		const W polygonSizes[],
+		unsigned int precision)
 {
 	std::string objfilename, mtufilename, mtufilenopath;
-	std::setlocale(LC_NUMERIC, "en_US.UTF-8"); // makes sure "." is the decimal separator
-	std::ofstream fp, fmtu;
+	std::ofstream fstream, fmtu;
 	bool color = false;
 	std::map<Color, std::string> colors;
 	Color actualColor;
@@ -557,52 +618,67 @@ bool saveMeshOnObj(
 			return false;
 	}
 
-	fp.open (objfilename);
-	if(!fp) {
+	fstream.open(objfilename);
+	if(!fstream) {
 		return false;
 	}
-	fp.precision(6);
-	fp.setf( std::ios::fixed, std:: ios::floatfield );
+	AsciiWriter fp(fstream, precision);
 
 	if (color){
 		fp << "mtllib " << mtufilenopath << "\n";
 
 	}
 
-	for(size_t i=0; i<nVertices*3; i+=3) {
-
+	//lines are formatted in parallel when they do not depend on the previous ones
+	fp.writeParallel(nVertices, [&](AsciiWriter& w, size_t v) {
+		size_t i = v*3;
 		if (modality.hasVertexNormals()) {
-			fp << "vn " << verticesNormals[i] <<
-				  " " << verticesNormals[i+1] <<
-				  " " << verticesNormals[i+2] << std::endl;
+			w << "vn " << verticesNormals[i] <<
+				 ' ' << verticesNormals[i+1] <<
+				 ' ' << verticesNormals[i+2] << '\n';
 		}
-		fp << "v " << vertices[i] << " " << vertices[i+1] << " " << vertices[i+2];
+		w << "v " << vertices[i] << ' ' << vertices[i+1] << ' ' << vertices[i+2];
 		if (modality.hasVertexColors()){
-			Color c = internal::colorFromArray(colorMod == io::RGB ? i : (i/3)*4, verticesColors, colorMod);
-            fp << " " << c.redF() << " " << c.greenF() << " " << c.blueF();
+			Color c = internal::colorFromArray(colorMod == io::RGB ? i : v*4, verticesColors, colorMod);
+			w << ' ' << c.redF() << ' ' << c.greenF() << ' ' << c.blueF();
 		}
-		fp << std::endl;
-	}
+		w << '\n';
+	});
 
 	if (modality.isTriangleMesh()) {
-		for(size_t i=0; i<nFaces*3; i+=3) {
-			if (modality.hasFaceColors()){
+		if (modality.hasFaceColors()){
+			for(size_t i=0; i<nFaces*3; i+=3) {
 				Color c = internal::colorFromArray(colorMod == io::RGB ? i : (i/3)*4, faceColors, colorMod);
 				internal::manageObjFileColor(fp, fmtu, c, colorMod, actualColor, colors);
+				fp << "f " << faces[i]+1 << ' ' << faces[i+1]+1 << ' ' << faces[i+2]+1 << '\n';
 			}
-			fp << "f " << faces[i]+1 << " " << faces[i+1]+1 << " " << faces[i+2]+1 << std::endl;
+		}
+		else {
+			fp.writeParallel(nFaces, [&](AsciiWriter& w, size_t f) {
+				size_t i = f*3;
+				w << "f " << faces[i]+1 << ' ' << faces[i+1]+1 << ' ' << faces[i+2]+1 << '\n';
+			});
 		}
 	}
 	else if (modality.isQuadMesh()) {
-		for(size_t i=0; i<nFaces*4; i+=4) {
-			if (modality.hasFaceColors()){
+		if (modality.hasFaceColors()){
+			for(size_t i=0; i<nFaces*4; i+=4) {
 				Color c = internal::colorFromArray(colorMod == io::RGB ? (i/4)*3 : i, faceColors, colorMod);
 				internal::manageObjFileColor(fp, fmtu, c, colorMod, actualColor, colors);
+				fp << "f " << faces[i]+1 <<
+					  ' ' << faces[i+1]+1 <<
+					  ' ' << faces[i+2]+1 <<
+					  ' ' << faces[i+3]+1 << '\n';
 			}
-			fp << "f " << faces[i]+1 <<
-				  " " << faces[i+1]+1 <<
-				  " " << faces[i+2]+1<<
-				  " " << faces[i+3]+1 << std::endl;
+		}
+		else {
+			fp.writeParallel(nFaces, [&](AsciiWriter& w, size_t f) {
+				size_t i = f*4;
+				w << "f " << faces[i]+1 <<
+					 ' ' << faces[i+1]+1 <<
+					 ' ' << faces[i+2]+1 <<
+					 ' ' << faces[i+3]+1 << '\n';
+			});
 		}
 	}
 	else if (modality.isPolygonMesh()) {
@@ -614,14 +690,15 @@ bool saveMeshOnObj(
 			}
 			fp << "f ";
 			for (size_t k = 0; k < polygonSizes[i]; k++)
-				fp << faces[j+k]+1 << " ";
-			fp << "\n";
+				fp << faces[j+k]+1 << ' ';
+			fp << '\n';
 			j += polygonSizes[i];
 		}
 	}
 	else assert(0);
 
-	fp.close();
+	fp.flush();
+	fstream.close();
 	if (color)
 		fmtu.close();
 	return true;
@@ -6,6 +6,7 @@
  */
 #include "load_save_ply.h"
 #include "../utilities/tokenizer.h"
+#include "mapped_file.h"
 
 #include <fstream>
 #include <sstream>
@@ -45,12 +46,13 @@ bool loadMeshFromPly(
 
 	uint nV = header.numberVertices();
 	uint nF = header.numberFaces();
-	uint nE = header.numberEdges();
+	uint nE = header.hasEdges() ? header.numberEdges() : 0;
 	std::vector<uint> vc, fc, ec; //v and f colors
 	std::vector<double> fn; //f normals
 	coords.resize(nV*3);
 	edges.resize(nE*2);
 	faces.clear();
+	faces.reserve(nF*3);
 	vertexNormals.resize(nV*3);
 	vc.resize(nV*4); //also alpha
 	fc.resize(nF*4); //also alpha
@@ -59,23 +61,54 @@ bool loadMeshFromPly(
 	faceSizes.resize(nF);
 
 	bool loadOk = true;
-	for (ply::Element el : header){
-		switch (el.type) {
-			case ply::VERTEX:
-				loadOk = ply::loadVertices(file, header, coords.data(), vertexNormals.data(), io::RGBA, vc.data());
-				break;
-			case ply::FACE:
-				loadOk = ply::loadFaces(file, header, faces, meshType, fn.data(), io::RGBA, fc.data(), faceSizes.data());
-				modality.setMeshType(meshType);
-				break;
-			case ply::EDGE:
-				loadOk = ply::loadEdges(file, header, edges.data(), io::RGBA, ec.data());
-				break;
-			default:
-				break;
-		}
-		if (!loadOk)
+	if (header.format() == ply::BINARY){
+		//binary content is parsed directly from the mapped file
+		std::streamoff start = file.tellg();
+		MappedFile map(filename);
+		if (start < 0 || !map.isOpen() || (size_t)start > map.size())
 			return false;
+		const char* data = map.data() + start;
+		const char* end = map.data() + map.size();
+		bool swap = header.isBigEndian() != ply::internal::isBigEndianMachine();
+		for (const ply::Element& el : header){
+			switch (el.type) {
+				case ply::VERTEX:
+					loadOk = ply::internal::loadVerticesBin(data, end, header, coords.data(), vertexNormals.data(), io::RGBA, vc.data());
+					break;
+				case ply::FACE:
+					loadOk = ply::internal::loadFacesBin(data, end, header, faces, meshType, fn.data(), io::RGBA, fc.data(), faceSizes.data());
+					modality.setMeshType(meshType);
+					break;
+				case ply::EDGE:
+					loadOk = ply::internal::loadEdgesBin(data, end, header, edges.data(), io::RGBA, ec.data());
+					break;
+				default:
+					loadOk = ply::internal::skipBinaryElement(data, end, el, swap);
+					break;
+			}
+			if (!loadOk)
+				return false;
+		}
+	}
+	else {
+		for (ply::Element el : header){
+			switch (el.type) {
+				case ply::VERTEX:
+					loadOk = ply::loadVertices(file, header, coords.data(), vertexNormals.data(), io::RGBA, vc.data());
+					break;
+				case ply::FACE:
+					loadOk = ply::loadFaces(file, header, faces, meshType, fn.data(), io::RGBA, fc.data(), faceSizes.data());
+					modality.setMeshType(meshType);
+					break;
+				case ply::EDGE:
+					loadOk = ply::loadEdges(file, header, edges.data(), io::RGBA, ec.data());
+					break;
+				default:
+					break;
+			}
+			if (!loadOk)
+				return false;
+		}
 	}
 	vertexColors.clear();
 	vertexColors.reserve(nV);
@@ -90,7 +123,7 @@ bool loadMeshFromPly(
 	edgeColors.clear();
 	edgeColors.reserve(nE);
 	for (uint i = 0; i < ec.size(); i+=4){
-		faceColors.push_back(Color(ec[i], ec[i+1], ec[i+2], ec[i+3]));
+		edgeColors.push_back(Color(ec[i], ec[i+1], ec[i+2], ec[i+3]));
 	}
 	file.close();
 	return loadOk;
@@ -373,8 +406,9 @@ bool saveMeshOnPly(
 	header.setModality(modality, binary);
 	header.setNumberVertices((unsigned long int)nVertices);
 	header.setNumberFaces((unsigned long int)nFaces);
-	header.setNumberEdges((unsigned long int)nEdges);
-	fp.open (plyfilename);
+	if (header.hasEdges())
+		header.setNumberEdges((unsigned long int)nEdges);
+	fp.open (plyfilename, binary ? std::ios::out | std::ios::binary : std::ios::out);
 	if(!fp) {
 		return false;
 	}
@@ -433,7 +467,7 @@ inline bool saveMeshOnPly(
 	header.setModality(modality, binary);
         header.setNumberVertices((unsigned long int)nVertices);
         header.setNumberFaces((unsigned long int)nFaces);
-	fp.open (plyfilename);
+	fp.open (plyfilename, binary ? std::ios::out | std::ios::binary : std::ios::out);
 	if(!fp) {
 		return false;
 	}
@@ -0,0 +1,60 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#ifndef CG3_MAPPED_FILE_H
+#define CG3_MAPPED_FILE_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+namespace cg3 {
+
+/**
+ * @ingroup cg3core
+ * @brief Read-only view of the whole content of a file.
+ *
+ * On POSIX systems the file is memory mapped, and its pages are loaded lazily
+ * by the operating system when they are accessed. On the other systems, the
+ * content of the file is read in memory by open().
+ *
+ * An empty file is opened like any other file: isOpen() returns true, and
+ * size() returns 0.
+ */
+class MappedFile
+{
+public:
+    MappedFile();
+    MappedFile(const std::string& filename);
+    MappedFile(const MappedFile& other) = delete;
+    MappedFile(MappedFile&& other);
+    ~MappedFile();
+
+    MappedFile& operator= (const MappedFile& other) = delete;
+    MappedFile& operator= (MappedFile&& other);
+
+    bool open(const std::string& filename);
+    void close();
+    bool isOpen() const;
+    const char* data() const;
+    std::size_t size() const;
+
+private:
+    void swap(MappedFile& other);
+
+    const char* ptr;
+    std::size_t length;
+    bool mapped;
+    bool opened;
+    std::vector<char> buffer; //used when the file cannot be mapped
+};
+
+} //namespace cg3
+
+#include "mapped_file.inl"
+
+#endif // CG3_MAPPED_FILE_H
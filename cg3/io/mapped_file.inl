@@ -0,0 +1,151 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#include "mapped_file.h"
+
+#include <fstream>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CG3_MAPPED_FILE_POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace cg3 {
+
+inline MappedFile::MappedFile() :
+    ptr(nullptr),
+    length(0),
+    mapped(false),
+    opened(false)
+{
+}
+
+inline MappedFile::MappedFile(const std::string& filename) :
+    MappedFile()
+{
+    open(filename);
+}
+
+inline MappedFile::MappedFile(MappedFile&& other) :
+    MappedFile()
+{
+    swap(other);
+}
+
+inline MappedFile::~MappedFile()
+{
+    close();
+}
+
+inline MappedFile& MappedFile::operator= (MappedFile&& other)
+{
+    close();
+    swap(other);
+    return *this;
+}
+
+/**
+ * @brief Opens the given file, closing the currently opened one.
+ * @return true if the file has been opened (also when it is empty), false if it
+ * does not exist or cannot be read
+ */
+inline bool MappedFile::open(const std::string& filename)
+{
+    close();
+    #ifdef CG3_MAPPED_FILE_POSIX
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0){
+        ::close(fd);
+        return false;
+    }
+    length = (std::size_t)st.st_size;
+    if (length == 0) { //an empty file cannot be mapped
+        ::close(fd);
+        opened = true;
+        return true;
+    }
+    void* p = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); //the mapping remains valid after closing the descriptor
+    if (p != MAP_FAILED){
+        ptr = static_cast<const char*>(p);
+        mapped = true;
+        opened = true;
+        return true;
+    }
+    length = 0;
+    #endif
+    //fallback: the file is read in memory
+    std::ifstream file(filename, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!file.is_open())
+        return false;
+    std::streamoff size = file.tellg();
+    if (size < 0)
+        return false;
+    buffer.resize((std::size_t)size);
+    file.seekg(0);
+    if (size > 0 && !file.read(buffer.data(), size)){
+        buffer.clear();
+        return false;
+    }
+    ptr = buffer.data();
+    length = buffer.size();
+    opened = true;
+    return true;
+}
+
+inline void MappedFile::close()
+{
+    #ifdef CG3_MAPPED_FILE_POSIX
+    if (mapped)
+        munmap(const_cast<char*>(ptr), length);
+    #endif
+    ptr = nullptr;
+    length = 0;
+    mapped = false;
+    opened = false;
+    buffer.clear();
+    buffer.shrink_to_fit();
+}
+
+inline bool MappedFile::isOpen() const
+{
+    return opened;
+}
+
+/**
+ * @brief Returns the pointer to the first byte of the file (nullptr if the file
+ * is empty). The pointer is valid until the file is closed.
+ */
+inline const char* MappedFile::data() const
+{
+    return ptr;
+}
+
+inline std::size_t MappedFile::size() const
+{
+    return length;
+}
+
+inline void MappedFile::swap(MappedFile& other)
+{
+    std::swap(ptr, other.ptr);
+    std::swap(length, other.length);
+    std::swap(mapped, other.mapped);
+    std::swap(opened, other.opened);
+    buffer.swap(other.buffer);
+}
+
+} //namespace cg3
+
+#undef CG3_MAPPED_FILE_POSIX
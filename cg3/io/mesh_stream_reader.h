@@ -0,0 +1,103 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+#ifndef CG3_MESH_STREAM_READER_H
+#define CG3_MESH_STREAM_READER_H
+
+#include "mapped_file.h"
+#include "ply/ply_header.h"
+
+#include <string>
+#include <vector>
+
+namespace cg3 {
+
+/**
+ * @ingroup cg3core
+ * @brief Pull-based reader of obj and ply (ascii and binary) meshes.
+ *
+ * Vertices and faces are returned in batches of a fixed maximum size, without
+ * materializing the whole mesh: the file is memory mapped and only the batch
+ * being returned is stored in memory. This allows to compute, for example,
+ * the bounding box or the area of a mesh that does not fit in memory.
+ *
+ * Vertices and faces are read by two independent cursors, therefore they can
+ * be read in any order, also when they are interleaved in the file (obj).
+ *
+ * Example:
+ * @code
+ * cg3::MeshStreamReader reader("scan.ply");
+ * reader.forEachVertexBatch([&](const std::vector<double>& coords) {
+ *     for (unsigned int i = 0; i < coords.size(); i += 3)
+ *         bb.extend(cg3::Point3d(coords[i], coords[i+1], coords[i+2]));
+ * });
+ * @endcode
+ */
+class MeshStreamReader
+{
+public:
+	static const unsigned int DEFAULT_BATCH_SIZE = 1 << 16;
+
+	MeshStreamReader();
+	MeshStreamReader(const std::string& filename);
+
+	bool open(const std::string& filename);
+	void close();
+	bool isOpen() const;
+	bool error() const;
+	void rewind();
+
+	long long numberVertices() const;
+	long long numberFaces() const;
+
+	unsigned int readVertices(
+			std::vector<double>& coords,
+			unsigned int maxVertices = DEFAULT_BATCH_SIZE);
+	unsigned int readFaces(
+			std::vector<unsigned int>& faces,
+			std::vector<unsigned int>& faceSizes,
+			unsigned int maxFaces = DEFAULT_BATCH_SIZE);
+
+	template <typename F>
+	bool forEachVertexBatch(F f, unsigned int batchSize = DEFAULT_BATCH_SIZE);
+
+	template <typename F>
+	bool forEachFaceBatch(F f, unsigned int batchSize = DEFAULT_BATCH_SIZE);
+
+private:
+	typedef enum {NONE, OBJ, PLY_ASCII, PLY_BINARY} FileType;
+
+	bool openPly(const std::string& filename);
+	const char* plyElementStart(ply::ElementType type);
+	unsigned int readObjVertices(std::vector<double>& coords, unsigned int maxVertices);
+	unsigned int readObjFaces(
+			std::vector<unsigned int>& faces,
+			std::vector<unsigned int>& faceSizes,
+			unsigned int maxFaces);
+	unsigned int readPlyVertices(std::vector<double>& coords, unsigned int maxVertices);
+	unsigned int readPlyFaces(
+			std::vector<unsigned int>& faces,
+			std::vector<unsigned int>& faceSizes,
+			unsigned int maxFaces);
+
+	MappedFile file;
+	FileType type;
+	ply::PlyHeader header;
+	bool swap; //binary ply with endianness different from the machine one
+	bool err;
+
+	const char* dataStart; //first character after the ply header
+	const char* vCursor;
+	const char* fCursor;
+	long long vRead, fRead;
+	unsigned long long objVertices; //obj vertices before fCursor
+};
+
+} //namespace cg3
+
+#include "mesh_stream_reader.inl"
+
+#endif // CG3_MESH_STREAM_READER_H
@@ -0,0 +1,472 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+#include "mesh_stream_reader.h"
+
+#include "ascii_numbers.h"
+#include "load_save_obj.h"
+#include "ply/ply_binary.h"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+
+namespace cg3 {
+
+namespace internal {
+
+inline const char* skipPlyAsciiSeparators(const char* p, const char* end)
+{
+	while (p != end && (isAsciiBlank(*p) || *p == '\n'))
+		++p;
+	return p;
+}
+
+/**
+ * @brief Parses the next value of an ascii ply file (values of a record can
+ * span multiple lines).
+ */
+inline bool readPlyAsciiValue(const char*& p, const char* end, double& value)
+{
+	p = skipPlyAsciiSeparators(p, end);
+	return parseAsciiDouble(p, end, value);
+}
+
+inline bool skipPlyAsciiProperty(const char*& p, const char* end, const ply::Property& prop)
+{
+	unsigned int n = 1;
+	if (prop.list){
+		double size;
+		if (!readPlyAsciiValue(p, end, size) || size < 0)
+			return false;
+		n = (unsigned int)size;
+	}
+	for (unsigned int i = 0; i < n; i++){
+		p = skipPlyAsciiSeparators(p, end);
+		if (p == end)
+			return false;
+		p = skipAsciiToken(p, end);
+	}
+	return true;
+}
+
+} //namespace cg3::internal
+
+inline MeshStreamReader::MeshStreamReader() :
+	type(NONE),
+	swap(false),
+	err(false),
+	dataStart(nullptr),
+	vCursor(nullptr),
+	fCursor(nullptr),
+	vRead(0),
+	fRead(0),
+	objVertices(0)
+{
+}
+
+inline MeshStreamReader::MeshStreamReader(const std::string& filename) :
+	MeshStreamReader()
+{
+	open(filename);
+}
+
+/**
+ * @brief Opens an obj or ply file, recognized by its extension.
+ * @return false if the file cannot be opened or its format is not supported
+ */
+inline bool MeshStreamReader::open(const std::string& filename)
+{
+	close();
+	std::string ext = filename.substr(std::min(filename.find_last_of("."), filename.size()));
+	std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+	if (ext == ".obj"){
+		if (!file.open(filename))
+			return false;
+		type = OBJ;
+		dataStart = file.data();
+	}
+	else if (ext == ".ply"){
+		if (!openPly(filename)){
+			close();
+			return false;
+		}
+	}
+	else
+		return false;
+	rewind();
+	return true;
+}
+
+inline void MeshStreamReader::close()
+{
+	file.close();
+	header.clear();
+	type = NONE;
+	swap = false;
+	dataStart = nullptr;
+	rewind();
+}
+
+inline bool MeshStreamReader::isOpen() const
+{
+	return type != NONE;
+}
+
+/**
+ * @brief Returns true if a malformed vertex or face has been found while reading,
+ * or if vertices or faces have been read while no file was open.
+ */
+inline bool MeshStreamReader::error() const
+{
+	return err;
+}
+
+/**
+ * @brief Restarts the reading of vertices and faces from the beginning of the file.
+ */
+inline void MeshStreamReader::rewind()
+{
+	vCursor = type == OBJ ? dataStart : nullptr;
+	fCursor = type == OBJ ? dataStart : nullptr;
+	vRead = 0;
+	fRead = 0;
+	objVertices = 0;
+	err = false;
+}
+
+/**
+ * @brief Returns the number of vertices declared in the header of a ply file,
+ * or -1 if it is not known before reading the file (obj).
+ */
+inline long long MeshStreamReader::numberVertices() const
+{
+	if (type == PLY_ASCII || type == PLY_BINARY)
+		return header.numberVertices();
+	return -1;
+}
+
+/**
+ * @brief Returns the number of faces declared in the header of a ply file,
+ * or -1 if it is not known before reading the file (obj).
+ */
+inline long long MeshStreamReader::numberFaces() const
+{
+	if (type == PLY_ASCII || type == PLY_BINARY)
+		return header.numberFaces();
+	return -1;
+}
+
+/**
+ * @brief Reads the next (at most) maxVertices vertices.
+ * @param coords: replaced with the coordinates x, y, z of the read vertices
+ * @return the number of read vertices: 0 when all the vertices have been read
+ * or an error occurred (see error()), e.g. the reader is not open
+ */
+inline unsigned int MeshStreamReader::readVertices(
+		std::vector<double>& coords,
+		unsigned int maxVertices)
+{
+	coords.clear();
+	if (type == NONE)
+		err = true;
+	if (err || maxVertices == 0)
+		return 0;
+	switch (type) {
+		case OBJ:
+			return readObjVertices(coords, maxVertices);
+		case PLY_ASCII:
+		case PLY_BINARY:
+			return readPlyVertices(coords, maxVertices);
+		default:
+			return 0;
+	}
+}
+
+/**
+ * @brief Reads the next (at most) maxFaces faces.
+ * @param faces: replaced with the (0-based) vertex indices of the read faces,
+ * one face after the other
+ * @param faceSizes: replaced with the number of vertices of each read face
+ * @return the number of read faces: 0 when all the faces have been read
+ * or an error occurred (see error()), e.g. the reader is not open
+ */
+inline unsigned int MeshStreamReader::readFaces(
+		std::vector<unsigned int>& faces,
+		std::vector<unsigned int>& faceSizes,
+		unsigned int maxFaces)
+{
+	faces.clear();
+	faceSizes.clear();
+	if (type == NONE)
+		err = true;
+	if (err || maxFaces == 0)
+		return 0;
+	switch (type) {
+		case OBJ:
+			return readObjFaces(faces, faceSizes, maxFaces);
+		case PLY_ASCII:
+		case PLY_BINARY:
+			return readPlyFaces(faces, faceSizes, maxFaces);
+		default:
+			return 0;
+	}
+}
+
+/**
+ * @brief Calls f(coords) for every batch of (at most) batchSize vertices,
+ * starting from the current position of the vertex cursor.
+ * @return false if an error occurred while reading the vertices, or the reader
+ * is not open
+ */
+template <typename F>
+bool MeshStreamReader::forEachVertexBatch(F f, unsigned int batchSize)
+{
+	std::vector<double> coords;
+	coords.reserve(batchSize * 3);
+	while (readVertices(coords, batchSize) > 0)
+		f(coords);
+	return !err;
+}
+
+/**
+ * @brief Calls f(faces, faceSizes) for every batch of (at most) batchSize
+ * faces, starting from the current position of the face cursor.
+ * @return false if an error occurred while reading the faces, or the reader
+ * is not open
+ */
+template <typename F>
+bool MeshStreamReader::forEachFaceBatch(F f, unsigned int batchSize)
+{
+	std::vector<unsigned int> faces, faceSizes;
+	faces.reserve(batchSize * 3);
+	faceSizes.reserve(batchSize);
+	while (readFaces(faces, faceSizes, batchSize) > 0)
+		f(faces, faceSizes);
+	return !err;
+}
+
+inline bool MeshStreamReader::openPly(const std::string& filename)
+{
+	std::ifstream stream(filename.c_str());
+	if (!stream.is_open())
+		return false;
+	header = ply::PlyHeader(stream);
+	if (header.errorWhileLoading())
+		return false;
+	std::streamoff start = stream.tellg();
+	stream.close();
+	if (start < 0 || !file.open(filename) || (std::size_t)start > file.size())
+		return false;
+	type = header.format() == ply::BINARY ? PLY_BINARY : PLY_ASCII;
+	swap = header.isBigEndian() != ply::internal::isBigEndianMachine();
+	dataStart = file.data() + start;
+	return true;
+}
+
+/**
+ * @brief Returns the position of the first record of the element of the given
+ * type, skipping all the elements that precede it.
+ */
+inline const char* MeshStreamReader::plyElementStart(ply::ElementType elementType)
+{
+	const char* p = dataStart;
+	const char* end = file.data() + file.size();
+	for (const ply::Element& el : header){
+		if (el.type == elementType)
+			return p;
+		if (type == PLY_BINARY){
+			if (!ply::internal::skipBinaryElement(p, end, el, swap))
+				return nullptr;
+		}
+		else {
+			for (unsigned int i = 0; i < el.numberElements; ++i){
+				for (const ply::Property& prop : el.properties){
+					if (!internal::skipPlyAsciiProperty(p, end, prop))
+						return nullptr;
+				}
+			}
+		}
+	}
+	return nullptr;
+}
+
+inline unsigned int MeshStreamReader::readObjVertices(
+		std::vector<double>& coords,
+		unsigned int maxVertices)
+{
+	const char* end = file.data() + file.size();
+	unsigned int n = 0;
+	while (n < maxVertices && vCursor != end){
+		vCursor = internal::skipAsciiBlanks(vCursor, end);
+		if (internal::objKeyword(vCursor, end, "v")){
+			vCursor += 1;
+			double c[3], extra[4];
+			unsigned int nExtra;
+			if (!internal::parseObjVertex(vCursor, end, c, extra, nExtra)){
+				err = true;
+				return 0;
+			}
+			coords.insert(coords.end(), c, c + 3);
+			n++;
+		}
+		vCursor = internal::skipAsciiLine(vCursor, end);
+	}
+	vRead += n;
+	return n;
+}
+
+inline unsigned int MeshStreamReader::readObjFaces(
+		std::vector<unsigned int>& faces,
+		std::vector<unsigned int>& faceSizes,
+		unsigned int maxFaces)
+{
+	const char* end = file.data() + file.size();
+	unsigned int n = 0;
+	while (n < maxFaces && fCursor != end){
+		fCursor = internal::skipAsciiBlanks(fCursor, end);
+		if (internal::objKeyword(fCursor, end, "v")){
+			objVertices++; //needed to resolve relative indices
+		}
+		else if (internal::objKeyword(fCursor, end, "f")){
+			fCursor += 1;
+			unsigned int nVert;
+			if (!internal::parseObjFace(fCursor, end, objVertices, faces, nVert)){
+				err = true;
+				faces.clear();
+				faceSizes.clear();
+				return 0;
+			}
+			if (nVert > 0){
+				faceSizes.push_back(nVert);
+				n++;
+			}
+		}
+		fCursor = internal::skipAsciiLine(fCursor, end);
+	}
+	fRead += n;
+	return n;
+}
+
+inline unsigned int MeshStreamReader::readPlyVertices(
+		std::vector<double>& coords,
+		unsigned int maxVertices)
+{
+	if (vRead == 0 && vCursor == nullptr)
+		vCursor = plyElementStart(ply::VERTEX);
+	if (vCursor == nullptr){
+		err = true;
+		return 0;
+	}
+	const char* end = file.data() + file.size();
+	unsigned int n = (unsigned int)std::min((long long)maxVertices, numberVertices() - vRead);
+	if (n == 0)
+		return 0;
+	coords.resize(n * 3);
+	unsigned int size;
+	bool ok = true;
+	if (type == PLY_BINARY && ply::internal::recordSize(header.vertexProperties(), size)){
+		if ((std::size_t)(end - vCursor) < (std::size_t)size * n){
+			ok = false;
+		}
+		else {
+			unsigned int offset = 0;
+			for (const ply::Property& p : header.vertexProperties()){
+				if (p.name == ply::x || p.name == ply::y || p.name == ply::z)
+					ply::internal::readBinaryColumn(vCursor + offset, size, n, p.type, swap, &coords[p.name - ply::x], 3);
+				offset += ply::internal::propertySize(p.type);
+			}
+			vCursor += (std::size_t)size * n;
+		}
+	}
+	else {
+		for (unsigned int v = 0; v < n && ok; ++v){
+			for (const ply::Property& p : header.vertexProperties()){
+				bool coord = !p.list && (p.name == ply::x || p.name == ply::y || p.name == ply::z);
+				if (type == PLY_BINARY){
+					if (coord)
+						ok = ply::internal::readBinaryProperty(vCursor, end, p.type, swap, coords[v*3 + p.name - ply::x]);
+					else
+						ok = ply::internal::skipBinaryProperty(vCursor, end, p, swap);
+				}
+				else {
+					if (coord)
+						ok = internal::readPlyAsciiValue(vCursor, end, coords[v*3 + p.name - ply::x]);
+					else
+						ok = internal::skipPlyAsciiProperty(vCursor, end, p);
+				}
+				if (!ok)
+					break;
+			}
+		}
+	}
+	if (!ok){
+		err = true;
+		coords.clear();
+		return 0;
+	}
+	vRead += n;
+	return n;
+}
+
+inline unsigned int MeshStreamReader::readPlyFaces(
+		std::vector<unsigned int>& faces,
+		std::vector<unsigned int>& faceSizes,
+		unsigned int maxFaces)
+{
+	if (fRead == 0 && fCursor == nullptr)
+		fCursor = plyElementStart(ply::FACE);
+	if (fCursor == nullptr){
+		err = true;
+		return 0;
+	}
+	const char* end = file.data() + file.size();
+	unsigned int n = (unsigned int)std::min((long long)maxFaces, numberFaces() - fRead);
+	bool ok = true;
+	for (unsigned int f = 0; f < n && ok; ++f){
+		for (const ply::Property& p : header.faceProperties()){
+			if (p.name == ply::vertex_indices && p.list){
+				unsigned int fSize = 0;
+				if (type == PLY_BINARY){
+					ok = ply::internal::readBinaryProperty(fCursor, end, p.listSizeType, swap, fSize);
+					for (unsigned int i = 0; i < fSize && ok; ++i){
+						unsigned int id;
+						ok = ply::internal::readBinaryProperty(fCursor, end, p.type, swap, id);
+						faces.push_back(id);
+					}
+				}
+				else {
+					double value;
+					ok = internal::readPlyAsciiValue(fCursor, end, value) && value >= 0;
+					fSize = ok ? (unsigned int)value : 0;
+					for (unsigned int i = 0; i < fSize && ok; ++i){
+						ok = internal::readPlyAsciiValue(fCursor, end, value) && value >= 0;
+						faces.push_back((unsigned int)value);
+					}
+				}
+				faceSizes.push_back(fSize);
+			}
+			else if (type == PLY_BINARY){
+				ok = ply::internal::skipBinaryProperty(fCursor, end, p, swap);
+			}
+			else {
+				ok = internal::skipPlyAsciiProperty(fCursor, end, p);
+			}
+			if (!ok)
+				break;
+		}
+	}
+	if (!ok){
+		err = true;
+		faces.clear();
+		faceSizes.clear();
+		return 0;
+	}
+	fRead += n;
+	return n;
+}
+
+} //namespace cg3
@@ -0,0 +1,105 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+#ifndef CG3_PLY_BINARY_H
+#define CG3_PLY_BINARY_H
+
+#include "ply.h"
+#include "ply_header.h"
+#include "../ascii_writer.h"
+#include <fstream>
+#include <vector>
+
+namespace cg3 {
+namespace ply {
+namespace internal {
+
+/*
+ * Block oriented access to the binary content of ply files.
+ *
+ * Binary elements are parsed from memory (a mapped file or a buffer holding
+ * the records of the element) instead of reading every property from the
+ * stream. When all the properties of an element have a fixed size, every
+ * property is converted with a loop specialized on its type over all the
+ * records of the element.
+ * Big endian files are supported: values are swapped when the endianness of
+ * the file differs from the one of the machine.
+ */
+
+bool isBigEndianMachine();
+unsigned int propertySize(PropertyType type);
+bool recordSize(const std::list<Property>& properties, unsigned int& size);
+
+template <typename T>
+bool readBinaryProperty(const char*& p, const char* end, PropertyType type, bool swap, T& value, bool isColor = false);
+
+bool skipBinaryProperty(const char*& p, const char* end, const Property& prop, bool swap);
+
+bool skipBinaryElement(const char*& p, const char* end, const Element& el, bool swap);
+
+template <typename T>
+void readBinaryColumn(
+		const char* data,
+		unsigned int stride,
+		unsigned int n,
+		PropertyType type,
+		bool swap,
+		T dest[],
+		unsigned int destStride,
+		bool isColor = false);
+
+template <typename F>
+bool parseBinaryStream(std::ifstream& file, const PlyHeader& header, ElementType type, F parse);
+
+/**
+ * @brief Collects the binary values of the properties written in a ply file,
+ * and writes them on the file in large blocks.
+ * Values are always written in little endian order.
+ */
+class BinaryWriter
+{
+public:
+	BinaryWriter(std::ofstream& file);
+	~BinaryWriter();
+
+	template <typename T>
+	void write(const T& value, PropertyType type, bool isColor = false);
+	void flush();
+
+private:
+	static const unsigned int BUFFER_SIZE = 1 << 16;
+
+	std::ofstream& file;
+	bool swap;
+	std::vector<char> buffer;
+	unsigned int size;
+};
+
+/**
+ * @brief Ascii counterpart of BinaryWriter: writes the values of the properties
+ * on an AsciiWriter, each one followed by a space.
+ * Integer properties are written as numbers (also char and uchar), with the
+ * same conversions applied by BinaryWriter.
+ */
+class AsciiPropertyWriter
+{
+public:
+	AsciiPropertyWriter(AsciiWriter& out);
+
+	template <typename T>
+	void write(const T& value, PropertyType type, bool isColor = false);
+
+private:
+	AsciiWriter& out;
+};
+
+} //namespace cg3::ply::internal
+} //namespace cg3::ply
+} //namespace cg3
+
+#include "ply_binary.inl"
+
+#endif // CG3_PLY_BINARY_H
@@ -0,0 +1,382 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+#include "ply_binary.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace cg3 {
+namespace ply {
+namespace internal {
+
+inline bool isBigEndianMachine()
+{
+	const uint16_t one = 1;
+	unsigned char first;
+	std::memcpy(&first, &one, 1);
+	return first == 0;
+}
+
+inline unsigned int propertySize(PropertyType type)
+{
+	switch (type) {
+		case CHAR:
+		case UCHAR:
+			return 1;
+		case SHORT:
+		case USHORT:
+			return 2;
+		case INT:
+		case UINT:
+		case FLOAT:
+			return 4;
+		case DOUBLE:
+			return 8;
+	}
+	return 0;
+}
+
+/**
+ * @brief Computes the size of the records of an element.
+ * @return false if the element contains list properties (variable size records)
+ */
+inline bool recordSize(const std::list<Property>& properties, unsigned int& size)
+{
+	size = 0;
+	for (const Property& p : properties){
+		if (p.list)
+			return false;
+		size += propertySize(p.type);
+	}
+	return true;
+}
+
+template <typename S>
+inline S loadValue(const char* p, bool swap)
+{
+	unsigned char b[sizeof(S)];
+	std::memcpy(b, p, sizeof(S));
+	if (swap){
+		for (unsigned int i = 0; i < sizeof(S) / 2; i++)
+			std::swap(b[i], b[sizeof(S) - 1 - i]);
+	}
+	S value;
+	std::memcpy(&value, b, sizeof(S));
+	return value;
+}
+
+template <typename S>
+inline void storeValue(char* p, S value, bool swap)
+{
+	unsigned char b[sizeof(S)];
+	std::memcpy(b, &value, sizeof(S));
+	if (swap){
+		for (unsigned int i = 0; i < sizeof(S) / 2; i++)
+			std::swap(b[i], b[sizeof(S) - 1 - i]);
+	}
+	std::memcpy(p, b, sizeof(S));
+}
+
+/*
+ * Conversion of a value read from a file of type S to T, with the same rules of
+ * readProperty(): floating point colors are in [0, 1], integer colors in [0, 255].
+ */
+template <typename S, typename T>
+inline T convertValue(S value, bool isColor)
+{
+	T p;
+	if (isColor && !std::is_integral<S>::value)
+		p = (T)(value * 255);
+	else
+		p = (T)value;
+	if (isColor && !std::is_integral<T>::value)
+		p = (float) p / 255.0;
+	return p;
+}
+
+/*
+ * Conversion of a value to the type D written in a file, with the same rules
+ * of writeProperty().
+ */
+template <typename D, typename T>
+inline D plyValue(T value, bool isColor)
+{
+	if (std::is_integral<D>::value){
+		if (isColor && !std::is_integral<T>::value) value *= 255;
+		return (D)value;
+	}
+	else {
+		D tmp = value;
+		if (isColor && std::is_integral<T>::value) tmp /= 255;
+		return tmp;
+	}
+}
+
+template <typename S, typename T>
+inline void readColumn(
+		const char* data,
+		unsigned int stride,
+		unsigned int n,
+		bool swap,
+		T dest[],
+		unsigned int destStride,
+		bool isColor)
+{
+	for (unsigned int i = 0; i < n; ++i, data += stride, dest += destStride)
+		*dest = convertValue<S, T>(loadValue<S>(data, swap), isColor);
+}
+
+/**
+ * @brief Reads a property of type type from n records of stride bytes, starting
+ * from data, and stores the values in dest[0], dest[destStride], dest[2*destStride], ...
+ * The type is dispatched once for all the records.
+ */
+template <typename T>
+void readBinaryColumn(
+		const char* data,
+		unsigned int stride,
+		unsigned int n,
+		PropertyType type,
+		bool swap,
+		T dest[],
+		unsigned int destStride,
+		bool isColor)
+{
+	switch (type) {
+		case CHAR:
+			readColumn<char>(data, stride, n, swap, dest, destStride, isColor); break;
+		case UCHAR:
+			readColumn<unsigned char>(data, stride, n, swap, dest, destStride, isColor); break;
+		case SHORT:
+			readColumn<short>(data, stride, n, swap, dest, destStride, isColor); break;
+		case USHORT:
+			readColumn<unsigned short>(data, stride, n, swap, dest, destStride, isColor); break;
+		case INT:
+			readColumn<int>(data, stride, n, swap, dest, destStride, isColor); break;
+		case UINT:
+			readColumn<unsigned int>(data, stride, n, swap, dest, destStride, isColor); break;
+		case FLOAT:
+			readColumn<float>(data, stride, n, swap, dest, destStride, isColor); break;
+		case DOUBLE:
+			readColumn<double>(data, stride, n, swap, dest, destStride, isColor); break;
+	}
+}
+
+/**
+ * @brief Reads a single property from p and advances p.
+ * @return false if the range [p, end) is too short
+ */
+template <typename T>
+inline bool readBinaryProperty(const char*& p, const char* end, PropertyType type, bool swap, T& value, bool isColor)
+{
+	if ((size_t)(end - p) < propertySize(type))
+		return false;
+	switch (type) {
+		case CHAR:
+			value = convertValue<char, T>(loadValue<char>(p, swap), isColor); break;
+		case UCHAR:
+			value = convertValue<unsigned char, T>(loadValue<unsigned char>(p, swap), isColor); break;
+		case SHORT:
+			value = convertValue<short, T>(loadValue<short>(p, swap), isColor); break;
+		case USHORT:
+			value = convertValue<unsigned short, T>(loadValue<unsigned short>(p, swap), isColor); break;
+		case INT:
+			value = convertValue<int, T>(loadValue<int>(p, swap), isColor); break;
+		case UINT:
+			value = convertValue<unsigned int, T>(loadValue<unsigned int>(p, swap), isColor); break;
+		case FLOAT:
+			value = convertValue<float, T>(loadValue<float>(p, swap), isColor); break;
+		case DOUBLE:
+			value = convertValue<double, T>(loadValue<double>(p, swap), isColor); break;
+	}
+	p += propertySize(type);
+	return true;
+}
+
+inline bool skipBinaryProperty(const char*& p, const char* end, const Property& prop, bool swap)
+{
+	if (prop.list){
+		unsigned int s;
+		if (!readBinaryProperty(p, end, prop.listSizeType, swap, s))
+			return false;
+		size_t size = (size_t)s * propertySize(prop.type);
+		if ((size_t)(end - p) < size)
+			return false;
+		p += size;
+	}
+	else {
+		if ((size_t)(end - p) < propertySize(prop.type))
+			return false;
+		p += propertySize(prop.type);
+	}
+	return true;
+}
+
+/**
+ * @brief Skips all the records of an element that is not loaded.
+ */
+inline bool skipBinaryElement(const char*& p, const char* end, const Element& el, bool swap)
+{
+	unsigned int size;
+	if (recordSize(el.properties, size)){
+		size_t total = (size_t)size * el.numberElements;
+		if ((size_t)(end - p) < total)
+			return false;
+		p += total;
+		return true;
+	}
+	for (unsigned int i = 0; i < el.numberElements; ++i){
+		for (const Property& prop : el.properties){
+			if (!skipBinaryProperty(p, end, prop, swap))
+				return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief Reads in memory the records of the element of the given type, which
+ * must start at the current position of the stream, and calls parse(p, end)
+ * on them. The stream is then positioned after the element.
+ *
+ * When all the properties of the element have a fixed size, the element is
+ * read with a single read. Otherwise the stream is read in chunks, scanning
+ * the sizes of the lists, until all the records are in memory: in both cases
+ * only the bytes of the element, and at most the last chunk after it, are read.
+ */
+template <typename F>
+bool parseBinaryStream(std::ifstream& file, const PlyHeader& header, ElementType type, F parse)
+{
+	const unsigned int CHUNK_SIZE = 1 << 16;
+	PlyHeader::iterator el = header.begin();
+	while (el != header.end() && el->type != type)
+		++el;
+	if (el == header.end())
+		return false;
+	bool swap = header.isBigEndian() != isBigEndianMachine();
+
+	std::streampos start = file.tellg();
+	std::vector<char> buffer;
+	size_t elementSize = 0;
+	unsigned int size;
+	if (recordSize(el->properties, size)){
+		elementSize = (size_t)size * el->numberElements;
+		buffer.resize(elementSize);
+		if (elementSize > 0 && !file.read(buffer.data(), elementSize))
+			return false;
+	}
+	else {
+		size_t read = 0;
+		for (unsigned int i = 0; i < el->numberElements; ){
+			const char* p = buffer.data() + elementSize;
+			const char* end = buffer.data() + read;
+			bool complete = true;
+			for (const Property& prop : el->properties)
+				complete = complete && skipBinaryProperty(p, end, prop, swap);
+			if (complete){
+				elementSize = p - buffer.data();
+				++i;
+			}
+			else {
+				//the record continues in the next chunk
+				buffer.resize(read + std::max<size_t>(CHUNK_SIZE, read / 2));
+				file.read(buffer.data() + read, buffer.size() - read);
+				if (file.gcount() == 0)
+					return false;
+				read += file.gcount();
+			}
+		}
+	}
+	const char* begin = buffer.data();
+	const char* p = begin;
+	bool ok = parse(p, begin + elementSize);
+	file.clear();
+	file.seekg(start + (std::streamoff)(p - begin));
+	return ok;
+}
+
+inline BinaryWriter::BinaryWriter(std::ofstream& file) :
+	file(file),
+	swap(isBigEndianMachine()),
+	buffer(BUFFER_SIZE),
+	size(0)
+{
+}
+
+inline BinaryWriter::~BinaryWriter()
+{
+	flush();
+}
+
+template <typename T>
+inline void BinaryWriter::write(const T& value, PropertyType type, bool isColor)
+{
+	if (size + 8 > BUFFER_SIZE)
+		flush();
+	char* p = buffer.data() + size;
+	switch (type) {
+		case CHAR:
+			storeValue(p, plyValue<char>(value, isColor), swap); break;
+		case UCHAR:
+			storeValue(p, plyValue<unsigned char>(value, isColor), swap); break;
+		case SHORT:
+			storeValue(p, plyValue<short>(value, isColor), swap); break;
+		case USHORT:
+			storeValue(p, plyValue<unsigned short>(value, isColor), swap); break;
+		case INT:
+			storeValue(p, plyValue<int>(value, isColor), swap); break;
+		case UINT:
+			storeValue(p, plyValue<unsigned int>(value, isColor), swap); break;
+		case FLOAT:
+			storeValue(p, plyValue<float>(value, isColor), swap); break;
+		case DOUBLE:
+			storeValue(p, plyValue<double>(value, isColor), swap); break;
+	}
+	size += propertySize(type);
+}
+
+inline void BinaryWriter::flush()
+{
+	if (size > 0)
+		file.write(buffer.data(), size);
+	size = 0;
+}
+
+inline AsciiPropertyWriter::AsciiPropertyWriter(AsciiWriter& out) :
+	out(out)
+{
+}
+
+template <typename T>
+inline void AsciiPropertyWriter::write(const T& value, PropertyType type, bool isColor)
+{
+	switch (type) {
+		case CHAR:
+			out << (int)plyValue<char>(value, isColor); break;
+		case UCHAR:
+			out << (unsigned int)plyValue<unsigned char>(value, isColor); break;
+		case SHORT:
+			out << (int)plyValue<short>(value, isColor); break;
+		case USHORT:
+			out << (unsigned int)plyValue<unsigned short>(value, isColor); break;
+		case INT:
+			out << plyValue<int>(value, isColor); break;
+		case UINT:
+			out << plyValue<unsigned int>(value, isColor); break;
+		case FLOAT:
+			out << plyValue<float>(value, isColor); break;
+		case DOUBLE:
+			out << plyValue<double>(value, isColor); break;
+	}
+	out << ' ';
+}
+
+} //namespace cg3::ply::internal
+} //namespace cg3::ply
+} //namespace cg3
@@ -8,6 +8,7 @@
 #define CG3_PLY_EDGE_H
 
 #include "ply_header.h"
+#include "ply_binary.h"
 #include "../file_commons.h"
 #include <cg3/utilities/tokenizer.h>
 #include <fstream>
@@ -25,6 +26,15 @@ bool loadEdgesTxt(
 		io::FileColorMode colorMod ,
 		B edgeColors[]);
 
+template <typename A, typename B>
+bool loadEdgesBin(
+		const char*& data,
+		const char* end,
+		const PlyHeader& header,
+		A edges[],
+		io::FileColorMode colorMod ,
+		B edgeColors[]);
+
 template <typename A, typename B>
 bool loadEdgesBin(
 		std::ifstream& file,
@@ -33,6 +43,31 @@ bool loadEdgesBin(
 		io::FileColorMode colorMod ,
 		B edgeColors[]);
 
+template <typename W, typename A, typename B>
+void writeEdge(
+		W& writer,
+		const PlyHeader& header,
+		uint e,
+		const A edges[],
+		uint colorStep,
+		const B edgeColors[]);
+
+template <typename A, typename B>
+void saveEdgesBin(
+		std::ofstream& file,
+		const PlyHeader& header,
+		const A edges[],
+		io::FileColorMode colorMod ,
+		const B edgeColors[]);
+
+template <typename A, typename B>
+void saveEdgesTxt(
+		std::ofstream& file,
+		const PlyHeader& header,
+		const A edges[],
+		io::FileColorMode colorMod ,
+		const B edgeColors[]);
+
 }
 
 template <typename A, typename B>
@@ -72,51 +72,166 @@ bool loadEdgesTxt(
 
 template <typename A, typename B>
 bool loadEdgesBin(
-		std::ifstream& file,
+		const char*& data,
+		const char* end,
 		const PlyHeader& header,
-		A edges[], //container with push_back method
+		A edges[],
 		io::FileColorMode colorMod ,
 		B edgeColors[])
 {
 	uint colorStep = 3;
 	if (colorMod == io::RGBA)
 		colorStep = 4;
-	for(uint e = 0; e < header.numberEdges(); ++e) {
-		for (ply::Property p : header.faceProperties()) {
+	bool swap = header.isBigEndian() != isBigEndianMachine();
+	uint nE = header.numberEdges();
+	uint size;
+	if (recordSize(header.edgeProperties(), size)){
+		//fixed size records: every property is read for all the edges at once
+		if ((size_t)(end - data) < (size_t)size * nE)
+			return false;
+		uint offset = 0;
+		for (const ply::Property& p : header.edgeProperties()) {
+			const char* column = data + offset;
 			switch (p.name) {
 			case ply::red :
-				edgeColors[e*colorStep] = internal::readProperty<B>(file, p.type); break;
+				readBinaryColumn(column, size, nE, p.type, swap, edgeColors, colorStep, true); break;
 			case ply::green :
-				edgeColors[e*colorStep+1] = internal::readProperty<B>(file, p.type); break;
+				readBinaryColumn(column, size, nE, p.type, swap, edgeColors+1, colorStep, true); break;
 			case ply::blue :
-				edgeColors[e*colorStep+2] = internal::readProperty<B>(file, p.type); break;
+				readBinaryColumn(column, size, nE, p.type, swap, edgeColors+2, colorStep, true); break;
 			case ply::alpha :
 				if (colorStep == 4)
-					edgeColors[e*colorStep+3] = internal::readProperty<B>(file, p.type);
+					readBinaryColumn(column, size, nE, p.type, swap, edgeColors+3, colorStep, true);
+				break;
+			case ply::vertex1 :
+				readBinaryColumn(column, size, nE, p.type, swap, edges, 2); break;
+			case ply::vertex2 :
+				readBinaryColumn(column, size, nE, p.type, swap, edges+1, 2); break;
+			default:
+				break;
+			}
+			offset += propertySize(p.type);
+		}
+		data += (size_t)size * nE;
+		return true;
+	}
+	for(uint e = 0; e < nE; ++e) {
+		for (const ply::Property& p : header.edgeProperties()) {
+			bool ok = true;
+			switch (p.name) {
+			case ply::red :
+				ok = readBinaryProperty(data, end, p.type, swap, edgeColors[e*colorStep], true); break;
+			case ply::green :
+				ok = readBinaryProperty(data, end, p.type, swap, edgeColors[e*colorStep+1], true); break;
+			case ply::blue :
+				ok = readBinaryProperty(data, end, p.type, swap, edgeColors[e*colorStep+2], true); break;
+			case ply::alpha :
+				if (colorStep == 4)
+					ok = readBinaryProperty(data, end, p.type, swap, edgeColors[e*colorStep+3], true);
 				else
-					internal::readProperty<B>(file, p.type);
-					;
+					ok = skipBinaryProperty(data, end, p, swap);
 				break;
 			case ply::vertex1:
-				edges[e*2] = internal::readProperty<A>(file, p.type); break;
+				ok = readBinaryProperty(data, end, p.type, swap, edges[e*2]); break;
 			case ply::vertex2:
-				edges[e*2+1] = internal::readProperty<A>(file, p.type); break;
+				ok = readBinaryProperty(data, end, p.type, swap, edges[e*2+1]); break;
 			case ply::unknown :
 			default:
-				if (p.list){
-					uint s = internal::readProperty<int>(file, p.listSizeType);
-					for (uint i = 0; i < s; ++i)
-						internal::readProperty<int>(file, p.type);
-				}
-				else {
-					internal::readProperty<int>(file, p.type);
-				}
+				ok = skipBinaryProperty(data, end, p, swap);
 			}
+			if (!ok)
+				return false;
 		}
 	}
 	return true;
 }
 
+template <typename A, typename B>
+bool loadEdgesBin(
+		std::ifstream& file,
+		const PlyHeader& header,
+		A edges[], //container with push_back method
+		io::FileColorMode colorMod ,
+		B edgeColors[])
+{
+	return parseBinaryStream(file, header, EDGE, [&](const char*& data, const char* end) {
+		return loadEdgesBin(data, end, header, edges, colorMod, edgeColors);
+	});
+}
+
+/**
+ * @brief Writes the properties of the edge e using writer, which can be a
+ * BinaryWriter or an AsciiPropertyWriter.
+ */
+template <typename W, typename A, typename B>
+void writeEdge(
+		W& writer,
+		const PlyHeader& header,
+		uint e,
+		const A edges[],
+		uint colorStep,
+		const B edgeColors[])
+{
+	for (const ply::Property& p : header.edgeProperties()) {
+		switch (p.name) {
+		case ply::red :
+			writer.write(edgeColors[e*colorStep], p.type, true); break;
+		case ply::green :
+			writer.write(edgeColors[e*colorStep+1], p.type, true); break;
+		case ply::blue :
+			writer.write(edgeColors[e*colorStep+2], p.type, true); break;
+		case ply::alpha :
+			if (colorStep == 4)
+				writer.write(edgeColors[e*colorStep+3], p.type, true);
+			else
+				writer.write((p.type < 6 ? 255 : 1), p.type, true);
+			break;
+		case ply::vertex1 :
+			writer.write(edges[e*2], p.type, true); break;
+		case ply::vertex2 :
+			writer.write(edges[e*2+1], p.type, true); break;
+		case ply::unknown :
+		default:
+			writer.write(0, p.type); break;
+		}
+	}
+}
+
+template <typename A, typename B>
+void saveEdgesBin(
+		std::ofstream& file,
+		const PlyHeader& header,
+		const A edges[],
+		io::FileColorMode colorMod ,
+		const B edgeColors[])
+{
+	BinaryWriter writer(file);
+	uint colorStep = colorMod == io::RGBA ? 4 : 3;
+	for(uint e = 0; e < header.numberEdges(); ++e)
+		writeEdge(writer, header, e, edges, colorStep, edgeColors);
+}
+
+/**
+ * @brief Writes the edges in ascii format, one per line. The lines are
+ * formatted in parallel.
+ */
+template <typename A, typename B>
+void saveEdgesTxt(
+		std::ofstream& file,
+		const PlyHeader& header,
+		const A edges[],
+		io::FileColorMode colorMod ,
+		const B edgeColors[])
+{
+	AsciiWriter out(file);
+	uint colorStep = colorMod == io::RGBA ? 4 : 3;
+	out.writeParallel(header.numberEdges(), [&](AsciiWriter& w, std::size_t e) {
+		AsciiPropertyWriter writer(w);
+		writeEdge(writer, header, e, edges, colorStep, edgeColors);
+		w << '\n';
+	});
+}
+
 } //namespace cg3::ply::internal
 
 template <typename A, typename B>
@@ -127,36 +242,12 @@ void saveEdges(
 		io::FileColorMode colorMod ,
 		const B edgeColors[])
 {
-	bool bin = header.format() == ply::BINARY;
-	uint colorStep = 3;
-	if (colorMod == io::RGBA)
-		colorStep = 4;
-	for(uint e = 0; e < header.numberEdges(); ++e) {
-		for (ply::Property p : header.edgeProperties()) {
-			switch (p.name) {
-			case ply::red :
-				internal::writeProperty(file, edgeColors[e*colorStep], p.type, bin, true); break;
-			case ply::green :
-				internal::writeProperty(file, edgeColors[e*colorStep+1], p.type, bin, true); break;
-			case ply::blue :
-				internal::writeProperty(file, edgeColors[e*colorStep+2], p.type, bin, true); break;
-			case ply::alpha :
-				if (colorStep == 4)
-					internal::writeProperty(file, edgeColors[e*colorStep+3], p.type, bin, true);
-				else
-					internal::writeProperty(file, (p.type < 6 ? 255 : 1), p.type, bin, true);
-					;
-				break;
-			case ply::vertex1 :
-				internal::writeProperty(file, edges[e*2], p.type, bin, true); break;
-			case ply::vertex2 :
-				internal::writeProperty(file, edges[e*2+1], p.type, bin, true); break;
-			case ply::unknown :
-			default:
-				internal::writeProperty(file, 0, p.type, bin); break;
-			}
-		}
-	}
+	if (!header.hasEdges())
+		return;
+	if (header.format() == ply::BINARY)
+		internal::saveEdgesBin(file, header, edges, colorMod, edgeColors);
+	else
+		internal::saveEdgesTxt(file, header, edges, colorMod, edgeColors);
 }
 
 template <typename A, typename B>
@@ -8,6 +8,7 @@
 #define CG3_PLY_FACE_H
 
 #include "ply_header.h"
+#include "ply_binary.h"
 #include "../file_commons.h"
 #include <cg3/utilities/tokenizer.h>
 #include <fstream>
@@ -49,6 +50,16 @@ bool loadFacesTxt(
 		C faceColors[],
 		D polygonSizes[]);
 
+template <template <typename... Args> class Container, typename A, typename D>
+bool loadFaceIndicesBin(
+		const char*& data,
+		const char* end,
+		Property p,
+		bool swap,
+		uint f,
+		Container<A>& faces,
+		D polygonSizes[]);
+
 template <template <typename... Args> class Container, typename A, typename D>
 bool loadFaceIndicesBin(
 		std::ifstream& file,
@@ -57,6 +68,18 @@ bool loadFaceIndicesBin(
 		Container<A>& faces,
 		D polygonSizes[]);
 
+template <typename A, typename B, typename C, typename D>
+bool loadFacesBin(
+		const char*& data,
+		const char* end,
+		const PlyHeader& header,
+		A& faces, //container with push_back method
+		io::FileMeshType& meshType,
+		B faceNormals[],
+		io::FileColorMode colorMod ,
+		C faceColors[],
+		D polygonSizes[]);
+
 template <typename A, typename B, typename C, typename D>
 bool loadFacesBin(
 		std::ifstream& file,
@@ -68,6 +91,41 @@ bool loadFacesBin(
 		C faceColors[],
 		D polygonSizes[]);
 
+template <typename W, typename A, typename B, typename C, typename D>
+void writeFace(
+		W& writer,
+		const PlyHeader& header,
+		uint f,
+		uint& startingIndex,
+		const A faces[],
+		const io::FileMeshMode& meshMode,
+		const B faceNormals[],
+		uint colorStep,
+		const C faceColors[],
+		const D polygonSizes[]);
+
+template <typename A, typename B, typename C, typename D>
+void saveFacesBin(
+		std::ofstream& file,
+		const PlyHeader& header,
+		const A faces[],
+		io::FileMeshMode meshMode,
+		const B faceNormals[],
+		io::FileColorMode colorMod ,
+		const C faceColors[],
+		const D polygonSizes[]);
+
+template <typename A, typename B, typename C, typename D>
+void saveFacesTxt(
+		std::ofstream& file,
+		const PlyHeader& header,
+		const A faces[],
+		io::FileMeshMode meshMode,
+		const B faceNormals[],
+		io::FileColorMode colorMod ,
+		const C faceColors[],
+		const D polygonSizes[]);
+
 } //namespace cg3::ply::internal
 
 template <typename A, typename B, typename C, typename D>
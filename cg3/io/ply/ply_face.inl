@@ -149,6 +149,34 @@ bool loadFacesTxt(
 	return true;
 }
 
+template <template <typename... Args> class Container, typename A, typename D>
+bool loadFaceIndicesBin(
+		const char*& data,
+		const char* end,
+		Property p,
+		bool swap,
+		uint f,
+		Container<A>& faces,
+		D polygonSizes[])
+{
+	if (!p.list) return false;
+
+	uint fsize;
+	if (!readBinaryProperty(data, end, p.listSizeType, swap, fsize))
+		return false;
+	polygonSizes[f] = fsize;
+
+	if ((size_t)(end - data) < (size_t)fsize * propertySize(p.type))
+		return false;
+	for (uint k = 0; k < fsize; ++k){
+		A index;
+		readBinaryProperty(data, end, p.type, swap, index);
+		faces.push_back(index);
+	}
+
+	return true;
+}
+
 template <template <typename... Args> class Container, typename A, typename D>
 bool loadFaceIndicesBin(
 		std::ifstream& file,
@@ -171,7 +199,8 @@ bool loadFaceIndicesBin(
 
 template <typename A, typename B, typename C, typename D>
 bool loadFacesBin(
-		std::ifstream& file,
+		const char*& data,
+		const char* end,
 		const PlyHeader& header,
 		A& faces,
 		io::FileMeshType& meshType,
@@ -183,41 +212,39 @@ bool loadFacesBin(
 	uint colorStep = 3;
 	if (colorMod == io::RGBA)
 		colorStep = 4;
+	bool swap = header.isBigEndian() != isBigEndianMachine();
+	//properties are visited once per face: a vector is faster than the header list
+	const std::vector<ply::Property> properties(header.faceProperties().begin(), header.faceProperties().end());
 	for(uint f = 0; f < header.numberFaces(); ++f) {
-		for (ply::Property p : header.faceProperties()) {
+		for (const ply::Property& p : properties) {
+			bool ok = true;
 			switch (p.name) {
 				case ply::nx :
-					faceNormals[f*3] = internal::readProperty<B>(file, p.type); break;
+					ok = readBinaryProperty(data, end, p.type, swap, faceNormals[f*3]); break;
 				case ply::ny :
-					faceNormals[f*3+1] = internal::readProperty<B>(file, p.type); break;
+					ok = readBinaryProperty(data, end, p.type, swap, faceNormals[f*3+1]); break;
 				case ply::nz :
-					faceNormals[f*3+2] = internal::readProperty<B>(file, p.type); break;
+					ok = readBinaryProperty(data, end, p.type, swap, faceNormals[f*3+2]); break;
 				case ply::red :
-					faceColors[f*colorStep] = internal::readProperty<C>(file, p.type); break;
+					ok = readBinaryProperty(data, end, p.type, swap, faceColors[f*colorStep], true); break;
 				case ply::green :
-					faceColors[f*colorStep+1] = internal::readProperty<C>(file, p.type); break;
+					ok = readBinaryProperty(data, end, p.type, swap, faceColors[f*colorStep+1], true); break;
 				case ply::blue :
-					faceColors[f*colorStep+2] = internal::readProperty<C>(file, p.type); break;
+					ok = readBinaryProperty(data, end, p.type, swap, faceColors[f*colorStep+2], true); break;
 				case ply::alpha :
 					if (colorStep == 4)
-						faceColors[f*colorStep+3] = internal::readProperty<C>(file, p.type);
+						ok = readBinaryProperty(data, end, p.type, swap, faceColors[f*colorStep+3], true);
 					else
-						internal::readProperty<C>(file, p.type);
-						;
+						ok = skipBinaryProperty(data, end, p, swap);
 					break;
 				case ply::vertex_indices :
-					loadFaceIndicesBin(file, p, f, faces, polygonSizes);
+					ok = loadFaceIndicesBin(data, end, p, swap, f, faces, polygonSizes);
 					break;
 				default:
-					if (p.list){
-						uint s = internal::readProperty<int>(file, p.listSizeType);
-						for (uint i = 0; i < s; ++i)
-							internal::readProperty<int>(file, p.type);
-					}
-					else {
-						internal::readProperty<int>(file, p.type);
-					}
+					ok = skipBinaryProperty(data, end, p, swap);
 			}
+			if (!ok)
+				return false;
 		}
 		if (f == 0){ //modify meshType
 			if (polygonSizes[f] == 3)
@@ -237,10 +264,87 @@ bool loadFacesBin(
 	return true;
 }
 
-} //namespace cg3::ply::internal
+template <typename A, typename B, typename C, typename D>
+bool loadFacesBin(
+		std::ifstream& file,
+		const PlyHeader& header,
+		A& faces,
+		io::FileMeshType& meshType,
+		B faceNormals[],
+		io::FileColorMode colorMod ,
+		C faceColors[],
+		D polygonSizes[])
+{
+	return parseBinaryStream(file, header, FACE, [&](const char*& data, const char* end) {
+		return loadFacesBin(data, end, header, faces, meshType, faceNormals, colorMod, faceColors, polygonSizes);
+	});
+}
+
+/**
+ * @brief Writes the properties of the face f using writer, which can be a
+ * BinaryWriter or an AsciiPropertyWriter.
+ * For polygon meshes, startingIndex must be the position of the first index of
+ * f in faces, and it is moved to the first index of the next face.
+ */
+template <typename W, typename A, typename B, typename C, typename D>
+void writeFace(
+		W& writer,
+		const PlyHeader& header,
+		uint f,
+		uint& startingIndex,
+		const A faces[],
+		const io::FileMeshMode& meshMode,
+		const B faceNormals[],
+		uint colorStep,
+		const C faceColors[],
+		const D polygonSizes[])
+{
+	for (const ply::Property& p : header.faceProperties()) {
+		switch (p.name) {
+			case ply::nx :
+				writer.write(faceNormals[f*3], p.type); break;
+			case ply::ny :
+				writer.write(faceNormals[f*3+1], p.type); break;
+			case ply::nz :
+				writer.write(faceNormals[f*3+2], p.type); break;
+			case ply::red :
+				writer.write(faceColors[f*colorStep], p.type, true); break;
+			case ply::green :
+				writer.write(faceColors[f*colorStep+1], p.type, true); break;
+			case ply::blue :
+				writer.write(faceColors[f*colorStep+2], p.type, true); break;
+			case ply::alpha :
+				if (colorStep == 4)
+					writer.write(faceColors[f*colorStep+3], p.type, true);
+				else
+					writer.write((p.type < 6 ? 255 : 1), p.type, true);
+				break;
+			case ply::vertex_indices : {
+				uint fsize;
+				if (meshMode.isTriangleMesh()){
+					fsize = 3; startingIndex = f*3;
+				}
+				else if (meshMode.isQuadMesh()) {
+					fsize = 4; startingIndex = f*4;
+				}
+				else {
+					fsize = polygonSizes[f];
+				}
+				writer.write(fsize, p.listSizeType);
+				for (uint k = 0; k < fsize; ++k)
+					writer.write(faces[startingIndex+k], p.type);
+				if (meshMode.isPolygonMesh())
+					startingIndex += polygonSizes[f];
+				break;
+			}
+			default:
+				writer.write(0, p.type); break;
+		}
+	}
+}
 
 template <typename A, typename B, typename C, typename D>
-void saveFaces(
+void saveFacesBin(
 		std::ofstream& file,
 		const PlyHeader& header,
 		const A faces[],
@@ -250,43 +354,66 @@ void saveFaces(
 		const C faceColors[],
 		const D polygonSizes[])
 {
-	bool bin = header.format() == ply::BINARY;
-	uint colorStep = 3;
+	BinaryWriter writer(file);
+	uint colorStep = colorMod == io::RGBA ? 4 : 3;
 	uint startingIndex = 0;
-	if (colorMod == io::RGBA)
-		colorStep = 4;
-	for(uint f = 0; f < header.numberFaces(); ++f) {
-		for (ply::Property p : header.faceProperties()) {
-			switch (p.name) {
-				case ply::nx :
-					internal::writeProperty(file, faceNormals[f*3], p.type, bin); break;
-				case ply::ny :
-					internal::writeProperty(file, faceNormals[f*3+1], p.type, bin); break;
-				case ply::nz :
-					internal::writeProperty(file, faceNormals[f*3+2], p.type, bin); break;
-				case ply::red :
-					internal::writeProperty(file, faceColors[f*colorStep], p.type, bin, true); break;
-				case ply::green :
-					internal::writeProperty(file, faceColors[f*colorStep+1], p.type, bin, true); break;
-				case ply::blue :
-					internal::writeProperty(file, faceColors[f*colorStep+2], p.type, bin, true); break;
-				case ply::alpha :
-					if (colorStep == 4)
-						internal::writeProperty(file, faceColors[f*colorStep+3], p.type, bin, true);
-					else
-						internal::writeProperty(file, (p.type < 6 ? 255 : 1), p.type, bin, true);
-						;
-					break;
-				case ply::vertex_indices :
-					internal::saveFaceIndices(file, p, f, startingIndex, faces, meshMode, polygonSizes, bin);
-					break;
-				default:
-					internal::writeProperty(file, 0, p.type, bin); break;
-			}
+	for(uint f = 0; f < header.numberFaces(); ++f)
+		writeFace(writer, header, f, startingIndex, faces, meshMode, faceNormals, colorStep, faceColors, polygonSizes);
+}
+
+/**
+ * @brief Writes the faces in ascii format, one per line. The lines are
+ * formatted in parallel, except for polygon meshes where the position of the
+ * indices of a face depends on the previous faces.
+ */
+template <typename A, typename B, typename C, typename D>
+void saveFacesTxt(
+		std::ofstream& file,
+		const PlyHeader& header,
+		const A faces[],
+		io::FileMeshMode meshMode,
+		const B faceNormals[],
+		io::FileColorMode colorMod ,
+		const C faceColors[],
+		const D polygonSizes[])
+{
+	AsciiWriter out(file);
+	uint colorStep = colorMod == io::RGBA ? 4 : 3;
+	if (meshMode.isPolygonMesh()){
+		uint startingIndex = 0;
+		AsciiPropertyWriter writer(out);
+		for(uint f = 0; f < header.numberFaces(); ++f) {
+			writeFace(writer, header, f, startingIndex, faces, meshMode, faceNormals, colorStep, faceColors, polygonSizes);
+			out << '\n';
 		}
-		if (!bin)
-			file << std::endl;
 	}
+	else {
+		out.writeParallel(header.numberFaces(), [&](AsciiWriter& w, std::size_t f) {
+			uint startingIndex = 0;
+			AsciiPropertyWriter writer(w);
+			writeFace(writer, header, f, startingIndex, faces, meshMode, faceNormals, colorStep, faceColors, polygonSizes);
+			w << '\n';
+		});
+	}
+}
+
+} //namespace cg3::ply::internal
+
+template <typename A, typename B, typename C, typename D>
+void saveFaces(
+		std::ofstream& file,
+		const PlyHeader& header,
+		const A faces[],
+		io::FileMeshMode meshMode,
+		const B faceNormals[],
+		io::FileColorMode colorMod ,
+		const C faceColors[],
+		const D polygonSizes[])
+{
+	if (header.format() == ply::BINARY)
+		internal::saveFacesBin(file, header, faces, meshMode, faceNormals, colorMod, faceColors, polygonSizes);
+	else
+		internal::saveFacesTxt(file, header, faces, meshMode, faceNormals, colorMod, faceColors, polygonSizes);
 }
 
 template <typename A, typename B, typename C, typename D>
@@ -13,6 +13,7 @@ namespace ply {
 
 CG3_INLINE PlyHeader::PlyHeader() :
 	_format(ply::UNKNOWN),
+	bigEndian(false),
 	isValid(false),
 	v(-1),
 	f(-1),
@@ -23,6 +24,7 @@ CG3_INLINE PlyHeader::PlyHeader() :
 
 CG3_INLINE PlyHeader::PlyHeader(ply::Format f, const ply::Element &vElement, const ply::Element fElement) :
 	_format(f),
+	bigEndian(false),
 	isValid(true),
 	v(0),
 	f(1),
@@ -35,6 +37,7 @@ CG3_INLINE PlyHeader::PlyHeader(ply::Format f, const ply::Element &vElement, con
 
 CG3_INLINE PlyHeader::PlyHeader(ply::Format f, const ply::Element &vElement, const ply::Element fElement, const ply::Element eElement) :
 	_format(f),
+	bigEndian(false),
 	isValid(true),
 	v(0),
 	f(1),
@@ -48,7 +51,11 @@ CG3_INLINE PlyHeader::PlyHeader(ply::Format f, const ply::Element &vElement, con
 
 CG3_INLINE PlyHeader::PlyHeader(std::ifstream &file) :
 	_format(ply::UNKNOWN),
-	isValid(false)
+	bigEndian(false),
+	isValid(false),
+	v(-1),
+	f(-1),
+	e(-1)
 {
 	std::setlocale(LC_NUMERIC, "en_US.UTF-8"); // makes sure "." is the decimal separator
 	if (file.is_open()){
@@ -71,6 +78,7 @@ CG3_INLINE PlyHeader::PlyHeader(std::ifstream &file) :
 							_format = ply::ASCII;
 						else if (*token == "binary_big_endian" || *token == "binary_little_endian" || *token == "binary")
 							_format = ply::BINARY;
+						bigEndian = *token == "binary_big_endian";
 					}
 					else if (headerLine == "element") { //new type of element read
 						if (!first){ //last element finished, save it
@@ -103,6 +111,7 @@ CG3_INLINE PlyHeader::PlyHeader(std::ifstream &file) :
 CG3_INLINE void PlyHeader::clear()
 {
 	_format = ply::UNKNOWN;
+	bigEndian = false;
 	elements.clear();
 	isValid = false;
 	v = -1;
@@ -148,6 +157,11 @@ CG3_INLINE ply::Format PlyHeader::format() const
 	return _format;
 }
 
+CG3_INLINE bool PlyHeader::isBigEndian() const
+{
+	return bigEndian;
+}
+
 CG3_INLINE const std::list<ply::Property> &PlyHeader::vertexProperties() const
 {
 	return elements[v].properties;
@@ -379,8 +393,11 @@ CG3_INLINE ply::Element PlyHeader::readElement(const Tokenizer &lineTokenizer) c
 		e.type = ply::EDGE;
 		e.numberElements = std::stoi(*(++token));
 	}
-	else
+	else {
 		e.type = ply::OTHER;
+		++token;
+		e.numberElements = token != lineTokenizer.end() ? std::stoi(*token) : 0;
+	}
 	return e;
 }
 
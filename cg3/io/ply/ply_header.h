@@ -38,6 +38,7 @@ public:
 	bool hasVertexAndFaceElements() const;
 	bool hasEdges() const;
 	ply::Format format() const;
+	bool isBigEndian() const;
 	const std::list<ply::Property>& vertexProperties() const;
 	const std::list<ply::Property>& faceProperties() const;
 	const std::list<ply::Property>& edgeProperties() const;
@@ -69,6 +70,7 @@ private:
 	std::string typeToString(ply::PropertyType t) const;
 
 	ply::Format _format;
+	bool bigEndian;
 	std::vector<ply::Element> elements;
 	bool isValid;
 	long int v, f, e;
@@ -8,6 +8,7 @@
 #define CG3_PLY_VERTEX_H
 
 #include "ply_header.h"
+#include "ply_binary.h"
 #include "../file_commons.h"
 #include <fstream>
 
@@ -25,6 +26,16 @@ bool loadVerticesTxt(
 		io::FileColorMode colorMod ,
 		C vertexColors[]);
 
+template <typename A, typename B, typename C>
+bool loadVerticesBin(
+		const char*& data,
+		const char* end,
+		const PlyHeader& header,
+		A vertices[],
+		B vertexNormals[],
+		io::FileColorMode colorMod ,
+		C vertexColors[]);
+
 template <typename A, typename B, typename C>
 bool loadVerticesBin(
 		std::ifstream& file,
@@ -34,6 +45,34 @@ bool loadVerticesBin(
 		io::FileColorMode colorMod ,
 		C vertexColors[]);
 
+template <typename W, typename A, typename B, typename C>
+void writeVertex(
+		W& writer,
+		const PlyHeader& header,
+		uint v,
+		const A vertices[],
+		const B vertexNormals[],
+		uint colorStep,
+		const C vertexColors[]);
+
+template <typename A, typename B, typename C>
+void saveVerticesBin(
+		std::ofstream& file,
+		const PlyHeader& header,
+		const A vertices[],
+		const B vertexNormals[],
+		io::FileColorMode colorMod ,
+		const C vertexColors[]);
+
+template <typename A, typename B, typename C>
+void saveVerticesTxt(
+		std::ofstream& file,
+		const PlyHeader& header,
+		const A vertices[],
+		const B vertexNormals[],
+		io::FileColorMode colorMod ,
+		const C vertexColors[]);
+
 } //namespace cg3::ply::internal
 
 template <typename A, typename B, typename C>
@@ -79,7 +79,8 @@ bool loadVerticesTxt(
 
 template <typename A, typename B, typename C>
 bool loadVerticesBin(
-		std::ifstream& file,
+		const char*& data,
+		const char* end,
 		const PlyHeader& header,
 		A vertices[],
 		B vertexNormals[],
@@ -89,98 +90,197 @@ bool loadVerticesBin(
 	uint colorStep = 3;
 	if (colorMod == io::RGBA)
 		colorStep = 4;
-	for(uint v = 0; v < header.numberVertices(); ++v) {
-		for (ply::Property p : header.vertexProperties()) {
+	bool swap = header.isBigEndian() != isBigEndianMachine();
+	uint nV = header.numberVertices();
+	uint size;
+	if (recordSize(header.vertexProperties(), size)){
+		//fixed size records: every property is read for all the vertices at once
+		if ((size_t)(end - data) < (size_t)size * nV)
+			return false;
+		uint offset = 0;
+		for (const ply::Property& p : header.vertexProperties()) {
+			const char* column = data + offset;
 			switch (p.name) {
 				case ply::x :
-					vertices[v*3] = internal::readProperty<A>(file, p.type); break;
+					readBinaryColumn(column, size, nV, p.type, swap, vertices, 3); break;
 				case ply::y :
-					vertices[v*3+1] = internal::readProperty<A>(file, p.type); break;
+					readBinaryColumn(column, size, nV, p.type, swap, vertices+1, 3); break;
 				case ply::z :
-					vertices[v*3+2] = internal::readProperty<A>(file, p.type); break;
+					readBinaryColumn(column, size, nV, p.type, swap, vertices+2, 3); break;
 				case ply::nx :
-					vertexNormals[v*3] = internal::readProperty<B>(file, p.type); break;
+					readBinaryColumn(column, size, nV, p.type, swap, vertexNormals, 3); break;
 				case ply::ny :
-					vertexNormals[v*3+1] = internal::readProperty<B>(file, p.type); break;
+					readBinaryColumn(column, size, nV, p.type, swap, vertexNormals+1, 3); break;
 				case ply::nz :
-					vertexNormals[v*3+2] = internal::readProperty<B>(file, p.type); break;
+					readBinaryColumn(column, size, nV, p.type, swap, vertexNormals+2, 3); break;
 				case ply::red :
-					vertexColors[v*colorStep] = internal::readProperty<C>(file, p.type, true); break;
+					readBinaryColumn(column, size, nV, p.type, swap, vertexColors, colorStep, true); break;
 				case ply::green :
-					vertexColors[v*colorStep+1] = internal::readProperty<C>(file, p.type, true); break;
+					readBinaryColumn(column, size, nV, p.type, swap, vertexColors+1, colorStep, true); break;
 				case ply::blue :
-					vertexColors[v*colorStep+2] = internal::readProperty<C>(file, p.type, true); break;
+					readBinaryColumn(column, size, nV, p.type, swap, vertexColors+2, colorStep, true); break;
 				case ply::alpha :
 					if (colorStep == 4)
-						vertexColors[v*colorStep+3] = internal::readProperty<C>(file, p.type, true);
-					else
-						internal::readProperty<C>(file, p.type, true); //read without save anywhere
+						readBinaryColumn(column, size, nV, p.type, swap, vertexColors+3, colorStep, true);
 					break;
 				default:
-					if (p.list){
-						uint s = internal::readProperty<int>(file, p.listSizeType);
-						for (uint i = 0; i < s; ++i)
-							internal::readProperty<int>(file, p.type);
-					}
-					else {
-						internal::readProperty<int>(file, p.type);
-					}
+					break;
 			}
+			offset += propertySize(p.type);
 		}
+		data += (size_t)size * nV;
+		return true;
 	}
-	return true;
-}
-
-} //namespace cg3::ply::internal
-
-template <typename A, typename B, typename C>
-void saveVertices(
-		std::ofstream& file,
-		const PlyHeader& header,
-		const A vertices[],
-		const B vertexNormals[],
-		io::FileColorMode colorMod ,
-		const C vertexColors[])
-{
-	bool bin = header.format() == ply::BINARY;
-	uint colorStep = 3;
-	if (colorMod == io::RGBA)
-		colorStep = 4;
-	for(uint v = 0; v < header.numberVertices(); ++v) {
-		for (ply::Property p : header.vertexProperties()) {
+	for(uint v = 0; v < nV; ++v) {
+		for (const ply::Property& p : header.vertexProperties()) {
+			bool ok = true;
 			switch (p.name) {
 				case ply::x :
-					internal::writeProperty(file, vertices[v*3], p.type, bin); break;
+					ok = readBinaryProperty(data, end, p.type, swap, vertices[v*3]); break;
 				case ply::y :
-					internal::writeProperty(file, vertices[v*3+1], p.type, bin); break;
+					ok = readBinaryProperty(data, end, p.type, swap, vertices[v*3+1]); break;
 				case ply::z :
-					internal::writeProperty(file, vertices[v*3+2], p.type, bin); break;
+					ok = readBinaryProperty(data, end, p.type, swap, vertices[v*3+2]); break;
 				case ply::nx :
-					internal::writeProperty(file, vertexNormals[v*3], p.type, bin); break;
+					ok = readBinaryProperty(data, end, p.type, swap, vertexNormals[v*3]); break;
 				case ply::ny :
-					internal::writeProperty(file, vertexNormals[v*3+1], p.type, bin); break;
+					ok = readBinaryProperty(data, end, p.type, swap, vertexNormals[v*3+1]); break;
 				case ply::nz :
-					internal::writeProperty(file, vertexNormals[v*3+2], p.type, bin); break;
+					ok = readBinaryProperty(data, end, p.type, swap, vertexNormals[v*3+2]); break;
 				case ply::red :
-					internal::writeProperty(file, vertexColors[v*colorStep], p.type, bin, true); break;
+					ok = readBinaryProperty(data, end, p.type, swap, vertexColors[v*colorStep], true); break;
 				case ply::green :
-					internal::writeProperty(file, vertexColors[v*colorStep+1], p.type, bin, true); break;
+					ok = readBinaryProperty(data, end, p.type, swap, vertexColors[v*colorStep+1], true); break;
 				case ply::blue :
-					internal::writeProperty(file, vertexColors[v*colorStep+2], p.type, bin, true); break;
+					ok = readBinaryProperty(data, end, p.type, swap, vertexColors[v*colorStep+2], true); break;
 				case ply::alpha :
 					if (colorStep == 4)
-						internal::writeProperty(file, vertexColors[v*colorStep+3], p.type, bin, true);
+						ok = readBinaryProperty(data, end, p.type, swap, vertexColors[v*colorStep+3], true);
 					else
-						internal::writeProperty(file, (p.type < 6 ? 255 : 1), p.type, bin, true);
-						;
+						ok = skipBinaryProperty(data, end, p, swap); //read without save anywhere
 					break;
 				default:
-					internal::writeProperty(file, 0, p.type, bin); break;
+					ok = skipBinaryProperty(data, end, p, swap);
 			}
+			if (!ok)
+				return false;
 		}
-		if (!bin)
-			file << std::endl;
 	}
+	return true;
+}
+
+template <typename A, typename B, typename C>
+bool loadVerticesBin(
+		std::ifstream& file,
+		const PlyHeader& header,
+		A vertices[],
+		B vertexNormals[],
+		io::FileColorMode colorMod ,
+		C vertexColors[])
+{
+	return parseBinaryStream(file, header, VERTEX, [&](const char*& data, const char* end) {
+		return loadVerticesBin(data, end, header, vertices, vertexNormals, colorMod, vertexColors);
+	});
+}
+
+/**
+ * @brief Writes the properties of the vertex v using writer, which can be a
+ * BinaryWriter or an AsciiPropertyWriter.
+ */
+template <typename W, typename A, typename B, typename C>
+void writeVertex(
+		W& writer,
+		const PlyHeader& header,
+		uint v,
+		const A vertices[],
+		const B vertexNormals[],
+		uint colorStep,
+		const C vertexColors[])
+{
+	for (const ply::Property& p : header.vertexProperties()) {
+		switch (p.name) {
+			case ply::x :
+				writer.write(vertices[v*3], p.type); break;
+			case ply::y :
+				writer.write(vertices[v*3+1], p.type); break;
+			case ply::z :
+				writer.write(vertices[v*3+2], p.type); break;
+			case ply::nx :
+				writer.write(vertexNormals[v*3], p.type); break;
+			case ply::ny :
+				writer.write(vertexNormals[v*3+1], p.type); break;
+			case ply::nz :
+				writer.write(vertexNormals[v*3+2], p.type); break;
+			case ply::red :
+				writer.write(vertexColors[v*colorStep], p.type, true); break;
+			case ply::green :
+				writer.write(vertexColors[v*colorStep+1], p.type, true); break;
+			case ply::blue :
+				writer.write(vertexColors[v*colorStep+2], p.type, true); break;
+			case ply::alpha :
+				if (colorStep == 4)
+					writer.write(vertexColors[v*colorStep+3], p.type, true);
+				else
+					writer.write((p.type < 6 ? 255 : 1), p.type, true);
+				break;
+			default:
+				writer.write(0, p.type); break;
+		}
+	}
+}
+
+template <typename A, typename B, typename C>
+void saveVerticesBin(
+		std::ofstream& file,
+		const PlyHeader& header,
+		const A vertices[],
+		const B vertexNormals[],
+		io::FileColorMode colorMod ,
+		const C vertexColors[])
+{
+	BinaryWriter writer(file);
+	uint colorStep = colorMod == io::RGBA ? 4 : 3;
+	for(uint v = 0; v < header.numberVertices(); ++v)
+		writeVertex(writer, header, v, vertices, vertexNormals, colorStep, vertexColors);
+}
+
+/**
+ * @brief Writes the vertices in ascii format, one per line. The lines are
+ * formatted in parallel.
+ */
+template <typename A, typename B, typename C>
+void saveVerticesTxt(
+		std::ofstream& file,
+		const PlyHeader& header,
+		const A vertices[],
+		const B vertexNormals[],
+		io::FileColorMode colorMod ,
+		const C vertexColors[])
+{
+	AsciiWriter out(file);
+	uint colorStep = colorMod == io::RGBA ? 4 : 3;
+	out.writeParallel(header.numberVertices(), [&](AsciiWriter& w, std::size_t v) {
+		AsciiPropertyWriter writer(w);
+		writeVertex(writer, header, v, vertices, vertexNormals, colorStep, vertexColors);
+		w << '\n';
+	});
+}
+
+} //namespace cg3::ply::internal
+
+template <typename A, typename B, typename C>
+void saveVertices(
+		std::ofstream& file,
+		const PlyHeader& header,
+		const A vertices[],
+		const B vertexNormals[],
+		io::FileColorMode colorMod ,
+		const C vertexColors[])
+{
+	if (header.format() == ply::BINARY)
+		internal::saveVerticesBin(file, header, vertices, vertexNormals, colorMod, vertexColors);
+	else
+		internal::saveVerticesTxt(file, header, vertices, vertexNormals, colorMod, vertexColors);
 }
 
 template <typename A, typename B, typename C>
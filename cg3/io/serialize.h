@@ -71,6 +71,29 @@ void deserialize(std::string& str, std::ifstream& binaryFile);
 
 namespace internal {
 
+/**
+ * @brief Tells if the serialized form of an object of type T is just the sequence
+ * of its bytes, as for primitive types and enums.
+ * Containers of these types are serialized (and deserialized) with a single
+ * write (read) of their whole data block.
+ *
+ * It can be specialized (inheriting from std::true_type) for trivially copyable
+ * types which are serialized by the generic cg3::serialize function (see
+ * CG3_IGNORE_TYPESAFE_SERIALIZATION_CHECK); it must not be specialized for types
+ * with a dedicated serialize function or derived from SerializableObject.
+ */
+template <typename T>
+struct isRawSerializable :
+        std::integral_constant<bool, std::is_fundamental<T>::value || std::is_enum<T>::value>
+{
+};
+
+template <typename T>
+void serializeRaw(const T data[], unsigned long long int n, std::ofstream& binaryFile);
+
+template <typename T>
+void deserializeRaw(T data[], unsigned long long int n, std::ifstream& binaryFile);
+
 template <typename T>
 std::string typeName(bool specifyIfConst = true, bool specifyIfVolatile = true, bool specifyIfReference = true);
 
@@ -398,6 +398,34 @@ inline void deserialize(std::string& str, std::ifstream& binaryFile)
 
 }
 
+/**
+ * @brief Writes the n objects of data with a single write of their bytes.
+ * The result is the same of calling serialize on every object, if T is a
+ * raw serializable type (see isRawSerializable).
+ */
+template <typename T>
+inline void internal::serializeRaw(
+        const T data[],
+        unsigned long long int n,
+        std::ofstream& binaryFile)
+{
+    binaryFile.write(reinterpret_cast<const char*>(data), n * sizeof(T));
+}
+
+/**
+ * @brief Reads n objects with a single read of their bytes.
+ * @throws std::ios_base::failure if the file does not contain n objects.
+ */
+template <typename T>
+inline void internal::deserializeRaw(
+        T data[],
+        unsigned long long int n,
+        std::ifstream& binaryFile)
+{
+    if (! binaryFile.read(reinterpret_cast<char*>(data), n * sizeof(T)))
+        throw std::ios_base::failure("Deserialization failed of a block of " + std::to_string(n) + " " + typeName<T>());
+}
+
 template<typename T>
 inline std::string internal::typeName(
         bool specifyIfConst,
@@ -0,0 +1,177 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#ifndef CG3_SERIALIZE_ARCHIVE_H
+#define CG3_SERIALIZE_ARCHIVE_H
+
+#include "serialize.h"
+#include "mapped_file.h"
+
+#include <map>
+#include <streambuf>
+
+namespace cg3 {
+
+namespace internal {
+
+/**
+ * @brief Read-only stream buffer on a range of memory, which supports
+ * seeking (tellg, seekg). The memory is not copied.
+ */
+class MemoryInputBuffer : public std::streambuf
+{
+public:
+    MemoryInputBuffer(const char* begin, const char* end);
+
+protected:
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which);
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which);
+};
+
+/**
+ * @brief Stream buffer that appends the written characters to a vector.
+ * The current position (tellp) can be queried, but not changed.
+ */
+class MemoryOutputBuffer : public std::streambuf
+{
+public:
+    MemoryOutputBuffer(std::vector<char>& buffer);
+
+protected:
+    int_type overflow(int_type c);
+    std::streamsize xsputn(const char* s, std::streamsize n);
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which);
+
+private:
+    std::vector<char>& buffer;
+};
+
+/**
+ * @brief An entry of the table of contents of an archive.
+ */
+struct ArchiveEntry
+{
+    unsigned long long int offset; //from the beginning of the archive
+    unsigned long long int size;   //bytes
+    unsigned long long int elementSize; //0 for objects, sizeof(T) for arrays of T
+};
+
+} //namespace cg3::internal
+
+/**
+ * @ingroup cg3core
+ * @brief Writes a binary archive of named objects, on a file or in memory.
+ *
+ * Every object is stored with cg3::serialize(), therefore any type that can be
+ * serialized on a std::ofstream (primitive types, std containers, Eigen matrices,
+ * SerializableObjects like Dcel, Graph, Array, RegularLattice3D...) can be stored
+ * in an archive, without any change to its serialize function.
+ * Arrays of primitive types can also be stored as raw, aligned blocks that
+ * ArchiveReader returns without copying them.
+ *
+ * A table of contents, written by close(), allows ArchiveReader to load any
+ * object by its name, without reading the other ones.
+ *
+ * @code
+ * cg3::ArchiveWriter archive("scene.cg3a");
+ * archive.write("cg3Dcel", dcel);
+ * archive.writeArray("distances", distances.data(), distances.size());
+ * archive.close();
+ * @endcode
+ *
+ * @see ArchiveReader
+ */
+class ArchiveWriter
+{
+public:
+    ArchiveWriter();
+    ArchiveWriter(const std::string& filename);
+    ArchiveWriter(const ArchiveWriter& other) = delete;
+    ~ArchiveWriter();
+
+    ArchiveWriter& operator= (const ArchiveWriter& other) = delete;
+
+    template <typename T>
+    void write(const std::string& name, const T& obj);
+
+    template <typename T>
+    void writeArray(const std::string& name, const T data[], unsigned long long int n);
+
+    void close();
+    bool isClosed() const;
+    const std::vector<char>& buffer() const;
+
+private:
+    void beginEntry(const std::string& name);
+    void endEntry(const std::string& name, unsigned long long int elementSize);
+    void align();
+    unsigned long long int position();
+
+    std::vector<char> memory;
+    internal::MemoryOutputBuffer memoryBuffer;
+    std::ofstream stream;
+    std::map<std::string, internal::ArchiveEntry> toc;
+    unsigned long long int entryBegin;
+    bool closed;
+};
+
+/**
+ * @ingroup cg3core
+ * @brief Read-only access to a binary archive written by ArchiveWriter, which
+ * can be a memory mapped file or a block of memory.
+ *
+ * Objects are loaded by name in any order, reading only the bytes of the
+ * loaded object; arrays stored with ArchiveWriter::writeArray can be accessed
+ * in place, without copying them.
+ *
+ * @code
+ * cg3::ArchiveReader archive("scene.cg3a");
+ * cg3::Dcel dcel;
+ * archive.read("cg3Dcel", dcel);
+ * unsigned long long int n;
+ * const double* distances = archive.array<double>("distances", n);
+ * @endcode
+ */
+class ArchiveReader
+{
+public:
+    ArchiveReader();
+    ArchiveReader(const std::string& filename);
+    ArchiveReader(const char* data, std::size_t size);
+
+    bool open(const std::string& filename);
+    bool open(const char* data, std::size_t size);
+    void close();
+    bool isOpen() const;
+
+    bool contains(const std::string& name) const;
+    std::vector<std::string> names() const;
+
+    template <typename T>
+    void read(const std::string& name, T& obj) const;
+
+    template <typename T>
+    const T* array(const std::string& name, unsigned long long int& n) const;
+
+    template <typename T>
+    void readArray(const std::string& name, std::vector<T>& v) const;
+
+private:
+    bool readTableOfContents();
+    const internal::ArchiveEntry& entry(const std::string& name) const;
+
+    MappedFile file;
+    const char* begin;
+    std::size_t length;
+    std::map<std::string, internal::ArchiveEntry> toc;
+};
+
+} //namespace cg3
+
+#include "serialize_archive.inl"
+
+#endif // CG3_SERIALIZE_ARCHIVE_H
@@ -0,0 +1,450 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#include "serialize_archive.h"
+
+#include <cstdint>
+#include <cstring>
+
+namespace cg3 {
+
+namespace internal {
+
+/*
+ * Layout of an archive:
+ *
+ * - header: magic string (8 bytes), version (8 bytes);
+ * - entries: the serialized objects and the raw arrays, the latter aligned to
+ *   ARCHIVE_ALIGNMENT bytes from the beginning of the archive;
+ * - table of contents: number of entries, then for each entry its name (as a
+ *   serialized std::string), offset, size and element size (8 bytes each);
+ * - footer: offset of the table of contents (8 bytes), magic string (8 bytes).
+ *
+ * Numbers are stored in the byte order of the machine, as in cg3::serialize.
+ */
+const char ARCHIVE_MAGIC[8] = {'c', 'g', '3', 'a', 'r', 'c', 'h', '\0'};
+const unsigned long long int ARCHIVE_VERSION = 1;
+const unsigned long long int ARCHIVE_ALIGNMENT = 64;
+
+inline MemoryInputBuffer::MemoryInputBuffer(const char* begin, const char* end)
+{
+    char* b = const_cast<char*>(begin);
+    setg(b, b, const_cast<char*>(end));
+}
+
+inline MemoryInputBuffer::pos_type MemoryInputBuffer::seekoff(
+        off_type off,
+        std::ios_base::seekdir dir,
+        std::ios_base::openmode which)
+{
+    if (!(which & std::ios_base::in))
+        return pos_type(off_type(-1));
+    off_type pos = off;
+    if (dir == std::ios_base::cur)
+        pos += gptr() - eback();
+    else if (dir == std::ios_base::end)
+        pos += egptr() - eback();
+    if (pos < 0 || pos > egptr() - eback())
+        return pos_type(off_type(-1));
+    setg(eback(), eback() + pos, egptr());
+    return pos_type(pos);
+}
+
+inline MemoryInputBuffer::pos_type MemoryInputBuffer::seekpos(
+        pos_type pos,
+        std::ios_base::openmode which)
+{
+    return seekoff(off_type(pos), std::ios_base::beg, which);
+}
+
+inline MemoryOutputBuffer::MemoryOutputBuffer(std::vector<char>& buffer) :
+    buffer(buffer)
+{
+}
+
+inline MemoryOutputBuffer::int_type MemoryOutputBuffer::overflow(int_type c)
+{
+    if (!traits_type::eq_int_type(c, traits_type::eof()))
+        buffer.push_back(traits_type::to_char_type(c));
+    return traits_type::not_eof(c);
+}
+
+inline std::streamsize MemoryOutputBuffer::xsputn(const char* s, std::streamsize n)
+{
+    buffer.insert(buffer.end(), s, s + n);
+    return n;
+}
+
+inline MemoryOutputBuffer::pos_type MemoryOutputBuffer::seekoff(
+        off_type off,
+        std::ios_base::seekdir dir,
+        std::ios_base::openmode which)
+{
+    if (off != 0 || dir != std::ios_base::cur || !(which & std::ios_base::out))
+        return pos_type(off_type(-1));
+    return pos_type(off_type(buffer.size()));
+}
+
+inline unsigned long long int loadArchiveNumber(const char* p)
+{
+    unsigned long long int n;
+    std::memcpy(&n, p, sizeof(n));
+    return n;
+}
+
+} //namespace cg3::internal
+
+/**
+ * @brief Creates an archive in memory. Its content can be accessed with
+ * buffer() after close().
+ */
+inline ArchiveWriter::ArchiveWriter() :
+    memoryBuffer(memory),
+    entryBegin(0),
+    closed(false)
+{
+    stream.std::ios::rdbuf(&memoryBuffer);
+    stream.write(internal::ARCHIVE_MAGIC, sizeof(internal::ARCHIVE_MAGIC));
+    serialize(internal::ARCHIVE_VERSION, stream);
+}
+
+/**
+ * @brief Creates an archive on the given file.
+ * @throws std::ios_base::failure if the file cannot be created.
+ */
+inline ArchiveWriter::ArchiveWriter(const std::string& filename) :
+    memoryBuffer(memory),
+    entryBegin(0),
+    closed(false)
+{
+    stream.open(filename, std::ios::out | std::ios::binary);
+    if (!stream.is_open())
+        throw std::ios_base::failure("Cannot create file " + filename);
+    stream.write(internal::ARCHIVE_MAGIC, sizeof(internal::ARCHIVE_MAGIC));
+    serialize(internal::ARCHIVE_VERSION, stream);
+}
+
+/**
+ * @brief Closes the archive, if close() has not been called.
+ */
+inline ArchiveWriter::~ArchiveWriter()
+{
+    try {
+        close();
+    }
+    catch(...){
+    }
+}
+
+/**
+ * @brief Stores obj in the archive with the given name, using cg3::serialize.
+ *
+ * The name usually is the id of the object passed to serializeObjectAttributes.
+ * @throws std::ios_base::failure if the archive has been closed, if it already
+ * contains an object with the same name or if the object cannot be written.
+ */
+template <typename T>
+inline void ArchiveWriter::write(const std::string& name, const T& obj)
+{
+    beginEntry(name);
+    serialize(obj, stream);
+    endEntry(name, 0);
+}
+
+/**
+ * @brief Stores the n elements of data in the archive with the given name, as
+ * a raw block of memory aligned to 64 bytes. ArchiveReader::array() returns a
+ * pointer to the block, without copying it.
+ *
+ * T must be a primitive type (see internal::isRawSerializable).
+ * @throws std::ios_base::failure if the archive has been closed, if it already
+ * contains an object with the same name or if the array cannot be written.
+ */
+template <typename T>
+inline void ArchiveWriter::writeArray(
+        const std::string& name,
+        const T data[],
+        unsigned long long int n)
+{
+    static_assert(internal::isRawSerializable<T>::value,
+                  "Only arrays of primitive types can be stored as raw arrays");
+    beginEntry(name);
+    align();
+    entryBegin = position();
+    internal::serializeRaw(data, n, stream);
+    endEntry(name, sizeof(T));
+}
+
+/**
+ * @brief Writes the table of contents and, if the archive is a file, closes it.
+ * No objects can be added after this call.
+ */
+inline void ArchiveWriter::close()
+{
+    if (closed)
+        return;
+    closed = true;
+    unsigned long long int tocOffset = position();
+    unsigned long long int n = toc.size();
+    serialize(n, stream);
+    for (const std::pair<const std::string, internal::ArchiveEntry>& e : toc){
+        serialize(e.first, stream);
+        serialize(e.second.offset, stream);
+        serialize(e.second.size, stream);
+        serialize(e.second.elementSize, stream);
+    }
+    serialize(tocOffset, stream);
+    stream.write(internal::ARCHIVE_MAGIC, sizeof(internal::ARCHIVE_MAGIC));
+    bool ok = stream.good();
+    if (stream.is_open())
+        stream.close();
+    if (!ok)
+        throw std::ios_base::failure("Cannot write the archive table of contents");
+}
+
+inline bool ArchiveWriter::isClosed() const
+{
+    return closed;
+}
+
+/**
+ * @brief Returns the content of an archive created in memory.
+ */
+inline const std::vector<char>& ArchiveWriter::buffer() const
+{
+    return memory;
+}
+
+inline void ArchiveWriter::beginEntry(const std::string& name)
+{
+    if (closed)
+        throw std::ios_base::failure("Cannot write " + name + ": the archive is closed");
+    if (toc.find(name) != toc.end())
+        throw std::ios_base::failure("The archive already contains " + name);
+    entryBegin = position();
+}
+
+inline void ArchiveWriter::endEntry(const std::string& name, unsigned long long int elementSize)
+{
+    if (!stream.good())
+        throw std::ios_base::failure("Cannot write " + name + " in the archive");
+    internal::ArchiveEntry& e = toc[name];
+    e.offset = entryBegin;
+    e.size = position() - entryBegin;
+    e.elementSize = elementSize;
+}
+
+/**
+ * @brief Pads the archive with zeros up to a multiple of ARCHIVE_ALIGNMENT bytes.
+ */
+inline void ArchiveWriter::align()
+{
+    static const char zeros[internal::ARCHIVE_ALIGNMENT] = {};
+    unsigned long long int rem = position() % internal::ARCHIVE_ALIGNMENT;
+    if (rem != 0)
+        stream.write(zeros, internal::ARCHIVE_ALIGNMENT - rem);
+}
+
+inline unsigned long long int ArchiveWriter::position()
+{
+    return (unsigned long long int) stream.tellp();
+}
+
+inline ArchiveReader::ArchiveReader() :
+    begin(nullptr),
+    length(0)
+{
+}
+
+inline ArchiveReader::ArchiveReader(const std::string& filename) :
+    ArchiveReader()
+{
+    open(filename);
+}
+
+inline ArchiveReader::ArchiveReader(const char* data, std::size_t size) :
+    ArchiveReader()
+{
+    open(data, size);
+}
+
+/**
+ * @brief Opens (memory maps) an archive file.
+ * @return true if the file has been opened and it is a valid archive
+ */
+inline bool ArchiveReader::open(const std::string& filename)
+{
+    close();
+    if (!file.open(filename))
+        return false;
+    begin = file.data();
+    length = file.size();
+    if (!readTableOfContents()){
+        close();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Opens an archive stored in memory (e.g. ArchiveWriter::buffer()).
+ * The memory is not copied, and it must be valid until the reader is closed.
+ * @return true if the memory contains a valid archive
+ */
+inline bool ArchiveReader::open(const char* data, std::size_t size)
+{
+    close();
+    begin = data;
+    length = size;
+    if (!readTableOfContents()){
+        close();
+        return false;
+    }
+    return true;
+}
+
+inline void ArchiveReader::close()
+{
+    file.close();
+    begin = nullptr;
+    length = 0;
+    toc.clear();
+}
+
+inline bool ArchiveReader::isOpen() const
+{
+    return begin != nullptr;
+}
+
+inline bool ArchiveReader::contains(const std::string& name) const
+{
+    return toc.find(name) != toc.end();
+}
+
+/**
+ * @brief Returns the names of the objects contained in the archive, in
+ * lexicographic order.
+ */
+inline std::vector<std::string> ArchiveReader::names() const
+{
+    std::vector<std::string> n;
+    n.reserve(toc.size());
+    for (const std::pair<const std::string, internal::ArchiveEntry>& e : toc)
+        n.push_back(e.first);
+    return n;
+}
+
+/**
+ * @brief Loads the object with the given name, using cg3::deserialize.
+ * Only the bytes of the object are read.
+ * @throws std::ios_base::failure if the archive does not contain the object
+ * or if the object cannot be deserialized.
+ */
+template <typename T>
+inline void ArchiveReader::read(const std::string& name, T& obj) const
+{
+    const internal::ArchiveEntry& e = entry(name);
+    internal::MemoryInputBuffer buffer(begin + e.offset, begin + e.offset + e.size);
+    std::ifstream stream;
+    stream.std::ios::rdbuf(&buffer);
+    try {
+        deserialize(obj, stream);
+    }
+    catch(std::ios_base::failure& ex){
+        throw std::ios_base::failure(ex.what() + std::string("\nFrom archive entry ") + name);
+    }
+}
+
+/**
+ * @brief Returns a pointer to the array stored with the given name by
+ * ArchiveWriter::writeArray, and sets n to its number of elements.
+ * The array is not copied: the pointer is valid until the reader is closed.
+ * @throws std::ios_base::failure if the archive does not contain an array of
+ * T with the given name.
+ */
+template <typename T>
+inline const T* ArchiveReader::array(const std::string& name, unsigned long long int& n) const
+{
+    const internal::ArchiveEntry& e = entry(name);
+    const char* p = begin + e.offset;
+    if (e.elementSize != sizeof(T))
+        throw std::ios_base::failure("Archive entry " + name + " is not an array of " + internal::typeName<T>());
+    if (reinterpret_cast<std::uintptr_t>(p) % alignof(T) != 0)
+        throw std::ios_base::failure("Archive entry " + name + " is not aligned in memory");
+    n = e.size / sizeof(T);
+    return reinterpret_cast<const T*>(p);
+}
+
+/**
+ * @brief Copies in v the array stored with the given name by
+ * ArchiveWriter::writeArray.
+ * @throws std::ios_base::failure if the archive does not contain an array of
+ * T with the given name.
+ */
+template <typename T>
+inline void ArchiveReader::readArray(const std::string& name, std::vector<T>& v) const
+{
+    const internal::ArchiveEntry& e = entry(name);
+    if (e.elementSize != sizeof(T))
+        throw std::ios_base::failure("Archive entry " + name + " is not an array of " + internal::typeName<T>());
+    std::vector<T> tmp(e.size / sizeof(T));
+    std::memcpy(tmp.data(), begin + e.offset, tmp.size() * sizeof(T));
+    v = std::move(tmp);
+}
+
+/**
+ * @brief Checks header and footer of the archive and loads its table of
+ * contents, checking that every entry lies inside the archive.
+ */
+inline bool ArchiveReader::readTableOfContents()
+{
+    const std::size_t headerSize = sizeof(internal::ARCHIVE_MAGIC) + 8;
+    const std::size_t footerSize = 8 + sizeof(internal::ARCHIVE_MAGIC);
+    if (begin == nullptr || length < headerSize + 8 + footerSize)
+        return false;
+    const char* end = begin + length;
+    if (std::memcmp(begin, internal::ARCHIVE_MAGIC, sizeof(internal::ARCHIVE_MAGIC)) != 0 ||
+            std::memcmp(end - sizeof(internal::ARCHIVE_MAGIC), internal::ARCHIVE_MAGIC, sizeof(internal::ARCHIVE_MAGIC)) != 0)
+        return false;
+    if (internal::loadArchiveNumber(begin + sizeof(internal::ARCHIVE_MAGIC)) != internal::ARCHIVE_VERSION)
+        return false;
+    const unsigned long long int tocEnd = length - footerSize;
+    unsigned long long int pos = internal::loadArchiveNumber(end - footerSize);
+    if (pos < headerSize || pos + 8 > tocEnd)
+        return false;
+    unsigned long long int n = internal::loadArchiveNumber(begin + pos);
+    pos += 8;
+    for (unsigned long long int i = 0; i < n; ++i){
+        if (pos + 8 > tocEnd)
+            return false;
+        unsigned long long int nameSize = internal::loadArchiveNumber(begin + pos);
+        pos += 8;
+        if (nameSize > tocEnd - pos || tocEnd - pos - nameSize < 24)
+            return false;
+        std::string name(begin + pos, nameSize);
+        pos += nameSize;
+        internal::ArchiveEntry e;
+        e.offset = internal::loadArchiveNumber(begin + pos);
+        e.size = internal::loadArchiveNumber(begin + pos + 8);
+        e.elementSize = internal::loadArchiveNumber(begin + pos + 16);
+        pos += 24;
+        if (e.offset < headerSize || e.offset > tocEnd || e.size > tocEnd - e.offset)
+            return false;
+        toc[name] = e;
+    }
+    return true;
+}
+
+inline const internal::ArchiveEntry& ArchiveReader::entry(const std::string& name) const
+{
+    std::map<std::string, internal::ArchiveEntry>::const_iterator it = toc.find(name);
+    if (it == toc.end())
+        throw std::ios_base::failure("The archive does not contain " + name);
+    return it->second;
+}
+
+} //namespace cg3
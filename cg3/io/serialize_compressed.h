@@ -0,0 +1,181 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#ifndef CG3_SERIALIZE_COMPRESSED_H
+#define CG3_SERIALIZE_COMPRESSED_H
+
+#include "serialize.h"
+#include "../utilities/parallel.h"
+
+#include <cstdint>
+#include <streambuf>
+
+namespace cg3 {
+
+namespace internal {
+
+std::uint32_t crc32(const char* data, std::size_t size);
+
+void compressBlock(const char* src, std::size_t size, std::vector<char>& dst);
+
+bool decompressBlock(const char* src, std::size_t size, char* dst, std::size_t dstSize);
+
+/**
+ * @brief Stream buffer that compresses the written bytes in independent
+ * blocks, and writes them on another stream buffer. The blocks of a batch
+ * are compressed in parallel.
+ */
+class CompressionBuffer : public std::streambuf
+{
+public:
+    CompressionBuffer(std::size_t blockSize, unsigned int nThreads);
+
+    void setSink(std::streambuf* sink);
+    bool flushBatch();
+
+protected:
+    int_type overflow(int_type c);
+    int sync();
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which);
+
+private:
+    std::streambuf* sink;
+    std::size_t blockSize;
+    unsigned int nThreads;
+    std::vector<char> batch;
+    std::vector<std::vector<char>> compressed;
+    std::vector<std::uint32_t> checksums;
+    unsigned long long int written; //uncompressed bytes already flushed
+};
+
+/**
+ * @brief Stream buffer that reads and decompresses the blocks written by a
+ * CompressionBuffer. The blocks of a batch are decompressed in parallel.
+ *
+ * Seeking (used by deserialize to restore the position after an error) is
+ * supported on every position of the blocks already read, and forward.
+ *
+ * Every block is verified with its CRC-32: a corrupted or truncated block
+ * makes underflow (and seeking) throw std::ios_base::failure, which the
+ * stream reports by setting its badbit.
+ */
+class DecompressionBuffer : public std::streambuf
+{
+public:
+    DecompressionBuffer(unsigned int nThreads);
+
+    void setSource(std::streambuf* source);
+
+protected:
+    int_type underflow();
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which);
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which);
+
+private:
+    struct Block {
+        unsigned long long int rawBegin;   //position in the uncompressed stream
+        unsigned long long int fileOffset; //position of the header in the source
+        unsigned int rawSize;
+        unsigned int storedSize;
+        std::uint32_t checksum;            //CRC-32 of the uncompressed bytes
+    };
+
+    bool loadBatch(std::size_t firstBlock);
+    bool readBlockHeader(std::size_t b);
+
+    std::streambuf* source;
+    unsigned int nThreads;
+    std::vector<Block> blocks;
+    std::vector<char> batch;
+    std::vector<std::vector<char>> stored;
+    unsigned long long int sourcePos;  //current position of the source
+    unsigned long long int batchBegin; //position of batch[0] in the uncompressed stream
+    std::size_t nextBlock;             //first block after the current batch
+};
+
+} //namespace cg3::internal
+
+/**
+ * @ingroup cg3core
+ * @brief std::ofstream that compresses everything written on it.
+ *
+ * Since it is a std::ofstream, any object can be serialized on it with the
+ * usual cg3::serialize functions (or SerializableObject::serialize):
+ *
+ * @code
+ * cg3::CompressedOfstream file("mesh.dcelz");
+ * dcel.serialize(file);
+ * file.close();
+ * @endcode
+ *
+ * The data is split in blocks that are compressed independently with a
+ * LZ77 codec (no external dependencies), in parallel, each one with the
+ * CRC-32 of its content. The file can be read with CompressedIfstream.
+ *
+ * @warning open() and close() hide the non-virtual members of std::ofstream:
+ * they must be called on a CompressedOfstream, not through a std::ofstream
+ * reference or pointer. std::ofstream::close() would close the file without
+ * writing the blocks still buffered, losing them. Writing and flushing through
+ * a std::ofstream (or std::ostream) reference are safe.
+ */
+class CompressedOfstream : public std::ofstream
+{
+public:
+    static const std::size_t DEFAULT_BLOCK_SIZE = 1 << 20;
+
+    CompressedOfstream(
+            unsigned int nThreads = numberOfThreads(),
+            std::size_t blockSize = DEFAULT_BLOCK_SIZE);
+    CompressedOfstream(
+            const std::string& filename,
+            unsigned int nThreads = numberOfThreads(),
+            std::size_t blockSize = DEFAULT_BLOCK_SIZE);
+    ~CompressedOfstream();
+
+    void open(const std::string& filename);
+    void close();
+
+private:
+    internal::CompressionBuffer buffer;
+};
+
+/**
+ * @ingroup cg3core
+ * @brief std::ifstream that decompresses a file written by CompressedOfstream.
+ *
+ * @code
+ * cg3::CompressedIfstream file("mesh.dcelz");
+ * dcel.deserialize(file);
+ * @endcode
+ *
+ * The blocks are decompressed in parallel, some blocks ahead of the current
+ * position. A block that does not match its checksum sets the badbit of the
+ * stream (deserialize functions then throw std::ios_base::failure).
+ *
+ * @warning open() and close() hide the non-virtual members of std::ifstream:
+ * they must be called on a CompressedIfstream, not through a std::ifstream
+ * reference or pointer: std::ifstream::open() would not read the header of
+ * the file and would leave the decompression buffer on its previous state.
+ */
+class CompressedIfstream : public std::ifstream
+{
+public:
+    CompressedIfstream(unsigned int nThreads = numberOfThreads());
+    CompressedIfstream(const std::string& filename, unsigned int nThreads = numberOfThreads());
+
+    void open(const std::string& filename);
+    void close();
+
+private:
+    internal::DecompressionBuffer buffer;
+};
+
+} //namespace cg3
+
+#include "serialize_compressed.inl"
+
+#endif // CG3_SERIALIZE_COMPRESSED_H
@@ -0,0 +1,617 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#include "serialize_compressed.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace cg3 {
+
+namespace internal {
+
+/*
+ * Layout of a compressed file: magic string (8 bytes), then a sequence of
+ * blocks. Every block has a header with its uncompressed size, its stored
+ * size and the CRC-32 of its uncompressed bytes (4 bytes each), followed by
+ * the stored bytes. If the two sizes are equal the block is stored
+ * uncompressed. The uncompressed size of a block is at most
+ * COMPRESSED_MAX_BLOCK_SIZE, so that a corrupted header cannot make the reader
+ * allocate more than that before the checksum is verified.
+ *
+ * A compressed block is a sequence of LZ77 sequences, each one made of:
+ * - a token: number of literals (4 high bits) and match length - 4 (4 low
+ *   bits); the value 15 means that the length continues with the following
+ *   bytes, summed until a byte different from 255;
+ * - the literals;
+ * - the offset of the match (2 bytes, little endian) and the continuation
+ *   of the match length.
+ * The last sequence has only literals.
+ */
+const char COMPRESSED_MAGIC[8] = {'c', 'g', '3', 'b', 'l', 'z', '\0', '2'};
+const std::size_t COMPRESSED_MAX_BLOCK_SIZE = 1 << 20;
+const unsigned int LZ_HASH_BITS = 14;
+const std::size_t LZ_MIN_MATCH = 4;
+const std::size_t LZ_LAST_LITERALS = 5; //a block always ends with literals
+const std::size_t LZ_MATCH_START_LIMIT = 12;
+const std::size_t LZ_MAX_OFFSET = 65535;
+
+/**
+ * @brief Computes the CRC-32 (ISO-HDLC, as zlib) of size bytes of data, with
+ * the slicing-by-8 algorithm.
+ */
+inline std::uint32_t crc32(const char* data, std::size_t size)
+{
+    struct Tables {
+        std::uint32_t t[8][256];
+        Tables() {
+            for (std::uint32_t i = 0; i < 256; ++i){
+                std::uint32_t c = i;
+                for (int k = 0; k < 8; ++k)
+                    c = (c >> 1) ^ (0xEDB88320u & (0u - (c & 1)));
+                t[0][i] = c;
+            }
+            for (std::uint32_t i = 0; i < 256; ++i)
+                for (int k = 1; k < 8; ++k)
+                    t[k][i] = (t[k-1][i] >> 8) ^ t[0][t[k-1][i] & 0xFF];
+        }
+    };
+    static const Tables tables;
+    const std::uint32_t (&t)[8][256] = tables.t;
+
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+    std::uint32_t c = 0xFFFFFFFFu;
+    for (; size >= 8; size -= 8, p += 8){
+        const std::uint32_t lo = c ^ (p[0] | (p[1] << 8) | (p[2] << 16) | ((std::uint32_t)p[3] << 24));
+        c = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+            t[3][p[4]] ^ t[2][p[5]] ^ t[1][p[6]] ^ t[0][p[7]];
+    }
+    for (; size > 0; --size, ++p)
+        c = (c >> 8) ^ t[0][(c ^ *p) & 0xFF];
+    return c ^ 0xFFFFFFFFu;
+}
+
+inline std::uint32_t lzRead32(const unsigned char* p)
+{
+    std::uint32_t v;
+    std::memcpy(&v, p, 4);
+    return v;
+}
+
+inline unsigned int lzHash(std::uint32_t v)
+{
+    return (v * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+inline void lzWriteLength(std::vector<char>& dst, std::size_t length)
+{
+    for (; length >= 255; length -= 255)
+        dst.push_back((char)255);
+    dst.push_back((char)length);
+}
+
+inline void lzWriteSequence(
+        std::vector<char>& dst,
+        const unsigned char* literals,
+        std::size_t nLiterals,
+        std::size_t offset,
+        std::size_t matchLength)
+{
+    std::size_t ml = matchLength - LZ_MIN_MATCH;
+    unsigned char token = (unsigned char)((std::min<std::size_t>(nLiterals, 15) << 4) |
+                                          (matchLength ? std::min<std::size_t>(ml, 15) : 0));
+    dst.push_back((char)token);
+    if (nLiterals >= 15)
+        lzWriteLength(dst, nLiterals - 15);
+    dst.insert(dst.end(), literals, literals + nLiterals);
+    if (matchLength){
+        dst.push_back((char)(offset & 0xFF));
+        dst.push_back((char)(offset >> 8));
+        if (ml >= 15)
+            lzWriteLength(dst, ml - 15);
+    }
+}
+
+inline bool lzReadLength(const unsigned char*& ip, const unsigned char* end, std::size_t& length)
+{
+    unsigned char s;
+    do {
+        if (ip >= end)
+            return false;
+        s = *ip++;
+        length += s;
+    } while (s == 255);
+    return true;
+}
+
+/**
+ * @brief Compresses size bytes of src in dst (which is overwritten).
+ * If compression does not reduce the size, dst contains a copy of src.
+ */
+inline void compressBlock(const char* src, std::size_t size, std::vector<char>& dst)
+{
+    dst.clear();
+    if (size <= LZ_MATCH_START_LIMIT){
+        dst.assign(src, src + size);
+        return;
+    }
+    dst.reserve(size);
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(src);
+    const std::size_t matchLimit = size - LZ_LAST_LITERALS;
+    const std::size_t startLimit = size - LZ_MATCH_START_LIMIT;
+    std::vector<std::uint32_t> table(1 << LZ_HASH_BITS, 0);
+    std::size_t ip = 0, anchor = 0;
+
+    while (ip < startLimit){
+        std::uint32_t seq = lzRead32(in + ip);
+        unsigned int h = lzHash(seq);
+        std::size_t ref = table[h];
+        table[h] = (std::uint32_t)ip;
+        if (ref < ip && ip - ref <= LZ_MAX_OFFSET && lzRead32(in + ref) == seq){
+            std::size_t length = LZ_MIN_MATCH;
+            while (ip + length < matchLimit && in[ref + length] == in[ip + length])
+                ++length;
+            while (ip > anchor && ref > 0 && in[ip-1] == in[ref-1]){
+                --ip; --ref; ++length;
+            }
+            lzWriteSequence(dst, in + anchor, ip - anchor, ip - ref, length);
+            ip += length;
+            anchor = ip;
+            if (ip < startLimit)
+                table[lzHash(lzRead32(in + ip - 2))] = (std::uint32_t)(ip - 2);
+        }
+        else {
+            //skip faster on incompressible data
+            ip += 1 + ((ip - anchor) >> 6);
+        }
+    }
+    lzWriteSequence(dst, in + anchor, size - anchor, 0, 0);
+
+    if (dst.size() >= size)
+        dst.assign(src, src + size);
+}
+
+/**
+ * @brief Decompresses a block produced by compressBlock (not stored
+ * uncompressed), which must expand to exactly dstSize bytes.
+ * @return false if the block is corrupted
+ */
+inline bool decompressBlock(const char* src, std::size_t size, char* dst, std::size_t dstSize)
+{
+    const unsigned char* ip = reinterpret_cast<const unsigned char*>(src);
+    const unsigned char* end = ip + size;
+    unsigned char* op = reinterpret_cast<unsigned char*>(dst);
+    unsigned char* const begin = op;
+    unsigned char* const oend = op + dstSize;
+
+    while (ip < end){
+        unsigned char token = *ip++;
+        std::size_t nLiterals = token >> 4;
+        if (nLiterals == 15 && !lzReadLength(ip, end, nLiterals))
+            return false;
+        if ((std::size_t)(end - ip) < nLiterals || (std::size_t)(oend - op) < nLiterals)
+            return false;
+        std::memcpy(op, ip, nLiterals);
+        ip += nLiterals;
+        op += nLiterals;
+        if (ip == end)
+            break;
+
+        if (end - ip < 2)
+            return false;
+        std::size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > (std::size_t)(op - begin))
+            return false;
+        std::size_t length = token & 15;
+        if (length == 15 && !lzReadLength(ip, end, length))
+            return false;
+        length += LZ_MIN_MATCH;
+        if ((std::size_t)(oend - op) < length)
+            return false;
+        const unsigned char* match = op - offset;
+        if (offset >= length){
+            std::memcpy(op, match, length);
+        }
+        else { //overlapping copy: repeats the last offset bytes
+            for (std::size_t i = 0; i < length; ++i)
+                op[i] = match[i];
+        }
+        op += length;
+    }
+    return op == oend;
+}
+
+inline CompressionBuffer::CompressionBuffer(std::size_t blockSize, unsigned int nThreads) :
+    sink(nullptr),
+    blockSize(std::max<std::size_t>(std::min<std::size_t>(blockSize, COMPRESSED_MAX_BLOCK_SIZE), 1)),
+    nThreads(std::max(nThreads, 1u)),
+    batch(this->blockSize * this->nThreads),
+    compressed(this->nThreads),
+    checksums(this->nThreads),
+    written(0)
+{
+    setp(batch.data(), batch.data() + batch.size());
+}
+
+/**
+ * @brief Sets the stream buffer on which the compressed blocks are written.
+ * Without a sink (nullptr), every write and sync fails.
+ */
+inline void CompressionBuffer::setSink(std::streambuf* sink)
+{
+    this->sink = sink;
+    written = 0;
+    if (sink == nullptr)
+        setp(nullptr, nullptr);
+    else
+        setp(batch.data(), batch.data() + batch.size());
+}
+
+/**
+ * @brief Compresses in parallel the blocks collected so far, and writes them
+ * on the sink.
+ */
+inline bool CompressionBuffer::flushBatch()
+{
+    std::size_t size = pptr() - pbase();
+    if (size == 0)
+        return true;
+    if (sink == nullptr)
+        return false;
+    parallelForChunks(
+        size,
+        blockSize,
+        [&](std::size_t c, std::size_t b, std::size_t e) {
+            compressBlock(pbase() + b, e - b, compressed[c]);
+            checksums[c] = crc32(pbase() + b, e - b);
+        },
+        nThreads);
+    bool ok = true;
+    std::size_t nBlocks = numberOfChunks(size, blockSize);
+    for (std::size_t c = 0; c < nBlocks && ok; ++c){
+        std::uint32_t header[3];
+        header[0] = (std::uint32_t)std::min(blockSize, size - c * blockSize);
+        header[1] = (std::uint32_t)compressed[c].size();
+        header[2] = checksums[c];
+        ok = sink->sputn(reinterpret_cast<const char*>(header), sizeof(header)) == (std::streamsize)sizeof(header) &&
+             sink->sputn(compressed[c].data(), compressed[c].size()) == (std::streamsize)compressed[c].size();
+    }
+    written += size;
+    setp(batch.data(), batch.data() + batch.size());
+    return ok;
+}
+
+inline CompressionBuffer::int_type CompressionBuffer::overflow(int_type c)
+{
+    if (sink == nullptr || !flushBatch())
+        return traits_type::eof();
+    if (!traits_type::eq_int_type(c, traits_type::eof())){
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+    }
+    return traits_type::not_eof(c);
+}
+
+inline int CompressionBuffer::sync()
+{
+    if (sink == nullptr || !flushBatch())
+        return -1;
+    return sink->pubsync();
+}
+
+inline CompressionBuffer::pos_type CompressionBuffer::seekoff(
+        off_type off,
+        std::ios_base::seekdir dir,
+        std::ios_base::openmode which)
+{
+    if (off != 0 || dir != std::ios_base::cur || !(which & std::ios_base::out))
+        return pos_type(off_type(-1));
+    return pos_type(off_type(written + (pptr() - pbase())));
+}
+
+inline DecompressionBuffer::DecompressionBuffer(unsigned int nThreads) :
+    source(nullptr),
+    nThreads(std::max(nThreads, 1u)),
+    stored(this->nThreads),
+    sourcePos(0),
+    batchBegin(0),
+    nextBlock(0)
+{
+    setg(nullptr, nullptr, nullptr);
+}
+
+/**
+ * @brief Sets the stream buffer from which the blocks are read, starting from
+ * its current position.
+ */
+inline void DecompressionBuffer::setSource(std::streambuf* source)
+{
+    this->source = source;
+    blocks.clear();
+    batchBegin = 0;
+    nextBlock = 0;
+    sourcePos = 0;
+    if (source != nullptr){
+        off_type p = source->pubseekoff(0, std::ios_base::cur, std::ios_base::in);
+        sourcePos = p < 0 ? 0 : (unsigned long long int)p;
+    }
+    setg(nullptr, nullptr, nullptr);
+    Block first;
+    first.rawBegin = 0;
+    first.fileOffset = sourcePos;
+    first.rawSize = 0;
+    first.storedSize = 0;
+    first.checksum = 0;
+    blocks.push_back(first); //sentinel: end of the blocks read so far
+}
+
+inline DecompressionBuffer::int_type DecompressionBuffer::underflow()
+{
+    if (gptr() < egptr())
+        return traits_type::to_int_type(*gptr());
+    if (!loadBatch(nextBlock))
+        return traits_type::eof();
+    return traits_type::to_int_type(*gptr());
+}
+
+inline DecompressionBuffer::pos_type DecompressionBuffer::seekoff(
+        off_type off,
+        std::ios_base::seekdir dir,
+        std::ios_base::openmode which)
+{
+    if (!(which & std::ios_base::in) || dir == std::ios_base::end)
+        return pos_type(off_type(-1));
+    off_type target = off;
+    if (dir == std::ios_base::cur)
+        target += (off_type)batchBegin + (gptr() - eback());
+    if (target < 0)
+        return pos_type(off_type(-1));
+    unsigned long long int t = (unsigned long long int)target;
+
+    if (t < batchBegin || t > batchBegin + (egptr() - eback())){
+        const std::size_t nRead = blocks.size() - 1;
+        if (t < blocks[nRead].rawBegin){
+            //block already read: binary search on the beginnings of the blocks
+            std::size_t b = std::upper_bound(
+                        blocks.begin(), blocks.begin() + nRead, t,
+                        [](unsigned long long int v, const Block& bl) { return v < bl.rawBegin; })
+                    - blocks.begin() - 1;
+            if (!loadBatch(b))
+                return pos_type(off_type(-1));
+        }
+        else {
+            do {
+                if (!loadBatch(nextBlock))
+                    return pos_type(off_type(-1));
+            } while (t > batchBegin + (egptr() - eback()));
+        }
+    }
+    setg(eback(), eback() + (t - batchBegin), egptr());
+    return pos_type(target);
+}
+
+inline DecompressionBuffer::pos_type DecompressionBuffer::seekpos(
+        pos_type pos,
+        std::ios_base::openmode which)
+{
+    return seekoff(off_type(pos), std::ios_base::beg, which);
+}
+
+/**
+ * @brief Reads the header of block b, which starts at the current position of
+ * the source. If b is a new block, it is added to the list of the blocks read.
+ * The last element of blocks is a sentinel with the positions after the last
+ * block read.
+ * @return false if the source ends before the header
+ * @throws std::ios_base::failure if the header is truncated or not valid
+ */
+inline bool DecompressionBuffer::readBlockHeader(std::size_t b)
+{
+    std::uint32_t header[3];
+    std::streamsize read = source->sgetn(reinterpret_cast<char*>(header), sizeof(header));
+    if (read == 0)
+        return false;
+    if (read != (std::streamsize)sizeof(header))
+        throw std::ios_base::failure("Truncated block in compressed stream");
+    if (header[0] == 0 || header[0] > COMPRESSED_MAX_BLOCK_SIZE || header[1] == 0 || header[1] > header[0])
+        throw std::ios_base::failure("Corrupted block in compressed stream");
+    sourcePos += sizeof(header);
+    if (b == blocks.size() - 1){
+        Block& bl = blocks[b];
+        bl.rawSize = header[0];
+        bl.storedSize = header[1];
+        bl.checksum = header[2];
+        Block next;
+        next.rawBegin = bl.rawBegin + bl.rawSize;
+        next.fileOffset = bl.fileOffset + sizeof(header) + bl.storedSize;
+        next.rawSize = 0;
+        next.storedSize = 0;
+        next.checksum = 0;
+        blocks.push_back(next);
+    }
+    if (blocks[b].rawSize != header[0] || blocks[b].storedSize != header[1] ||
+            blocks[b].checksum != header[2])
+        throw std::ios_base::failure("Corrupted block in compressed stream");
+    return true;
+}
+
+/**
+ * @brief Reads up to nThreads blocks starting from firstBlock, and decompresses
+ * them in parallel in the get area.
+ * @return false if there are no more blocks
+ * @throws std::ios_base::failure if a block is truncated, has a header which
+ * is not valid, cannot be decompressed or does not match its checksum
+ */
+inline bool DecompressionBuffer::loadBatch(std::size_t firstBlock)
+{
+    if (source == nullptr || firstBlock >= blocks.size())
+        return false;
+    if (blocks[firstBlock].fileOffset != sourcePos){
+        off_type p = source->pubseekpos(off_type(blocks[firstBlock].fileOffset), std::ios_base::in);
+        if (p < 0)
+            return false;
+        sourcePos = blocks[firstBlock].fileOffset;
+    }
+    std::size_t n = 0;
+    for (; n < nThreads; ++n){
+        std::size_t b = firstBlock + n;
+        if (!readBlockHeader(b))
+            break;
+        std::vector<char>& s = stored[n];
+        s.resize(blocks[b].storedSize);
+        std::streamsize read = source->sgetn(s.data(), s.size());
+        if (read > 0)
+            sourcePos += read;
+        if (read != (std::streamsize)s.size())
+            throw std::ios_base::failure("Truncated block in compressed stream");
+    }
+    if (n == 0)
+        return false;
+
+    const unsigned long long int begin = blocks[firstBlock].rawBegin;
+    batch.resize(blocks[firstBlock + n].rawBegin - begin);
+    std::vector<char> ok(n, 0);
+    parallelFor(
+        0,
+        n,
+        [&](std::size_t k) {
+            const Block& bl = blocks[firstBlock + k];
+            char* dst = batch.data() + (bl.rawBegin - begin);
+            if (bl.storedSize == bl.rawSize){
+                std::memcpy(dst, stored[k].data(), bl.rawSize);
+                ok[k] = 1;
+            }
+            else {
+                ok[k] = decompressBlock(stored[k].data(), bl.storedSize, dst, bl.rawSize);
+            }
+            ok[k] = ok[k] && crc32(dst, bl.rawSize) == bl.checksum;
+        },
+        1,
+        nThreads);
+    if (std::find(ok.begin(), ok.end(), 0) != ok.end())
+        throw std::ios_base::failure("Corrupted block in compressed stream");
+    batchBegin = begin;
+    nextBlock = firstBlock + n;
+    setg(batch.data(), batch.data(), batch.data() + batch.size());
+    return true;
+}
+
+} //namespace cg3::internal
+
+/**
+ * @param nThreads: number of threads used to compress the blocks
+ * @param blockSize: size in bytes of the (uncompressed) blocks, at most 1MB
+ */
+inline CompressedOfstream::CompressedOfstream(unsigned int nThreads, std::size_t blockSize) :
+    buffer(blockSize, nThreads)
+{
+}
+
+/**
+ * @brief Creates (overwrites) the given file.
+ * @param nThreads: number of threads used to compress the blocks
+ * @param blockSize: size in bytes of the (uncompressed) blocks, at most 1MB
+ */
+inline CompressedOfstream::CompressedOfstream(
+        const std::string& filename,
+        unsigned int nThreads,
+        std::size_t blockSize) :
+    CompressedOfstream(nThreads, blockSize)
+{
+    open(filename);
+}
+
+inline CompressedOfstream::~CompressedOfstream()
+{
+    close();
+}
+
+/**
+ * @brief Creates (overwrites) the given file. If the file cannot be created,
+ * the failbit of the stream is set.
+ */
+inline void CompressedOfstream::open(const std::string& filename)
+{
+    close();
+    std::ofstream::open(filename, std::ios::out | std::ios::binary);
+    if (!is_open())
+        return;
+    std::streambuf* file = std::ofstream::rdbuf();
+    file->sputn(internal::COMPRESSED_MAGIC, sizeof(internal::COMPRESSED_MAGIC));
+    buffer.setSink(file);
+    std::ios::rdbuf(&buffer);
+}
+
+/**
+ * @brief Compresses and writes the remaining data, and closes the file.
+ * Writing on the stream after close() sets its badbit, as for a closed
+ * std::ofstream.
+ */
+inline void CompressedOfstream::close()
+{
+    if (!is_open())
+        return;
+    bool flushed = buffer.flushBatch();
+    buffer.setSink(nullptr);
+    //rdbuf() clears the state of the stream
+    std::ios::iostate state = rdstate();
+    std::ios::rdbuf(std::ofstream::rdbuf());
+    setstate(flushed ? state : state | std::ios::badbit);
+    std::ofstream::close();
+}
+
+/**
+ * @param nThreads: number of threads used to decompress the blocks
+ */
+inline CompressedIfstream::CompressedIfstream(unsigned int nThreads) :
+    buffer(nThreads)
+{
+}
+
+/**
+ * @brief Opens the given file.
+ * @param nThreads: number of threads used to decompress the blocks
+ */
+inline CompressedIfstream::CompressedIfstream(const std::string& filename, unsigned int nThreads) :
+    CompressedIfstream(nThreads)
+{
+    open(filename);
+}
+
+/**
+ * @brief Opens the given file. If the file cannot be opened or it is not a
+ * compressed file, the failbit of the stream is set.
+ */
+inline void CompressedIfstream::open(const std::string& filename)
+{
+    close();
+    std::ifstream::open(filename, std::ios::in | std::ios::binary);
+    if (!is_open())
+        return;
+    std::streambuf* file = std::ifstream::rdbuf();
+    char magic[sizeof(internal::COMPRESSED_MAGIC)];
+    bool valid = file->sgetn(magic, sizeof(magic)) == (std::streamsize)sizeof(magic) &&
+            std::memcmp(magic, internal::COMPRESSED_MAGIC, sizeof(magic)) == 0;
+    buffer.setSource(file);
+    std::ios::rdbuf(&buffer);
+    if (!valid)
+        setstate(std::ios::failbit);
+}
+
+inline void CompressedIfstream::close()
+{
+    buffer.setSource(nullptr);
+    std::ios::iostate state = rdstate();
+    std::ios::rdbuf(std::ifstream::rdbuf());
+    setstate(state);
+    if (is_open())
+        std::ifstream::close();
+}
+
+} //namespace cg3
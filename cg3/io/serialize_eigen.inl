@@ -18,9 +18,20 @@ inline void internal::serializeEigen(
     serialize("EigenMatrix", binaryFile);
     serialize(row, binaryFile);
     serialize(col, binaryFile);
-    for (unsigned int i = 0; i < row; i++){
-        for (unsigned int j = 0; j < col; ++j){
-            serialize(m(i,j), binaryFile);
+    //the matrix is stored row by row
+    if (T::IsRowMajor || row <= 1 || col <= 1){
+        internal::serializeRaw(m.data(), row * col, binaryFile);
+    }
+    else {
+        //column major: rows are copied in a row major buffer of bounded size
+        typedef typename T::Scalar Scalar;
+        typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMatrix;
+        const unsigned long long int rowsPerBlock = std::max(1ull, (1ull << 16) / col);
+        RowMatrix buffer;
+        for (unsigned long long int i = 0; i < row; i += rowsPerBlock){
+            unsigned long long int n = std::min(rowsPerBlock, row - i);
+            buffer = m.middleRows(i, n);
+            internal::serializeRaw(buffer.data(), n * col, binaryFile);
         }
     }
 }
@@ -41,12 +52,22 @@ inline void internal::deserializeEigen(
         deserialize(col, binaryFile);
         tmp.resize(row, col);
 
-        for (unsigned int i = 0; i < row; i++){
-            for (unsigned int j = 0; j < col; ++j){
-                deserialize(tmp(i,j), binaryFile);
+        if (T::IsRowMajor || row <= 1 || col <= 1){
+            internal::deserializeRaw(tmp.data(), row * col, binaryFile);
+        }
+        else {
+            typedef typename T::Scalar Scalar;
+            typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMatrix;
+            const unsigned long long int rowsPerBlock = std::max(1ull, (1ull << 16) / col);
+            RowMatrix buffer;
+            for (unsigned long long int i = 0; i < row; i += rowsPerBlock){
+                unsigned long long int n = std::min(rowsPerBlock, row - i);
+                buffer.resize(n, col);
+                internal::deserializeRaw(buffer.data(), n * col, binaryFile);
+                tmp.middleRows(i, n) = buffer;
             }
         }
-        m = tmp;
+        m.derived() = std::move(tmp);
     }
     catch(std::ios_base::failure& e){
         cg3::restoreFilePosition(binaryFile, begin);
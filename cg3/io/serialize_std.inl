@@ -175,8 +175,13 @@ inline void serialize(const std::vector<T, A...> &v, std::ofstream& binaryFile)
     unsigned long long int size = v.size();
     serialize(std::string("stdvector"), binaryFile);
     serialize(size, binaryFile);
-    for (typename std::vector<T, A...>::const_iterator it = v.begin(); it != v.end(); ++it)
-        serialize((*it), binaryFile);
+    if (internal::isRawSerializable<T>::value){
+        internal::serializeRaw(v.data(), size, binaryFile);
+    }
+    else {
+        for (typename std::vector<T, A...>::const_iterator it = v.begin(); it != v.end(); ++it)
+            serialize((*it), binaryFile);
+    }
 }
 
 /**
@@ -237,8 +242,13 @@ inline void deserialize(std::vector<T, A...> &v, std::ifstream& binaryFile)
             throw std::ios_base::failure("Mismatching String: " + s + " != stdvector");
         deserialize(size, binaryFile);
         tmpv.resize(size);
-        for (unsigned int it = 0; it < size; ++it){
-            deserialize(tmpv[it], binaryFile);
+        if (internal::isRawSerializable<T>::value){
+            internal::deserializeRaw(tmpv.data(), size, binaryFile);
+        }
+        else {
+            for (unsigned long long int it = 0; it < size; ++it){
+                deserialize(tmpv[it], binaryFile);
+            }
         }
         v = std::move(tmpv);
 
@@ -433,8 +443,13 @@ inline void serialize(const std::array<T, A...> &a, std::ofstream& binaryFile)
     unsigned long long int size = a.size();
     serialize("stdarray", binaryFile);
     serialize(size, binaryFile);
-    for (typename std::array<T, A...>::const_iterator it = a.begin(); it != a.end(); ++it)
-        serialize((*it), binaryFile);
+    if (internal::isRawSerializable<T>::value){
+        internal::serializeRaw(a.data(), size, binaryFile);
+    }
+    else {
+        for (typename std::array<T, A...>::const_iterator it = a.begin(); it != a.end(); ++it)
+            serialize((*it), binaryFile);
+    }
 }
 
 /**
@@ -458,8 +473,13 @@ inline void deserialize(std::array<T, A...> &a, std::ifstream& binaryFile)
         if (size != a.size())
             throw std::ios_base::failure(std::string("Mismatching std::array size: ") + std::to_string(size) + " != " + std::to_string(a.size()));
         std::vector<T> tmp(size);
-        for (unsigned int it = 0; it < size; ++it){
-            deserialize(tmp[it], binaryFile);
+        if (internal::isRawSerializable<T>::value){
+            internal::deserializeRaw(tmp.data(), size, binaryFile);
+        }
+        else {
+            for (unsigned int it = 0; it < size; ++it){
+                deserialize(tmp[it], binaryFile);
+            }
         }
         std::copy_n(tmp.begin(), size, a.begin());
     }
@@ -30,14 +30,14 @@ CG3_INLINE std::vector<SimpleEigenMesh> EigenMeshLibIglAlgorithms::connectedComp
       @todo Pull request
     */
     ///If IGL Static (pull request problem)
-    Eigen::MatrixXi FF = mm.F;
+    Eigen::MatrixXi FF = mm.getFacesMatrix();
     igl::facet_components(FF, C);
     ///
     for (unsigned int i = 0; i < C.size(); i++){
         if (C(i) >= (int)connectedComponents.size()){
             assert(C(i) == (int)connectedComponents.size());
             SimpleEigenMesh m;
-            m.V = mm.V;
+            m.setVerticesMatrix(mm.V.topRows(mm.numberVertices()).eval());
             connectedComponents.push_back(m);
         }
         connectedComponents[C(i)].addFace(mm.F.row(i));
@@ -54,13 +54,13 @@ CG3_INLINE std::vector<std::vector<int>> EigenMeshLibIglAlgorithms::vertexToVert
 {
     std::vector<std::vector<int>> result;
 
-    Eigen::MatrixXi FF = m.F;
+    Eigen::MatrixXi FF = m.getFacesMatrix();
     igl::adjacency_list(FF, result);
 
     //Libigl algorithm takes only the max value in m.F
     //so we resize the vector to be of the same size of
     //the vertex matrix
-    result.resize(m.V.rows());
+    result.resize(m.numberVertices());
 
     return result;
 }
@@ -71,8 +71,8 @@ CG3_INLINE std::vector<std::vector<int>> EigenMeshLibIglAlgorithms::vertexToFace
     std::vector<std::vector<int>> VF;
     std::vector<std::vector<int>> VFi;
 
-    Eigen::MatrixXi FF = m.F;
-    Eigen::MatrixXd VV = m.V;
+    Eigen::MatrixXi FF = m.getFacesMatrix();
+    Eigen::MatrixXd VV = m.getVerticesMatrix();
     igl::vertex_triangle_adjacency(VV, FF, VF, VFi);
 
     return VF;
@@ -82,7 +82,7 @@ CG3_INLINE Eigen::MatrixXi EigenMeshLibIglAlgorithms::faceToFaceAdjacencies(
         const SimpleEigenMesh& m)
 {
     Eigen::MatrixXi eigenResult;
-    Eigen::MatrixXi FF = m.F;
+    Eigen::MatrixXi FF = m.getFacesMatrix();
     igl::triangle_triangle_adjacency(FF, eigenResult);
 
     return eigenResult;
@@ -37,7 +37,9 @@ std::vector<uint> birthFaceVectorConversion(const CSGTree::VectorJ& birthFaces);
  */
 CG3_INLINE CSGTree EigenMeshLibIglAlgorithms::eigenMeshToCSGTree(const SimpleEigenMesh& m)
 {
-    return CSGTree(m.V, m.F);
+    const Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor> V = m.getVerticesMatrix();
+    const Eigen::Matrix<int, Eigen::Dynamic, 3, Eigen::RowMajor> F = m.getFacesMatrix();
+    return CSGTree(V, F);
 }
 
 
@@ -33,8 +33,8 @@ CG3_INLINE void EigenMeshLibIglAlgorithms::vertexCurvature(
         std::vector<double>& maxValue,
         const unsigned int nRing)
 {
-    Eigen::MatrixXd V = m.V;
-    Eigen::MatrixXi F = m.F;
+    Eigen::MatrixXd V = m.getVerticesMatrix();
+    Eigen::MatrixXi F = m.getFacesMatrix();
 
     Eigen::MatrixXd PD1, PD2, PV1, PV2;
     igl::principal_curvature(V,F,PD1,PD2,PV1,PV2,nRing,true);
@@ -27,10 +27,10 @@ CG3_INLINE SimpleEigenMesh EigenMeshLibIglAlgorithms::decimateMesh(
      */
     Eigen::MatrixXd VV;
     Eigen::MatrixXi FF;
-    igl::decimate(m.V, m.F, numberDesiredFaces, VV, FF, mapping);
+    igl::decimate(m.getVerticesMatrix(), m.getFacesMatrix(), numberDesiredFaces, VV, FF, mapping);
 
-    output.V = VV;
-    output.F = FF;
+    output.setVerticesMatrix(VV);
+    output.setFacesMatrix(FF);
     return output;
 }
 
@@ -46,10 +46,10 @@ CG3_INLINE EigenMesh EigenMeshLibIglAlgorithms::decimateMesh(
      */
     Eigen::MatrixXd VV;
     Eigen::MatrixXi FF;
-    igl::decimate(m.V, m.F, numberDesiredFaces, VV, FF, mapping);
+    igl::decimate(m.getVerticesMatrix(), m.getFacesMatrix(), numberDesiredFaces, VV, FF, mapping);
 
-    output.V = VV;
-    output.F = FF;
+    output.setVerticesMatrix(VV);
+    output.setFacesMatrix(FF);
     output.updateFaceNormals();
     output.updateVerticesNormals();
     output.CV = Eigen::MatrixXf::Constant(output.V.rows(), 3, 0.5);
@@ -74,9 +74,9 @@ CG3_INLINE void EigenMeshLibIglAlgorithms::decimateMesh(
      */
     Eigen::MatrixXd VV;
     Eigen::MatrixXi FF;
-    igl::decimate(m.V, m.F, numberDesiredFaces, VV, FF, mapping);
-    m.V = VV;
-    m.F = FF;
+    igl::decimate(m.getVerticesMatrix(), m.getFacesMatrix(), numberDesiredFaces, VV, FF, mapping);
+    m.setVerticesMatrix(VV);
+    m.setFacesMatrix(FF);
 }
 
 CG3_INLINE void EigenMeshLibIglAlgorithms::decimateMesh(
@@ -86,9 +86,9 @@ CG3_INLINE void EigenMeshLibIglAlgorithms::decimateMesh(
 {
     Eigen::MatrixXd VV;
     Eigen::MatrixXi FF;
-    igl::decimate(m.V, m.F, numberDesiredFaces, VV, FF, mapping);
-    m.V = VV;
-    m.F = FF;
+    igl::decimate(m.getVerticesMatrix(), m.getFacesMatrix(), numberDesiredFaces, VV, FF, mapping);
+    m.setVerticesMatrix(VV);
+    m.setFacesMatrix(FF);
 
     m.CV = Eigen::MatrixXf::Constant(m.V.rows(), 3, 0.5);
     Eigen::MatrixXf tmp = m.CF;
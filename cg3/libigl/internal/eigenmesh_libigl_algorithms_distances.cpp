@@ -20,8 +20,8 @@ CG3_INLINE double EigenMeshLibIglAlgorithms::hausdorffDistance(
         const SimpleEigenMesh& m1,
         const SimpleEigenMesh& m2)
 {
-    Eigen::MatrixXd VA = m1.V, VB = m2.V;
-    Eigen::MatrixXi FA = m1.F, FB = m2.F;
+    Eigen::MatrixXd VA = m1.getVerticesMatrix(), VB = m2.getVerticesMatrix();
+    Eigen::MatrixXi FA = m1.getFacesMatrix(), FB = m2.getFacesMatrix();
 
     double hDistance;
     igl::hausdorff(VA, FA, VB, FB, hDistance);
@@ -31,8 +31,8 @@ CG3_INLINE std::vector<double> EigenMeshLibIglAlgorithms::exactGeodesics(
 {
     std::vector<double> vertexGeodesics;
 
-    Eigen::MatrixXd V = m.V;
-    Eigen::MatrixXi F = m.F;
+    Eigen::MatrixXd V = m.getVerticesMatrix();
+    Eigen::MatrixXi F = m.getFacesMatrix();
 
     Eigen::VectorXi VS,FS,VT,FT;
 
@@ -61,7 +61,9 @@ CG3_INLINE void EigenMeshLibIglAlgorithms::heatGeodesicsPrecomputeData(
         const SimpleEigenMesh& m,
         igl::HeatGeodesicsData<double>& precomputedData)
 {
-    igl::heat_geodesics_precompute(m.V, m.F, precomputedData);
+    const Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor> V = m.getVerticesMatrix();
+    const Eigen::Matrix<int, Eigen::Dynamic, 3, Eigen::RowMajor> F = m.getFacesMatrix();
+    igl::heat_geodesics_precompute(V, F, precomputedData);
 }
 
 } //namespace cg3::libigl::internal
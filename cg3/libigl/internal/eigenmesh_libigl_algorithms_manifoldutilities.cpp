@@ -20,14 +20,16 @@ namespace internal {
 
 CG3_INLINE bool EigenMeshLibIglAlgorithms::isEdgeManifold(const SimpleEigenMesh& input)
 {
-    return igl::is_edge_manifold(input.F);
+    const Eigen::Matrix<int, Eigen::Dynamic, 3, Eigen::RowMajor> F = input.getFacesMatrix();
+    return igl::is_edge_manifold(F);
 }
 
 CG3_INLINE bool EigenMeshLibIglAlgorithms::isVertexManifold(
         const SimpleEigenMesh& input,
         Eigen::Matrix<bool, Eigen::Dynamic, 1>& B)
 {
-    return igl::is_vertex_manifold(input.V, B);
+    const Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor> V = input.getVerticesMatrix();
+    return igl::is_vertex_manifold(V, B);
 }
 
 
@@ -35,7 +37,8 @@ CG3_INLINE unsigned int EigenMeshLibIglAlgorithms::extractManifoldPatches(
         const SimpleEigenMesh& m,
         Eigen::Matrix<int, Eigen::Dynamic, 1>& I)
 {
-    return igl::extract_manifold_patches(m.F, I);
+    const Eigen::Matrix<int, Eigen::Dynamic, 3, Eigen::RowMajor> F = m.getFacesMatrix();
+    return igl::extract_manifold_patches(F, I);
 }
 
 } //namespace cg3::libigl::internal
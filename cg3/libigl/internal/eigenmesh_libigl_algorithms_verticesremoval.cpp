@@ -32,13 +32,13 @@ CG3_INLINE void EigenMeshLibIglAlgorithms::removeUnreferencedVertices(
     */
     ///
     /// If IGL Static (pull request problem)
-    Eigen::MatrixXd VV = input.V, NV;
-    Eigen::MatrixXi FF = input.F, NF;
+    Eigen::MatrixXd VV = input.getVerticesMatrix(), NV;
+    Eigen::MatrixXi FF = input.getFacesMatrix(), NF;
     igl::remove_unreferenced(VV,FF, NV, NF, I);
     ///
 
-    input.V = NV;
-    input.F = NF;
+    input.setVerticesMatrix(NV);
+    input.setFacesMatrix(NF);
 }
 
 CG3_INLINE void EigenMeshLibIglAlgorithms::removeDuplicateVertices(
@@ -59,14 +59,14 @@ CG3_INLINE void EigenMeshLibIglAlgorithms::removeDuplicateVertices(
     */
     ///
     /// If IGL Static (pull request problem)
-    Eigen::MatrixXd VV = input.V, NV;
-    Eigen::MatrixXi FF = input.F, NF;
+    Eigen::MatrixXd VV = input.getVerticesMatrix(), NV;
+    Eigen::MatrixXi FF = input.getFacesMatrix(), NF;
     Eigen::Matrix<int, Eigen::Dynamic, 1> IInverse;
     igl::remove_duplicate_vertices( VV,FF, epsilon, NV, I, IInverse, NF);
     ///
 
-    input.V = NV;
-    input.F = NF;
+    input.setVerticesMatrix(NV);
+    input.setFacesMatrix(NF);
 }
 
 CG3_INLINE void EigenMeshLibIglAlgorithms::removeDuplicateVertices(
@@ -87,14 +87,14 @@ CG3_INLINE void EigenMeshLibIglAlgorithms::removeDuplicateVertices(
     */
     ///
     /// If IGL Static (pull request problem)
-    Eigen::MatrixXd VV = input.V, NV;
-    Eigen::MatrixXi FF = input.F, NF;
+    Eigen::MatrixXd VV = input.getVerticesMatrix(), NV;
+    Eigen::MatrixXi FF = input.getFacesMatrix(), NF;
     Eigen::Matrix<int, Eigen::Dynamic, 1> IInverse;
     igl::remove_duplicate_vertices( VV,FF, epsilon, NV, I, IInverse, NF);
     ///
 
-    input.V = NV;
-    input.F = NF;
+    input.setVerticesMatrix(NV);
+    input.setFacesMatrix(NF);
 
     Eigen::MatrixXd NNV(NV.rows(), 3);
     Eigen::MatrixXf NCV(NV.rows(), 3);
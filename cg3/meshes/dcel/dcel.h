@@ -34,7 +34,7 @@ class Dcel : public TemplatedDcel<Vertex, HalfEdge, Face>
 public:
     Dcel() : TemplatedDcel() {}
     Dcel(const TemplatedDcel<Vertex, HalfEdge, Face>& t) : TemplatedDcel(t) {}
-    Dcel(TemplatedDcel<Vertex, HalfEdge, Face>&& t) : TemplatedDcel(t) {}
+    Dcel(TemplatedDcel<Vertex, HalfEdge, Face>&& t) : TemplatedDcel(std::move(t)) {}
     using TemplatedDcel<Vertex, HalfEdge, Face>::TemplatedDcel; //inherits constructors
     using TemplatedDcel<Vertex, HalfEdge, Face>::operator=; //inherits assignment operators
 };
@@ -6,16 +6,15 @@
  */
 #include "dcel_builder.h"
 
+#include <algorithm>
+
 namespace cg3 {
 
-CG3_INLINE DcelBuilder::DcelBuilder(Dcel startingDcel) : d(startingDcel), updateNormalOnInsertion(true)
+CG3_INLINE DcelBuilder::DcelBuilder(Dcel startingDcel) :
+    d(std::move(startingDcel)),
+    mapsUpToDate(false),
+    updateNormalOnInsertion(true)
 {
-    for (cg3::Dcel::Vertex* v : d.vertexIterator()) {
-        mapVertices[v->coordinate()] = v->id();
-    }
-    for (cg3::Dcel::HalfEdge* he : d.halfEdgeIterator()){
-        mapHalfEdges[std::make_pair(he->fromVertex()->id(), he->toVertex()->id())] = he->id();
-    }
 }
 
 CG3_INLINE Dcel& DcelBuilder::dcel()
@@ -25,14 +24,16 @@ CG3_INLINE Dcel& DcelBuilder::dcel()
 
 CG3_INLINE unsigned int DcelBuilder::addVertex(const Point3d& p, const Vec3d& n, const Color &c, int flag)
 {
-    if (mapVertices.find(p) == mapVertices.end()){
+    updateMaps();
+    std::unordered_map<cg3::Point3d, unsigned int>::iterator it = mapVertices.find(p);
+    if (it == mapVertices.end()){
         cg3::Dcel::Vertex* v = d.addVertex(p, n, c);
-        mapVertices[p] = v->id();
+        mapVertices.emplace(p, v->id());
         v->setFlag(flag);
         return v->id();
     }
     else
-        return mapVertices[p];
+        return it->second;
 }
 
 CG3_INLINE int DcelBuilder::addFace(
@@ -42,11 +43,8 @@ CG3_INLINE int DcelBuilder::addFace(
         const Color& c,
         int flag)
 {
-    std::vector<uint> vids(3);
-    vids[0] = vid1;
-    vids[1] = vid2;
-    vids[2] = vid3;
-    return addFace(vids, c, flag);
+    const uint vids[3] = {vid1, vid2, vid3};
+    return addFaceFromIds(vids, 3, c, flag);
 }
 
 CG3_INLINE int DcelBuilder::addFace(
@@ -57,45 +55,180 @@ CG3_INLINE int DcelBuilder::addFace(
         const Color& c,
         int flag)
 {
-    std::vector<uint> vids(4);
-    vids[0] = vid1;
-    vids[1] = vid2;
-    vids[2] = vid3;
-    vids[3] = vid4;
-    return addFace(vids, c, flag);
+    const uint vids[4] = {vid1, vid2, vid3, vid4};
+    return addFaceFromIds(vids, 4, c, flag);
 }
 
 CG3_INLINE int DcelBuilder::addFace(const std::vector<uint>& vids, const Color& c, int flag)
 {
-    //one of the ids does not exist in the dcel
-    for (const uint& vid : vids)
-        if (d.vertex(vid) == nullptr)
-            return -1;
+    return addFaceFromIds(vids.data(), vids.size(), c, flag);
+}
+
+CG3_INLINE int DcelBuilder::addFace(
+        const Point3d& p1,
+        const Point3d& p2,
+        const Point3d& p3,
+        const Color& c,
+        int flag)
+{
+    unsigned int vid1, vid2, vid3;
+
+    //setting vids: addVertex returns the id of the vertex if it already exists
+    vid1 = addVertex(p1);
+    vid2 = addVertex(p2);
+    vid3 = addVertex(p3);
+
+    return addFace(vid1, vid2, vid3, c, flag);
+}
+
+CG3_INLINE int DcelBuilder::addFace(
+        const Point3d& p1,
+        const Point3d& p2,
+        const Point3d& p3,
+        const Point3d& p4,
+        const Color& c,
+        int flag)
+{
+    unsigned int vid1, vid2, vid3, vid4;
+
+    //setting vids: addVertex returns the id of the vertex if it already exists
+    vid1 = addVertex(p1);
+    vid2 = addVertex(p2);
+    vid3 = addVertex(p3);
+    vid4 = addVertex(p4);
+
+    return addFace(vid1, vid2, vid3, vid4, c, flag);
+}
+
+CG3_INLINE int DcelBuilder::addFace(const std::vector<Point3d>& ps, const Color& c, int flag)
+{
+    std::vector<uint> vids(ps.size());
+    for (uint i = 0; i < ps.size(); i++)
+        vids[i] = addVertex(ps[i]);
+    return addFace(vids, c, flag);
+}
+
+/**
+ * @brief Inserts in the Dcel a whole indexed triangle mesh.
+ *
+ * The i-th vertex has coordinates (coords[3*i], coords[3*i+1], coords[3*i+2]), and the
+ * j-th triangle is composed by the vertices tris[3*j], tris[3*j+1], tris[3*j+2], which
+ * are indices in the coords vector. Differently from addVertex(), vertices are not merged
+ * with the existing ones having the same coordinates.
+ *
+ * The storage of the Dcel is sized once, and twin half edges (also the border half edges
+ * already contained in the Dcel) are linked with a single sort of all the edges.
+ * Edges shared by more than two half edges, or by two half edges with the same orientation,
+ * are left without twins.
+ *
+ * @param[in] coords: coordinates of the vertices, 3 for each vertex
+ * @param[in] tris: indices of the vertices of the triangles, 3 for each triangle
+ * @return false if the size of one of the vectors is not a multiple of 3 or some index
+ * is out of range (in this case the Dcel is not modified), true otherwise
+ */
+CG3_INLINE bool DcelBuilder::build(const std::vector<double>& coords, const std::vector<uint>& tris)
+{
+    if (coords.size() % 3 != 0 || tris.size() % 3 != 0)
+        return false;
+    const uint nv = coords.size() / 3;
+    const uint nt = tris.size() / 3;
+    for (uint vid : tris)
+        if (vid >= nv)
+            return false;
+
+    d.reserve(d.numberVertices() + nv, d.numberHalfEdges() + 3 * nt, d.numberFaces() + nt);
+
+    struct Edge {
+        uint v1, v2; //sorted ids of the extremes
+        cg3::Dcel::HalfEdge* he;
+        bool operator<(const Edge& o) const {
+            if (v1 != o.v1) return v1 < o.v1;
+            if (v2 != o.v2) return v2 < o.v2;
+            return he->id() < o.he->id();
+        }
+    };
+    std::vector<Edge> edges;
+    edges.reserve(3 * nt);
 
-    std::vector<std::pair<uint, uint>> pes;
-    for (uint i = 0; i < vids.size(); ++i){
-        pes.push_back(std::make_pair(vids[i], vids[(i+1)%vids.size()]));
+    //border half edges of the current dcel may be twins of the new ones
+    for (cg3::Dcel::HalfEdge* he : d.halfEdgeIterator()){
+        if (he->twin() == nullptr){
+            uint v1 = he->fromVertex()->id(), v2 = he->toVertex()->id();
+            edges.push_back({std::min(v1, v2), std::max(v1, v2), he});
+        }
+    }
+
+    std::vector<cg3::Dcel::Vertex*> vs(nv);
+    for (uint i = 0; i < nv; ++i)
+        vs[i] = d.addVertex(cg3::Point3d(coords[3*i], coords[3*i+1], coords[3*i+2]));
+
+    for (uint t = 0; t < nt; ++t){
+        cg3::Dcel::Face* f = d.addFace();
+        cg3::Dcel::HalfEdge* hes[3] = {d.addHalfEdge(), d.addHalfEdge(), d.addHalfEdge()};
+        for (uint i = 0; i < 3; ++i){
+            cg3::Dcel::Vertex* from = vs[tris[3*t+i]];
+            cg3::Dcel::Vertex* to = vs[tris[3*t+(i+1)%3]];
+            hes[i]->setFromVertex(from);
+            hes[i]->setToVertex(to);
+            hes[i]->setNext(hes[(i+1)%3]);
+            hes[i]->setPrev(hes[(i+2)%3]);
+            hes[i]->setFace(f);
+            from->setIncidentHalfEdge(hes[i]);
+            edges.push_back({std::min(from->id(), to->id()), std::max(from->id(), to->id()), hes[i]});
+        }
+        f->setOuterHalfEdge(hes[0]);
+        if (updateNormalOnInsertion)
+            f->updateArea();
+    }
+
+    //linking twins
+    std::sort(edges.begin(), edges.end());
+    bool nonManifold = false;
+    for (uint i = 0; i < edges.size(); ){
+        uint j = i + 1;
+        while (j < edges.size() && edges[j].v1 == edges[i].v1 && edges[j].v2 == edges[i].v2)
+            ++j;
+        if (j - i == 2 && edges[i].he->fromVertex() == edges[i+1].he->toVertex()){
+            edges[i].he->setTwin(edges[i+1].he);
+            edges[i+1].he->setTwin(edges[i].he);
+        }
+        else if (j - i > 1) {
+            nonManifold = true;
+        }
+        i = j;
+    }
+    if (nonManifold){
+        std::cerr << "Warning Dcel Builder: some edges are shared by more than two "
+                     "half edges or are badly oriented. Possible Non-Manifold Mesh\n";
     }
 
-    // one of the three edges already exists in the dcel ->
+    mapsUpToDate = false;
+    return true;
+}
+
+CG3_INLINE int DcelBuilder::addFaceFromIds(const uint* vids, uint size, const Color& c, int flag)
+{
+    updateMaps();
+
+    //one of the ids does not exist in the dcel
+    for (uint i = 0; i < size; ++i)
+        if (d.vertex(vids[i]) == nullptr)
+            return -1;
+
+    // one of the edges already exists in the dcel ->
     // bad orientation of face or non edge-manifold mesh
-    for (const std::pair<uint, uint>& pe : pes)
-        if (mapHalfEdges.find(pe) != mapHalfEdges.end())
+    for (uint i = 0; i < size; ++i)
+        if (mapHalfEdges.find(halfEdgeKey(vids[i], vids[(i+1)%size])) != mapHalfEdges.end())
             return -1;
 
     //looking for twins...
-    std::vector<std::pair<uint, uint>>  tpes;
-    for (const std::pair<uint, uint>& pe : pes)
-        tpes.push_back(std::make_pair(pe.second, pe.first));
-
-    std::vector<cg3::Dcel::HalfEdge*> tes(tpes.size(), nullptr);
-
-    std::map<std::pair<unsigned int, unsigned int>, unsigned int>::iterator it;
-    for (uint i = 0; i < tpes.size(); ++i){
-        it = mapHalfEdges.find(tpes[i]);
+    twinsBuffer.assign(size, nullptr);
+    for (uint i = 0; i < size; ++i){
+        std::unordered_map<unsigned long long, unsigned int>::iterator it =
+                mapHalfEdges.find(halfEdgeKey(vids[(i+1)%size], vids[i]));
         if (it != mapHalfEdges.end()){
-            tes[i] = d.halfEdge(it->second);
-            if (tes[i]->twin() != nullptr){
+            twinsBuffer[i] = d.halfEdge(it->second);
+            if (twinsBuffer[i]->twin() != nullptr){
                 std::cerr << "Warning Dcel Builder: Half Edge has already a twin! "
                              "Possible Non-Manifold Mesh\n";
             }
@@ -105,53 +238,40 @@ CG3_INLINE int DcelBuilder::addFace(const std::vector<uint>& vids, const Color&
     //add face
     cg3::Dcel::Face* f = d.addFace();
 
-    std::vector<cg3::Dcel::Vertex*> vs;
-    std::vector<cg3::Dcel::HalfEdge*> hes(vids.size());
-
-    //get vertices
-    for (uint vid : vids)
-        vs.push_back(d.vertex(vid));
-
     //add half edges
-    for (uint i = 0; i < hes.size(); i++)
-        hes[i] = d.addHalfEdge();
+    halfEdgesBuffer.resize(size);
+    for (uint i = 0; i < size; i++)
+        halfEdgesBuffer[i] = d.addHalfEdge();
 
+    for (uint i = 0; i < size; i++){
+        cg3::Dcel::HalfEdge* he = halfEdgesBuffer[i];
+        cg3::Dcel::Vertex* v = d.vertex(vids[i]);
 
-    for (uint i = 0; i < hes.size(); i++){
         //from and to vertex
-        hes[i]->setFromVertex(vs[i]);
-        hes[i]->setToVertex(vs[(i+1)%hes.size()]);
+        he->setFromVertex(v);
+        he->setToVertex(d.vertex(vids[(i+1)%size]));
 
         //twin
-        hes[i]->setTwin(tes[i]);
-        if (tes[i])
-            tes[i]->setTwin(hes[i]);
+        he->setTwin(twinsBuffer[i]);
+        if (twinsBuffer[i])
+            twinsBuffer[i]->setTwin(he);
 
         //vertex incident
-        vs[i]->setIncidentHalfEdge(hes[i]);
+        v->setIncidentHalfEdge(he);
 
         //face
-        hes[i]->setFace(f);
+        he->setFace(f);
 
         //prev and next
-        if (i > 0){
-            hes[i]->setPrev(hes[i-1]);
-            hes[i-1]->setNext(hes[i]);
-        }
+        he->setPrev(halfEdgesBuffer[(i+size-1)%size]);
+        he->setNext(halfEdgesBuffer[(i+1)%size]);
 
         //mapHalfEdges
-        mapHalfEdges.insert(std::make_pair(
-                                std::make_pair(vids[i], vids[(i+1)%vids.size()]),
-                                hes[i]->id()));
-
+        mapHalfEdges.emplace(halfEdgeKey(vids[i], vids[(i+1)%size]), he->id());
     }
 
-    //prev and next
-    hes[0]->setPrev(hes[hes.size()-1]);
-    hes[hes.size()-1]->setNext(hes[0]);
-
     //other settings f
-    f->setOuterHalfEdge(hes[0]);
+    f->setOuterHalfEdge(halfEdgesBuffer[0]);
     f->setColor(c);
     f->setFlag(flag);
 
@@ -159,89 +279,30 @@ CG3_INLINE int DcelBuilder::addFace(const std::vector<uint>& vids, const Color&
     return f->id();
 }
 
-CG3_INLINE int DcelBuilder::addFace(
-        const Point3d& p1,
-        const Point3d& p2,
-        const Point3d& p3,
-        const Color& c,
-        int flag)
-{
-    unsigned int vid1, vid2, vid3;
-
-    //setting vids
-    std::map<cg3::Point3d, unsigned int>::iterator it;
-    it = mapVertices.find(p1);
-    if (it == mapVertices.end())
-        vid1 = addVertex(p1);
-    else
-        vid1 = it->second;
-
-    it = mapVertices.find(p2);
-    if (it == mapVertices.end())
-        vid2 = addVertex(p2);
-    else
-        vid2 = it->second;
-
-    it = mapVertices.find(p3);
-    if (it == mapVertices.end())
-        vid3 = addVertex(p3);
-    else
-        vid3 = it->second;
-
-    return addFace(vid1, vid2, vid3, c, flag);
-}
-
-CG3_INLINE int DcelBuilder::addFace(
-        const Point3d& p1,
-        const Point3d& p2,
-        const Point3d& p3,
-        const Point3d& p4,
-        const Color& c,
-        int flag)
+/**
+ * @brief Fills the maps of vertices and half edges with the elements of the Dcel,
+ * if they have not been updated after the last bulk insertion.
+ */
+CG3_INLINE void DcelBuilder::updateMaps()
 {
-    unsigned int vid1, vid2, vid3, vid4;
-
-    //setting vids
-    std::map<cg3::Point3d, unsigned int>::iterator it;
-    it = mapVertices.find(p1);
-    if (it == mapVertices.end())
-        vid1 = addVertex(p1);
-    else
-        vid1 = it->second;
-
-    it = mapVertices.find(p2);
-    if (it == mapVertices.end())
-        vid2 = addVertex(p2);
-    else
-        vid2 = it->second;
-
-    it = mapVertices.find(p3);
-    if (it == mapVertices.end())
-        vid3 = addVertex(p3);
-    else
-        vid3 = it->second;
-
-    it = mapVertices.find(p4);
-    if (it == mapVertices.end())
-        vid4 = addVertex(p4);
-    else
-        vid4 = it->second;
-
-    return addFace(vid1, vid2, vid3, vid4, c, flag);
+    if (mapsUpToDate)
+        return;
+    mapVertices.clear();
+    mapHalfEdges.clear();
+    mapVertices.reserve(d.numberVertices());
+    mapHalfEdges.reserve(d.numberHalfEdges());
+    for (cg3::Dcel::Vertex* v : d.vertexIterator()) {
+        mapVertices.emplace(v->coordinate(), v->id());
+    }
+    for (cg3::Dcel::HalfEdge* he : d.halfEdgeIterator()){
+        mapHalfEdges.emplace(halfEdgeKey(he->fromVertex()->id(), he->toVertex()->id()), he->id());
+    }
+    mapsUpToDate = true;
 }
 
-CG3_INLINE int DcelBuilder::addFace(const std::vector<Point3d>& ps, const Color& c, int flag)
+CG3_INLINE unsigned long long DcelBuilder::halfEdgeKey(unsigned int fromVid, unsigned int toVid)
 {
-    std::vector<uint> vids(ps.size());
-    std::map<cg3::Point3d, unsigned int>::iterator it;
-    for (uint i = 0; i < ps.size(); i++){
-        it = mapVertices.find(ps[i]);
-        if (it == mapVertices.end())
-            vids[i] = addVertex(ps[i]);
-        else
-            vids[i] = it->second;
-    }
-    return addFace(vids, c, flag);
+    return ((unsigned long long)fromVid << 32) | toVid;
 }
 
 CG3_INLINE void DcelBuilder::finalize()
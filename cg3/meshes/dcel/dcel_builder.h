@@ -18,6 +18,10 @@ namespace cg3 {
  * This class allows to create a cg3::Dcel mesh without caring of half edges, which are
  * automatically created and setted. Using this builder it is possible to create a Dcel
  * by insertion of vertices and facets only (like more simpler data structures).
+ *
+ * Vertices and half edges already inserted are found through hash tables.
+ * Whole indexed triangle meshes can be inserted at once with build(), which does not
+ * use the hash tables and links twin half edges by sorting them.
  */
 class DcelBuilder
 {
@@ -66,16 +70,27 @@ public:
                 const Color &c = Color(128, 128, 128),
                 int flag = 0);
 
+    bool build(const std::vector<double>& coords, const std::vector<uint>& tris);
+
     void finalize();
 
     void setUpdateNormalOnInsertion(bool b = true);
 
 protected:
 
+    int addFaceFromIds(const uint* vids, uint size, const Color& c, int flag);
+    void updateMaps();
+    static unsigned long long halfEdgeKey(unsigned int fromVid, unsigned int toVid);
+
     cg3::Dcel d;
-    std::map<cg3::Point3d, unsigned int> mapVertices;
-    std::map<std::pair<unsigned int, unsigned int>, unsigned int> mapHalfEdges;
+    std::unordered_map<cg3::Point3d, unsigned int> mapVertices;
+    std::unordered_map<unsigned long long, unsigned int> mapHalfEdges;
+    bool mapsUpToDate; /**< @brief false if the maps must be rebuilt before the next insertion */
     bool updateNormalOnInsertion;
+
+    //buffers reused by addFace, in order to avoid an allocation for every face
+    std::vector<cg3::Dcel::HalfEdge*> twinsBuffer;
+    std::vector<cg3::Dcel::HalfEdge*> halfEdgesBuffer;
 };
 
 } //namespace cg3
@@ -24,13 +24,11 @@ class DcelData : public virtual cg3::Mesh
 	friend class cg3::Face;
 protected:
 	//Data
-	#ifdef NDEBUG
 	std::vector<Point3d> vertexCoordinates;
 	std::vector<Vec3d> vertexNormals;
 	std::vector<Color> vertexColors;
 	std::vector<Vec3d> faceNormals;
 	std::vector<Color> faceColors;
-	#endif
 };
 
 } //namespace cg3::internal
@@ -7,12 +7,9 @@
 
 #include "dcel_face.h"
 #include "dcel_vertex.h"
-#include "algorithms/dcel_cgal_triangulation.h"
+#include <cg3/geometry/polygon_triangulator.h>
 #include <cg3/geometry/transformations3.h>
 #include <cg3/geometry/utils3.h>
-#ifdef CG3_CGAL_DEFINED
-#include <cg3/cgal/triangulation3.h>
-#endif
 
 namespace cg3 {
 
@@ -30,7 +27,6 @@ namespace cg3 {
  * - id setted to 0;
  * - flag setted to 0.
  */
-#ifdef NDEBUG
 CG3_INLINE Face::Face(internal::DcelData& parent) :
     parent(&parent),
     _outerHalfEdge(nullptr),
@@ -40,11 +36,6 @@ CG3_INLINE Face::Face(internal::DcelData& parent) :
 {
     _innerHalfEdges.clear();
 }
-#else
-CG3_INLINE Face::Face() : _outerHalfEdge(nullptr), _area(0), _id(0), _flag(0){
-    _innerHalfEdges.clear();
-}
-#endif
 
 /**
  * \~Italian
@@ -108,11 +99,7 @@ CG3_INLINE int Face::flag() const
  */
 CG3_INLINE Vec3d Face::normal() const
 {
-	#ifdef NDEBUG
 	return parent->faceNormals[_id];
-	#else
-	return _normal;
-	#endif
 }
 
 /**
@@ -133,11 +120,7 @@ CG3_INLINE double Face::area() const
  */
 CG3_INLINE Color Face::color() const
 {
-	#ifdef NDEBUG
 	return parent->faceColors[_id];
-	#else
-	return _color;
-	#endif
 }
 
 /**
@@ -233,11 +216,7 @@ CG3_INLINE void Face::resetFlag()
  */
 CG3_INLINE void Face::setNormal(const Vec3d& newNormal)
 {
-	#ifdef NDEBUG
 	parent->faceNormals[_id] = newNormal;
-	#else
-	_normal = newNormal;
-	#endif
 }
 
 /**
@@ -257,11 +236,7 @@ CG3_INLINE void Face::setArea(double newArea)
  */
 CG3_INLINE void Face::setColor(const Color& newColor)
 {
-	#ifdef NDEBUG
 	parent->faceColors[_id] = newColor;
-	#else
-	_color = newColor;
-	#endif
 }
 
 /**
@@ -381,70 +356,35 @@ CG3_INLINE Point3d Face::barycenter() const
     return p;
 }
 
-#ifdef CG3_CGAL_DEFINED
 /**
  * \~Italian
- * @brief Face::getTriangulation
- * @param triangles
+ * @brief Funzione che calcola una triangolazione della faccia, eventualmente con buchi.
+ *
+ * I triangoli hanno lo stesso orientamento della faccia. La triangolazione è calcolata
+ * mediante ear clipping (PolygonTriangulator), riutilizzando dei buffer locali al thread:
+ * la funzione può essere chiamata in parallelo su facce diverse.
+ *
+ * @param[out] triangles: vettore di triplette di vertici, uno per ogni triangolo
  */
 CG3_INLINE void Face::triangulation(std::vector<std::array<const Vertex*, 3> > &triangles) const
 {
-    // Taking all the coordinates on vectors
-    std::vector<Point3d> borderCoordinates;
-    std::vector< std::vector<Point3d> > innerBorderCoordinates;
-    std::map<Point3d, const Vertex*> pointsVerticesMap;
-    for (const HalfEdge* he : incidentHalfEdgeIterator()){
-        assert(he != nullptr && "Next component of Previous HalfEdge is null.");
-        assert(he->fromVertex() != nullptr && "HalfEdge's from vertex is null.");
-        borderCoordinates.push_back(he->fromVertex()->coordinate());
-        std::pair<const Vertex*, const Vertex*> pp;
-        pp.first = he->fromVertex();
-        pp.second = he->toVertex();
-        pointsVerticesMap[he->fromVertex()->coordinate()] = he->fromVertex();
-    }
+    thread_local PolygonTriangulator triangulator;
+    thread_local std::vector<Point3d> points;
+    thread_local std::vector<unsigned int> borderSizes, indices;
+    thread_local std::vector<const HalfEdge*> borderHalfEdges;
 
-    if (hasHoles()){
-        innerBorderCoordinates.reserve(numberInnerHalfEdges());
-        int i = 0;
-        for (Face::ConstInnerHalfEdgeIterator ihe = innerHalfEdgeBegin(), ihend = innerHalfEdgeEnd(); ihe != ihend; ++ihe, ++i){
-            const HalfEdge* he = *ihe;
-            std::vector<Point3d> inner;
-            for (Face::ConstIncidentHalfEdgeIterator heit = incidentHalfEdgeBegin(he), hend = incidentHalfEdgeEnd(); heit != hend; ++heit) {
-                assert(*(heit) != nullptr && "Next component of Previous HalfEdge is null.");
-                assert((*heit)->fromVertex() != nullptr && "HalfEdge's from vertex is null.");
-                inner.push_back((*heit)->fromVertex()->coordinate());
-                std::pair<const Vertex*, const Vertex*> pp;
-                pp.first = (*heit)->fromVertex();
-                pp.second = (*heit)->toVertex();
-                pointsVerticesMap[(*heit)->fromVertex()->coordinate()] = (*heit)->fromVertex();
-            }
-            innerBorderCoordinates.push_back(inner);
-        }
-    }
-
-    #ifdef NDEBUG
-	std::vector<std::array<Point3d, 3> > trianglesP = internal::triangulate3(parent->faceNormals[_id], borderCoordinates, innerBorderCoordinates);
-    #else
-    std::vector<std::array<Point3d, 3> > trianglesP = cgal::triangulate3(_normal, borderCoordinates, innerBorderCoordinates);
-    #endif
+    borders(points, borderSizes, borderHalfEdges);
+    indices.clear();
+    unsigned int nt = triangulator.triangulate(points, borderSizes, indices, parent->faceNormals[_id]);
 
     triangles.clear();
-    for (unsigned int i = 0; i < trianglesP.size(); ++i) {
-            std::array<Point3d, 3> triangle = trianglesP[i];
-            Point3d p1 = triangle[0];
-            Point3d p2 = triangle[1];
-            Point3d p3 = triangle[2];
-            assert(pointsVerticesMap.find(p1) != pointsVerticesMap.end() && "Triangulation vertex not founded on original face.");
-            assert(pointsVerticesMap.find(p2) != pointsVerticesMap.end() && "Triangulation vertex not founded on original face.");
-            assert(pointsVerticesMap.find(p3) != pointsVerticesMap.end() && "Triangulation vertex not founded on original face.");
-            const Vertex* a = pointsVerticesMap[p1];
-            const Vertex* b = pointsVerticesMap[p2];
-            const Vertex* c = pointsVerticesMap[p3];
-            std::array<const Vertex*, 3> tuple = {a, b, c};
-            triangles.push_back(tuple);
+    triangles.reserve(nt);
+    for (unsigned int i = 0; i < nt; ++i) {
+        triangles.push_back({borderHalfEdges[indices[3*i]]->fromVertex(),
+                             borderHalfEdges[indices[3*i+1]]->fromVertex(),
+                             borderHalfEdges[indices[3*i+2]]->fromVertex()});
     }
 }
-#endif
 
 /**
  * \~Italian
@@ -456,11 +396,7 @@ CG3_INLINE std::string Face::toString() const
 {
     std::stringstream ss;
 
-    #ifdef NDEBUG
     ss << "ID: " << _id << "; Normal: " << parent->faceNormals[_id] << "; Outer Component: ";
-    #else
-    ss << "ID: " << _id << "; Normal: " << _normal << "; Outer Component: ";
-    #endif
     if (_outerHalfEdge != nullptr) ss << _outerHalfEdge->id();
     else ss << "nullptr";
     ss << "; N Inner Components: " << _innerHalfEdges.size() << "; Inner Components: "
@@ -576,19 +512,16 @@ CG3_INLINE Vec3d Face::updateNormal()
     }
     if (normal == Vec3d())
         std::cerr << "Warning: degenerate triangle/polygon; ID: " << id() << "\n";
-    #ifdef NDEBUG
     parent->faceNormals[_id] = normal;
-    #else
-    this->_normal = normal;
-    #endif
     return normal;
 }
 
 /**
  * \~Italian
  * @brief Funzione che aggiorna l'area della faccia
- * @warning Funziona se e solo se la faccia è un triangolo
- * @warning Utilizza Face::ConstIncidentVertexIterator
+ *
+ * Se la faccia non è un triangolo, l'area è la somma delle aree dei triangoli
+ * della sua triangolazione (vedi Face::triangulation).
  * @return L'area della faccia aggiornata
  */
 CG3_INLINE double Face::updateArea()
@@ -606,7 +539,6 @@ CG3_INLINE double Face::updateArea()
             Point3d v3 = _outerHalfEdge->prev()->fromVertex()->coordinate();
             _area = (((v3 - v1).cross(v2 - v1)).length() / 2);
         }
-        #ifdef CG3_CGAL_DEFINED
         else {
             _area = 0;
             std::vector<std::array<const Vertex*, 3> > t;
@@ -623,7 +555,6 @@ CG3_INLINE double Face::updateArea()
                 _area += (((v3 - v1).cross(v2 - v1)).length() / 2);
             }
         }
-        #endif
     }
     return _area;
 }
@@ -1176,6 +1107,40 @@ CG3_INLINE double Face::signedVolume() const
     return vertex1()->coordinate().dot(vertex2()->coordinate().cross(vertex3()->coordinate())) / 6.0f;
 }
 
+/**
+ * @brief Collects the borders of the face, as required by PolygonTriangulator:
+ * the points of the outer border followed by the points of the inner borders.
+ *
+ * @param[out] points: coordinates of the from vertices of the half edges of the borders
+ * @param[out] borderSizes: number of half edges of the outer border and of each inner border
+ * @param[out] borderHalfEdges: the half edge associated to every point
+ */
+CG3_INLINE void Face::borders(
+        std::vector<Point3d>& points,
+        std::vector<unsigned int>& borderSizes,
+        std::vector<const HalfEdge*>& borderHalfEdges) const
+{
+    points.clear();
+    borderSizes.clear();
+    borderHalfEdges.clear();
+    auto addBorder = [&](const HalfEdge* start) {
+        unsigned int size = 0;
+        const HalfEdge* he = start;
+        do {
+            assert(he != nullptr && "Next component of Previous HalfEdge is null.");
+            assert(he->fromVertex() != nullptr && "HalfEdge's from vertex is null.");
+            points.push_back(parent->vertexCoordinates[he->fromVertex()->id()]);
+            borderHalfEdges.push_back(he);
+            he = he->next();
+            size++;
+        } while (he != start);
+        borderSizes.push_back(size);
+    };
+    addBorder(_outerHalfEdge);
+    for (const HalfEdge* he : _innerHalfEdges)
+        addBorder(he);
+}
+
 
 CG3_INLINE std::ostream&operator<<(std::ostream& inputStream, const Face* f)
 {
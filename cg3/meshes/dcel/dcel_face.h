@@ -11,6 +11,7 @@
 #include "dcel_half_edge.h"
 #include <cg3/geometry/point3.h>
 #include <cg3/utilities/color.h>
+#include <array>
 
 namespace cg3 {
 
@@ -179,10 +180,8 @@ public:
     int numberIncidentVertices()                                                 const;
     int numberIncidentHalfEdges()                                                const;
     Point3d barycenter()                                                          const;
-    #ifdef CG3_CGAL_DEFINED
     void triangulation(
             std::vector<std::array<const Vertex*, 3> >& triangles)            const;
-    #endif
     std::string toString()                                                          const;
     ConstAdjacentFaceIterator adjacentFaceBegin()                                   const;
     ConstAdjacentFaceIterator adjacentFaceEnd()                                     const;
@@ -250,23 +249,14 @@ protected:
     * Constructors *
     ****************/
 
-    #ifdef NDEBUG
     Face(internal::DcelData &parent);
-    #else
-    Face();
-    #endif
     virtual ~Face();
 
     /*************
     * Attributes *
     **************/
 
-    #ifdef NDEBUG
     internal::DcelData *parent;
-    #else
-    Vec3d                            _normal;
-    Color                           _color;
-    #endif
     HalfEdge*                 _outerHalfEdge;
     std::vector<HalfEdge*>    _innerHalfEdges;
     double                          _area;
@@ -285,6 +275,10 @@ protected:
 
     std::string innerComponentsToString() const;
     double signedVolume() const;
+    void borders(
+            std::vector<Point3d>& points,
+            std::vector<unsigned int>& borderSizes,
+            std::vector<const HalfEdge*>& borderHalfEdges) const;
 };
 
 std::ostream& operator<< (std::ostream& inputStream, const Face* f);
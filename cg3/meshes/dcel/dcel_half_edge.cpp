@@ -30,7 +30,6 @@ namespace cg3 {
  * - id pari a 0;
  * - flag pari a 0.
  */
-#ifdef NDEBUG
 CG3_INLINE HalfEdge::HalfEdge(internal::DcelData& parent) :
     parent(&parent),
     _fromVertex(nullptr),
@@ -43,19 +42,6 @@ CG3_INLINE HalfEdge::HalfEdge(internal::DcelData& parent) :
     _flag(0)
 {
 }
-#else
-CG3_INLINE HalfEdge::HalfEdge() :
-    _fromVertex(nullptr),
-    _toVertex(nullptr),
-    _twin(nullptr),
-    _prev(nullptr),
-    _next(nullptr),
-    _face(nullptr),
-    _id(0),
-    _flag(0)
-{
-}
-#endif
 
 /**
  * \~Italian
@@ -14,10 +14,8 @@
 
 #include "dcel_data.h"
 
-#ifdef NDEBUG
 #include <cg3/geometry/point3.h>
 #include <cg3/utilities/color.h>
-#endif
 
 namespace cg3 {
 
@@ -126,20 +124,14 @@ protected:
     * Constructors *
     ****************/
 
-    #ifdef NDEBUG
     HalfEdge(internal::DcelData &parent);
-    #else
-    HalfEdge();
-    #endif
     virtual ~HalfEdge();
 
     /**************
     * Attributes *
     **************/
 
-    #ifdef NDEBUG
     internal::DcelData* parent;
-    #endif
     Vertex* 	_fromVertex; /**< \~Italian @brief Vertice di origine dell'half edge */
     Vertex* 	_toVertex;   /**< \~Italian @brief Vertice di destinazione dell'half edge */
     HalfEdge* _twin;       /**< \~Italian @brief Half edge gemello dell'half edge */
@@ -0,0 +1,237 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+#ifndef CG3_DCEL_POOL_H
+#define CG3_DCEL_POOL_H
+
+#include <vector>
+#include <new>
+#include <type_traits>
+#include <cstddef>
+
+namespace cg3 {
+namespace internal {
+
+/**
+ * @class DcelPool
+ * @brief Chunked storage for the elements (Vertex, HalfEdge, Face) of the Dcel.
+ *
+ * The pool hands out uninitialized slots taken from contiguous slabs, which are
+ * never moved or reallocated: pointers to the elements built in a slot remain
+ * valid until the slot is released or the pool is cleared.
+ * Released slots are kept in a free list and reused by the next allocations.
+ *
+ * The pool does not construct nor destroy elements: the Dcel builds them with
+ * placement new and calls their destructors before releasing the slots.
+ * All the slabs are released at once by clear() and by the destructor.
+ */
+template <class T>
+class DcelPool
+{
+public:
+    DcelPool();
+    DcelPool(const DcelPool& other) = delete;
+    DcelPool(DcelPool&& other);
+    ~DcelPool();
+
+    DcelPool& operator= (const DcelPool& other) = delete;
+    DcelPool& operator= (DcelPool&& other);
+
+    void* allocate();
+    void deallocate(void* p);
+    void reserve(std::size_t n);
+    void clear();
+    void swap(DcelPool& other);
+    void splice(DcelPool& other);
+    std::size_t capacity() const;
+
+private:
+    union Slot {
+        Slot* next;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+
+    static const std::size_t MIN_SLAB_SIZE = 256;
+    static const std::size_t MAX_SLAB_SIZE = 65536;
+
+    void addSlab(std::size_t size);
+
+    std::vector<Slot*> slabs;
+    std::size_t totalCapacity;
+    std::size_t nextSlabSize;
+    Slot* freeList;
+    Slot* cursor;
+    Slot* cursorEnd;
+};
+
+template <class T>
+DcelPool<T>::DcelPool() :
+    totalCapacity(0),
+    nextSlabSize(MIN_SLAB_SIZE),
+    freeList(nullptr),
+    cursor(nullptr),
+    cursorEnd(nullptr)
+{
+}
+
+template <class T>
+DcelPool<T>::DcelPool(DcelPool<T>&& other) :
+    DcelPool()
+{
+    swap(other);
+}
+
+template <class T>
+DcelPool<T>::~DcelPool()
+{
+    clear();
+}
+
+template <class T>
+DcelPool<T>& DcelPool<T>::operator= (DcelPool<T>&& other)
+{
+    clear();
+    swap(other);
+    return *this;
+}
+
+/**
+ * @brief Returns an uninitialized slot, large enough to contain a T.
+ *
+ * @par Complexity:
+ *      \e O(1) amortized
+ */
+template <class T>
+inline void* DcelPool<T>::allocate()
+{
+    Slot* s;
+    if (freeList != nullptr){
+        s = freeList;
+        freeList = freeList->next;
+    }
+    else {
+        if (cursor == cursorEnd)
+            addSlab(nextSlabSize);
+        s = cursor++;
+    }
+    return static_cast<void*>(s);
+}
+
+/**
+ * @brief Gives back to the pool a slot previously returned by allocate().
+ * The element contained in the slot must be already destroyed.
+ *
+ * @par Complexity:
+ *      \e O(1)
+ */
+template <class T>
+inline void DcelPool<T>::deallocate(void* p)
+{
+    Slot* s = static_cast<Slot*>(p);
+    s->next = freeList;
+    freeList = s;
+}
+
+/**
+ * @brief Makes sure that the next n allocations will not require further
+ * memory allocations.
+ */
+template <class T>
+void DcelPool<T>::reserve(std::size_t n)
+{
+    if ((std::size_t)(cursorEnd - cursor) < n)
+        addSlab(n);
+}
+
+/**
+ * @brief Releases all the slabs of the pool.
+ * All the elements contained in the pool must be already destroyed.
+ */
+template <class T>
+void DcelPool<T>::clear()
+{
+    for (Slot* s : slabs)
+        ::operator delete(static_cast<void*>(s));
+    slabs.clear();
+    totalCapacity = 0;
+    nextSlabSize = MIN_SLAB_SIZE;
+    freeList = nullptr;
+    cursor = nullptr;
+    cursorEnd = nullptr;
+}
+
+template <class T>
+void DcelPool<T>::swap(DcelPool<T>& other)
+{
+    std::swap(slabs, other.slabs);
+    std::swap(totalCapacity, other.totalCapacity);
+    std::swap(nextSlabSize, other.nextSlabSize);
+    std::swap(freeList, other.freeList);
+    std::swap(cursor, other.cursor);
+    std::swap(cursorEnd, other.cursorEnd);
+}
+
+/**
+ * @brief Takes the ownership of all the slabs of the other pool, which will be
+ * left empty. Elements allocated in the other pool are not moved.
+ *
+ * @par Complexity:
+ *      \e O(number of slabs and free slots of other)
+ */
+template <class T>
+void DcelPool<T>::splice(DcelPool<T>& other)
+{
+    while (other.cursor != other.cursorEnd)
+        other.deallocate(other.cursor++);
+    slabs.insert(slabs.end(), other.slabs.begin(), other.slabs.end());
+    totalCapacity += other.totalCapacity;
+    //the free slots of other are pushed in front of the free list
+    if (other.freeList != nullptr){
+        Slot* last = other.freeList;
+        while (last->next != nullptr)
+            last = last->next;
+        last->next = freeList;
+        freeList = other.freeList;
+    }
+    other.slabs.clear();
+    other.totalCapacity = 0;
+    other.nextSlabSize = MIN_SLAB_SIZE;
+    other.freeList = nullptr;
+    other.cursor = nullptr;
+    other.cursorEnd = nullptr;
+}
+
+/**
+ * @brief Returns the number of slots allocated by the pool.
+ */
+template <class T>
+inline std::size_t DcelPool<T>::capacity() const
+{
+    return totalCapacity;
+}
+
+/**
+ * @brief Allocates a new slab which becomes the one used by allocate().
+ * The slots left in the previous slab are kept in the free list.
+ */
+template <class T>
+void DcelPool<T>::addSlab(std::size_t size)
+{
+    while (cursor != cursorEnd)
+        deallocate(cursor++);
+    Slot* slab = static_cast<Slot*>(::operator new(size * sizeof(Slot)));
+    slabs.push_back(slab);
+    totalCapacity += size;
+    cursor = slab;
+    cursorEnd = slab + size;
+    if (nextSlabSize < MAX_SLAB_SIZE)
+        nextSlabSize *= 2;
+}
+
+} //namespace cg3::internal
+} //namespace cg3
+
+#endif // CG3_DCEL_POOL_H
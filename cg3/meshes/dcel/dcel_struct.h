@@ -12,12 +12,20 @@
 #include <cg3/utilities/color.h>
 #include <cg3/meshes/mesh.h>
 #include <cg3/io/file_commons.h>
+#include <cg3/utilities/parallel.h>
 #include "dcel_data.h"
 #include "dcel_iterators.h"
+#include "dcel_pool.h"
+
+#include <cstdint>
+#include <unordered_map>
 
 namespace cg3 {
     class SimpleEigenMesh;
     class EigenMesh;
+namespace internal {
+    class DcelBlockWriter;
+} //namespace cg3::internal
 } //namespace cg3
 
 #ifdef CG3_CINOLIB_DEFINED
@@ -69,6 +77,15 @@ namespace cg3 {
  * We can do the same thing with Dcel::HalfEdge and Dcel::Face. For const Dcel, you can use const iterators.
  * Dcel::Vertex and Dcel::Face classes have also other type of iterators (which are mostly circular iterators)
  * that allows to access to incident/adjacent elements. See the documentation for all the specific iterators.
+ *
+ * Vertices, half edges and faces are stored in chunked pools (see internal::DcelPool): elements are
+ * allocated from contiguous slabs and their pointers remain valid until they are deleted. All the slabs
+ * are released at once by clear() and by the destructor. If the size of the mesh is known in advance,
+ * reserve() allows to allocate all the elements in a single slab.
+ *
+ * Coordinates, normals and colors of vertices and faces are not stored inside the elements, but in
+ * contiguous arrays indexed by the ids of the elements (see internal::DcelData). The arrays can be
+ * accessed directly through vertexCoordinateData(), faceNormalData() and the other raw accessors.
  */
 template <class V = Vertex, class HE = HalfEdge, class F = Face>
 class TemplatedDcel : public SerializableObject, public internal::DcelData
@@ -127,6 +144,11 @@ public:
     const HalfEdge* halfEdge(unsigned int idHalfEdge)    const;
     const Face* face(unsigned int idFace)                const;
 	BoundingBox3 boundingBox()                            const;
+    inline const Point3d* vertexCoordinateData()  const;
+    inline const Vec3d* vertexNormalData()        const;
+    inline const Color* vertexColorData()         const;
+    inline const Vec3d* faceNormalData()          const;
+    inline const Color* faceColorData()           const;
     inline unsigned int numberVertices()        const;
     inline unsigned int numberHalfEdges()       const;
     inline unsigned int numberFaces()           const;
@@ -159,6 +181,11 @@ public:
     inline VertexRangeBasedIterator vertexIterator();
     inline HalfEdgeRangeBasedIterator halfEdgeIterator();
     inline FaceRangeBasedIterator faceIterator();
+    inline Point3d* vertexCoordinateData();
+    inline Vec3d* vertexNormalData();
+    inline Color* vertexColorData();
+    inline Vec3d* faceNormalData();
+    inline Color* faceColorData();
 
     /*****************
     * Public Methods *
@@ -173,11 +200,15 @@ public:
     double volume()                                         const;
     Point3d barycenter()                                  const;
     double averageHalfEdgesLength()                      const;
+    void triangulation(
+            std::vector<unsigned int>& triangles,
+            std::vector<unsigned int>& triangleFaces,
+            unsigned int nThreads = numberOfThreads()) const;
     bool saveOnObj(const std::string& fileNameObj) const;
     bool saveOnObj(const std::string& fileNameObj, bool saveProperties)             const;
 	bool saveOnPly(const std::string& fileNamePly, bool binary = true) const;
 	bool saveOnPly(const std::string& fileNamePly, bool binary, io::FileMeshMode fm) const;
-    void saveOnDcelFile(const std::string& fileNameDcel)           const;
+    bool saveOnDcelFile(const std::string& fileNameDcel)           const;
 
     Vertex* addVertex(const Point3d& p = Point3d(), const Vec3d& n = Vec3d(), const Color &c = Color(128, 128, 128));
     HalfEdge* addHalfEdge();
@@ -190,11 +221,12 @@ public:
     bool deleteFace(unsigned int fid);
     void invertFaceOrientations();
     void deleteUnreferencedVertices();
-    void deleteDuplicatedVertices();
+    unsigned int deleteDuplicatedVertices(double epsilon = 0);
     void updateFaceAreas();
     void updateFaceNormals();
     void updateVertexNormals();
 	BoundingBox3 updateBoundingBox();
+    BoundingBox3 updateGeometry(unsigned int nThreads = numberOfThreads());
 	void setFaceColors(const Color &c);
 	void setFaceFlags(int flag);
 	void setVertexColors(const Color &c);
@@ -208,22 +240,26 @@ public:
     void rotate(double matrix[3][3], const Point3d& centroid = Point3d());
     void translate(const Vec3d &c);
     void recalculateIds();
+    void compact();
     void resetFaceColors();
+    void reserve(unsigned int nv, unsigned int nhe, unsigned int nf);
     void clear();
-    #ifdef  CG3_CGAL_DEFINED
     unsigned int triangulateFace(uint idf);
-    void triangulate();
-    #endif
+    unsigned int triangulate(unsigned int nThreads = numberOfThreads());
     bool loadFromFile(const std::string& filename);
     bool loadFromObj(const std::string& filename);
     bool loadFromPly(const std::string& filename);
     bool loadFromDcelFile(const std::string& filename);
+    static TemplatedDcel fromIndexedTriangles(
+            const std::vector<double>& coords,
+            const std::vector<unsigned int>& tris);
 
     void swap(TemplatedDcel& d);
     void merge(const TemplatedDcel& d);
     void merge(TemplatedDcel&& d);
 
-    TemplatedDcel& operator= (TemplatedDcel dcel);
+    TemplatedDcel& operator= (const TemplatedDcel& dcel);
+    TemplatedDcel& operator= (TemplatedDcel&& dcel);
 
     // SerializableObject interface
     void serialize(std::ofstream& binaryFile) const;
@@ -238,13 +274,16 @@ protected:
     std::vector<Vertex* >   vertices;
     std::vector<HalfEdge* > halfEdges;
     std::vector<Face* >     faces;
-    std::set<int>           unusedVids;
-    std::set<int>           unusedHeids;
-    std::set<int>           unusedFids;
+    std::vector<unsigned int> unusedVids;  /**< @brief Free list of the ids of deleted vertices */
+    std::vector<unsigned int> unusedHeids; /**< @brief Free list of the ids of deleted half edges */
+    std::vector<unsigned int> unusedFids;  /**< @brief Free list of the ids of deleted faces */
     unsigned int            nVertices;
     unsigned int            nHalfEdges;
     unsigned int            nFaces;
 	BoundingBox3             bBox;
+    internal::DcelPool<Vertex>   vertexPool;
+    internal::DcelPool<HalfEdge> halfEdgePool;
+    internal::DcelPool<Face>     facePool;
 
     /******************
     * Private Methods *
@@ -254,6 +293,32 @@ protected:
     HalfEdge* addHalfEdge(int id);
     Face* addFace(int id);
 
+    Vertex* newVertex();
+    HalfEdge* newHalfEdge();
+    Face* newFace();
+    void destroyVertex(Vertex* v);
+    void destroyHalfEdge(HalfEdge* he);
+    void destroyFace(Face* f);
+    void destroyElements();
+    void copyElements(const TemplatedDcel& d);
+    void moveElements(TemplatedDcel& d);
+    void compactIds(bool shrink);
+    unsigned int splitFace(
+            Face* f,
+            const std::vector<const cg3::HalfEdge*>& borderHalfEdges,
+            const unsigned int* triangles,
+            unsigned int nTriangles,
+            std::unordered_map<uint64_t, HalfEdge*>& diagonals);
+    static void deserializeUnusedIds(std::vector<unsigned int>& ids, std::ifstream& binaryFile);
+    template <class Reader>
+    void deserializeBlocks(Reader& reader);
+    void deserializeLegacy(std::ifstream& binaryFile);
+    void deserializeElementData(std::ifstream& binaryFile);
+    template <class T>
+    static int32_t elementId(const T* e);
+    static void putColor(internal::DcelBlockWriter& w, const Color& c);
+    static Point3d readPoint(const char* p);
+
     std::vector<const Vertex*> makeSingleBorder(const Face *f)     const;
     void toStdVectors(
             std::vector<double> &vertices,
@@ -264,6 +329,11 @@ protected:
             std::vector<unsigned int> &faceSizes,
             std::vector<float> &faceColors) const;
 
+    void buildFromIndexedTriangles(
+            const std::vector<double>& coords,
+            const std::vector<unsigned int>& tris,
+            bool computeVertexNormals);
+
     void afterLoadFile(
             const std::list<double>& coords,
             const std::list<unsigned int>& faces,
@@ -11,11 +11,19 @@
 #include <cg3/utilities/const.h>
 #include <cg3/io/serialize.h>
 #include <cg3/io/load_save_file.h>
+#include <cg3/io/mapped_file.h>
 #include <cg3/geometry/transformations3.h>
+#include <cg3/geometry/polygon_triangulator.h>
+#include <cg3/utilities/hash.h>
+#include <cg3/utilities/parallel.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <unordered_map>
 
-#ifdef  CG3_CGAL_DEFINED
-#include <cg3/cgal/triangulation3.h>
-#endif //CGAL_DEFINED
 
 #include <cg3/meshes/eigenmesh/eigenmesh.h>
 
@@ -25,6 +33,127 @@
 
 namespace cg3 {
 
+namespace internal {
+
+/* Layout of the version 2 of the .dcel file (after the tag string "cg3Dcel2").
+ * All the values are little endian, integers are 32 bit and colors are rgba bytes.
+ * Element blocks contain a record for every slot (id) of the Dcel: slots of deleted
+ * elements are recognized by the lists of unused ids, and their records are zeroed.
+ *
+ * header:     magic, version, #vertex slots, #half edge slots, #face slots,
+ *             #unused vids, #unused heids, #unused fids (uint64), #inner half edges (uint64),
+ *             bounding box (6 doubles)
+ * unused ids: unusedVids, unusedHeids, unusedFids
+ * vertices:   coordinates (3 doubles), normals (3 doubles), colors (4 bytes),
+ *             incident half edge, cardinality, flag
+ * half edges: from vertex, to vertex, twin, prev, next, face, flag
+ * faces:      normals (3 doubles), colors (4 bytes), areas (double),
+ *             outer half edge, flag, number of inner half edges;
+ *             then the inner half edges of all the faces
+ *
+ * Missing pointers are stored as -1.
+ * The data of derived Vertex, HalfEdge and Face classes follows the blocks.
+ */
+const uint32_t DCEL_FILE_MAGIC = 0x6C656364; //"dcel"
+const uint32_t DCEL_FILE_VERSION = 2;
+const std::size_t DCEL_FILE_HEADER_SIZE = 2 * sizeof(uint32_t) + 7 * sizeof(uint64_t) + 6 * sizeof(double);
+
+/**
+ * @brief Buffers small values and writes them on the file in large blocks.
+ */
+class DcelBlockWriter
+{
+public:
+    DcelBlockWriter(std::ofstream& file) : file(file), buffer(1 << 20), pos(0) {}
+    ~DcelBlockWriter() { flush(); }
+
+    template <class T>
+    void put(const T& value)
+    {
+        if (pos + sizeof(T) > buffer.size())
+            flush();
+        std::memcpy(&buffer[pos], &value, sizeof(T));
+        pos += sizeof(T);
+    }
+
+    template <class T>
+    void putArray(const T* values, std::size_t n)
+    {
+        flush();
+        file.write(reinterpret_cast<const char*>(values), n * sizeof(T));
+    }
+
+    void flush()
+    {
+        if (pos > 0)
+            file.write(buffer.data(), pos);
+        pos = 0;
+    }
+
+private:
+    std::ofstream& file;
+    std::vector<char> buffer;
+    std::size_t pos;
+};
+
+/**
+ * @brief Reads blocks of bytes from a stream.
+ * The returned pointer is valid until the next call of read().
+ */
+class DcelStreamReader
+{
+public:
+    DcelStreamReader(std::ifstream& file) : file(file) {}
+
+    const char* read(std::size_t n)
+    {
+        buffer.resize(n);
+        if (n > 0 && !file.read(buffer.data(), n))
+            throw std::ios_base::failure("Unexpected end of file");
+        return buffer.data();
+    }
+
+private:
+    std::ifstream& file;
+    std::vector<char> buffer;
+};
+
+/**
+ * @brief Reads blocks of bytes from memory (e.g. a memory mapped file), without copies.
+ */
+class DcelMemoryReader
+{
+public:
+    DcelMemoryReader(const char* begin, const char* end) : begin(begin), cur(begin), end(end) {}
+
+    const char* read(std::size_t n)
+    {
+        if ((std::size_t)(end - cur) < n)
+            throw std::ios_base::failure("Unexpected end of file");
+        const char* p = cur;
+        cur += n;
+        return p;
+    }
+
+    std::size_t position() const { return cur - begin; }
+
+private:
+    const char* begin;
+    const char* cur;
+    const char* end;
+};
+
+template <class T>
+inline T readDcelValue(const char*& p)
+{
+    T value;
+    std::memcpy(&value, p, sizeof(T));
+    p += sizeof(T);
+    return value;
+}
+
+} //namespace cg3::internal
+
 /****
  * Range Based Iterators
  *****/
@@ -142,122 +271,36 @@ inline TemplatedDcel<V, HE, F>::TemplatedDcel(const std::string& filename) :
 /**
  * @brief Dcel's Copy Constructor.
  *
- * Creates a new Dcel starting from the input Dcel, creating new instances of
- * vertices, half edges and faces and setting all the relations between them.
+ * Creates a new Dcel starting from the input Dcel: the attribute arrays are copied
+ * as contiguous blocks, the elements are copy constructed and then relinked by id.
+ * Ids of the elements (and unused ids) are the same of the input Dcel.
  *
  * @param[in] dcel.
+ * @par Complexity:
+ *      \e O(numVertices \e + \e NumHalfEdges \e + \e NumFaces)
  */
 template <class V, class HE, class F>
-TemplatedDcel<V, HE, F>::TemplatedDcel(const TemplatedDcel<V, HE, F>& dcel)
+TemplatedDcel<V, HE, F>::TemplatedDcel(const TemplatedDcel<V, HE, F>& dcel) :
+    nVertices(0),
+    nHalfEdges(0),
+    nFaces(0)
 {
-    unusedVids = dcel.unusedVids;
-    unusedHeids = dcel.unusedHeids;
-    unusedFids = dcel.unusedFids;
-    nVertices = dcel.nVertices;
-    nHalfEdges = dcel.nHalfEdges;
-    nFaces = dcel.nFaces;
+    copyElements(dcel);
     bBox = dcel.bBox;
-    std::map<const TemplatedDcel::Vertex*, TemplatedDcel::Vertex*> mapVertices;
-	std::map<const TemplatedDcel::HalfEdge*, TemplatedDcel::HalfEdge*>
-			mapHalfEdges;
-    std::map<const TemplatedDcel::Face*, TemplatedDcel::Face*> mapFaces;
-    vertices.resize(dcel.vertices.size(), nullptr);
-    #ifdef NDEBUG
-	vertexCoordinates.resize(dcel.vertexCoordinates.size(), Point3d());
-	vertexNormals.resize(dcel.vertexNormals.size(), Vec3d());
-    vertexColors.resize(dcel.vertexColors.size(), Color());
-    #endif
-    for (const TemplatedDcel::Vertex* ov : dcel.vertexIterator()) {
-        TemplatedDcel::Vertex* v = addVertex(ov->id());
-        v->setId(ov->id());
-        v->setCoordinate(ov->coordinate());
-        v->setFlag(ov->flag());
-        v->setCardinality(ov->cardinality());
-        v->setNormal(ov->normal());
-        v->setColor(ov->color());
-        mapVertices[ov] = v;
-    }
-
-    halfEdges.resize(dcel.halfEdges.size(), nullptr);
-    for (const TemplatedDcel::HalfEdge* ohe : dcel.halfEdgeIterator()) {
-        TemplatedDcel::HalfEdge* he = addHalfEdge(ohe->id());
-        he->setId(ohe->id());
-        he->setFlag(ohe->flag());
-        he->setFromVertex(mapVertices[ohe->fromVertex()]);
-        he->setToVertex(mapVertices[ohe->toVertex()]);
-        mapHalfEdges[ohe] = he;
-    }
-
-    faces.resize(dcel.faces.size(), nullptr);
-    #ifdef NDEBUG
-	faceNormals.resize(dcel.faceNormals.size(), Vec3d());
-    faceColors.resize(dcel.faceColors.size(), Color());
-    #endif
-    for (const Face* of : dcel.faceIterator()){
-        TemplatedDcel::Face* f = addFace(of->id());
-        f->setId(of->id());
-        f->setColor(of->color());
-        f->setFlag(of->flag());
-        f->setNormal(of->normal());
-        f->setArea(of->area());
-        f->setOuterHalfEdge(mapHalfEdges[of->outerHalfEdge()]);
-		for (typename TemplatedDcel<V, HE, F>::Face::ConstInnerHalfEdgeIterator
-			 heit = of->innerHalfEdgeBegin();
-			 heit != of->innerHalfEdgeEnd();
-			 ++heit){
-            f->addInnerHalfEdge(mapHalfEdges[*heit]);
-        }
-        mapFaces[of] = f;
-    }
-
-    for (const TemplatedDcel::HalfEdge* ohe : dcel.halfEdgeIterator()) {
-        TemplatedDcel::HalfEdge* he = mapHalfEdges[ohe];
-        he->setNext(mapHalfEdges[ohe->next()]);
-        he->setPrev(mapHalfEdges[ohe->prev()]);
-        he->setTwin(mapHalfEdges[ohe->twin()]);
-        he->setFace(mapFaces[ohe->face()]);
-    }
-
-    for (const TemplatedDcel::Vertex* ov : dcel.vertexIterator()) {
-        TemplatedDcel::Vertex * v = mapVertices[ov];
-        v->setIncidentHalfEdge(mapHalfEdges[ov->incidentHalfEdge()]);
-    }
 }
 
 /**
  * @brief Dcel's Move Constructor.
+ * The storage of the elements is taken from the input Dcel, which will be empty.
  * @param[in] dcel
  */
 template <class V, class HE, class F>
-TemplatedDcel<V, HE, F>::TemplatedDcel(TemplatedDcel<V, HE, F>&& dcel)
-{
-    vertices = std::move(dcel.vertices);
-    faces = std::move(dcel.faces);
-    halfEdges = std::move(dcel.halfEdges);
-    unusedVids = std::move(dcel.unusedVids);
-    unusedHeids = std::move(dcel.unusedHeids);
-    unusedFids = std::move(dcel.unusedFids);
-    nVertices = std::move(dcel.nVertices);
-    nHalfEdges = std::move(dcel.nHalfEdges);
-    nFaces = std::move(dcel.nFaces);
-    bBox = std::move(dcel.bBox);
-    #ifdef NDEBUG
-    vertexCoordinates = std::move(dcel.vertexCoordinates);
-    vertexNormals = std::move(dcel.vertexNormals);
-    vertexColors = std::move(dcel.vertexColors);
-    faceNormals = std::move(dcel.faceNormals);
-    faceColors = std::move(dcel.faceColors);
-    for (Vertex* v : vertexIterator()){
-        v->parent = this;
-    }
-    for (HalfEdge* he : halfEdgeIterator()){
-        he->parent = this;
-    }
-    for (Face* f : faceIterator()){
-        f->parent = this;
-    }
-    #endif
-
+TemplatedDcel<V, HE, F>::TemplatedDcel(TemplatedDcel<V, HE, F>&& dcel) :
+    nVertices(0),
+    nHalfEdges(0),
+    nFaces(0)
+{
+    moveElements(dcel);
 }
 
 template <class V, class HE, class F>
@@ -284,20 +327,12 @@ TemplatedDcel<V, HE, F>::TemplatedDcel(const cinolib::Trimesh<> &trimesh)
 /**
  * @brief Dcel's Destructor.
  *
- * Deletes all the elements of the Dcel.
+ * Deletes all the elements of the Dcel and releases their storage.
  */
 template <class V, class HE, class F>
 TemplatedDcel<V, HE, F>::~TemplatedDcel()
 {
-    for (unsigned int i=0; i<vertices.size(); i++)
-        if (vertices[i]!= nullptr)
-            delete vertices[i];
-    for (unsigned int i=0; i<halfEdges.size(); i++)
-        if (halfEdges[i] != nullptr)
-            delete halfEdges[i];
-    for (unsigned int i=0; i<faces.size(); i++)
-        if (faces[i] != nullptr)
-            delete faces[i];
+    destroyElements();
 }
 
 /***
@@ -750,16 +785,115 @@ TemplatedDcel<V, HE, F>::faceIterator()
     return FaceRangeBasedIterator(this);
 }
 
+/**
+ * @brief Returns a pointer to the contiguous array of the coordinates of the vertices.
+ *
+ * The i-th entry of the array refers to the vertex having id i; the array has
+ * vertices.size() entries and the entries of deleted vertices are meaningless.
+ * The pointer is invalidated by any operation that adds vertices, or that
+ * changes their ids (recalculateIds(), compact()).
+ * @par Complexity:
+ *      \e O(1)
+ */
+template <class V, class HE, class F>
+inline const Point3d* TemplatedDcel<V, HE, F>::vertexCoordinateData() const
+{
+    return vertexCoordinates.data();
+}
+
+/**
+ * @see vertexCoordinateData() const
+ */
+template <class V, class HE, class F>
+inline Point3d* TemplatedDcel<V, HE, F>::vertexCoordinateData()
+{
+    return vertexCoordinates.data();
+}
+
+/**
+ * @brief Returns a pointer to the contiguous array of the normals of the vertices.
+ * @see vertexCoordinateData()
+ */
+template <class V, class HE, class F>
+inline const Vec3d* TemplatedDcel<V, HE, F>::vertexNormalData() const
+{
+    return vertexNormals.data();
+}
+
+/**
+ * @see vertexNormalData() const
+ */
+template <class V, class HE, class F>
+inline Vec3d* TemplatedDcel<V, HE, F>::vertexNormalData()
+{
+    return vertexNormals.data();
+}
+
+/**
+ * @brief Returns a pointer to the contiguous array of the colors of the vertices.
+ * @see vertexCoordinateData()
+ */
+template <class V, class HE, class F>
+inline const Color* TemplatedDcel<V, HE, F>::vertexColorData() const
+{
+    return vertexColors.data();
+}
+
+/**
+ * @see vertexColorData() const
+ */
+template <class V, class HE, class F>
+inline Color* TemplatedDcel<V, HE, F>::vertexColorData()
+{
+    return vertexColors.data();
+}
+
+/**
+ * @brief Returns a pointer to the contiguous array of the normals of the faces,
+ * indexed by the ids of the faces.
+ * @see vertexCoordinateData()
+ */
+template <class V, class HE, class F>
+inline const Vec3d* TemplatedDcel<V, HE, F>::faceNormalData() const
+{
+    return faceNormals.data();
+}
+
+/**
+ * @see faceNormalData() const
+ */
+template <class V, class HE, class F>
+inline Vec3d* TemplatedDcel<V, HE, F>::faceNormalData()
+{
+    return faceNormals.data();
+}
+
+/**
+ * @brief Returns a pointer to the contiguous array of the colors of the faces,
+ * indexed by the ids of the faces.
+ * @see vertexCoordinateData()
+ */
+template <class V, class HE, class F>
+inline const Color* TemplatedDcel<V, HE, F>::faceColorData() const
+{
+    return faceColors.data();
+}
+
+/**
+ * @see faceColorData() const
+ */
+template <class V, class HE, class F>
+inline Color* TemplatedDcel<V, HE, F>::faceColorData()
+{
+    return faceColors.data();
+}
+
 template <class V, class HE, class F>
 bool TemplatedDcel<V, HE, F>::vertexBelongsToThis(
         const typename TemplatedDcel<V, HE, F>::Vertex* v) const
 {
     if (!v) return false;
-    #ifdef NDEBUG
     return v->parent == this;
-    #else
-    return v->id() < vertices.size() && vertices[v->id()] == v;
-    #endif
 }
 
 template <class V, class HE, class F>
@@ -767,11 +901,7 @@ bool TemplatedDcel<V, HE, F>::halfEdgeBelongsToThis(
         const typename TemplatedDcel<V, HE, F>::HalfEdge* he) const
 {
     if (!he) return false;
-    #ifdef NDEBUG
     return he->parent == this;
-    #else
-    return he->id() < halfEdges.size() && halfEdges[he->id()] == he;
-    #endif
 }
 
 template <class V, class HE, class F>
@@ -779,11 +909,7 @@ bool TemplatedDcel<V, HE, F>::faceBelongsToThis(
         const typename TemplatedDcel<V, HE, F>::Face* f) const
 {
     if (!f) return false;
-    #ifdef NDEBUG
     return f->parent == this;
-    #else
-    return f->id() < faces.size() && faces[f->id()] == f;
-    #endif
 }
 
 /**
@@ -861,6 +987,78 @@ double TemplatedDcel<V, HE, F>::averageHalfEdgesLength() const
     return average;
 }
 
+/**
+ * @brief Computes a triangulation of all the faces of the Dcel, as a flat buffer
+ * of vertex ids.
+ *
+ * Triangular faces are copied as they are; the other faces (polygons, possibly
+ * with holes) are triangulated by ear clipping (see PolygonTriangulator).
+ * Triangles have the same orientation of their faces, and are listed following
+ * the order of the face ids. The faces are split in chunks processed in parallel,
+ * each one with its own triangulator and buffers: the result does not depend on
+ * the number of threads.
+ *
+ * @param[out] triangles: the ids of the vertices of the triangles, three for each triangle
+ * @param[out] triangleFaces: for each triangle, the id of the face that contains it
+ * @param[in] nThreads: number of threads used; by default, all the hardware threads
+ *
+ * @par Complexity:
+ *      \e O(numFaces / nThreads) for triangle and convex faces
+ */
+template <class V, class HE, class F>
+void TemplatedDcel<V, HE, F>::triangulation(
+        std::vector<unsigned int>& triangles,
+        std::vector<unsigned int>& triangleFaces,
+        unsigned int nThreads) const
+{
+    const std::size_t grain = 4096;
+    const std::size_t nChunks = numberOfChunks(faces.size(), grain);
+    std::vector<std::vector<unsigned int> > chunkTriangles(nChunks), chunkFaces(nChunks);
+
+    parallelForChunks(faces.size(), grain, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+        PolygonTriangulator triangulator;
+        std::vector<Point3d> points;
+        std::vector<unsigned int> borderSizes, indices;
+        std::vector<const cg3::HalfEdge*> borderHalfEdges;
+        std::vector<unsigned int>& tris = chunkTriangles[chunk];
+        std::vector<unsigned int>& tf = chunkFaces[chunk];
+        tris.reserve((end - begin) * 3);
+        tf.reserve(end - begin);
+        for (std::size_t i = begin; i < end; ++i){
+            const Face* f = faces[i];
+            if (f == nullptr || f->outerHalfEdge() == nullptr)
+                continue;
+            const cg3::HalfEdge* he = f->outerHalfEdge();
+            if (!f->hasHoles() && he->next()->next()->next() == he) {
+                tris.push_back(he->fromVertex()->id());
+                tris.push_back(he->toVertex()->id());
+                tris.push_back(he->next()->toVertex()->id());
+                tf.push_back(i);
+            }
+            else {
+                f->borders(points, borderSizes, borderHalfEdges);
+                indices.clear();
+                unsigned int nt = triangulator.triangulate(points, borderSizes, indices, faceNormals[i]);
+                for (unsigned int k : indices)
+                    tris.push_back(borderHalfEdges[k]->fromVertex()->id());
+                tf.insert(tf.end(), nt, (unsigned int)i);
+            }
+        }
+    }, nThreads);
+
+    std::size_t nTriangles = 0;
+    for (const std::vector<unsigned int>& tf : chunkFaces)
+        nTriangles += tf.size();
+    triangles.resize(nTriangles * 3);
+    triangleFaces.resize(nTriangles);
+    std::size_t t = 0;
+    for (std::size_t c = 0; c < nChunks; ++c){
+        std::copy(chunkTriangles[c].begin(), chunkTriangles[c].end(), triangles.begin() + t * 3);
+        std::copy(chunkFaces[c].begin(), chunkFaces[c].end(), triangleFaces.begin() + t);
+        t += chunkFaces[c].size();
+    }
+}
+
 /**
  * @brief Saves the mesh in a Wavefront OBJ file.
  *
@@ -979,21 +1177,27 @@ bool TemplatedDcel<V, HE, F>::saveOnPly(
  * @brief Saves the mesh in the cg3's format "dcel".
  * Allows to explicitly save the holes of the faces.
  *
+ * The file uses the version 2 of the format (see serialize()), in which attributes
+ * and connectivity are stored in contiguous blocks that loadFromDcelFile() reads
+ * from a memory mapping.
+ *
  * @param[in] fileNameDcel: the file name, \b with \b dcel \b extension
+ * @return true if the file has been written correctly.
  *
  * @par Complexity:
  *      \e O(numVertices) + \e O(numFaces) + \e O(numHalfEdges)
  */
 template <class V, class HE, class F>
-void TemplatedDcel<V, HE, F>::saveOnDcelFile(
+bool TemplatedDcel<V, HE, F>::saveOnDcelFile(
 		const std::string& fileNameDcel) const
 {
     std::ofstream myfile;
     myfile.open (fileNameDcel, std::ios::out | std::ios::binary);
-    if (myfile.is_open()) {
-        serialize(myfile);
-    }
+    if (!myfile.is_open())
+        return false;
+    serialize(myfile);
     myfile.close();
+    return myfile.good();
 }
 
 /**
@@ -1010,38 +1214,22 @@ typename TemplatedDcel<V, HE, F>::Vertex *TemplatedDcel<V, HE, F>::addVertex(
 		const Vec3d& n,
 		const Color& c)
 {
-    #ifdef NDEBUG
-    Vertex* last= new Vertex(*this);
-    #else
-    Vertex* last= new Vertex();
-    #endif
+    Vertex* last = newVertex();
     if (unusedVids.size() == 0) {
         last->setId(nVertices);
         vertices.push_back(last);
-        #ifdef NDEBUG
         vertexCoordinates.push_back(p);
         vertexNormals.push_back(n);
         vertexColors.push_back(c);
-        #else
-        last->setCoordinate(p);
-        last->setNormal(n);
-        last->setColor(c);
-        #endif
     }
     else {
-        int vid = *(unusedVids.begin());
+        unsigned int vid = unusedVids.back();
+        unusedVids.pop_back();
         last->setId(vid);
         vertices[vid] = last;
-        unusedVids.erase(vid);
-        #ifdef NDEBUG
         vertexCoordinates[vid] = p;
         vertexNormals[vid] = n;
         vertexColors[vid] = c;
-        #else
-        last->setCoordinate(p);
-        last->setNormal(n);
-        last->setColor(c);
-        #endif
 
     }
     nVertices++;
@@ -1059,22 +1247,17 @@ template <class V, class HE, class F>
 typename TemplatedDcel<V, HE, F>::HalfEdge*
 TemplatedDcel<V, HE, F>::addHalfEdge()
 {
-    #ifdef NDEBUG
-    HalfEdge* last = new HalfEdge(*this);
-    #else
-    HalfEdge* last = new HalfEdge();
-    #endif
+    HalfEdge* last = newHalfEdge();
     if (unusedHeids.size() == 0){
         last->setId(nHalfEdges);
         halfEdges.push_back(last);
         //halfEdgeLinks.push_back({-1, -1, -1, -1, -1, -1});
     }
     else {
-        int heid = *(unusedHeids.begin());
+        unsigned int heid = unusedHeids.back();
+        unusedHeids.pop_back();
         last->setId(heid);
         halfEdges[heid] = last;
-        //halfEdgeLinks[heid] = {-1, -1, -1, -1, -1, -1};
-        unusedHeids.erase(heid);
     }
     nHalfEdges++;
     return last;
@@ -1095,34 +1278,20 @@ template <class V, class HE, class F>
 typename TemplatedDcel<V, HE, F>::Face*
 TemplatedDcel<V, HE, F>::addFace(const Vec3d& n, const Color& c)
 {
-    #ifdef NDEBUG
-    Face* last = new Face(*this);
-    #else
-    Face* last = new Face();
-    #endif
+    Face* last = newFace();
     if (unusedFids.size() == 0){
         last->setId(nFaces);
         faces.push_back(last);
-        #ifdef NDEBUG
         faceNormals.push_back(n);
         faceColors.push_back(c);
-        #else
-        last->setNormal(n);
-        last->setColor(c);
-        #endif
     }
     else {
-        int fid = *(unusedFids.begin());
+        unsigned int fid = unusedFids.back();
+        unusedFids.pop_back();
         last->setId(fid);
         faces[fid] = last;
-        unusedFids.erase(fid);
-        #ifdef NDEBUG
         faceNormals[fid] = n;
         faceColors[fid] = c;
-        #else
-        last->setNormal(n);
-        last->setColor(c);
-        #endif
     }
     nFaces++;
     return last;
@@ -1167,10 +1336,10 @@ bool TemplatedDcel<V, HE, F>::deleteVertex(typename TemplatedDcel::Vertex* v)
             } while (he != v->_incidentHalfEdge);
         }
         vertices[v->_id]=nullptr;
-        unusedVids.insert(v->_id);
+        unusedVids.push_back(v->_id);
         nVertices--;
 
-        delete v;
+        destroyVertex(v);
         return true;
     }
     else
@@ -1229,10 +1398,10 @@ bool TemplatedDcel<V, HE, F>::deleteHalfEdge(HalfEdge* he)
 			if (he->_fromVertex->_incidentHalfEdge == he)
 				he->_fromVertex->_incidentHalfEdge = nullptr;
         halfEdges[he->_id] = nullptr;
-        unusedHeids.insert(he->_id);
+        unusedHeids.push_back(he->_id);
         nHalfEdges--;
 
-        delete he;
+        destroyHalfEdge(he);
         return true;
     }
     else
@@ -1282,9 +1451,9 @@ bool TemplatedDcel<V, HE, F>::deleteFace(Face* f)
             } while (he != f->_innerHalfEdges[i]);
         }
         faces[f->id()]=nullptr;
-        unusedFids.insert(f->id());
+        unusedFids.push_back(f->id());
         nFaces--;
-        delete f;
+        destroyFace(f);
         return true;
     }
     else
@@ -1320,36 +1489,115 @@ void TemplatedDcel<V, HE, F>::deleteUnreferencedVertices()
     }
 }
 
-template <class V, class HE, class F>
-void TemplatedDcel<V, HE, F>::deleteDuplicatedVertices()
-{
-    std::vector<std::pair<uint, uint>> duplicated;
-    for (uint i = 0; i < vertices.size(); ++i){
-        for (uint j = i+1; j < vertices.size(); ++j) {
-            if (vertices[i] && vertices[j] && vertices[i]->coordinate() == vertices[j]->coordinate()){
-                duplicated.push_back(std::make_pair(i, j));
+/**
+ * @brief Merges all the vertices having the same coordinates.
+ *
+ * Every group of duplicated vertices is collapsed into the vertex of the group
+ * having the smallest id: all the half edges incident to the other vertices of
+ * the group are linked to it, and the other vertices are deleted.
+ * Half edges that become degenerate (same from and to vertex) are unlinked from
+ * their faces.
+ *
+ * Exact duplicates are found sorting the vertices by coordinates. If an epsilon
+ * greater than zero is given, vertices are hashed on a uniform grid having cells of
+ * size epsilon, and a vertex is merged into the vertex with the smallest id, among
+ * the ones that are not already merged and whose distance is less or equal than
+ * epsilon. Cell coordinates are clamped to +-2^62, so very small epsilons or very
+ * large coordinates do not overflow (vertices in the clamped cells are still
+ * compared by distance).
+ *
+ * @param[in] epsilon: tolerance for the distance between two duplicated vertices,
+ * default 0 (exact duplicates)
+ * @return the number of deleted vertices
+ * @par Complexity:
+ *      \e O(numVertices log(numVertices) + numHalfEdges)
+ */
+template <class V, class HE, class F>
+unsigned int TemplatedDcel<V, HE, F>::deleteDuplicatedVertices(double epsilon)
+{
+    //for each vertex id, the id of the vertex that will replace it
+    std::vector<uint> rep(vertices.size());
+    for (uint i = 0; i < rep.size(); ++i)
+        rep[i] = i;
+    unsigned int nMerged = 0;
+
+    if (epsilon <= 0) {
+        std::vector<uint> sorted;
+        sorted.reserve(nVertices);
+        for (const Vertex* v : vertexIterator())
+            sorted.push_back(v->id());
+        std::sort(sorted.begin(), sorted.end(), [&](uint a, uint b){
+            const Point3d& pa = vertices[a]->coordinate();
+            const Point3d& pb = vertices[b]->coordinate();
+            return pa < pb || (pa == pb && a < b);
+        });
+        for (uint i = 1; i < sorted.size(); ++i) {
+            uint first = rep[sorted[i-1]];
+            if (vertices[sorted[i]]->coordinate() == vertices[first]->coordinate()){
+                rep[sorted[i]] = first;
+                nMerged++;
             }
         }
     }
-
-    for (uint i = 0; i < duplicated.size(); ++i){
-        //duplicated[i].second becomes duplicated[i].first
-        for (HalfEdge* he : halfEdgeIterator()){
-            if (he->fromVertex()->id() == duplicated[i].second){
-                he->setFromVertex(vertices[duplicated[i].first]);
+    else {
+        typedef std::array<long long int, 3> Cell;
+        //cell coordinate, clamped in a range where the cast and c+-1 are defined
+        auto cellCoordinate = [epsilon](double x) {
+            const double limit = 4611686018427387904.0; //2^62
+            double c = std::floor(x / epsilon);
+            if (c > limit)
+                c = limit;
+            else if (!(c >= -limit)) //also NaN
+                c = -limit;
+            return (long long int)c;
+        };
+        std::unordered_map<Cell, std::vector<uint>> grid;
+        grid.reserve(nVertices);
+        for (const Vertex* v : vertexIterator()) {
+            const Point3d& p = v->coordinate();
+            Cell c = {cellCoordinate(p.x()),
+                      cellCoordinate(p.y()),
+                      cellCoordinate(p.z())};
+            const uint none = std::numeric_limits<uint>::max();
+            uint found = none;
+            for (int i = -1; i <= 1; ++i) {
+                for (int j = -1; j <= 1; ++j) {
+                    for (int k = -1; k <= 1; ++k) {
+                        auto it = grid.find({c[0]+i, c[1]+j, c[2]+k});
+                        if (it != grid.end()) {
+                            for (uint id : it->second) {
+                                if ((found == none || id < found) &&
+                                        vertices[id]->coordinate().dist(p) <= epsilon)
+                                    found = id;
+                            }
+                        }
+                    }
+                }
+            }
+            if (found != none) {
+                rep[v->id()] = found;
+                nMerged++;
             }
-            if (he->toVertex()->id() == duplicated[i].second){
-                he->setToVertex(vertices[duplicated[i].first]);
+            else {
+                grid[c].push_back(v->id());
             }
         }
-        vertices[duplicated[i].second]->setIncidentHalfEdge(nullptr);
-        deleteVertex(duplicated[i].second);
+    }
 
-        //adjusting next duplicates: duplicated[i].second should not exists also in the next duplicated pairs!
-        for (uint j = i+1; j < duplicated.size(); ++j){
-            if (duplicated[j].first == duplicated[i].second){
-                duplicated[j].first = duplicated[i].first;
-            }
+    if (nMerged == 0)
+        return 0;
+
+    //single sweep on the half edges
+    for (HalfEdge* he : halfEdgeIterator()){
+        if (he->fromVertex() != nullptr && rep[he->fromVertex()->id()] != he->fromVertex()->id())
+            he->setFromVertex(vertices[rep[he->fromVertex()->id()]]);
+        if (he->toVertex() != nullptr && rep[he->toVertex()->id()] != he->toVertex()->id())
+            he->setToVertex(vertices[rep[he->toVertex()->id()]]);
+    }
+    for (uint i = 0; i < rep.size(); ++i){
+        if (rep[i] != i) {
+            vertices[i]->setIncidentHalfEdge(nullptr);
+            deleteVertex(i);
         }
     }
 
@@ -1368,6 +1616,7 @@ void TemplatedDcel<V, HE, F>::deleteDuplicatedVertices()
             }
         }
     }
+    return nMerged;
 }
 
 template<class V, class HE, class F>
@@ -1393,7 +1642,24 @@ void TemplatedDcel<V, HE, F>::updateFaceAreas()
 template <class V, class HE, class F>
 void TemplatedDcel<V, HE, F>::updateFaceNormals()
 {
-    for (Face* f : faceIterator()){
+    for (unsigned int i = 0; i < faces.size(); ++i){
+        Face* f = faces[i];
+        if (f == nullptr)
+            continue;
+        const HalfEdge* he = f->outerHalfEdge();
+        if (he != nullptr && he->next() != nullptr && he->next()->next() != nullptr &&
+                he->next()->next()->next() == he) {
+            const Point3d& a = vertexCoordinates[he->fromVertex()->id()];
+            const Point3d& b = vertexCoordinates[he->toVertex()->id()];
+            const Point3d& c = vertexCoordinates[he->next()->toVertex()->id()];
+            Vec3d n = (b - a).cross(c - a);
+            if (n != Vec3d()) {
+                n.normalize();
+                faceNormals[i] = n;
+                continue;
+            }
+        }
+        //polygons and degenerate triangles
         f->updateNormal();
     }
 }
@@ -1402,7 +1668,9 @@ void TemplatedDcel<V, HE, F>::updateFaceNormals()
  * \~Italian
  * @brief Funzione che ricalcola e aggiorna le normali e le cardinalità dei vertici presenti nella Dcel.
  *
- * Richiama il metodo \c updateNormal() della classe Dcel::Vertex.
+ * Richiama il metodo \c updateNormal() della classe Dcel::Vertex: la normale di un vertice
+ * è la media (non pesata e non normalizzata) delle normali delle sue facce incidenti.
+ * updateGeometry() calcola le stesse normali.
  *
  * @warning Utilizza Dcel::Vertex::ConstIncidentFaceIterator
  * @par Complessità:
@@ -1426,17 +1694,126 @@ template <class V, class HE, class F>
 BoundingBox3 TemplatedDcel<V, HE, F>::updateBoundingBox()
 {
     bBox.reset();
-    for (const Vertex* v : vertexIterator()){
-        const Point3d& coord = v->coordinate();
+    Point3d min = bBox.min(), max = bBox.max();
+    for (unsigned int i = 0; i < vertexCoordinates.size(); ++i){
+        if (vertices[i] == nullptr)
+            continue;
+        const Point3d& coord = vertexCoordinates[i];
+
+        min.setX(std::min(min.x(), coord.x()));
+        min.setY(std::min(min.y(), coord.y()));
+        min.setZ(std::min(min.z(), coord.z()));
+
+        max.setX(std::max(max.x(), coord.x()));
+        max.setY(std::max(max.y(), coord.y()));
+        max.setZ(std::max(max.z(), coord.z()));
+    }
+    bBox.setMin(min);
+    bBox.setMax(max);
+    return bBox;
+}
 
-        bBox.setMinX(std::min(bBox.minX(), coord.x()));
-        bBox.setMinY(std::min(bBox.minY(), coord.y()));
-        bBox.setMinZ(std::min(bBox.minZ(), coord.z()));
+/**
+ * @brief Updates in a single parallel sweep all the geometric attributes of the Dcel:
+ * - normals and areas of the faces;
+ * - normals and cardinalities of the vertices;
+ * - the bounding box.
+ *
+ * As in updateVertexNormals(), the normal of a vertex is the mean of the normals of
+ * its incident faces, not weighted and not normalized: both the functions compute the
+ * same normals. Vertices without incident half edges get a zero normal and cardinality.
+ * Degenerate triangles get a zero normal and area, and their number is reported once
+ * on std::cerr.
+ *
+ * Faces are processed first, then vertices gather the values of their incident faces.
+ * Every value is computed by a single thread, always in the same order, and the partial
+ * bounding boxes are reduced in a fixed order: the result does not depend on the number
+ * of threads.
+ *
+ * @param[in] nThreads: number of threads used; by default, all the hardware threads
+ * @return The updated bounding box
+ * @par Complexity:
+ *      \e O((numVertices + numFaces) / nThreads)
+ */
+template <class V, class HE, class F>
+BoundingBox3 TemplatedDcel<V, HE, F>::updateGeometry(unsigned int nThreads)
+{
+    const std::size_t grain = 4096;
+    std::atomic<std::size_t> nDegenerate(0);
+
+    parallelFor(0, faces.size(), [&](std::size_t i) {
+        Face* f = faces[i];
+        if (f == nullptr)
+            return;
+        const HalfEdge* he = f->outerHalfEdge();
+        if (he != nullptr && he->next() != nullptr && he->next()->next() != nullptr &&
+                he->next()->next()->next() == he) {
+            const Point3d& a = vertexCoordinates[he->fromVertex()->id()];
+            const Point3d& b = vertexCoordinates[he->toVertex()->id()];
+            const Point3d& c = vertexCoordinates[he->next()->toVertex()->id()];
+            Vec3d n = (b - a).cross(c - a);
+            double l = n.length();
+            if (l > 0){
+                faceNormals[i] = n / l;
+                f->setArea(l / 2);
+            }
+            else {
+                faceNormals[i] = Vec3d(0,0,0); //degenerate triangle, reported after the loop
+                f->setArea(0);
+                nDegenerate++;
+            }
+        }
+        else {
+            f->updateArea(); //updates also the normal of the polygon
+        }
+    }, grain, nThreads);
+    if (nDegenerate > 0)
+        std::cerr << "Warning: " << nDegenerate.load() << " degenerate triangles\n";
+
+    const std::size_t nChunks = numberOfChunks(vertices.size(), grain);
+    std::vector<Point3d> chunkMin(nChunks), chunkMax(nChunks);
+    parallelForChunks(vertices.size(), grain, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+        BoundingBox3 bb;
+        Point3d min = bb.min(), max = bb.max();
+        for (std::size_t i = begin; i < end; ++i){
+            Vertex* v = vertices[i];
+            if (v == nullptr)
+                continue;
+            const Point3d& coord = vertexCoordinates[i];
+            min.setX(std::min(min.x(), coord.x()));
+            min.setY(std::min(min.y(), coord.y()));
+            min.setZ(std::min(min.z(), coord.z()));
+            max.setX(std::max(max.x(), coord.x()));
+            max.setY(std::max(max.y(), coord.y()));
+            max.setZ(std::max(max.z(), coord.z()));
+
+            if (v->incidentHalfEdge() == nullptr){
+                vertexNormals[i] = Vec3d(0,0,0);
+                v->setCardinality(0);
+                continue;
+            }
+            Vec3d normal(0,0,0);
+            unsigned int n = 0;
+            for (const Face* f : v->incidentFaceIterator()){
+                if (f != nullptr)
+                    normal += faceNormals[f->id()];
+                n++;
+            }
+            vertexNormals[i] = normal / n; //as in Vertex::updateNormal()
+            v->setCardinality(n);
+        }
+        chunkMin[chunk] = min;
+        chunkMax[chunk] = max;
+    }, nThreads);
 
-        bBox.setMaxX(std::max(bBox.maxX(), coord.x()));
-        bBox.setMaxY(std::max(bBox.maxY(), coord.y()));
-        bBox.setMaxZ(std::max(bBox.maxZ(), coord.z()));
+    bBox.reset();
+    Point3d min = bBox.min(), max = bBox.max();
+    for (std::size_t c = 0; c < nChunks; ++c){
+        min = min.min(chunkMin[c]);
+        max = max.max(chunkMax[c]);
     }
+    bBox.setMin(min);
+    bBox.setMax(max);
     return bBox;
 }
 
@@ -1477,11 +1854,9 @@ void TemplatedDcel<V, HE, F>::scale(double scaleFactor)
 template <class V, class HE, class F>
 void TemplatedDcel<V, HE, F>::scale(const Vec3d& scaleVector)
 {
-    for (Vertex* v : vertexIterator()){
-        Point3d p = v->coordinate();
+    //slots of deleted vertices are transformed too: their values are never read
+    for (Point3d& p : vertexCoordinates)
         p *= scaleVector;
-        v->setCoordinate(p);
-    }
     updateBoundingBox();
 }
 
@@ -1492,11 +1867,9 @@ void TemplatedDcel<V, HE, F>::scale(const BoundingBox3& newBoundingBox)
     Point3d newCenter = newBoundingBox.center();
     Point3d deltaOld = bBox.max() - bBox.min();
     Point3d deltaNew = newBoundingBox.max() - newBoundingBox.min();
-    for (Vertex* v : vertexIterator()) {
-        v->setCoordinate(v->coordinate() - oldCenter);
-        v->setCoordinate(v->coordinate() * (deltaNew / deltaOld));
-        v->setCoordinate(v->coordinate() + newCenter);
-    }
+    Point3d factor = deltaNew / deltaOld;
+    for (Point3d& p : vertexCoordinates)
+        p = (p - oldCenter) * factor + newCenter;
     bBox = newBoundingBox;
 }
 
@@ -1510,11 +1883,8 @@ void TemplatedDcel<V, HE, F>::rotate(const Eigen::Matrix3d& matrix)
 template <class V, class HE, class F>
 void TemplatedDcel<V, HE, F>::rotate(const Eigen::Matrix3d &matrix, const Point3d& centroid)
 {
-    for (Vertex* v : vertexIterator()){
-        Point3d r = v->coordinate();
-        r.rotate(matrix, centroid);
-        v->setCoordinate(r);
-    }
+    for (Point3d& p : vertexCoordinates)
+        p.rotate(matrix, centroid);
     updateFaceNormals();
     updateVertexNormals();
     updateBoundingBox();
@@ -1531,14 +1901,10 @@ void TemplatedDcel<V, HE, F>::rotate(const Vec3d& axis, double angle, const Poin
 template <class V, class HE, class F>
 void TemplatedDcel<V, HE, F>::rotate(double matrix[3][3], const Point3d& centroid)
 {
-    for (Vertex* v : vertexIterator()){
-        Point3d r = v->coordinate();
-        r.rotate(matrix, centroid);
-        v->setCoordinate(r);
-        Vec3d n = v->normal();
+    for (Point3d& p : vertexCoordinates)
+        p.rotate(matrix, centroid);
+    for (Vec3d& n : vertexNormals)
         n.rotate(matrix, centroid);
-        v->setNormal(n);
-    }
     updateFaceNormals();
     updateBoundingBox();
 }
@@ -1546,9 +1912,8 @@ void TemplatedDcel<V, HE, F>::rotate(double matrix[3][3], const Point3d& centroi
 template <class V, class HE, class F>
 void TemplatedDcel<V, HE, F>::translate(const cg3::Vec3d& c)
 {
-    for (Vertex* v : vertexIterator()){
-        v->setCoordinate(v->coordinate() + c);
-    }
+    for (Point3d& p : vertexCoordinates)
+        p += c;
     updateBoundingBox();
 }
 
@@ -1561,44 +1926,120 @@ void TemplatedDcel<V, HE, F>::translate(const cg3::Vec3d& c)
  * di componenti, e soprattutto se non si sono memorizzati riferimenti alle componenti mediante
  * vecchi id.
  *
+ * @see compact()
  * @par Complessità:
  *      \e O(numVertices \e + \e NumHalfEdges \e + \e NumFaces)
  */
 template <class V, class HE, class F>
 void TemplatedDcel<V, HE, F>::recalculateIds()
 {
-    nVertices = 0;
-    for (unsigned int i = 0; i < vertices.size(); i++){
-        vertices[nVertices] = vertices[i];
-        if (vertices[i] != nullptr) {
-            vertices[i]->setId(nVertices);
-            nVertices++;
-        }
-    }
-    unusedVids.clear();
-    vertices.resize(nVertices);
-
-    nHalfEdges = 0;
-    for (unsigned int i = 0; i < halfEdges.size(); i++){
-        halfEdges[nHalfEdges] = halfEdges[i];
-        if (halfEdges[i] != nullptr) {
-            halfEdges[i]->setId(nHalfEdges);
-            nHalfEdges++;
-        }
-    }
-    unusedHeids.clear();
-    halfEdges.resize(nHalfEdges);
+    compactIds(false);
+}
 
-    nFaces = 0;
-    for (unsigned int i = 0; i < faces.size(); i++){
-        faces[nFaces] = faces[i];
-        if (faces[i] != nullptr) {
-            faces[i]->setId(nFaces);
-            nFaces++;
-        }
-    }
-    unusedFids.clear();
-    faces.resize(nFaces);
+/**
+ * @brief Renumbers densely the ids of vertices, half edges and faces, and shrinks
+ * all the storage of the Dcel to its new size.
+ *
+ * After this operation, ids of the elements go from 0 to numberVertices()-1,
+ * numberHalfEdges()-1 and numberFaces()-1, and there are no unused ids.
+ * The elements are moved into new pools, sized for the remaining elements: the
+ * memory left by the deleted elements is released.
+ *
+ * @warning Pointers to the elements and ids previously stored outside the Dcel are
+ * not valid anymore. recalculateIds() renumbers the ids keeping the pointers valid,
+ * but does not release memory.
+ *
+ * @see recalculateIds()
+ * @par Complexity:
+ *      \e O(numVertices \e + \e NumHalfEdges \e + \e NumFaces)
+ */
+template <class V, class HE, class F>
+void TemplatedDcel<V, HE, F>::compact()
+{
+    compactIds(true);
+
+    internal::DcelPool<Vertex> newVertexPool;
+    internal::DcelPool<HalfEdge> newHalfEdgePool;
+    internal::DcelPool<Face> newFacePool;
+    newVertexPool.reserve(nVertices);
+    newHalfEdgePool.reserve(nHalfEdges);
+    newFacePool.reserve(nFaces);
+    std::vector<Vertex*> oldVertices(vertices);
+    std::vector<HalfEdge*> oldHalfEdges(halfEdges);
+    std::vector<Face*> oldFaces(faces);
+    for (Vertex*& v : vertices)
+        v = new (newVertexPool.allocate()) Vertex(*v);
+    for (HalfEdge*& he : halfEdges)
+        he = new (newHalfEdgePool.allocate()) HalfEdge(*he);
+    for (Face*& f : faces)
+        f = new (newFacePool.allocate()) Face(*f);
+
+    //copied pointers still refer to the old elements: they are relinked by id
+    auto halfEdgeOf = [&](const cg3::HalfEdge* he) -> HalfEdge* {
+        return he == nullptr ? nullptr : halfEdges[he->_id];
+    };
+    auto vertexOf = [&](const cg3::Vertex* v) -> Vertex* {
+        return v == nullptr ? nullptr : vertices[v->_id];
+    };
+    auto faceOf = [&](const cg3::Face* f) -> Face* {
+        return f == nullptr ? nullptr : faces[f->_id];
+    };
+    for (Vertex* v : vertices)
+        v->_incidentHalfEdge = halfEdgeOf(v->_incidentHalfEdge);
+    for (HalfEdge* he : halfEdges){
+        he->_fromVertex = vertexOf(he->_fromVertex);
+        he->_toVertex = vertexOf(he->_toVertex);
+        he->_twin = halfEdgeOf(he->_twin);
+        he->_prev = halfEdgeOf(he->_prev);
+        he->_next = halfEdgeOf(he->_next);
+        he->_face = faceOf(he->_face);
+    }
+    for (Face* f : faces){
+        f->_outerHalfEdge = halfEdgeOf(f->_outerHalfEdge);
+        for (cg3::HalfEdge*& ihe : f->_innerHalfEdges)
+            ihe = halfEdgeOf(ihe);
+    }
+
+    for (Vertex* v : oldVertices)
+        v->~Vertex();
+    for (HalfEdge* he : oldHalfEdges)
+        he->~HalfEdge();
+    for (Face* f : oldFaces)
+        f->~Face();
+    vertexPool.swap(newVertexPool);
+    halfEdgePool.swap(newHalfEdgePool);
+    facePool.swap(newFacePool);
+    //the old pools, with all their slabs, are released here
+}
+
+/**
+ * @brief Reserves the storage for the given number of vertices, half edges and faces.
+ *
+ * Does not change the content of the Dcel: it just avoids further memory allocations
+ * when the elements will be added (e.g. when the size of a mesh that is going to be
+ * built is known in advance).
+ *
+ * @param[in] nv: number of vertices
+ * @param[in] nhe: number of half edges
+ * @param[in] nf: number of faces
+ */
+template <class V, class HE, class F>
+void TemplatedDcel<V, HE, F>::reserve(unsigned int nv, unsigned int nhe, unsigned int nf)
+{
+    vertices.reserve(nv);
+    halfEdges.reserve(nhe);
+    faces.reserve(nf);
+    if (nv > nVertices)
+        vertexPool.reserve(nv - nVertices);
+    if (nhe > nHalfEdges)
+        halfEdgePool.reserve(nhe - nHalfEdges);
+    if (nf > nFaces)
+        facePool.reserve(nf - nFaces);
+    vertexCoordinates.reserve(nv);
+    vertexNormals.reserve(nv);
+    vertexColors.reserve(nv);
+    faceNormals.reserve(nf);
+    faceColors.reserve(nf);
 }
 
 /**
@@ -1615,15 +2056,7 @@ void TemplatedDcel<V, HE, F>::recalculateIds()
 template <class V, class HE, class F>
 void TemplatedDcel<V, HE, F>::clear()
 {
-    for (unsigned int i=0; i<vertices.size(); i++)
-        if (vertices[i] != nullptr)
-            delete vertices[i];
-    for (unsigned int i=0; i<halfEdges.size(); i++)
-        if (halfEdges[i] != nullptr)
-            delete halfEdges[i];
-    for (unsigned int i=0; i<faces.size(); i++)
-        if (faces[i] != nullptr)
-            delete faces[i];
+    destroyElements();
     vertices.clear();
     halfEdges.clear();
     faces.clear();
@@ -1633,202 +2066,107 @@ void TemplatedDcel<V, HE, F>::clear()
     nVertices = 0;
     nFaces = 0;
     nHalfEdges = 0;
-    #ifdef NDEBUG
     vertexCoordinates.clear();
     vertexNormals.clear();
     vertexColors.clear();
     faceNormals.clear();
     faceColors.clear();
-    #endif
 }
 
-#ifdef  CG3_CGAL_DEFINED
 /**
  * \~Italian
  * @brief Funzione che, presa in ingresso una faccia, ne crea una triangolazione.
  *
  * La faccia in ingresso diventa un triangolo (se se lo era già rimarrà un triangolo),
  * e inserisce nella Dcel tanti altri triangoli che comporranno la faccia triangolata.
+ * I nuovi triangoli hanno la normale e il colore della faccia di partenza.
  *
- * Utilizza CGAL.
- * Utilizzabile SOLAMENTE se è definita la costante letterale CGAL_DEFINED
- * @param[in] f: la faccia che verrà triangolata
- * @return Il numero di triangoli che compone la faccia appena triangolata.
+ * La triangolazione è calcolata mediante ear clipping (vedi PolygonTriangulator).
+ * Se l'ear clipping fallisce (ad esempio su bordi che si autointersecano), una faccia
+ * senza buchi viene triangolata a ventaglio; una faccia con buchi viene invece lasciata
+ * invariata.
+ * @param[in] idf: l'id della faccia che verrà triangolata
+ * @return Il numero di triangoli che compone la faccia appena triangolata, 0 se la
+ * faccia non è stata triangolata.
  */
 template <class V, class HE, class F>
 unsigned int TemplatedDcel<V, HE, F>::triangulateFace(uint idf)
 {
-    int count=0;
     Face* f = face(idf);
     if (f == nullptr)
         return 0;
     if (f->isTriangle())
         return 1;
-    else {
-        // Taking all the coordinates on vectors
-        HalfEdge* firstHalfEdge = *(f->incidentHalfEdgeBegin());
-        std::vector<Point3d> borderCoordinates;
-        std::vector< std::vector<Point3d> > innerBorderCoordinates;
-        std::map<std::pair<Vertex*, Vertex*>, HalfEdge*> verticesEdgeMap;
-        std::map<std::pair<Vertex*, Vertex*>, HalfEdge*> twinsEdgeMap;
-        std::map<Point3d, Vertex*> pointsVerticesMap;
-        for (HalfEdge* he : f->incidentHalfEdgeIterator()){
-            borderCoordinates.push_back(he->fromVertex()->coordinate());
-            std::pair<Vertex*, Vertex*> pp;
-            pp.first = he->fromVertex();
-            pp.second = he->toVertex();
-            verticesEdgeMap[pp] = he;
-            pointsVerticesMap[he->fromVertex()->coordinate()] = he->fromVertex();
-        }
-
-        if (f->hasHoles()){
-            innerBorderCoordinates.reserve(f->numberInnerHalfEdges());
-            for (HalfEdge* he : f->innerHalfEdgeIterator()){
-                std::vector<Point3d> inner;
-                for (typename Face::IncidentHalfEdgeIterator heit = f->incidentHalfEdgeBegin(he); heit != f->incidentHalfEdgeEnd(); ++heit){
-                    inner.push_back((*heit)->fromVertex()->coordinate());
-                    std::pair<Vertex*, Vertex*> pp;
-                    pp.first = (*heit)->fromVertex();
-                    pp.second = (*heit)->toVertex();
-                    verticesEdgeMap[pp] = *heit;
-                }
-                innerBorderCoordinates.push_back(inner);
-            }
-        }
-
-        ///TRIANGULATION
-
-        std::vector<std::array<Point3d, 3> > triangulation = cgal::triangulate3(f->normal(), borderCoordinates, innerBorderCoordinates);
-        ///
-
+    PolygonTriangulator triangulator;
+    std::vector<Point3d> points;
+    std::vector<unsigned int> borderSizes, indices;
+    std::vector<const cg3::HalfEdge*> borderHalfEdges;
+    std::unordered_map<uint64_t, HalfEdge*> diagonals;
+    f->borders(points, borderSizes, borderHalfEdges);
+    unsigned int nt = triangulator.triangulate(points, borderSizes, indices, f->normal());
+    return splitFace(f, borderHalfEdges, indices.data(), nt, diagonals);
+}
 
-        ///RECONSTRUCTION
-        for (unsigned int i = 0; i < triangulation.size(); i++) {
-            std::array<Point3d, 3> triangle = triangulation[i];
 
-            Point3d p1 = triangle[0];
-            Point3d p2 = triangle[1];
-            Point3d p3 = triangle[2];
-
-            HalfEdge* e1, *e2, *e3;
-            std::pair<Vertex*, Vertex*> pp;
-            bool b = false;
-            pp.first = pointsVerticesMap[p1];
-            pp.second = pointsVerticesMap[p2];
-            if (verticesEdgeMap.find(pp) != verticesEdgeMap.end()){
-                e1 = verticesEdgeMap[pp];
-                if (e1 == firstHalfEdge) b = true;
-            }
-            else {
-                e1 = addHalfEdge();
-                e1->setFromVertex(pp.first);
-                e1->setToVertex(pp.second);
-                if (twinsEdgeMap.find(pp) == twinsEdgeMap.end()){
-                    Vertex* tmp = pp.first;
-                    pp.first = pp.second;
-                    pp.second = tmp;
-                    twinsEdgeMap[pp] = e1;
-                }
-                else {
-                    HalfEdge* twin = twinsEdgeMap[pp];
-                    twin->setTwin(e1);
-                    e1->setTwin(twin);
-                    twinsEdgeMap.erase(pp);
-                }
-            }
-            pp.first = pointsVerticesMap[p2];
-            pp.second = pointsVerticesMap[p3];
-            if (verticesEdgeMap.find(pp) != verticesEdgeMap.end()){
-                e2 = verticesEdgeMap[pp];
-                if (e2 == firstHalfEdge) b = true;
-            }
-            else {
-                e2 = addHalfEdge();
-                e2->setFromVertex(pp.first);
-                e2->setToVertex(pp.second);
-                if (twinsEdgeMap.find(pp) == twinsEdgeMap.end()){
-                    Vertex* tmp = pp.first;
-                    pp.first = pp.second;
-                    pp.second = tmp;
-                    twinsEdgeMap[pp] = e2;
-                }
-                else {
-                    HalfEdge* twin = twinsEdgeMap[pp];
-                    twin->setTwin(e2);
-                    e2->setTwin(twin);
-                    twinsEdgeMap.erase(pp);
-                }
-            }
-            pp.first = pointsVerticesMap[p3];
-            pp.second = pointsVerticesMap[p1];
-            if (verticesEdgeMap.find(pp) != verticesEdgeMap.end()){
-                e3 = verticesEdgeMap[pp];
-                if (e3 == firstHalfEdge) b = true;
-            }
-            else {
-                e3 = addHalfEdge();
-                e3->setFromVertex(pp.first);
-                e3->setToVertex(pp.second);
-                if (twinsEdgeMap.find(pp) == twinsEdgeMap.end()){
-                    Vertex* tmp = pp.first;
-                    pp.first = pp.second;
-                    pp.second = tmp;
-                    twinsEdgeMap[pp] = e3;
-                }
-                else {
-                    HalfEdge* twin = twinsEdgeMap[pp];
-                    twin->setTwin(e3);
-                    e3->setTwin(twin);
-                    twinsEdgeMap.erase(pp);
-                }
-            }
-
-            Face* f;
-            if (!b)
-                f = addFace();
-            else
-                f = firstHalfEdge->face();
-
-            e1->setNext(e2);
-            e2->setNext(e3);
-            e3->setNext(e1);
-            e1->setPrev(e3);
-            e2->setPrev(e1);
-            e3->setPrev(e2);
-            e1->setFace(f);
-            e2->setFace(f);
-            e3->setFace(f);
-            f->setOuterHalfEdge(e1);
-            f->setNormal(firstHalfEdge->face()->normal());
-            f->setColor(firstHalfEdge->face()->color());
-
-            ++count;
-        }
-
-    }
-    return count;
-}
-
-
-/**
- * \~Italian
- * @brief Funzione che trasforma una Dcel composta da poligoni generici in una Dcel di triangoli.
- *
- * Per ogni faccia, ne viene creata una triangolazione. I triangoli presenti non vengono modificati.
- * Vengono tuttavia aggiornate le normali ai vertici.
- *
- * Utilizza CGAL.
- * Utilizzabile SOLAMENTE se è definita la costante letterale CGAL_DEFINED
- */
-template <class V, class HE, class F>
-void TemplatedDcel<V, HE, F>::triangulate()
-{
-    for (Face* f : faceIterator()) {
-        triangulateFace(f->id());
-    }
-    updateVertexNormals();
-}
-#endif
+/**
+ * \~Italian
+ * @brief Funzione che trasforma una Dcel composta da poligoni generici in una Dcel di triangoli.
+ *
+ * Per ogni faccia, ne viene creata una triangolazione. I triangoli presenti non vengono modificati.
+ * Vengono tuttavia aggiornate le normali ai vertici.
+ *
+ * Le triangolazioni delle facce sono calcolate in parallelo, e poi inserite nella Dcel
+ * seguendo l'ordine degli id delle facce: il risultato non dipende dal numero di thread.
+ *
+ * Le facce che non possono essere triangolate (vedi triangulateFace()) rimangono invariate,
+ * e la Dcel resta consistente.
+ *
+ * @param[in] nThreads: numero di thread utilizzati; di default, tutti i thread hardware
+ * @return Il numero di facce che non sono state triangolate (0 se la Dcel è ora composta
+ * solo da triangoli).
+ */
+template <class V, class HE, class F>
+unsigned int TemplatedDcel<V, HE, F>::triangulate(unsigned int nThreads)
+{
+    std::vector<unsigned int> polygons;
+    for (const Face* f : faceIterator())
+        if (!f->isTriangle())
+            polygons.push_back(f->id());
+
+    const std::size_t grain = 256;
+    const std::size_t nChunks = numberOfChunks(polygons.size(), grain);
+    std::vector<std::vector<unsigned int> > chunkTriangles(nChunks), chunkSizes(nChunks);
+    parallelForChunks(polygons.size(), grain, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+        PolygonTriangulator triangulator;
+        std::vector<Point3d> points;
+        std::vector<unsigned int> borderSizes;
+        std::vector<const cg3::HalfEdge*> borderHalfEdges;
+        for (std::size_t i = begin; i < end; ++i){
+            const Face* f = faces[polygons[i]];
+            f->borders(points, borderSizes, borderHalfEdges);
+            chunkSizes[chunk].push_back(
+                        triangulator.triangulate(points, borderSizes, chunkTriangles[chunk], f->normal()));
+        }
+    }, nThreads);
+
+    std::vector<const cg3::HalfEdge*> borderHalfEdges;
+    std::vector<Point3d> points;
+    std::vector<unsigned int> borderSizes;
+    std::unordered_map<uint64_t, HalfEdge*> diagonals;
+    unsigned int failures = 0;
+    for (std::size_t c = 0; c < nChunks; ++c){
+        const unsigned int* tris = chunkTriangles[c].data();
+        for (std::size_t i = 0; i < chunkSizes[c].size(); ++i){
+            Face* f = faces[polygons[c * grain + i]];
+            f->borders(points, borderSizes, borderHalfEdges);
+            if (splitFace(f, borderHalfEdges, tris, chunkSizes[c][i], diagonals) == 0)
+                failures++;
+            tris += chunkSizes[c][i] * 3;
+        }
+    }
+    updateVertexNormals();
+    return failures;
+}
 
 /**
  * \~Italian
@@ -1946,24 +2284,96 @@ bool TemplatedDcel<V, HE, F>::loadFromPly(const std::string& filename)
 		return false;*/
 }
 
+/**
+ * @brief Loads the Dcel from a file saved with saveOnDcelFile().
+ *
+ * Files in the version 2 of the .dcel format are memory mapped, and the blocks of
+ * attributes and connectivity are read directly from the mapping, without passing
+ * through a stream. Files in the previous version are read with deserialize().
+ *
+ * @param[in] filename: the name of the .dcel file
+ * @return true if the file has been loaded, false otherwise (the Dcel is not modified)
+ */
 template <class V, class HE, class F>
 bool TemplatedDcel<V, HE, F>::loadFromDcelFile(const std::string& filename)
 {
-    std::ifstream myfile;
-    myfile.open (filename, std::ios::in | std::ios::binary);
-    if (myfile.is_open()) {
+    MappedFile file(filename);
+    if (!file.isOpen())
+        return false;
+    const std::string tag = "cg3Dcel2";
+    const unsigned long long int tagSize = tag.size();
+    const std::size_t begin = sizeof(tagSize) + tag.size();
+    if (file.size() < begin ||
+            std::memcmp(file.data(), &tagSize, sizeof(tagSize)) != 0 ||
+            std::memcmp(file.data() + sizeof(tagSize), tag.data(), tag.size()) != 0){
+        //previous version of the format
+        file.close();
+        std::ifstream myfile(filename, std::ios::in | std::ios::binary);
         try {
             deserialize(myfile);
         }
         catch(...){
-            myfile.close();
             return false;
         }
+        return true;
     }
-    myfile.close();
+
+    TemplatedDcel tmp;
+    try {
+        internal::DcelMemoryReader reader(file.data() + begin, file.data() + file.size());
+        tmp.deserializeBlocks(reader);
+        if (!std::is_same<V, cg3::Vertex>::value ||
+                !std::is_same<HE, cg3::HalfEdge>::value ||
+                !std::is_same<F, cg3::Face>::value){
+            std::ifstream myfile(filename, std::ios::in | std::ios::binary);
+            myfile.exceptions(std::ios::failbit | std::ios::badbit);
+            myfile.seekg(begin + reader.position());
+            tmp.deserializeElementData(myfile);
+        }
+    }
+    catch(...){
+        return false;
+    }
+    *this = std::move(tmp);
     return true;
 }
 
+/**
+ * @brief Creates a triangle Dcel from an indexed triangle mesh.
+ *
+ * The i-th vertex has coordinates (coords[3*i], coords[3*i+1], coords[3*i+2]), and
+ * the j-th face is composed by the vertices tris[3*j], tris[3*j+1], tris[3*j+2].
+ * Ids of vertices and faces of the Dcel are the same of the input mesh.
+ *
+ * Twin half edges are linked by a radix sort of the edges, in linear time.
+ * Edges shared by more than two triangles, or by two triangles with inconsistent
+ * orientation, are detected and their half edges are paired in the same way of
+ * loadFromObj() and loadFromPly().
+ *
+ * Face normals and areas, vertex normals and the bounding box are computed.
+ *
+ * @param[in] coords: coordinates of the vertices, 3 for each vertex
+ * @param[in] tris: indices of the vertices of the triangles, 3 for each triangle
+ * @return The Dcel, empty if the size of one of the vectors is not a multiple of 3
+ * or some index is out of range
+ * @par Complexity:
+ *      \e O(numVertices + numFaces)
+ */
+template <class V, class HE, class F>
+TemplatedDcel<V, HE, F> TemplatedDcel<V, HE, F>::fromIndexedTriangles(
+        const std::vector<double>& coords,
+        const std::vector<unsigned int>& tris)
+{
+    TemplatedDcel<V, HE, F> d;
+    if (coords.size() % 3 != 0 || tris.size() % 3 != 0)
+        return d;
+    for (unsigned int vid : tris)
+        if (vid >= coords.size() / 3)
+            return d;
+    d.buildFromIndexedTriangles(coords, tris, true);
+    return d;
+}
+
 template <class V, class HE, class F>
 void TemplatedDcel<V, HE, F>::swap(TemplatedDcel& d)
 {
@@ -1977,8 +2387,10 @@ void TemplatedDcel<V, HE, F>::swap(TemplatedDcel& d)
     std::swap(nHalfEdges, d.nHalfEdges);
     std::swap(nFaces, d.nFaces);
     std::swap(bBox, d.bBox);
+    vertexPool.swap(d.vertexPool);
+    halfEdgePool.swap(d.halfEdgePool);
+    facePool.swap(d.facePool);
 
-    #ifdef NDEBUG
     std::swap(vertexCoordinates, d.vertexCoordinates);
     std::swap(vertexNormals, d.vertexNormals);
     std::swap(vertexColors, d.vertexColors);
@@ -1996,127 +2408,95 @@ void TemplatedDcel<V, HE, F>::swap(TemplatedDcel& d)
         he->parent = &d;
     for (Face* f: d.faceIterator())
         f->parent = &d;
-    #endif
 }
 
 /**
  * @brief Merges the input Dcel with this Dcel.
+ *
+ * The elements of d are copied after the ones of this Dcel: their ids (and the
+ * unused ids of d) are shifted by the number of ids of this Dcel.
+ *
  * @param d: a Dcel
+ * @par Complexity:
+ *      \e O(number of elements of d)
  */
 template <class V, class HE, class F>
 void TemplatedDcel<V, HE, F>::merge(const TemplatedDcel<V, HE, F>& d)
 {
-    std::vector<int> mapV(d.vertices.size(), -1); //map from d vertex to this vertex
-    std::vector<int> mapHE(d.halfEdges.size(), -1); //map from d halfEdge to this halfEdge
-    std::vector<int> mapF(d.faces.size(), -1); //map from d face to this face
-
-    for (const Vertex* v : d.vertexIterator()) {
-        Vertex* nv = addVertex(v->coordinate(), v->normal(), v->color());
-        nv->setFlag(v->flag());
-        nv->setCardinality(v->cardinality());
-        mapV[v->id()] = nv->id();
-    }
-
-    for (const HalfEdge* he : d.halfEdgeIterator()) {
-        HalfEdge* nhe = addHalfEdge();
-        nhe->setFlag(he->flag());
-        mapHE[he->id()] = nhe->id();
-    }
-
-    for (const Face* f : d.faceIterator()) {
-        Face* nf = addFace(f->normal(), f->color());
-        nf->setFlag(f->flag());
-        nf->setArea(f->area());
-        mapF[f->id()] = nf->id();
-    }
-
-    for (uint vid = 0; vid < mapV.size(); ++vid) {
-        int nvid = mapV[vid];
-        if (nvid >= 0) {
-            const HalfEdge* he = d.vertex(vid)->incidentHalfEdge();
-			if (he != nullptr)
-				vertices[nvid]->setIncidentHalfEdge(halfEdges[mapHE[he->id()]]);
-        }
-    }
-
-    for (uint heid = 0; heid < mapHE.size(); ++heid){
-        int nheid = mapHE[heid];
-        if (nheid >= 0) {
-            const HalfEdge* the = d.halfEdge(heid)->twin();
-			if (the != nullptr)
-				halfEdges[nheid]->setTwin(halfEdges[mapHE[the->id()]]);
-
-            const HalfEdge* nhe = d.halfEdge(heid)->next();
-			if (nhe != nullptr)
-				halfEdges[nheid]->setNext(halfEdges[mapHE[nhe->id()]]);
-
-            const HalfEdge* phe = d.halfEdge(heid)->prev();
-			if (phe != nullptr)
-				halfEdges[nheid]->setPrev(halfEdges[mapHE[phe->id()]]);
-
-            const Vertex* fv = d.halfEdge(heid)->fromVertex();
-			if (fv != nullptr)
-				halfEdges[nheid]->setFromVertex(vertices[mapV[fv->id()]]);
-
-            const Vertex* pv = d.halfEdge(heid)->toVertex();
-			if (pv != nullptr)
-				halfEdges[nheid]->setToVertex(vertices[mapV[pv->id()]]);
-
-            const Face* f = d.halfEdge(heid)->face();
-			if (f != nullptr)
-				halfEdges[nheid]->setFace(faces[mapF[f->id()]]);
-        }
-    }
-
-    for (uint fid = 0; fid < mapF.size(); ++fid) {
-        int nfid = mapF[fid];
-        if (nfid >= 0) {
-            const HalfEdge* he = d.face(fid)->outerHalfEdge();
-			if (he != nullptr)
-				faces[nfid]->setOuterHalfEdge(halfEdges[mapHE[he->id()]]);
-
-            for (const HalfEdge* ihe : d.face(fid)->innerHalfEdgeIterator()){
-				if (ihe != nullptr)
-					faces[nfid]->addInnerHalfEdge(halfEdges[mapHE[ihe->id()]]);
-            }
-        }
+    if (&d == this){
+        TemplatedDcel<V, HE, F> copy(d);
+        merge(std::move(copy));
+        return;
     }
+    if (vertices.empty() && halfEdges.empty() && faces.empty())
+        bBox = d.bBox;
+    copyElements(d);
 }
 
 /**
  * @brief Merges the input Dcel with this Dcel. At the end, the input Dcel d will be empty.
+ *
+ * The elements of d are not copied: their storage is spliced in this Dcel, and
+ * only their ids are updated (shifted by the number of ids of this Dcel).
+ * If this Dcel is empty, d is just moved in this Dcel.
+ *
  * @param d: a rvalue reference of a Dcel
+ * @par Complexity:
+ *      \e O(number of elements of d)
  */
 template <class V, class HE, class F>
 void TemplatedDcel<V, HE, F>::merge(TemplatedDcel&& d)
 {
+    if (&d == this){
+        merge(static_cast<const TemplatedDcel&>(d));
+        return;
+    }
+    if (vertices.empty() && halfEdges.empty() && faces.empty()){
+        clear();
+        moveElements(d);
+        return;
+    }
     uint nv = vertices.size();
     uint nhe = halfEdges.size();
     uint nf = faces.size();
     vertices.insert(vertices.end(), d.vertices.begin(), d.vertices.end());
     halfEdges.insert(halfEdges.end(), d.halfEdges.begin(), d.halfEdges.end());
     faces.insert(faces.end(), d.faces.begin(), d.faces.end());
+    vertexCoordinates.insert(vertexCoordinates.end(), d.vertexCoordinates.begin(), d.vertexCoordinates.end());
+    vertexNormals.insert(vertexNormals.end(), d.vertexNormals.begin(), d.vertexNormals.end());
+    vertexColors.insert(vertexColors.end(), d.vertexColors.begin(), d.vertexColors.end());
+    faceNormals.insert(faceNormals.end(), d.faceNormals.begin(), d.faceNormals.end());
+    faceColors.insert(faceColors.end(), d.faceColors.begin(), d.faceColors.end());
     for (uint v = nv;  v < vertices.size(); ++v){
-        if (vertices[v])
-            vertices[v]->setId(v);
-        else
-            unusedVids.insert(v);
+        if (vertices[v]) {
+            vertices[v]->_id = v;
+            vertices[v]->parent = this;
+        }
     }
     for (uint he = nhe;  he < halfEdges.size(); ++he){
-        if (halfEdges[he])
-            halfEdges[he]->setId(he);
-        else
-            unusedHeids.insert(he);
+        if (halfEdges[he]) {
+            halfEdges[he]->_id = he;
+            halfEdges[he]->parent = this;
+        }
     }
     for (uint f = nf;  f < faces.size(); ++f){
-        if (faces[f])
-            faces[f]->setId(f);
-        else
-            unusedFids.insert(f);
+        if (faces[f]) {
+            faces[f]->_id = f;
+            faces[f]->parent = this;
+        }
     }
+    for (uint id : d.unusedVids)
+        unusedVids.push_back(id + nv);
+    for (uint id : d.unusedHeids)
+        unusedHeids.push_back(id + nhe);
+    for (uint id : d.unusedFids)
+        unusedFids.push_back(id + nf);
     nVertices += d.nVertices;
     nHalfEdges += d.nHalfEdges;
     nFaces += d.nFaces;
+    vertexPool.splice(d.vertexPool);
+    halfEdgePool.splice(d.halfEdgePool);
+    facePool.splice(d.facePool);
 
     d.vertices.clear();
     d.halfEdges.clear();
@@ -2124,72 +2504,102 @@ void TemplatedDcel<V, HE, F>::merge(TemplatedDcel&& d)
     d.unusedVids.clear();
     d.unusedHeids.clear();
     d.unusedFids.clear();
+    d.vertexCoordinates.clear();
+    d.vertexNormals.clear();
+    d.vertexColors.clear();
+    d.faceNormals.clear();
+    d.faceColors.clear();
     d.nVertices = 0;
     d.nHalfEdges = 0;
     d.nFaces = 0;
 }
 
+/**
+ * @brief Serializes the Dcel, using the version 2 of the .dcel format.
+ *
+ * Attributes and connectivity of the elements are written in contiguous blocks,
+ * with a record for each id, through few large writes. The data of derived
+ * Vertex, HalfEdge and Face classes is written after the blocks.
+ *
+ * @par Complexity:
+ *      \e O(numVertices) + \e O(numFaces) + \e O(numHalfEdges)
+ */
 template <class V, class HE, class F>
 void TemplatedDcel<V, HE, F>::serialize(std::ofstream& binaryFile) const
 {
-    cg3::serialize("cg3Dcel", binaryFile);
-    //BB
-    bBox.serialize(binaryFile);
-    //N
-    cg3::serialize(nVertices, binaryFile);
-    cg3::serialize(nHalfEdges, binaryFile);
-    cg3::serialize(nFaces, binaryFile);
-    //Sets
-    cg3::serialize(unusedVids, binaryFile);
-    cg3::serialize(unusedHeids, binaryFile);
-    cg3::serialize(unusedFids, binaryFile);
-    //Vertices
-    for (const TemplatedDcel::Vertex* v : vertexIterator()){
-        int heid = -1;
-        if (v->incidentHalfEdge() != nullptr) heid = v->incidentHalfEdge()->id();
-
-        cg3::serialize(v->id(), binaryFile);
-        v->coordinate().serialize(binaryFile);
-        v->normal().serialize(binaryFile);
-        cg3::serialize(v->color(), binaryFile);
-        cg3::serialize(heid, binaryFile);
-        cg3::serialize(v->cardinality(), binaryFile);
-        cg3::serialize(v->flag(), binaryFile);
-    }
-    //HalfEdges
-    for (const HalfEdge* he : halfEdgeIterator()){
-        int fv = -1; if (he->fromVertex() != nullptr) fv = he->fromVertex()->id();
-        int tv = -1; if (he->toVertex() != nullptr) tv = he->toVertex()->id();
-        int tw = -1; if (he->twin() != nullptr) tw = he->twin()->id();
-        int prev = -1; if (he->prev() != nullptr) prev = he->prev()->id();
-        int next = -1; if (he->next() != nullptr) next = he->next()->id();
-        int face = -1; if (he->face() != nullptr) face = he->face()->id();
-
-        cg3::serialize(he->id(), binaryFile);
-        cg3::serialize(fv, binaryFile);
-        cg3::serialize(tv, binaryFile);
-        cg3::serialize(tw, binaryFile);
-        cg3::serialize(prev, binaryFile);
-        cg3::serialize(next, binaryFile);
-        cg3::serialize(face, binaryFile);
-        cg3::serialize(he->flag(), binaryFile);
-    }
-    //Faces
-    for (const Face* f : faceIterator()){
-        int ohe = -1; if (f->outerHalfEdge() != nullptr) ohe = f->outerHalfEdge()->id();
-        cg3::serialize(f->id(), binaryFile);
-        cg3::serialize(ohe, binaryFile);
-        f->normal().serialize(binaryFile);
-        cg3::serialize(f->color(), binaryFile);
-        cg3::serialize(f->area(), binaryFile);
-        cg3::serialize(f->flag(), binaryFile);
-        cg3::serialize(f->numberInnerHalfEdges(), binaryFile);
+    cg3::serialize("cg3Dcel2", binaryFile);
+    uint64_t nInner = 0;
+    for (const Face* f : faceIterator())
+        nInner += f->numberInnerHalfEdges();
+    {
+        internal::DcelBlockWriter w(binaryFile);
+        //Header
+        w.put(internal::DCEL_FILE_MAGIC);
+        w.put(internal::DCEL_FILE_VERSION);
+        w.put((uint64_t)vertices.size());
+        w.put((uint64_t)halfEdges.size());
+        w.put((uint64_t)faces.size());
+        w.put((uint64_t)unusedVids.size());
+        w.put((uint64_t)unusedHeids.size());
+        w.put((uint64_t)unusedFids.size());
+        w.put(nInner);
+        w.put(bBox.minX()); w.put(bBox.minY()); w.put(bBox.minZ());
+        w.put(bBox.maxX()); w.put(bBox.maxY()); w.put(bBox.maxZ());
+        //Unused ids
+        w.putArray(unusedVids.data(), unusedVids.size());
+        w.putArray(unusedHeids.data(), unusedHeids.size());
+        w.putArray(unusedFids.data(), unusedFids.size());
 
-        for (typename Face::ConstInnerHalfEdgeIterator heit = f->innerHalfEdgeBegin(); heit != f->innerHalfEdgeEnd(); ++heit){
-            const HalfEdge* he = *heit;
-            int idhe = -1; if (he != nullptr) idhe = he->id();
-            cg3::serialize(idhe, binaryFile);
+        //Vertices
+        for (unsigned int i = 0; i < vertices.size(); ++i){
+            const Point3d& p = vertices[i] ? vertexCoordinates[i] : Point3d();
+            w.put(p.x()); w.put(p.y()); w.put(p.z());
+        }
+        for (unsigned int i = 0; i < vertices.size(); ++i){
+            const Vec3d& n = vertices[i] ? vertexNormals[i] : Vec3d();
+            w.put(n.x()); w.put(n.y()); w.put(n.z());
+        }
+        for (unsigned int i = 0; i < vertices.size(); ++i)
+            putColor(w, vertices[i] ? vertexColors[i] : Color(0, 0, 0, 0));
+        for (const Vertex* v : vertices){
+            w.put(v ? elementId(v->_incidentHalfEdge) : -1);
+            w.put(v ? (int32_t)v->_cardinality : 0);
+            w.put(v ? (int32_t)v->_flag : 0);
+        }
+        //HalfEdges
+        for (const HalfEdge* he : halfEdges){
+            if (he){
+                w.put(elementId(he->_fromVertex));
+                w.put(elementId(he->_toVertex));
+                w.put(elementId(he->_twin));
+                w.put(elementId(he->_prev));
+                w.put(elementId(he->_next));
+                w.put(elementId(he->_face));
+                w.put((int32_t)he->_flag);
+            }
+            else {
+                for (unsigned int j = 0; j < 6; ++j)
+                    w.put((int32_t)-1);
+                w.put((int32_t)0);
+            }
+        }
+        //Faces
+        for (unsigned int i = 0; i < faces.size(); ++i){
+            const Vec3d& n = faces[i] ? faceNormals[i] : Vec3d();
+            w.put(n.x()); w.put(n.y()); w.put(n.z());
+        }
+        for (unsigned int i = 0; i < faces.size(); ++i)
+            putColor(w, faces[i] ? faceColors[i] : Color(0, 0, 0, 0));
+        for (const Face* f : faces)
+            w.put(f ? f->_area : 0.0);
+        for (const Face* f : faces){
+            w.put(f ? elementId(f->_outerHalfEdge) : -1);
+            w.put(f ? (int32_t)f->_flag : 0);
+            w.put(f ? (int32_t)f->_innerHalfEdges.size() : 0);
         }
+        for (const Face* f : faceIterator())
+            for (const HalfEdge* ihe : f->_innerHalfEdges)
+                w.put(elementId(ihe));
     }
 
     //serialization of other infos contained in Vertices, Half Edges and Faces
@@ -2201,6 +2611,10 @@ void TemplatedDcel<V, HE, F>::serialize(std::ofstream& binaryFile) const
         f->serialize(binaryFile);
 }
 
+/**
+ * @brief Deserializes a Dcel written by serialize(). Files written with the
+ * previous version of the .dcel format are supported.
+ */
 template <class V, class HE, class F>
 void TemplatedDcel<V, HE, F>::deserialize(std::ifstream& binaryFile)
 {
@@ -2210,119 +2624,16 @@ void TemplatedDcel<V, HE, F>::deserialize(std::ifstream& binaryFile)
         std::string s;
         cg3::deserialize(s, binaryFile);
 
-        if (s != "cg3Dcel")
-            throw std::ios_base::failure("Mismatching String: " + s + " != cg3Dcel");
-        //BB
-
-        tmp.bBox.deserialize(binaryFile);
-        cg3::deserialize(tmp.nVertices, binaryFile);
-        cg3::deserialize(tmp.nHalfEdges, binaryFile);
-        cg3::deserialize(tmp.nFaces, binaryFile);
-        cg3::deserialize(tmp.unusedVids, binaryFile);
-        cg3::deserialize(tmp.unusedHeids, binaryFile);
-        cg3::deserialize(tmp.unusedFids, binaryFile);
-
-        //Vertices
-        tmp.vertices.resize(tmp.nVertices+tmp.unusedVids.size(), nullptr);
-        #ifdef NDEBUG
-		tmp.vertexCoordinates.resize(tmp.nVertices+tmp.unusedVids.size(), Point3d());
-		tmp.vertexNormals.resize(tmp.nVertices+tmp.unusedVids.size(), Vec3d());
-        tmp.vertexColors.resize(tmp.nVertices+tmp.unusedVids.size(), Color());
-        #endif
-        std::map<int, int> vert;
-
-        for (unsigned int i = 0; i < tmp.nVertices; i++){
-            int id, heid;
-            Point3d coord; Vec3d norm; Color color;
-            int c, f;
-            cg3::deserialize(id, binaryFile);
-            coord.deserialize(binaryFile);
-            norm.deserialize(binaryFile);
-            cg3::deserialize(color, binaryFile);
-            cg3::deserialize(heid, binaryFile);
-            cg3::deserialize(c, binaryFile);
-            cg3::deserialize(f, binaryFile);
-
-            Vertex* v = tmp.addVertex(id);
-            v->setCardinality(c);
-            v->setCoordinate(coord);
-            v->setNormal(norm);
-            v->setFlag(f);
-            vert[id] = heid;
-        }
-        //HalfEdges
-        tmp.halfEdges.resize(tmp.nHalfEdges+tmp.unusedHeids.size(), nullptr);
-        std::map<int, std::array<int, 6> > edges;
-
-        for (unsigned int i = 0; i < tmp.nHalfEdges; i++){
-            int id, fv, tv, tw, prev, next, face, flag;
-            cg3::deserialize(id, binaryFile);
-            cg3::deserialize(fv, binaryFile);
-            cg3::deserialize(tv, binaryFile);
-            cg3::deserialize(tw, binaryFile);
-            cg3::deserialize(prev, binaryFile);
-            cg3::deserialize(next, binaryFile);
-            cg3::deserialize(face, binaryFile);
-            cg3::deserialize(flag, binaryFile);
-            HalfEdge* he = tmp.addHalfEdge(id);
-            he->setFlag(flag);
-            edges[id] = {fv, tv, tw, prev, next, face};
-        }
-
-        //Faces
-        tmp.faces.resize(tmp.nFaces+tmp.unusedFids.size(), nullptr);
-        #ifdef NDEBUG
-		tmp.faceNormals.resize(tmp.nFaces+tmp.unusedFids.size(), Vec3d());
-        tmp.faceColors.resize(tmp.nFaces+tmp.unusedFids.size(), Color());
-        #endif
-        for (unsigned int i = 0; i < tmp.nFaces; i++){
-            int id, ohe, /*cr, cg, cb,*/ flag, nihe;
-            double /*nx, ny, nz,*/ area;
-            Color color;
-            Vec3d norm;
-            cg3::deserialize(id, binaryFile);
-            cg3::deserialize(ohe, binaryFile);
-            norm.deserialize(binaryFile);
-            cg3::deserialize(color, binaryFile);
-            cg3::deserialize(area, binaryFile);
-            cg3::deserialize(flag, binaryFile);
-            cg3::deserialize(nihe, binaryFile);
-
-
-            Face* f = tmp.addFace(id);
-            f->setColor(color);
-            f->setNormal(norm);
-            f->setArea(area);
-            f->setFlag(flag);
-            f->setOuterHalfEdge(tmp.halfEdge(ohe));
-            for (int j = 0; j < nihe; j++){
-                int idhe;
-                cg3::deserialize(idhe, binaryFile);
-                f->addInnerHalfEdge(tmp.halfEdge(idhe));
-            }
-        }
-
-        for (Vertex* v : tmp.vertexIterator()){
-            v->setIncidentHalfEdge(tmp.halfEdge(vert[v->id()]));
-        }
-        for (HalfEdge* he : tmp.halfEdgeIterator()){
-            std::array<int, 6> a = edges[he->id()];
-            he->setFromVertex(tmp.vertex(a[0]));
-            he->setToVertex(tmp.vertex(a[1]));
-            he->setTwin(tmp.halfEdge(a[2]));
-            he->setPrev(tmp.halfEdge(a[3]));
-            he->setNext(tmp.halfEdge(a[4]));
-            he->setFace(tmp.face(a[5]));
+        if (s == "cg3Dcel2"){
+            internal::DcelStreamReader reader(binaryFile);
+            tmp.deserializeBlocks(reader);
         }
+        else if (s == "cg3Dcel")
+            tmp.deserializeLegacy(binaryFile);
+        else
+            throw std::ios_base::failure("Mismatching String: " + s + " != cg3Dcel2");
 
-        //deserialization of other infos contained in Vertices, Half Edges and Faces
-        for (Vertex* v: tmp.vertexIterator())
-            v->deserialize(binaryFile);
-        for (HalfEdge* he: tmp.halfEdgeIterator())
-            he->deserialize(binaryFile);
-        for (Face* f: tmp.faceIterator())
-            f->deserialize(binaryFile);
-
+        tmp.deserializeElementData(binaryFile);
         *this = std::move(tmp);
     }
     catch(std::ios_base::failure& e){
@@ -2349,9 +2660,31 @@ void TemplatedDcel<V, HE, F>::deserialize(std::ifstream& binaryFile)
  * @return La Dcel appena assegnata
  */
 template <class V, class HE, class F>
-TemplatedDcel<V, HE, F>& TemplatedDcel<V, HE, F>::operator = (TemplatedDcel<V, HE, F> dcel)
+TemplatedDcel<V, HE, F>& TemplatedDcel<V, HE, F>::operator = (const TemplatedDcel<V, HE, F>& dcel)
+{
+    if (&dcel != this){
+        clear();
+        copyElements(dcel);
+        bBox = dcel.bBox;
+    }
+    return *this;
+}
+
+/**
+ * @brief Move assignment operator of the Dcel.
+ *
+ * Deletes the elements of this Dcel and takes the storage of the elements of
+ * the input Dcel, which will be empty.
+ * @param[in] dcel: dcel that will be moved in this Dcel
+ * @return This Dcel
+ */
+template <class V, class HE, class F>
+TemplatedDcel<V, HE, F>& TemplatedDcel<V, HE, F>::operator = (TemplatedDcel<V, HE, F>&& dcel)
 {
-    swap(dcel);
+    if (&dcel != this){
+        clear();
+        moveElements(dcel);
+    }
     return *this;
 }
 
@@ -2371,11 +2704,7 @@ TemplatedDcel<V, HE, F>& TemplatedDcel<V, HE, F>::operator = (TemplatedDcel<V, H
 template <class V, class HE, class F>
 typename TemplatedDcel<V, HE, F>::Vertex* TemplatedDcel<V, HE, F>::addVertex(int id)
 {
-    #ifdef NDEBUG
-    Vertex* last= new Vertex((DcelData&)*this);
-    #else
-    Vertex* last= new Vertex();
-    #endif
+    Vertex* last = newVertex();
     last->setId(id);
     vertices[id] = last;
     return last;
@@ -2393,11 +2722,7 @@ typename TemplatedDcel<V, HE, F>::Vertex* TemplatedDcel<V, HE, F>::addVertex(int
 template <class V, class HE, class F>
 typename TemplatedDcel<V, HE, F>::HalfEdge* TemplatedDcel<V, HE, F>::addHalfEdge(int id)
 {
-    #ifdef NDEBUG
-    HalfEdge* last = new HalfEdge(*this);
-    #else
-    HalfEdge* last = new HalfEdge();
-    #endif
+    HalfEdge* last = newHalfEdge();
     last->setId(id);
     halfEdges[id] = last;
     return last;
@@ -2415,16 +2740,722 @@ typename TemplatedDcel<V, HE, F>::HalfEdge* TemplatedDcel<V, HE, F>::addHalfEdge
 template <class V, class HE, class F>
 typename TemplatedDcel<V, HE, F>::Face* TemplatedDcel<V, HE, F>::addFace(int id)
 {
-    #ifdef NDEBUG
-    Face* last = new Face(*this);
-    #else
-    Face* last = new Face();
-    #endif
+    Face* last = newFace();
     last->setId(id);
     faces[id] = last;
     return last;
 }
 
+/**
+ * @brief Builds a new vertex in a slot of the vertex pool.
+ * The vertex is not inserted in the list of vertices of the Dcel.
+ */
+template <class V, class HE, class F>
+inline typename TemplatedDcel<V, HE, F>::Vertex* TemplatedDcel<V, HE, F>::newVertex()
+{
+    return new (vertexPool.allocate()) Vertex((internal::DcelData&)*this);
+}
+
+/**
+ * @brief Builds a new half edge in a slot of the half edge pool.
+ * The half edge is not inserted in the list of half edges of the Dcel.
+ */
+template <class V, class HE, class F>
+inline typename TemplatedDcel<V, HE, F>::HalfEdge* TemplatedDcel<V, HE, F>::newHalfEdge()
+{
+    return new (halfEdgePool.allocate()) HalfEdge((internal::DcelData&)*this);
+}
+
+/**
+ * @brief Builds a new face in a slot of the face pool.
+ * The face is not inserted in the list of faces of the Dcel.
+ */
+template <class V, class HE, class F>
+inline typename TemplatedDcel<V, HE, F>::Face* TemplatedDcel<V, HE, F>::newFace()
+{
+    return new (facePool.allocate()) Face((internal::DcelData&)*this);
+}
+
+template <class V, class HE, class F>
+inline void TemplatedDcel<V, HE, F>::destroyVertex(Vertex* v)
+{
+    v->~Vertex();
+    vertexPool.deallocate(v);
+}
+
+template <class V, class HE, class F>
+inline void TemplatedDcel<V, HE, F>::destroyHalfEdge(HalfEdge* he)
+{
+    he->~HalfEdge();
+    halfEdgePool.deallocate(he);
+}
+
+template <class V, class HE, class F>
+inline void TemplatedDcel<V, HE, F>::destroyFace(Face* f)
+{
+    f->~Face();
+    facePool.deallocate(f);
+}
+
+/**
+ * @brief Destroys all the elements of the Dcel and releases all the slabs of the
+ * pools at once. Lists of elements are left untouched.
+ */
+template <class V, class HE, class F>
+void TemplatedDcel<V, HE, F>::destroyElements()
+{
+    for (Vertex* v : vertices)
+        if (v != nullptr)
+            v->~Vertex();
+    for (HalfEdge* he : halfEdges)
+        if (he != nullptr)
+            he->~HalfEdge();
+    for (Face* f : faces)
+        if (f != nullptr)
+            f->~Face();
+    vertexPool.clear();
+    halfEdgePool.clear();
+    facePool.clear();
+}
+
+/**
+ * @brief Appends to this Dcel a copy of all the elements of d (which must be a
+ * different Dcel).
+ *
+ * Attribute arrays are appended as contiguous blocks, and elements are copy
+ * constructed (keeping the data of derived classes) in the pools of this Dcel.
+ * Then, their pointers are relinked by id: ids of d are shifted by the number
+ * of ids of this Dcel. The bounding box is not modified.
+ */
+template <class V, class HE, class F>
+void TemplatedDcel<V, HE, F>::copyElements(const TemplatedDcel& d)
+{
+    assert(&d != this);
+    const unsigned int nv = vertices.size(), nhe = halfEdges.size(), nf = faces.size();
+    vertexPool.reserve(d.nVertices);
+    halfEdgePool.reserve(d.nHalfEdges);
+    facePool.reserve(d.nFaces);
+    vertices.resize(nv + d.vertices.size(), nullptr);
+    halfEdges.resize(nhe + d.halfEdges.size(), nullptr);
+    faces.resize(nf + d.faces.size(), nullptr);
+    vertexCoordinates.insert(vertexCoordinates.end(), d.vertexCoordinates.begin(), d.vertexCoordinates.end());
+    vertexNormals.insert(vertexNormals.end(), d.vertexNormals.begin(), d.vertexNormals.end());
+    vertexColors.insert(vertexColors.end(), d.vertexColors.begin(), d.vertexColors.end());
+    faceNormals.insert(faceNormals.end(), d.faceNormals.begin(), d.faceNormals.end());
+    faceColors.insert(faceColors.end(), d.faceColors.begin(), d.faceColors.end());
+
+    for (unsigned int i = 0; i < d.vertices.size(); ++i){
+        if (d.vertices[i] != nullptr){
+            Vertex* v = new (vertexPool.allocate()) Vertex(*d.vertices[i]);
+            v->parent = this;
+            v->_id = nv + i;
+            vertices[nv + i] = v;
+        }
+    }
+    for (unsigned int i = 0; i < d.halfEdges.size(); ++i){
+        if (d.halfEdges[i] != nullptr){
+            HalfEdge* he = new (halfEdgePool.allocate()) HalfEdge(*d.halfEdges[i]);
+            he->parent = this;
+            he->_id = nhe + i;
+            halfEdges[nhe + i] = he;
+        }
+    }
+    for (unsigned int i = 0; i < d.faces.size(); ++i){
+        if (d.faces[i] != nullptr){
+            Face* f = new (facePool.allocate()) Face(*d.faces[i]);
+            f->parent = this;
+            f->_id = nf + i;
+            faces[nf + i] = f;
+        }
+    }
+    for (unsigned int id : d.unusedVids)
+        unusedVids.push_back(nv + id);
+    for (unsigned int id : d.unusedHeids)
+        unusedHeids.push_back(nhe + id);
+    for (unsigned int id : d.unusedFids)
+        unusedFids.push_back(nf + id);
+    nVertices += d.nVertices;
+    nHalfEdges += d.nHalfEdges;
+    nFaces += d.nFaces;
+
+    //copied pointers still refer to the elements of d: they are relinked by id
+    auto vertexOf = [&](const cg3::Vertex* v) -> Vertex* {
+        return v == nullptr ? nullptr : vertices[nv + v->_id];
+    };
+    auto halfEdgeOf = [&](const cg3::HalfEdge* he) -> HalfEdge* {
+        return he == nullptr ? nullptr : halfEdges[nhe + he->_id];
+    };
+    auto faceOf = [&](const cg3::Face* f) -> Face* {
+        return f == nullptr ? nullptr : faces[nf + f->_id];
+    };
+    for (unsigned int i = nv; i < vertices.size(); ++i){
+        if (Vertex* v = vertices[i])
+            v->_incidentHalfEdge = halfEdgeOf(v->_incidentHalfEdge);
+    }
+    for (unsigned int i = nhe; i < halfEdges.size(); ++i){
+        if (HalfEdge* he = halfEdges[i]){
+            he->_fromVertex = vertexOf(he->_fromVertex);
+            he->_toVertex = vertexOf(he->_toVertex);
+            he->_twin = halfEdgeOf(he->_twin);
+            he->_prev = halfEdgeOf(he->_prev);
+            he->_next = halfEdgeOf(he->_next);
+            he->_face = faceOf(he->_face);
+        }
+    }
+    for (unsigned int i = nf; i < faces.size(); ++i){
+        if (Face* f = faces[i]){
+            f->_outerHalfEdge = halfEdgeOf(f->_outerHalfEdge);
+            for (cg3::HalfEdge*& ihe : f->_innerHalfEdges)
+                ihe = halfEdgeOf(ihe);
+        }
+    }
+}
+
+/**
+ * @brief Moves all the elements of d (which must be a different Dcel) in this
+ * Dcel, which must be empty. At the end, d will be empty.
+ *
+ * The storage of the elements is taken from d without copies: only the pointers
+ * of the elements to their Dcel are updated.
+ */
+template <class V, class HE, class F>
+void TemplatedDcel<V, HE, F>::moveElements(TemplatedDcel& d)
+{
+    assert(&d != this && vertices.empty() && halfEdges.empty() && faces.empty());
+    vertices = std::move(d.vertices);
+    halfEdges = std::move(d.halfEdges);
+    faces = std::move(d.faces);
+    unusedVids = std::move(d.unusedVids);
+    unusedHeids = std::move(d.unusedHeids);
+    unusedFids = std::move(d.unusedFids);
+    nVertices = d.nVertices;
+    nHalfEdges = d.nHalfEdges;
+    nFaces = d.nFaces;
+    bBox = d.bBox;
+    vertexPool.swap(d.vertexPool);
+    halfEdgePool.swap(d.halfEdgePool);
+    facePool.swap(d.facePool);
+    vertexCoordinates = std::move(d.vertexCoordinates);
+    vertexNormals = std::move(d.vertexNormals);
+    vertexColors = std::move(d.vertexColors);
+    faceNormals = std::move(d.faceNormals);
+    faceColors = std::move(d.faceColors);
+    for (Vertex* v : vertexIterator())
+        v->parent = this;
+    for (HalfEdge* he : halfEdgeIterator())
+        he->parent = this;
+    for (Face* f : faceIterator())
+        f->parent = this;
+
+    d.vertices.clear();
+    d.halfEdges.clear();
+    d.faces.clear();
+    d.unusedVids.clear();
+    d.unusedHeids.clear();
+    d.unusedFids.clear();
+    d.vertexCoordinates.clear();
+    d.vertexNormals.clear();
+    d.vertexColors.clear();
+    d.faceNormals.clear();
+    d.faceColors.clear();
+    d.nVertices = 0;
+    d.nHalfEdges = 0;
+    d.nFaces = 0;
+}
+
+/**
+ * @brief Replaces a face with the triangles of one of its triangulations.
+ *
+ * The first triangle reuses the face, the others are new faces with the same normal
+ * and color. The half edges of the borders are reused, while a pair of twin half edges
+ * is added for each diagonal.
+ *
+ * @param[in] f: the face to split
+ * @param[in] borderHalfEdges: the half edges of the borders of the face, as given by Face::borders()
+ * @param[in] triangles: indices in borderHalfEdges of the from vertices of the triangles
+ * @param[in] nTriangles: number of triangles
+ * @param diagonals: buffer used to pair the twin half edges of the diagonals
+ *
+ * If nTriangles is 0 (the triangulation failed), a face without holes is split in
+ * a fan of triangles around a vertex that appears only once on its border. A face
+ * with holes is left unchanged: its inner borders could not be reached.
+ * @return the number of triangles, 0 if the face has not been split
+ */
+template <class V, class HE, class F>
+unsigned int TemplatedDcel<V, HE, F>::splitFace(
+        Face* f,
+        const std::vector<const cg3::HalfEdge*>& borderHalfEdges,
+        const unsigned int* triangles,
+        unsigned int nTriangles,
+        std::unordered_map<uint64_t, HalfEdge*>& diagonals)
+{
+    std::vector<unsigned int> fan;
+    if (nTriangles == 0){
+        if (!f->_innerHalfEdges.empty())
+            return 0;
+        const unsigned int n = borderHalfEdges.size();
+        std::unordered_map<const cg3::Vertex*, unsigned int> occurrences;
+        for (const cg3::HalfEdge* he : borderHalfEdges)
+            occurrences[he->fromVertex()]++;
+        unsigned int s = 0;
+        while (s < n && occurrences[borderHalfEdges[s]->fromVertex()] > 1)
+            s++;
+        if (n < 3 || s == n)
+            return 0;
+        for (unsigned int i = 1; i + 1 < n; ++i)
+            fan.insert(fan.end(), {s, (s + i) % n, (s + i + 1) % n});
+        triangles = fan.data();
+        nTriangles = n - 2;
+    }
+    const Vec3d normal = f->normal();
+    const Color color = f->color();
+    diagonals.clear();
+    f->_innerHalfEdges.clear();
+
+    auto edge = [&](unsigned int a, unsigned int b) -> HalfEdge* {
+        HalfEdge* from = halfEdges[borderHalfEdges[a]->id()];
+        if (borderHalfEdges[a]->next() == borderHalfEdges[b])
+            return from; //edge of a border
+        HalfEdge* he = addHalfEdge();
+        he->setFromVertex(from->fromVertex());
+        he->setToVertex(halfEdges[borderHalfEdges[b]->id()]->fromVertex());
+        auto it = diagonals.find(((uint64_t)b << 32) | a);
+        if (it != diagonals.end()){
+            he->setTwin(it->second);
+            it->second->setTwin(he);
+            diagonals.erase(it);
+        }
+        else {
+            diagonals[((uint64_t)a << 32) | b] = he;
+        }
+        return he;
+    };
+
+    for (unsigned int t = 0; t < nTriangles; ++t){
+        const unsigned int* tri = triangles + t * 3;
+        HalfEdge* e1 = edge(tri[0], tri[1]);
+        HalfEdge* e2 = edge(tri[1], tri[2]);
+        HalfEdge* e3 = edge(tri[2], tri[0]);
+        Face* tf = t == 0 ? f : addFace(normal, color);
+        e1->setNext(e2);
+        e2->setNext(e3);
+        e3->setNext(e1);
+        e1->setPrev(e3);
+        e2->setPrev(e1);
+        e3->setPrev(e2);
+        e1->setFace(tf);
+        e2->setFace(tf);
+        e3->setFace(tf);
+        tf->setOuterHalfEdge(e1);
+        const Point3d& a = vertexCoordinates[e1->fromVertex()->id()];
+        const Point3d& b = vertexCoordinates[e2->fromVertex()->id()];
+        const Point3d& c = vertexCoordinates[e3->fromVertex()->id()];
+        tf->setArea((b - a).cross(c - a).length() / 2);
+    }
+    return nTriangles;
+}
+
+/**
+ * @brief Single pass that renumbers the ids of all the elements, removing the
+ * holes left by deleted elements (together with their attributes).
+ * @param[in] shrink: if true, the capacity of the storage vectors is released
+ */
+template <class V, class HE, class F>
+void TemplatedDcel<V, HE, F>::compactIds(bool shrink)
+{
+    nVertices = 0;
+    for (unsigned int i = 0; i < vertices.size(); i++){
+        if (vertices[i] != nullptr) {
+            if (nVertices != i){
+                vertexCoordinates[nVertices] = vertexCoordinates[i];
+                vertexNormals[nVertices] = vertexNormals[i];
+                vertexColors[nVertices] = vertexColors[i];
+            }
+            vertices[nVertices] = vertices[i];
+            vertices[nVertices]->setId(nVertices);
+            nVertices++;
+        }
+    }
+    unusedVids.clear();
+    vertices.resize(nVertices);
+    vertexCoordinates.resize(nVertices);
+    vertexNormals.resize(nVertices);
+    vertexColors.resize(nVertices);
+
+    nHalfEdges = 0;
+    for (unsigned int i = 0; i < halfEdges.size(); i++){
+        if (halfEdges[i] != nullptr) {
+            halfEdges[nHalfEdges] = halfEdges[i];
+            halfEdges[nHalfEdges]->setId(nHalfEdges);
+            nHalfEdges++;
+        }
+    }
+    unusedHeids.clear();
+    halfEdges.resize(nHalfEdges);
+
+    nFaces = 0;
+    for (unsigned int i = 0; i < faces.size(); i++){
+        if (faces[i] != nullptr) {
+            if (nFaces != i){
+                faceNormals[nFaces] = faceNormals[i];
+                faceColors[nFaces] = faceColors[i];
+            }
+            faces[nFaces] = faces[i];
+            faces[nFaces]->setId(nFaces);
+            nFaces++;
+        }
+    }
+    unusedFids.clear();
+    faces.resize(nFaces);
+    faceNormals.resize(nFaces);
+    faceColors.resize(nFaces);
+
+    if (shrink){
+        vertices.shrink_to_fit();
+        halfEdges.shrink_to_fit();
+        faces.shrink_to_fit();
+        unusedVids.shrink_to_fit();
+        unusedHeids.shrink_to_fit();
+        unusedFids.shrink_to_fit();
+        vertexCoordinates.shrink_to_fit();
+        vertexNormals.shrink_to_fit();
+        vertexColors.shrink_to_fit();
+        faceNormals.shrink_to_fit();
+        faceColors.shrink_to_fit();
+    }
+}
+
+/**
+ * @brief Reads a list of unused ids, written by the version 1 of the .dcel format
+ * with the same layout of a serialized std::set<int>.
+ */
+template <class V, class HE, class F>
+void TemplatedDcel<V, HE, F>::deserializeUnusedIds(
+        std::vector<unsigned int>& ids,
+        std::ifstream& binaryFile)
+{
+    std::string s;
+    unsigned long long int size;
+    cg3::deserialize(s, binaryFile);
+    if (s != "stdset")
+        throw std::ios_base::failure("Mismatching String: " + s + " != stdset");
+    cg3::deserialize(size, binaryFile);
+    std::vector<unsigned int> tmp(size);
+    if (size > 0 && !binaryFile.read(reinterpret_cast<char*>(tmp.data()), size * sizeof(unsigned int)))
+        throw std::ios_base::failure("Deserialization failed of unused ids");
+    ids = std::move(tmp);
+}
+
+/**
+ * @brief Reads the blocks of a Dcel serialized with the version 2 of the .dcel
+ * format, after the tag string, in this empty Dcel.
+ *
+ * The Reader gives access to the next n bytes through the method read(n):
+ * blocks are read either from a stream or directly from a memory mapped file.
+ *
+ * @throws std::ios_base::failure if the data is not valid
+ */
+template <class V, class HE, class F>
+template <class Reader>
+void TemplatedDcel<V, HE, F>::deserializeBlocks(Reader& reader)
+{
+    const char* p = reader.read(internal::DCEL_FILE_HEADER_SIZE);
+    uint32_t magic = internal::readDcelValue<uint32_t>(p);
+    uint32_t version = internal::readDcelValue<uint32_t>(p);
+    if (magic != internal::DCEL_FILE_MAGIC)
+        throw std::ios_base::failure("Wrong magic number or byte order of the dcel file");
+    if (version != internal::DCEL_FILE_VERSION)
+        throw std::ios_base::failure("Unsupported version of the dcel file: " + std::to_string(version));
+    uint64_t sizes[7];
+    for (unsigned int i = 0; i < 7; ++i)
+        sizes[i] = internal::readDcelValue<uint64_t>(p);
+    const uint64_t maxSlots = std::numeric_limits<int32_t>::max();
+    if (sizes[0] > maxSlots || sizes[1] > maxSlots || sizes[2] > maxSlots ||
+            sizes[3] > sizes[0] || sizes[4] > sizes[1] || sizes[5] > sizes[2])
+        throw std::ios_base::failure("Wrong sizes in the dcel file");
+    const unsigned int nv = sizes[0], nhe = sizes[1], nf = sizes[2];
+    double bb[6];
+    for (unsigned int i = 0; i < 6; ++i)
+        bb[i] = internal::readDcelValue<double>(p);
+    bBox = BoundingBox3(Point3d(bb[0], bb[1], bb[2]), Point3d(bb[3], bb[4], bb[5]));
+
+    //Unused ids
+    std::vector<char> alive[3] = {
+        std::vector<char>(nv, 1), std::vector<char>(nhe, 1), std::vector<char>(nf, 1)};
+    std::vector<unsigned int>* unused[3] = {&unusedVids, &unusedHeids, &unusedFids};
+    for (unsigned int k = 0; k < 3; ++k){
+        unused[k]->resize(sizes[3+k]);
+        if (sizes[3+k] > 0)
+            std::memcpy(unused[k]->data(), reader.read(sizes[3+k] * sizeof(uint32_t)), sizes[3+k] * sizeof(uint32_t));
+        for (unsigned int id : *unused[k]){
+            if (id >= alive[k].size() || !alive[k][id])
+                throw std::ios_base::failure("Wrong unused ids in the dcel file");
+            alive[k][id] = 0;
+        }
+    }
+    nVertices = nv - unusedVids.size();
+    nHalfEdges = nhe - unusedHeids.size();
+    nFaces = nf - unusedFids.size();
+    reserve(nVertices, nHalfEdges, nFaces);
+    vertices.assign(nv, nullptr);
+    halfEdges.assign(nhe, nullptr);
+    faces.assign(nf, nullptr);
+    for (unsigned int i = 0; i < nv; ++i)
+        if (alive[0][i]) addVertex(i);
+    for (unsigned int i = 0; i < nhe; ++i)
+        if (alive[1][i]) addHalfEdge(i);
+    for (unsigned int i = 0; i < nf; ++i)
+        if (alive[2][i]) addFace(i);
+
+    auto vertexPtr = [&](int32_t id) -> Vertex* {
+        if (id < 0) return nullptr;
+        if ((unsigned int)id >= nv || vertices[id] == nullptr)
+            throw std::ios_base::failure("Wrong vertex id in the dcel file");
+        return vertices[id];
+    };
+    auto halfEdgePtr = [&](int32_t id) -> HalfEdge* {
+        if (id < 0) return nullptr;
+        if ((unsigned int)id >= nhe || halfEdges[id] == nullptr)
+            throw std::ios_base::failure("Wrong half edge id in the dcel file");
+        return halfEdges[id];
+    };
+    auto facePtr = [&](int32_t id) -> Face* {
+        if (id < 0) return nullptr;
+        if ((unsigned int)id >= nf || faces[id] == nullptr)
+            throw std::ios_base::failure("Wrong face id in the dcel file");
+        return faces[id];
+    };
+
+    //Vertices
+    vertexCoordinates.resize(nv);
+    p = reader.read(nv * 3 * sizeof(double));
+    for (unsigned int i = 0; i < nv; ++i, p += 3 * sizeof(double))
+        vertexCoordinates[i] = readPoint(p);
+    vertexNormals.resize(nv);
+    p = reader.read(nv * 3 * sizeof(double));
+    for (unsigned int i = 0; i < nv; ++i, p += 3 * sizeof(double))
+        vertexNormals[i] = readPoint(p);
+    vertexColors.resize(nv);
+    p = reader.read(nv * 4);
+    for (unsigned int i = 0; i < nv; ++i, p += 4)
+        vertexColors[i] = Color((unsigned char)p[0], (unsigned char)p[1], (unsigned char)p[2], (unsigned char)p[3]);
+    p = reader.read(nv * 3 * sizeof(int32_t));
+    for (unsigned int i = 0; i < nv; ++i){
+        int32_t heid = internal::readDcelValue<int32_t>(p);
+        int32_t card = internal::readDcelValue<int32_t>(p);
+        int32_t flag = internal::readDcelValue<int32_t>(p);
+        if (Vertex* v = vertices[i]){
+            v->_incidentHalfEdge = halfEdgePtr(heid);
+            v->_cardinality = card;
+            v->_flag = flag;
+        }
+    }
+
+    //HalfEdges
+    p = reader.read(nhe * 7 * sizeof(int32_t));
+    for (unsigned int i = 0; i < nhe; ++i){
+        int32_t a[7];
+        for (unsigned int j = 0; j < 7; ++j)
+            a[j] = internal::readDcelValue<int32_t>(p);
+        if (HalfEdge* he = halfEdges[i]){
+            he->_fromVertex = vertexPtr(a[0]);
+            he->_toVertex = vertexPtr(a[1]);
+            he->_twin = halfEdgePtr(a[2]);
+            he->_prev = halfEdgePtr(a[3]);
+            he->_next = halfEdgePtr(a[4]);
+            he->_face = facePtr(a[5]);
+            he->_flag = a[6];
+        }
+    }
+
+    //Faces
+    faceNormals.resize(nf);
+    p = reader.read(nf * 3 * sizeof(double));
+    for (unsigned int i = 0; i < nf; ++i, p += 3 * sizeof(double))
+        faceNormals[i] = readPoint(p);
+    faceColors.resize(nf);
+    p = reader.read(nf * 4);
+    for (unsigned int i = 0; i < nf; ++i, p += 4)
+        faceColors[i] = Color((unsigned char)p[0], (unsigned char)p[1], (unsigned char)p[2], (unsigned char)p[3]);
+    p = reader.read(nf * sizeof(double));
+    for (unsigned int i = 0; i < nf; ++i){
+        double area = internal::readDcelValue<double>(p);
+        if (faces[i])
+            faces[i]->_area = area;
+    }
+    std::vector<int32_t> nInner(nf);
+    uint64_t totInner = 0;
+    p = reader.read(nf * 3 * sizeof(int32_t));
+    for (unsigned int i = 0; i < nf; ++i){
+        int32_t ohe = internal::readDcelValue<int32_t>(p);
+        int32_t flag = internal::readDcelValue<int32_t>(p);
+        nInner[i] = internal::readDcelValue<int32_t>(p);
+        if (Face* f = faces[i]){
+            f->_outerHalfEdge = halfEdgePtr(ohe);
+            f->_flag = flag;
+            if (nInner[i] < 0)
+                throw std::ios_base::failure("Wrong number of inner half edges in the dcel file");
+            totInner += nInner[i];
+        }
+    }
+    if (totInner != sizes[6])
+        throw std::ios_base::failure("Wrong number of inner half edges in the dcel file");
+    p = reader.read(totInner * sizeof(int32_t));
+    for (unsigned int i = 0; i < nf; ++i){
+        if (Face* f = faces[i]){
+            f->_innerHalfEdges.reserve(nInner[i]);
+            for (int32_t j = 0; j < nInner[i]; ++j)
+                f->_innerHalfEdges.push_back(halfEdgePtr(internal::readDcelValue<int32_t>(p)));
+        }
+    }
+}
+
+/**
+ * @brief Reads in this empty Dcel the data of a Dcel serialized with the
+ * version 1 of the .dcel format, after the tag string.
+ */
+template <class V, class HE, class F>
+void TemplatedDcel<V, HE, F>::deserializeLegacy(std::ifstream& binaryFile)
+{
+    bBox.deserialize(binaryFile);
+    cg3::deserialize(nVertices, binaryFile);
+    cg3::deserialize(nHalfEdges, binaryFile);
+    cg3::deserialize(nFaces, binaryFile);
+    deserializeUnusedIds(unusedVids, binaryFile);
+    deserializeUnusedIds(unusedHeids, binaryFile);
+    deserializeUnusedIds(unusedFids, binaryFile);
+
+    //Vertices
+    vertices.resize(nVertices+unusedVids.size(), nullptr);
+    vertexCoordinates.resize(nVertices+unusedVids.size(), Point3d());
+    vertexNormals.resize(nVertices+unusedVids.size(), Vec3d());
+    vertexColors.resize(nVertices+unusedVids.size(), Color());
+    std::map<int, int> vert;
+
+    for (unsigned int i = 0; i < nVertices; i++){
+        int id, heid;
+        Point3d coord; Vec3d norm; Color color;
+        int c, f;
+        cg3::deserialize(id, binaryFile);
+        coord.deserialize(binaryFile);
+        norm.deserialize(binaryFile);
+        cg3::deserialize(color, binaryFile);
+        cg3::deserialize(heid, binaryFile);
+        cg3::deserialize(c, binaryFile);
+        cg3::deserialize(f, binaryFile);
+
+        Vertex* v = addVertex(id);
+        v->setCardinality(c);
+        v->setCoordinate(coord);
+        v->setNormal(norm);
+        v->setColor(color);
+        v->setFlag(f);
+        vert[id] = heid;
+    }
+    //HalfEdges
+    halfEdges.resize(nHalfEdges+unusedHeids.size(), nullptr);
+    std::map<int, std::array<int, 6> > edges;
+
+    for (unsigned int i = 0; i < nHalfEdges; i++){
+        int id, fv, tv, tw, prev, next, face, flag;
+        cg3::deserialize(id, binaryFile);
+        cg3::deserialize(fv, binaryFile);
+        cg3::deserialize(tv, binaryFile);
+        cg3::deserialize(tw, binaryFile);
+        cg3::deserialize(prev, binaryFile);
+        cg3::deserialize(next, binaryFile);
+        cg3::deserialize(face, binaryFile);
+        cg3::deserialize(flag, binaryFile);
+        HalfEdge* he = addHalfEdge(id);
+        he->setFlag(flag);
+        edges[id] = {fv, tv, tw, prev, next, face};
+    }
+
+    //Faces
+    faces.resize(nFaces+unusedFids.size(), nullptr);
+    faceNormals.resize(nFaces+unusedFids.size(), Vec3d());
+    faceColors.resize(nFaces+unusedFids.size(), Color());
+    for (unsigned int i = 0; i < nFaces; i++){
+        int id, ohe, /*cr, cg, cb,*/ flag, nihe;
+        double /*nx, ny, nz,*/ area;
+        Color color;
+        Vec3d norm;
+        cg3::deserialize(id, binaryFile);
+        cg3::deserialize(ohe, binaryFile);
+        norm.deserialize(binaryFile);
+        cg3::deserialize(color, binaryFile);
+        cg3::deserialize(area, binaryFile);
+        cg3::deserialize(flag, binaryFile);
+        cg3::deserialize(nihe, binaryFile);
+
+
+        Face* f = addFace(id);
+        f->setColor(color);
+        f->setNormal(norm);
+        f->setArea(area);
+        f->setFlag(flag);
+        f->setOuterHalfEdge(halfEdge(ohe));
+        for (int j = 0; j < nihe; j++){
+            int idhe;
+            cg3::deserialize(idhe, binaryFile);
+            f->addInnerHalfEdge(halfEdge(idhe));
+        }
+    }
+
+    for (Vertex* v : vertexIterator()){
+        v->setIncidentHalfEdge(halfEdge(vert[v->id()]));
+    }
+    for (HalfEdge* he : halfEdgeIterator()){
+        std::array<int, 6> a = edges[he->id()];
+        he->setFromVertex(vertex(a[0]));
+        he->setToVertex(vertex(a[1]));
+        he->setTwin(halfEdge(a[2]));
+        he->setPrev(halfEdge(a[3]));
+        he->setNext(halfEdge(a[4]));
+        he->setFace(face(a[5]));
+    }
+
+}
+
+/**
+ * @brief Reads the data of derived Vertex, HalfEdge and Face classes, which
+ * follows the blocks of the .dcel format.
+ */
+template <class V, class HE, class F>
+void TemplatedDcel<V, HE, F>::deserializeElementData(std::ifstream& binaryFile)
+{
+    for (Vertex* v: vertexIterator())
+        v->deserialize(binaryFile);
+    for (HalfEdge* he: halfEdgeIterator())
+        he->deserialize(binaryFile);
+    for (Face* f: faceIterator())
+        f->deserialize(binaryFile);
+}
+
+template <class V, class HE, class F>
+template <class T>
+inline int32_t TemplatedDcel<V, HE, F>::elementId(const T* e)
+{
+    return e == nullptr ? -1 : (int32_t)e->id();
+}
+
+template <class V, class HE, class F>
+inline void TemplatedDcel<V, HE, F>::putColor(internal::DcelBlockWriter& w, const Color& c)
+{
+    w.put((uint8_t)c.red());
+    w.put((uint8_t)c.green());
+    w.put((uint8_t)c.blue());
+    w.put((uint8_t)c.alpha());
+}
+
+template <class V, class HE, class F>
+inline Point3d TemplatedDcel<V, HE, F>::readPoint(const char* p)
+{
+    double c[3];
+    std::memcpy(c, p, sizeof(c));
+    return Point3d(c[0], c[1], c[2]);
+}
+
 /**
  * \~Italian
  * @brief Funzione che, data in ingresso una faccia avente dei buchi, restituisce una singola lista di vertici di una faccia avente dummy edge.
@@ -2573,6 +3604,142 @@ void TemplatedDcel<V, HE, F>::toStdVectors(
     }
 }
 
+/**
+ * @brief Fills an empty Dcel with an indexed triangle mesh, see fromIndexedTriangles().
+ * Input indices must be valid.
+ *
+ * Face normals, areas, vertex cardinalities and the bounding box are always computed;
+ * vertex normals (average of the normals of the incident faces) only if
+ * computeVertexNormals is true.
+ */
+template <class V, class HE, class F>
+void TemplatedDcel<V, HE, F>::buildFromIndexedTriangles(
+        const std::vector<double>& coords,
+        const std::vector<unsigned int>& tris,
+        bool computeVertexNormals)
+{
+    assert(nVertices == 0 && nHalfEdges == 0 && nFaces == 0);
+    assert(unusedVids.empty() && unusedHeids.empty() && unusedFids.empty());
+    const unsigned int nv = coords.size() / 3;
+    const unsigned int nt = tris.size() / 3;
+    reserve(nv, 3 * nt, nt);
+
+    bBox.reset();
+    Point3d min = bBox.min(), max = bBox.max();
+    for (unsigned int i = 0; i < nv; ++i){
+        Point3d coord(coords[3*i], coords[3*i+1], coords[3*i+2]);
+        min = min.min(coord);
+        max = max.max(coord);
+        addVertex(coord);
+    }
+    bBox.setMin(min);
+    bBox.setMax(max);
+
+    //the dcel is empty: the id of the i-th half edge of the t-th triangle is 3*t+i.
+    //Half edges are counted by the smaller and by the larger id of their extremes
+    std::vector<unsigned int> bucketBegin(nv + 1, 0);
+    std::vector<unsigned int> maxBucketBegin(nv + 1, 0);
+    for (unsigned int t = 0; t < nt; ++t){
+        Face* f = addFace();
+        HalfEdge* hes[3] = {addHalfEdge(), addHalfEdge(), addHalfEdge()};
+        for (unsigned int i = 0; i < 3; ++i){
+            unsigned int from = tris[3*t+i], to = tris[3*t+(i+1)%3];
+            hes[i]->_fromVertex = vertices[from];
+            hes[i]->_toVertex = vertices[to];
+            hes[i]->_next = hes[(i+1)%3];
+            hes[i]->_prev = hes[(i+2)%3];
+            hes[i]->_face = f;
+            vertices[from]->_incidentHalfEdge = hes[i];
+            vertices[from]->_cardinality++;
+            bucketBegin[std::min(from, to) + 1]++;
+            maxBucketBegin[std::max(from, to) + 1]++;
+        }
+        f->_outerHalfEdge = hes[0];
+
+        const Point3d& a = vertexCoordinates[tris[3*t]];
+        Vec3d n = (vertexCoordinates[tris[3*t+1]] - a).cross(vertexCoordinates[tris[3*t+2]] - a);
+        double l = n.length();
+        if (l > 0){
+            faceNormals[t] = n / l;
+            f->_area = l / 2;
+        }
+        else {
+            f->updateNormal(); //degenerate triangle: zero normal and warning
+            f->_area = 0;
+        }
+    }
+
+    //the undirected edge of a half edge is identified by its extremes (min, max):
+    //half edges are sorted by (min, max) with a LSD radix sort of two digits, that
+    //is a counting sort by max followed by a counting sort by min.
+    //Both sorts are stable: half edges of the same edge remain sorted by id
+    auto from = [&](unsigned int he) { return tris[he]; };
+    auto to = [&](unsigned int he) { return tris[he % 3 == 2 ? he - 2 : he + 1]; };
+    for (unsigned int i = 0; i < nv; ++i){
+        bucketBegin[i+1] += bucketBegin[i];
+        maxBucketBegin[i+1] += maxBucketBegin[i];
+    }
+    std::vector<unsigned int> sorted(3 * nt);
+    {
+        std::vector<unsigned int> sortedByMax(3 * nt);
+        for (unsigned int he = 0; he < 3 * nt; ++he)
+            sortedByMax[maxBucketBegin[std::max(from(he), to(he))]++] = he;
+        std::vector<unsigned int>().swap(maxBucketBegin);
+        std::vector<unsigned int> pos(bucketBegin.begin(), bucketBegin.end() - 1);
+        for (unsigned int he : sortedByMax)
+            sorted[pos[std::min(from(he), to(he))]++] = he;
+    }
+
+    //linking twins: manifold edges are composed by two opposite half edges
+    for (unsigned int i = 0; i < sorted.size(); ){
+        unsigned int v1 = std::min(from(sorted[i]), to(sorted[i]));
+        unsigned int v2 = std::max(from(sorted[i]), to(sorted[i]));
+        unsigned int j = i + 1;
+        while (j < sorted.size() &&
+               std::min(from(sorted[j]), to(sorted[j])) == v1 &&
+               std::max(from(sorted[j]), to(sorted[j])) == v2)
+            ++j;
+        if (j - i == 2 && from(sorted[i]) == to(sorted[i+1]) && to(sorted[i]) == from(sorted[i+1])){
+            HalfEdge* he1 = halfEdges[sorted[i]];
+            HalfEdge* he2 = halfEdges[sorted[i+1]];
+            he1->_twin = he2;
+            he2->_twin = he1;
+        }
+        else if (j - i > 1){
+            //non manifold edge: half edges are paired in order of id, each one with the
+            //last unpaired half edge with opposite orientation (as in afterLoadFile)
+            HalfEdge* open[2] = {nullptr, nullptr};
+            for (unsigned int k = i; k < j; ++k){
+                HalfEdge* he = halfEdges[sorted[k]];
+                unsigned int dir = from(sorted[k]) < to(sorted[k]) ? 0 : 1;
+                unsigned int opp = from(sorted[k]) == to(sorted[k]) ? dir : 1 - dir;
+                if (open[opp] != nullptr){
+                    he->_twin = open[opp];
+                    open[opp]->_twin = he;
+                    open[opp] = nullptr;
+                }
+                else {
+                    open[dir] = he;
+                }
+            }
+        }
+        i = j;
+    }
+
+    if (computeVertexNormals){
+        std::vector<unsigned int> nIncidentFaces(nv, 0);
+        for (unsigned int t = 0; t < nt; ++t){
+            for (unsigned int i = 0; i < 3; ++i){
+                vertexNormals[tris[3*t+i]] += faceNormals[t];
+                nIncidentFaces[tris[3*t+i]]++;
+            }
+        }
+        for (unsigned int i = 0; i < nv; ++i)
+            if (nIncidentFaces[i] > 0)
+                vertexNormals[i] /= nIncidentFaces[i];
+    }
+}
+
 template <class V, class HE, class F>
 void TemplatedDcel<V, HE, F>::afterLoadFile(
         const std::list<double> &coords,
@@ -2583,6 +3750,26 @@ void TemplatedDcel<V, HE, F>::afterLoadFile(
         const std::list<Color> &fcolor,
         const std::list<unsigned int> &fsizes)
 {
+    if (std::all_of(fsizes.begin(), fsizes.end(), [](unsigned int s) { return s == 3; })){
+        //triangle mesh: linear time construction
+        std::vector<double> vcoords(coords.begin(), coords.end());
+        std::vector<unsigned int> vtris(faces.begin(), faces.end());
+        buildFromIndexedTriangles(vcoords, vtris, !fm.hasVertexNormals());
+        if (fm.hasVertexNormals()){
+            std::list<double>::const_iterator vnit = vnorm.begin();
+            for (Vec3d& n : vertexNormals){
+                n.setX(*(vnit++));
+                n.setY(*(vnit++));
+                n.setZ(*(vnit++));
+            }
+        }
+        if (fm.hasVertexColors())
+            std::copy(vcolor.begin(), vcolor.end(), vertexColors.begin());
+        if (fm.hasFaceColors())
+            std::copy(fcolor.begin(), fcolor.end(), faceColors.begin());
+        return;
+    }
+
     std::vector<Vertex*> vertices;
 
     std::map< std::pair<int,int>, HalfEdge* > edge;
@@ -2590,6 +3777,9 @@ void TemplatedDcel<V, HE, F>::afterLoadFile(
 
     bool first = true;
 
+    reserve(coords.size() / 3, faces.size(), fsizes.size());
+    vertices.reserve(coords.size() / 3);
+
     std::list<double>::const_iterator vnit = vnorm.begin();
     std::list<Color>::const_iterator vcit = vcolor.begin();
     for (std::list<double>::const_iterator it = coords.begin(); it != coords.end(); ){
@@ -2691,90 +3881,21 @@ void TemplatedDcel<V, HE, F>::copyFrom(const SimpleEigenMesh& eigenMesh)
 {
     clear();
 
-    std::vector<Vertex*> vertices;
-
-    std::map< std::pair<int,int>, HalfEdge* > edge;
-    typename std::map< std::pair<int,int>, HalfEdge* >::iterator eiter;
-
-    bool first = true;
-
-
+    std::vector<double> coords(eigenMesh.numberVertices() * 3);
+    std::vector<unsigned int> tris(eigenMesh.numberFaces() * 3);
     for (unsigned int i = 0; i < eigenMesh.numberVertices(); i++) {
-
         Point3d coord = eigenMesh.vertex(i);
-
-        if (first) {
-            bBox.setMin(coord);
-            bBox.setMax(coord);
-            first = false;
-        }
-
-        if (coord.x() < bBox.minX()) bBox.setMinX(coord.x());
-        if (coord.y() < bBox.minY()) bBox.setMinY(coord.y());
-        if (coord.z() < bBox.minZ()) bBox.setMinZ(coord.z());
-
-        if (coord.x() > bBox.maxX()) bBox.setMaxX(coord.x());
-        if (coord.y() > bBox.maxY()) bBox.setMaxY(coord.y());
-        if (coord.z() > bBox.maxZ()) bBox.setMaxZ(coord.z());
-
-        Vertex* vid = addVertex(coord);
-
-        vertices.push_back(vid);
+        coords[3*i] = coord.x();
+        coords[3*i+1] = coord.y();
+        coords[3*i+2] = coord.z();
     }
-
     for (unsigned int i = 0; i < eigenMesh.numberFaces(); i++) {
-
-        std::vector<int> nid;
         Point3i ff = eigenMesh.face(i);
-        nid.push_back(ff.x());
-        nid.push_back(ff.y());
-        nid.push_back(ff.z());
-        nid.push_back(nid[0]);
-        std::pair<int, int> p;
-        HalfEdge* eid = nullptr;
-        Face* fid = addFace();
-        HalfEdge* prev = nullptr;
-        HalfEdge* first = nullptr;
-
-        for (unsigned int i=0; i<nid.size()-1; i++){
-            eid = addHalfEdge();
-            if (i==0) {
-                first = eid;
-                fid->setOuterHalfEdge(eid);
-            }
-            else {
-                eid->setPrev(prev);
-                prev->setNext(eid);
-            }
-            vertices[nid[i]]->setIncidentHalfEdge(eid);
-            eid->setFromVertex(vertices[nid[i]]);
-            vertices[nid[i]]->incrementCardinality();
-            eid->setToVertex(vertices[nid[i+1]]);
-            eid->setFace(fid);
-            p.first = nid[i+1];
-            p.second = nid[i];
-            eiter = edge.find(p);
-            if (eiter != edge.end()){
-                HalfEdge* twin = edge[p];
-                eid->setTwin(twin);
-                twin->setTwin(eid);
-                edge.erase(eiter);
-            }
-            else {
-                p.first = nid[i];
-                p.second = nid[i+1];
-                edge[p] = eid;
-            }
-            prev = eid;
-        }
-        eid->setNext(first);
-        first->setPrev(eid);
-
-        fid->setColor(Color(128, 128, 128));
-
-        fid->updateNormal();
-        fid->updateArea();
+        tris[3*i] = ff.x();
+        tris[3*i+1] = ff.y();
+        tris[3*i+2] = ff.z();
     }
+    buildFromIndexedTriangles(coords, tris, false);
 }
 
 template <class V, class HE, class F>
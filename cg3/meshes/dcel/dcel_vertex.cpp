@@ -26,7 +26,6 @@ namespace cg3 {
  * - id pari a 0;
  * - flag pari a 0.
  */
-#ifdef NDEBUG
 CG3_INLINE Vertex::Vertex(internal::DcelData& parent) :
     parent(&parent),
     _incidentHalfEdge(nullptr),
@@ -35,15 +34,6 @@ CG3_INLINE Vertex::Vertex(internal::DcelData& parent) :
     _flag(0)
 {
 }
-#else
-CG3_INLINE Vertex::Vertex() :
-    _incidentHalfEdge(nullptr),
-    _cardinality(0),
-    _id(0),
-    _flag(0)
-{
-}
-#endif
 
 /**
  * \~Italian
@@ -83,11 +73,7 @@ CG3_INLINE int Vertex::flag() const
  */
 CG3_INLINE Vec3d Vertex::normal() const
 {
-	#ifdef NDEBUG
 	return parent->vertexNormals[_id];
-	#else
-	return _normal;
-	#endif
 }
 
 /**
@@ -97,11 +83,7 @@ CG3_INLINE Vec3d Vertex::normal() const
  */
 CG3_INLINE const Point3d& Vertex::coordinate() const
 {
-	#ifdef NDEBUG
 	return parent->vertexCoordinates[_id];
-	#else
-	return _coordinate;
-	#endif
 }
 
 /**
@@ -111,11 +93,7 @@ CG3_INLINE const Point3d& Vertex::coordinate() const
  */
 CG3_INLINE Color Vertex::color() const
 {
-	#ifdef NDEBUG
 	return parent->vertexColors[_id];
-	#else
-	return _color;
-	#endif
 }
 
 /**
@@ -147,11 +125,7 @@ CG3_INLINE const HalfEdge* Vertex::incidentHalfEdge() const
  */
 CG3_INLINE double Vertex::dist(const Vertex* otherVertex) const
 {
-	#ifdef NDEBUG
 	return parent->vertexCoordinates[_id].dist(parent->vertexCoordinates[otherVertex->_id]);
-	#else
-	return this->_coordinate.dist(otherVertex->_coordinate);
-	#endif
 }
 
 /**
@@ -199,11 +173,7 @@ CG3_INLINE void Vertex::resetFlag()
  */
 CG3_INLINE void Vertex::setNormal(const Vec3d& newNormal)
 {
-	#ifdef NDEBUG
 	parent->vertexNormals[_id] = newNormal;
-	#else
-	_normal = newNormal;
-	#endif
 }
 
 /**
@@ -213,11 +183,7 @@ CG3_INLINE void Vertex::setNormal(const Vec3d& newNormal)
  */
 CG3_INLINE void Vertex::setCoordinate(const Point3d& newCoordinate)
 {
-	#ifdef NDEBUG
 	parent->vertexCoordinates[_id] = newCoordinate;
-	#else
-	_coordinate = newCoordinate;
-	#endif
 }
 
 /**
@@ -231,11 +197,7 @@ CG3_INLINE void Vertex::setCardinality( int newCardinality )
 }
 
 CG3_INLINE void Vertex::setColor(const Color& c) {
-	#ifdef NDEBUG
 	parent->vertexColors[_id] = c;
-	#else
-	_color = c;
-	#endif
 }
 
 /**
@@ -361,11 +323,7 @@ CG3_INLINE std::string Vertex::toString() const
 {
     std::stringstream ss;
 
-    #ifdef NDEBUG
     ss << "ID: " << _id << "; Position: " << to_string(parent->vertexCoordinates[_id]) << "; Normal: " << to_string(parent->vertexNormals[_id])
-    #else
-    ss << "ID: " << _id << "; Position: " << to_string(_coordinate) << "; Normal: " << to_string(_normal)
-    #endif
        << "; Half-Edge: " ;
     if (_incidentHalfEdge == nullptr) ss << "nullptr";
     else ss << _incidentHalfEdge->id();
@@ -385,32 +343,17 @@ CG3_INLINE std::string Vertex::toString() const
  */
 CG3_INLINE Vec3d Vertex::updateNormal()
 {
-    #ifdef NDEBUG
-    parent->vertexNormals[_id].set(0,0,0);
-    #else
-    _normal.set(0,0,0);
-    #endif
+    Vec3d normal(0,0,0);
     unsigned int n = 0;
     ConstIncidentFaceIterator f;
     for (f = incidentFaceBegin(); f != incidentFaceEnd(); ++f) {
-        #ifdef NDEBUG
-        parent->vertexNormals[_id] += (*f)->normal();
-        #else
-        _normal += (*f)->normal();
-        #endif
+        normal += (*f)->normal();
         n++;
     }
-    #ifdef NDEBUG
-    parent->vertexNormals[_id] /= n;
-    #else
-    _normal /= n;
-    #endif
+    normal /= n;
     _cardinality = n;
-    #ifdef NDEBUG
-    return parent->vertexNormals[_id];
-    #else
-    return _normal;
-    #endif
+    parent->vertexNormals[_id] = normal;
+    return normal;
 }
 
 /**
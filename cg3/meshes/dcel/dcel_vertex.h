@@ -184,11 +184,7 @@ protected:
     * Constructors *
     ****************/
 
-    #ifdef NDEBUG
     Vertex(internal::DcelData& parent);
-    #else
-    Vertex();
-    #endif
     //Vertex(Dcel& parent, const Pointd& p);
     //Vertex(Dcel& parent, const Pointd& p, HalfEdge* halfEdge);
     //Vertex(Dcel& parent, const Pointd& p, HalfEdge* halfEdge, int cardinality);
@@ -198,13 +194,7 @@ protected:
     * Attributes *
     **************/
 
-    #ifdef NDEBUG
     internal::DcelData* parent;
-    #else
-    Point3d          _coordinate;         /**< \~Italian @brief Punto nello spazio 3D rappresentante la posizione del vertice */
-    Vec3d            _normal;             /**< \~Italian @brief Vettore normale al vertice */
-    Color           _color;              /**< \~Italian @brief Colore associato al vertice */
-    #endif
     HalfEdge* _incidentHalfEdge;   /**< \~Italian @brief Uno degli half edge uscenti incidenti sul vertice */
     unsigned int    _cardinality;        /**< \~Italian @brief Numero di edge (metà degli half edge) incidenti sul vertice */
     unsigned int    _id;                 /**< \~Italian @brief Id univoco, all'interno della Dcel, associato al vertice */
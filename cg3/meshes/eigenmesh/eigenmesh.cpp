@@ -63,6 +63,8 @@ EigenMesh::EigenMesh(const Dcel& dcel)
     clear();
     V.resize(dcel.numberVertices(), 3);
     F.resize(dcel.numberFaces(), 3);
+    nVertices = V.rows();
+    nFaces = F.rows();
     CF.resize(F.rows(), 3);
     updateVertexColorsSize();
     NV.resize(V.rows(), 3);
@@ -97,6 +99,8 @@ bool EigenMesh::loadFromObj(const std::string& filename)
     clear();
 	io::FileMeshMode mode;
     bool b = loadTriangleMeshFromObj(filename, V, F, mode, NV, CV, CF);
+    nVertices = V.rows();
+    nFaces = F.rows();
     updateBoundingBox();
 
     if (b){
@@ -105,7 +109,7 @@ bool EigenMesh::loadFromObj(const std::string& filename)
             updateVerticesNormals();
         }
         else
-            NV.rowwise().normalize();
+            NV.topRows(nVertices).rowwise().normalize();
 		if (!(mode.hasVertexColors())){
             updateVertexColorsSize();
         }
@@ -121,6 +125,8 @@ bool EigenMesh::loadFromPly(const std::string& filename)
     clear();
 	io::FileMeshMode mode;
     bool b = loadTriangleMeshFromPly(filename, V, F, mode, NV, CV, CF);
+    nVertices = V.rows();
+    nFaces = F.rows();
     updateBoundingBox();
 
     if (b){
@@ -129,7 +135,7 @@ bool EigenMesh::loadFromPly(const std::string& filename)
             updateVerticesNormals();
         }
         else
-            NV.rowwise().normalize();
+            NV.topRows(nVertices).rowwise().normalize();
 		if (!(mode.hasVertexColors())){
             updateVertexColorsSize();
         }
@@ -153,13 +159,13 @@ void EigenMesh::setFaceColor(int red, int green, int blue, int f)
 void EigenMesh::setFaceColor(double red, double green, double blue, int f)
 {
     if (f < 0){
-        if (CF.rows() != F.rows())
+        if (CF.rows() < F.rows())
             CF.resize(F.rows(), 3);
-        for (unsigned int i = 0; i < (unsigned int)CF.rows(); i++)
+        for (unsigned int i = 0; i < nFaces; i++)
             CF.row(i) << red, green, blue;
     }
     else{
-        assert(f < F.rows());
+        assert((unsigned int)f < nFaces);
         CF.row(f) << red, green, blue;
     }
 }
@@ -177,20 +183,20 @@ void EigenMesh::setVertexColor(int red, int green, int blue, int v)
 void EigenMesh::setVertexColor(double red, double green, double blue, int v)
 {
     if (v < 0){
-        if (CV.rows() != V.rows())
+        if (CV.rows() < V.rows())
             CV.resize(V.rows(), 3);
-        for (unsigned int i = 0; i < (unsigned int)CV.rows(); i++)
+        for (unsigned int i = 0; i < nVertices; i++)
             CV.row(i) << red, green, blue;
     }
     else{
-        assert(v < V.rows());
+        assert((unsigned int)v < nVertices);
         CV.row(v) << red, green, blue;
     }
 }
 
 void EigenMesh::setVertexNormal(const Vec3d &n, unsigned int v)
 {
-    assert(v < (unsigned int)V.rows());
+    assert(v < nVertices);
     NV.row(v) << n.x(), n.y(), n.z();
 }
 
@@ -215,10 +221,10 @@ void EigenMesh::rotate(const Eigen::Matrix3d &m, const Eigen::Vector3d &centroid
 {
     SimpleEigenMesh::rotate(m, centroid);
     updateBoundingBox();
-    for (unsigned int i = 0; i < (unsigned int)NF.rows(); i++){
+    for (unsigned int i = 0; i < nFaces; i++){
         NF.row(i) =  m * NF.row(i).transpose();
     }
-    for (unsigned int i = 0; i < (unsigned int)NV.rows(); i++){
+    for (unsigned int i = 0; i < nVertices; i++){
         NV.row(i) =  m * NV.row(i).transpose();
     }
 }
@@ -243,19 +249,19 @@ void EigenMesh::scale(const Vec3d& scaleFactor)
 
 Eigen::MatrixXf EigenMesh::verticesColorMatrix() const
 {
-    return CV;
+    return getVerticesColorsMatrix();
 }
 
 Eigen::MatrixXf EigenMesh::facesColorMatrix() const
 {
-    return CF;
+    return getFacesColorsMatrix();
 }
 
 void EigenMesh::updateFaceNormals()
 {
     Eigen::Matrix<double,3,1> Z(0,0,0);
     NF.resize(F.rows(),3);
-    int nf = F.rows();
+    int nf = nFaces;
     //#pragma omp parallel for
     for(int i = 0; i < nf; i++) {
         const Eigen::Matrix<double, 1, 3, Eigen::RowMajor> v1 = V.row(F(i,1)) - V.row(F(i,0));
@@ -278,22 +284,17 @@ void EigenMesh::updateVerticesNormals()
 {
     NV = Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor>::Zero(V.rows(), 3);
     // loop over faces
-    for(int i = 0;i<F.rows();i++) {
+    for(unsigned int i = 0;i<nFaces;i++) {
         // throw normal at each corner
         for(int j = 0; j < 3;j++) {
             NV.row(F(i,j)) += NF.row(i);
         }
     }
-    NV.rowwise().normalize();
+    NV.topRows(nVertices).rowwise().normalize();
 }
 
 void EigenMesh::removeDegenerateTriangles(double epsilon) {
-    for (unsigned int i = 0; i < (unsigned int)F.rows(); i++){
-        if (isDegenerateTriangle(i, epsilon)){
-            this->removeFace(i);
-            i--;
-        }
-    }
+    SimpleEigenMesh::removeDegenerateTriangles(epsilon);
 }
 
 std::pair<int, int> EigenMesh::commonVertices(unsigned int f1, unsigned int f2) const
@@ -320,7 +321,7 @@ bool EigenMesh::saveOnPly(const std::string &filename, bool binary) const
     else
 		mode.setPolygonMesh();
     io::FileColorMode colorMode = io::RGB;
-	return saveMeshOnPly(filename, V.rows(), F.rows(), V.data(), F.data(),
+	return saveMeshOnPly(filename, nVertices, nFaces, V.data(), F.data(),
 						 binary, mode, NV.data(), NF.data(), colorMode,
 						 CV.data(), CF.data());
 }
@@ -338,25 +339,25 @@ bool EigenMesh::saveOnObj(const std::string& filename) const
 	else
 		mode.setPolygonMesh();
 	io::FileColorMode colorMode = io::RGB;
-	return saveMeshOnObj(filename, V.rows(), F.rows(), V.data(), F.data(), mode,
+	return saveMeshOnObj(filename, nVertices, nFaces, V.data(), F.data(), mode,
 						 NV.data(), colorMode, CV.data(), CF.data());
 }
 
 void EigenMesh::merge(EigenMesh& result, const EigenMesh& m1, const EigenMesh& m2)
 {
     SimpleEigenMesh::merge(result, m1, m2);
-    result.CF.resize(m1.CF.rows()+m2.CF.rows(), 3);
-    result.CF << m1.CF,
-            m2.CF;
-    result.CV.resize(m1.CV.rows()+m2.CV.rows(), 3);
-    result.CV << m1.CV,
-            m2.CV;
-    result.NV.resize(m1.NV.rows()+m2.NV.rows(), 3);
-    result.NV << m1.NV,
-            m2.NV;
-    result.NF.resize(m1.NF.rows()+m2.NF.rows(), 3);
-    result.NF << m1.NF,
-            m2.NF;
+    result.CF.resize(m1.nFaces+m2.nFaces, 3);
+    result.CF << m1.getFacesColorsMatrix(),
+            m2.getFacesColorsMatrix();
+    result.CV.resize(m1.nVertices+m2.nVertices, 3);
+    result.CV << m1.getVerticesColorsMatrix(),
+            m2.getVerticesColorsMatrix();
+    result.NV.resize(m1.nVertices+m2.nVertices, 3);
+    result.NV << m1.getVerticesNormalsMatrix(),
+            m2.getVerticesNormalsMatrix();
+    result.NF.resize(m1.nFaces+m2.nFaces, 3);
+    result.NF << m1.getFacesNormalsMatrix(),
+            m2.getFacesNormalsMatrix();
     result.updateBoundingBox();
 }
 
@@ -364,18 +365,18 @@ EigenMesh EigenMesh::merge(const EigenMesh& m1, const EigenMesh& m2)
 {
     EigenMesh result;
     SimpleEigenMesh::merge(result, m1, m2);
-    result.CF.resize(m1.CF.rows()+m2.CF.rows(), 3);
-    result.CF << m1.CF,
-            m2.CF;
-    result.CV.resize(m1.CV.rows()+m2.CV.rows(), 3);
-    result.CV << m1.CV,
-            m2.CV;
-    result.NV.resize(m1.NV.rows()+m2.NV.rows(), 3);
-    result.NV << m1.NV,
-            m2.NV;
-    result.NF.resize(m1.NF.rows()+m2.NF.rows(), 3);
-    result.NF << m1.NF,
-            m2.NF;
+    result.CF.resize(m1.nFaces+m2.nFaces, 3);
+    result.CF << m1.getFacesColorsMatrix(),
+            m2.getFacesColorsMatrix();
+    result.CV.resize(m1.nVertices+m2.nVertices, 3);
+    result.CV << m1.getVerticesColorsMatrix(),
+            m2.getVerticesColorsMatrix();
+    result.NV.resize(m1.nVertices+m2.nVertices, 3);
+    result.NV << m1.getVerticesNormalsMatrix(),
+            m2.getVerticesNormalsMatrix();
+    result.NF.resize(m1.nFaces+m2.nFaces, 3);
+    result.NF << m1.getFacesNormalsMatrix(),
+            m2.getFacesNormalsMatrix();
     result.updateBoundingBox();
     return result;
 }
@@ -385,6 +386,8 @@ EigenMesh& EigenMesh::operator=(const Dcel& dcel)
     clear();
     V.resize(dcel.numberVertices(), 3);
     F.resize(dcel.numberFaces(), 3);
+    nVertices = V.rows();
+    nFaces = F.rows();
     CF.resize(F.rows(), 3);
     CV = Eigen::MatrixXf::Constant(V.rows(), 3, 0.5);
     NV.resize(V.rows(), 3);
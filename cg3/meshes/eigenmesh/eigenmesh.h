@@ -48,11 +48,13 @@ public:
     EigenMesh(const Trimesh<T>& trimesh);
     #endif
 
-    const Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor>& getVerticesNormalsMatrix() const;
-    const Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor>& getFacesNormalsMatrix() const;
-    const Eigen::Matrix<float, Eigen::Dynamic, 3, Eigen::RowMajor>& getVerticesColorsMatrix() const;
-    const Eigen::Matrix<float, Eigen::Dynamic, 3, Eigen::RowMajor>& getFacesColorsMatrix() const;
+    Eigen::Map<const Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor> > getVerticesNormalsMatrix() const;
+    Eigen::Map<const Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor> > getFacesNormalsMatrix() const;
+    Eigen::Map<const Eigen::Matrix<float, Eigen::Dynamic, 3, Eigen::RowMajor> > getVerticesColorsMatrix() const;
+    Eigen::Map<const Eigen::Matrix<float, Eigen::Dynamic, 3, Eigen::RowMajor> > getFacesColorsMatrix() const;
 
+    virtual void reserve(unsigned int nv, unsigned int nf);
+    virtual void shrinkToFit();
     virtual void resizeVertices(unsigned int nv);
     virtual void resizeFaces(unsigned int nf);
     void updateBoundingBox();
@@ -63,6 +65,8 @@ public:
     virtual unsigned int addVertex(const Point3d &p);
     virtual unsigned int addVertex(double x, double y, double z);
     virtual void removeFace(unsigned int f);
+    using SimpleEigenMesh::removeFaces;
+    virtual void removeFaces(const std::vector<bool>& toRemove);
     virtual bool loadFromObj(const std::string &filename);
     virtual bool loadFromPly(const std::string &filename);
     void setFaceColor(const Color &c, int f = -1);
@@ -112,6 +116,7 @@ protected:
     void updateFaceColorsSize();
     void updateVertexColorsSize();
     void updateColorSizes();
+    void reserveAttributes();
 
     //Eigen::RowVector3d BBmin, BBmax;
     BoundingBox3 bb;
@@ -146,24 +151,65 @@ inline EigenMesh::EigenMesh(const std::string &filename)
     loadFromFile(filename);
 }
 
-inline const Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor>& EigenMesh::getVerticesNormalsMatrix() const
+inline Eigen::Map<const Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor> > EigenMesh::getVerticesNormalsMatrix() const
 {
-    return NV;
+    return Eigen::Map<const Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor> >(
+                NV.data(), std::min((unsigned int)NV.rows(), nVertices), 3);
 }
 
-inline const Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor>& EigenMesh::getFacesNormalsMatrix() const
+inline Eigen::Map<const Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor> > EigenMesh::getFacesNormalsMatrix() const
 {
-    return NF;
+    return Eigen::Map<const Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor> >(
+                NF.data(), std::min((unsigned int)NF.rows(), nFaces), 3);
 }
 
-inline const Eigen::Matrix<float, Eigen::Dynamic, 3, Eigen::RowMajor>& EigenMesh::getVerticesColorsMatrix() const
+inline Eigen::Map<const Eigen::Matrix<float, Eigen::Dynamic, 3, Eigen::RowMajor> > EigenMesh::getVerticesColorsMatrix() const
 {
-    return CV;
+    return Eigen::Map<const Eigen::Matrix<float, Eigen::Dynamic, 3, Eigen::RowMajor> >(
+                CV.data(), std::min((unsigned int)CV.rows(), nVertices), 3);
 }
 
-inline const Eigen::Matrix<float, Eigen::Dynamic, 3, Eigen::RowMajor>& EigenMesh::getFacesColorsMatrix() const
+inline Eigen::Map<const Eigen::Matrix<float, Eigen::Dynamic, 3, Eigen::RowMajor> > EigenMesh::getFacesColorsMatrix() const
 {
-    return CF;
+    return Eigen::Map<const Eigen::Matrix<float, Eigen::Dynamic, 3, Eigen::RowMajor> >(
+                CF.data(), std::min((unsigned int)CF.rows(), nFaces), 3);
+}
+
+/**
+ * @brief Makes room for at least nv vertices and nf faces, together with
+ * their normals and colors.
+ */
+inline void EigenMesh::reserve(unsigned int nv, unsigned int nf)
+{
+    SimpleEigenMesh::reserve(nv, nf);
+    reserveAttributes();
+}
+
+/**
+ * @brief Releases the capacity reserved by reserve() or by the insertions.
+ */
+inline void EigenMesh::shrinkToFit()
+{
+    SimpleEigenMesh::shrinkToFit();
+    NV.conservativeResize(std::min((unsigned int)NV.rows(), nVertices), Eigen::NoChange);
+    CV.conservativeResize(std::min((unsigned int)CV.rows(), nVertices), Eigen::NoChange);
+    NF.conservativeResize(std::min((unsigned int)NF.rows(), nFaces), Eigen::NoChange);
+    CF.conservativeResize(std::min((unsigned int)CF.rows(), nFaces), Eigen::NoChange);
+}
+
+/**
+ * @brief Grows the matrices of normals and colors to the capacity of V and F.
+ */
+inline void EigenMesh::reserveAttributes()
+{
+    if (NV.rows() < V.rows())
+        NV.conservativeResize(V.rows(), Eigen::NoChange);
+    if (CV.rows() < V.rows())
+        CV.conservativeResize(V.rows(), Eigen::NoChange);
+    if (NF.rows() < F.rows())
+        NF.conservativeResize(F.rows(), Eigen::NoChange);
+    if (CF.rows() < F.rows())
+        CF.conservativeResize(F.rows(), Eigen::NoChange);
 }
 
 inline void EigenMesh::resizeVertices(unsigned int nv)
@@ -181,8 +227,8 @@ inline void EigenMesh::resizeFaces(unsigned int nf)
 
 inline void EigenMesh::updateBoundingBox()
 {
-    if (V.rows() > 0){
-        Eigen::RowVector3d min = V.colwise().minCoeff(), max = V.colwise().maxCoeff();
+    if (nVertices > 0){
+        Eigen::RowVector3d min = V.topRows(nVertices).colwise().minCoeff(), max = V.topRows(nVertices).colwise().maxCoeff();
         bb.min().x() = min(0); bb.min().y() = min(1); bb.min().z() = min(2);
         bb.max().x() = max(0); bb.max().y() = max(1); bb.max().z() = max(2);
     }
@@ -193,94 +239,83 @@ inline void EigenMesh::clear()
     V.resize(0,Eigen::NoChange);
     F.resize(0,Eigen::NoChange);
     CF.resize(0,Eigen::NoChange);
+    CV.resize(0,Eigen::NoChange);
     NV.resize(0,Eigen::NoChange);
     NF.resize(0,Eigen::NoChange);
+    nVertices = 0;
+    nFaces = 0;
+    invalidateCache();
 }
 
 inline unsigned int EigenMesh::addFace(const Eigen::VectorXi& f)
 {
-    SimpleEigenMesh::addFace(f);
-    NF.conservativeResize(F.rows(), Eigen::NoChange);
-    Vec3d n = SimpleEigenMesh::faceNormal(F.rows()-1);
-    for (unsigned int i = 0; i < 3; i++)
-        NF(F.rows()-1, i) = n(i);
-    CF.conservativeResize(F.rows(), Eigen::NoChange);
-    for (unsigned int i = 0; i < 3; i++)
-        CF(F.rows()-1, i) = 0.5;
-    return (unsigned int)F.rows()-1;
+    assert (f.size() == 3);
+    return EigenMesh::addFace(f(0), f(1), f(2));
 }
 
 inline unsigned int EigenMesh::addFace(unsigned int t1, unsigned int t2, unsigned int t3)
 {
-    SimpleEigenMesh::addFace(t1, t2, t3);
-    NF.conservativeResize(F.rows(), Eigen::NoChange);
-    Vec3d n = SimpleEigenMesh::faceNormal(F.rows()-1);
+    unsigned int f = SimpleEigenMesh::addFace(t1, t2, t3);
+    reserveAttributes();
+    Vec3d n = SimpleEigenMesh::faceNormal(f);
     for (unsigned int i = 0; i < 3; i++)
-        NF(F.rows()-1, i) = n(i);
-    CF.conservativeResize(F.rows(), Eigen::NoChange);
+        NF(f, i) = n(i);
     for (unsigned int i = 0; i < 3; i++)
-        CF(F.rows()-1, i) = 0.5;
-    return (unsigned int)F.rows()-1;
+        CF(f, i) = 0.5;
+    return f;
 }
 
 inline unsigned int EigenMesh::addVertex(const Eigen::VectorXd& p)
 {
-    SimpleEigenMesh::addVertex(p);
-    NV.conservativeResize(V.rows(), Eigen::NoChange);
-    for (unsigned int i = 0; i < 3; i++)
-        NV(V.rows()-1, i) = 0;
-    CV.conservativeResize(V.rows(), Eigen::NoChange);
-    for (unsigned int i = 0; i < 3; i++)
-        CV(V.rows()-1, i) = 0.5;
-    return (unsigned int)V.rows()-1;
+    assert (p.size() == 3);
+    return EigenMesh::addVertex(p(0), p(1), p(2));
 }
 
 inline unsigned int EigenMesh::addVertex(const Point3d &p)
 {
-    SimpleEigenMesh::addVertex(p);
-    NV.conservativeResize(V.rows(), Eigen::NoChange);
-    for (unsigned int i = 0; i < 3; i++)
-        NV(V.rows()-1, i) = 0;
-    CV.conservativeResize(V.rows(), Eigen::NoChange);
-    for (unsigned int i = 0; i < 3; i++)
-        CV(V.rows()-1, i) = 0.5;
-    return (unsigned int)V.rows()-1;
+    return EigenMesh::addVertex(p.x(), p.y(), p.z());
 }
 
 inline unsigned int EigenMesh::addVertex(double x, double y, double z)
 {
-    SimpleEigenMesh::addVertex(x,y,z);
-    NV.conservativeResize(V.rows(), Eigen::NoChange);
+    unsigned int v = SimpleEigenMesh::addVertex(x,y,z);
+    reserveAttributes();
     for (unsigned int i = 0; i < 3; i++)
-        NV(V.rows()-1, i) = 0;
-    CV.conservativeResize(V.rows(), Eigen::NoChange);
+        NV(v, i) = 0;
     for (unsigned int i = 0; i < 3; i++)
-        CV(V.rows()-1, i) = 0.5;
-    return (unsigned int)V.rows()-1;
+        CV(v, i) = 0.5;
+    return v;
 }
 
 inline void EigenMesh::removeFace(unsigned int f)
 {
+    removeRow(NF, f, std::min((unsigned int)NF.rows(), nFaces));
+    removeRow(CF, f, std::min((unsigned int)CF.rows(), nFaces));
     SimpleEigenMesh::removeFace(f);
-    cg3::removeRowFromEigenMatrix(NF, f);
-    cg3::removeRowFromEigenMatrix(CF, f);
+}
+
+inline void EigenMesh::removeFaces(const std::vector<bool>& toRemove)
+{
+    removeRows(NF, toRemove, std::min((unsigned int)NF.rows(), nFaces));
+    removeRows(CF, toRemove, std::min((unsigned int)CF.rows(), nFaces));
+    SimpleEigenMesh::removeFaces(toRemove);
 }
 
 inline Vec3d EigenMesh::faceNormal(unsigned int f) const
 {
-    assert (f < (unsigned int)F.rows());
+    assert (f < nFaces);
     return Vec3d(NF(f,0), NF(f,1), NF(f,2));
 }
 
 inline Vec3d EigenMesh::vertexNormal(unsigned int v) const
 {
-    assert (v < (unsigned int)V.rows());
+    assert (v < nVertices);
     return Vec3d(NV(v,0), NV(v,1), NV(v,2));
 }
 
 inline Color EigenMesh::faceColor(unsigned int f) const
 {
-    assert (f < (unsigned int)F.rows());
+    assert (f < nFaces);
     Color c;
     c.setRedF((float)CF(f,0));
     c.setGreenF((float)CF(f,1));
@@ -290,7 +325,7 @@ inline Color EigenMesh::faceColor(unsigned int f) const
 
 inline Color EigenMesh::vertexColor(unsigned int v) const
 {
-    assert (v < (unsigned int)V.rows());
+    assert (v < nVertices);
     Color c;
     c.setRedF((float)CV(v,0));
     c.setGreenF((float)CV(v,1));
@@ -324,12 +359,21 @@ void EigenMesh::setFacesColorMatrix(const Eigen::PlainObjectBase<U>& CF)
 
 inline void EigenMesh::serialize(std::ofstream& binaryFile) const
 {
+    if (nVertices != (unsigned int)V.rows() || nFaces != (unsigned int)F.rows()){
+        EigenMesh m(*this);
+        m.EigenMesh::shrinkToFit();
+        m.EigenMesh::serialize(binaryFile);
+        return;
+    }
     serializeObjectAttributes("cg3EigenMesh", binaryFile, V, F, bb, NV, NF, CV, CF);
 }
 
 inline void EigenMesh::deserialize(std::ifstream& binaryFile)
 {
     deserializeObjectAttributes("cg3EigenMesh", binaryFile, V, F, bb, NV, NF, CV, CF);
+    nVertices = V.rows();
+    nFaces = F.rows();
+    invalidateCache();
 }
 
 } //namespace cg3
@@ -18,11 +18,15 @@
 
 namespace cg3 {
 
-SimpleEigenMesh::SimpleEigenMesh(const Dcel& dcel)
+SimpleEigenMesh::SimpleEigenMesh(const Dcel& dcel) :
+    vfCacheValid(false),
+    normalsCacheValid(false)
 {
     clear();
     V.resize(dcel.numberVertices(), 3);
     F.resize(dcel.numberFaces(), 3);
+    nVertices = V.rows();
+    nFaces = F.rows();
     std::map<int, int> vids;
     unsigned int i = 0;
     for (Dcel::ConstVertexIterator vit = dcel.vertexBegin(); vit != dcel.vertexEnd(); ++vit){
@@ -41,7 +45,11 @@ SimpleEigenMesh::SimpleEigenMesh(const Dcel& dcel)
 }
 
 #ifdef CG3_CINOLIB_DEFINED
-SimpleEigenMesh::SimpleEigenMesh(const cinolib::Trimesh<>& trimesh)
+SimpleEigenMesh::SimpleEigenMesh(const cinolib::Trimesh<>& trimesh) :
+    nVertices(0),
+    nFaces(0),
+    vfCacheValid(false),
+    normalsCacheValid(false)
 {
     resizeVertices(trimesh.num_verts());
     resizeFaces(trimesh.num_polys());
@@ -64,22 +72,25 @@ Vec3d SimpleEigenMesh::faceNormal(unsigned int f) const
 }
 
 /**
- * @brief Returns the normal of the given vertex id
- * @note for cg3::SimpleEigenMesh, the normal is computed every time the
- * function is called, and the complexity is O(number of faces).
+ * @brief Returns the normal of the given vertex id, which is the average of
+ * the normals of its incident faces.
+ * @note for cg3::SimpleEigenMesh, the vertex-face incidences and the face normals
+ * are cached by the first call after a modification of the mesh, which takes
+ * O(number of faces). The next calls take O(valence of the vertex).
+ * Since the caches are built inside a const member function, the first call
+ * after a modification must not run concurrently with other calls.
  * @param v: vertex id
  */
 Vec3d SimpleEigenMesh::vertexNormal(unsigned int v) const
 {
-    unsigned int n = 0;
+    assert(v < nVertices);
+    updateVertexFacesCache();
+    updateFaceNormalsCache();
+    unsigned int n = vfOffsets[v+1] - vfOffsets[v];
     Vec3d normal;
-    for (unsigned int f = 0; f < (unsigned int)F.rows(); f++){
-        for (unsigned int i = 0; i < 3; i++){
-            if ((unsigned int)F(f,i) == v){
-                n++;
-                normal += faceNormal(f);
-            }
-        }
+    for (unsigned int i = vfOffsets[v]; i < vfOffsets[v+1]; i++){
+        unsigned int f = vfFaces[i];
+        normal += Vec3d(faceNormalsCache(f,0), faceNormalsCache(f,1), faceNormalsCache(f,2));
     }
     if (n != 0){
         normal /= n;
@@ -89,28 +100,56 @@ Vec3d SimpleEigenMesh::vertexNormal(unsigned int v) const
 
 bool SimpleEigenMesh::isDegenerateTriangle(unsigned int f, double epsilon) const
 {
-    assert(f < (unsigned int)F.rows());
+    assert(f < nFaces);
     return faceArea(f) <= epsilon;
 }
 
 void SimpleEigenMesh::removeDegenerateTriangles(double epsilon)
 {
-    for (unsigned int i = 0; i < (unsigned int)F.rows(); i++){
+    std::vector<bool> toRemove(nFaces, false);
+    bool found = false;
+    for (unsigned int i = 0; i < nFaces; i++){
         if (isDegenerateTriangle(i, epsilon)){
-            this->removeFace(i);
-            i--;
+            toRemove[i] = true;
+            found = true;
         }
     }
+    if (found)
+        this->removeFaces(toRemove);
+}
+
+/**
+ * @brief Removes the faces f such that toRemove[f] is true, with a single
+ * compaction of the faces matrix. The remaining faces keep their relative order.
+ * @param toRemove: vector of (at least) numberFaces() flags
+ *
+ * @par Complexity:
+ *      \e O(number of faces)
+ */
+void SimpleEigenMesh::removeFaces(const std::vector<bool>& toRemove)
+{
+    assert(toRemove.size() >= nFaces);
+    removeRows(F, toRemove, nFaces);
+    nFaces -= (unsigned int)std::count(toRemove.begin(), toRemove.begin() + nFaces, true);
+    invalidateCache();
 }
 
 bool SimpleEigenMesh::loadFromObj(const std::string& filename)
 {
-    return loadTriangleMeshFromObj(filename, V, F);
+    bool b = loadTriangleMeshFromObj(filename, V, F);
+    nVertices = V.rows();
+    nFaces = F.rows();
+    invalidateCache();
+    return b;
 }
 
 bool SimpleEigenMesh::loadFromPly(const std::string& filename)
 {
-    return loadTriangleMeshFromPly(filename, V, F);
+    bool b = loadTriangleMeshFromPly(filename, V, F);
+    nVertices = V.rows();
+    nFaces = F.rows();
+    invalidateCache();
+    return b;
 }
 
 bool SimpleEigenMesh::loadFromFile(const std::string& filename)
@@ -128,33 +167,34 @@ bool SimpleEigenMesh::loadFromFile(const std::string& filename)
 
 bool SimpleEigenMesh::saveOnPly(const std::string& filename, bool binary) const
 {
-	return saveMeshOnPly(filename, V.rows(), F.rows(), V.data(), F.data(), binary);
+	return saveMeshOnPly(filename, nVertices, nFaces, V.data(), F.data(), binary);
 }
 
 bool SimpleEigenMesh::saveOnObj(const std::string& filename) const
 {
-    return saveMeshOnObj(filename, V.rows(), F.rows(), V.data(), F.data());
+    return saveMeshOnObj(filename, nVertices, nFaces, V.data(), F.data());
 }
 
 void SimpleEigenMesh::translate(const Vec3d& p)
 {
     Eigen::RowVector3d v;
     v << p.x(), p.y(), p.z();
-    V.rowwise() += v;
+    V.topRows(nVertices).rowwise() += v;
 }
 
 void SimpleEigenMesh::translate(const Eigen::Vector3d& p)
 {
-    V.rowwise() += p.transpose();
+    V.topRows(nVertices).rowwise() += p.transpose();
 }
 
 void SimpleEigenMesh::rotate(const Eigen::Matrix3d& m, const Eigen::Vector3d& centroid)
 {
-    V.rowwise() -= centroid.transpose();
-    for (unsigned int i = 0; i < V.rows(); i++){
+    V.topRows(nVertices).rowwise() -= centroid.transpose();
+    for (unsigned int i = 0; i < nVertices; i++){
         V.row(i) =  m * V.row(i).transpose();
     }
-    V.rowwise() += centroid.transpose();
+    V.topRows(nVertices).rowwise() += centroid.transpose();
+    invalidateNormalsCache();
 }
 
 void SimpleEigenMesh::rotate(const Vec3d& axis, double angle, const Point3d& centroid)
@@ -171,7 +211,7 @@ void SimpleEigenMesh::scale(const BoundingBox3& newBoundingBox)
     Point3d newCenter = newBoundingBox.center();
     Point3d deltaOld = bb.max() - bb.min();
     Point3d deltaNew = newBoundingBox.max() - newBoundingBox.min();
-    for (int i = 0; i < V.rows(); i++){
+    for (unsigned int i = 0; i < nVertices; i++){
         Point3d coord = vertex(i);
         coord -= oldCenter;
         coord *= deltaNew / deltaOld;
@@ -186,7 +226,7 @@ void SimpleEigenMesh::scale(const BoundingBox3& oldBoundingBox, const BoundingBo
     Point3d newCenter = newBoundingBox.center();
     Point3d deltaOld = oldBoundingBox.max() - oldBoundingBox.min();
     Point3d deltaNew = newBoundingBox.max() - newBoundingBox.min();
-    for (int i = 0; i < V.rows(); i++){
+    for (unsigned int i = 0; i < nVertices; i++){
         Point3d coord = vertex(i);
         coord -= oldCenter;
         coord *= deltaNew / deltaOld;
@@ -198,11 +238,12 @@ void SimpleEigenMesh::scale(const BoundingBox3& oldBoundingBox, const BoundingBo
 void SimpleEigenMesh::scale(const Vec3d& scaleFactor)
 {
     if (scaleFactor.x() > 0 && scaleFactor.y() > 0 && scaleFactor.z() > 0){
-        for (unsigned int i = 0; i < (uint)V.rows(); i++){
+        for (unsigned int i = 0; i < nVertices; i++){
             V.row(i) = Eigen::Vector3d(V(i,0) * scaleFactor.x(),
                                        V(i,1) * scaleFactor.y(),
                                        V(i,2) * scaleFactor.z());
         }
+        invalidateNormalsCache();
     }
 }
 
@@ -213,24 +254,30 @@ void SimpleEigenMesh::scale(double scaleFactor)
 
 void SimpleEigenMesh::merge(const SimpleEigenMesh& m2)
 {
-    uint start = V.rows();
-    V.conservativeResize(start+m2.V.rows(), 3);
-    for (uint i = 0; i < (uint)m2.V.rows(); ++i){
+    uint start = nVertices;
+    V.conservativeResize(start+m2.nVertices, 3);
+    for (uint i = 0; i < m2.nVertices; ++i){
         V.row(start + i) = m2.V.row(i);
     }
-    uint startf = F.rows();
-    F.conservativeResize(startf + m2.F.rows(), 3);
+    nVertices = V.rows();
+    uint startf = nFaces;
+    F.conservativeResize(startf + m2.nFaces, 3);
     for (uint i = 0; i < m2.numberFaces(); i++){
         F.row(startf+i) = Eigen::RowVector3i(m2.F(i,0)+start, m2.F(i,1)+start, m2.F(i,2)+start);
     }
+    nFaces = F.rows();
+    invalidateCache();
 }
 
 void SimpleEigenMesh::merge(SimpleEigenMesh &result, const SimpleEigenMesh& m1, const SimpleEigenMesh& m2)
 {
-    result.V.resize(m1.V.rows()+m2.V.rows(), 3);
-    result.V << m1.V,
-            m2.V;
-    result.F = m1.F;
+    result.V.resize(m1.nVertices+m2.nVertices, 3);
+    result.V << m1.V.topRows(m1.nVertices),
+            m2.V.topRows(m2.nVertices);
+    result.F = m1.F.topRows(m1.nFaces);
+    result.nVertices = result.V.rows();
+    result.nFaces = result.F.rows();
+    result.invalidateCache();
     int start = m1.numberVertices();
     for (unsigned int i = 0; i < m2.numberFaces(); i++){
         Point3i fi =m2.face(i);
@@ -241,16 +288,51 @@ void SimpleEigenMesh::merge(SimpleEigenMesh &result, const SimpleEigenMesh& m1,
 SimpleEigenMesh SimpleEigenMesh::merge(const SimpleEigenMesh& m1, const SimpleEigenMesh& m2)
 {
     SimpleEigenMesh result;
-    result.V.resize(m1.V.rows()+m2.V.rows(), 3);
-    result.V << m1.V,
-            m2.V;
-    result.F = m1.F;
-    int start = m1.numberVertices();
-    for (unsigned int i = 0; i < m2.numberFaces(); i++){
-        Point3i fi =m2.face(i);
-        result.addFace(fi.x()+start, fi.y()+start, fi.z()+start);
-    }
+    merge(result, m1, m2);
     return result;
 }
 
+/**
+ * @brief Builds, if not valid, the CSR table of the faces incident to each vertex
+ * with a counting pass and a filling pass over the faces.
+ * A face is listed once for each of its corners on the vertex.
+ */
+void SimpleEigenMesh::updateVertexFacesCache() const
+{
+    if (vfCacheValid)
+        return;
+    vfOffsets.assign(nVertices + 1, 0);
+    for (unsigned int f = 0; f < nFaces; f++){
+        for (unsigned int i = 0; i < 3; i++){
+            assert((unsigned int)F(f,i) < nVertices);
+            vfOffsets[F(f,i) + 1]++;
+        }
+    }
+    for (unsigned int v = 0; v < nVertices; v++)
+        vfOffsets[v+1] += vfOffsets[v];
+    vfFaces.resize(vfOffsets[nVertices]);
+    std::vector<unsigned int> pos(vfOffsets.begin(), vfOffsets.end() - 1);
+    for (unsigned int f = 0; f < nFaces; f++){
+        for (unsigned int i = 0; i < 3; i++){
+            vfFaces[pos[F(f,i)]++] = f;
+        }
+    }
+    vfCacheValid = true;
+}
+
+/**
+ * @brief Computes, if not valid, the (normalized) normals of all the faces.
+ */
+void SimpleEigenMesh::updateFaceNormalsCache() const
+{
+    if (normalsCacheValid)
+        return;
+    faceNormalsCache.resize(nFaces, 3);
+    for (unsigned int f = 0; f < nFaces; f++){
+        Vec3d n = SimpleEigenMesh::faceNormal(f);
+        faceNormalsCache(f,0) = n.x(); faceNormalsCache(f,1) = n.y(); faceNormalsCache(f,2) = n.z();
+    }
+    normalsCacheValid = true;
+}
+
 } //namespace cg3
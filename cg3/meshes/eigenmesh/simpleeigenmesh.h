@@ -9,6 +9,8 @@
 #define CG3_SIMPLEEIGENMESH_H
 
 #include <Eigen/Core>
+#include <algorithm>
+#include <vector>
 
 #include <cg3/meshes/mesh.h>
 #include <cg3/geometry/point3.h>
@@ -63,8 +65,8 @@ public:
     SimpleEigenMesh(const cinolib::Trimesh<> &trimesh);
     #endif
 
-    const Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor>& getVerticesMatrix() const;
-    const Eigen::Matrix<int, Eigen::Dynamic, 3, Eigen::RowMajor>& getFacesMatrix() const;
+    Eigen::Map<const Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor> > getVerticesMatrix() const;
+    Eigen::Map<const Eigen::Matrix<int, Eigen::Dynamic, 3, Eigen::RowMajor> > getFacesMatrix() const;
 
     unsigned int numberVertices() const;
     unsigned int numberFaces() const;
@@ -78,6 +80,8 @@ public:
     Point3d barycenter() const;
 
     virtual void clear();
+    virtual void reserve(unsigned int nv, unsigned int nf);
+    virtual void shrinkToFit();
     virtual void resizeVertices(unsigned int nv);
     void setVertex(unsigned int i, const Eigen::VectorXd &p);
     void setVertex(unsigned int i, const Point3d &p);
@@ -91,6 +95,8 @@ public:
     virtual unsigned int addFace(const Eigen::VectorXi &f);
     virtual unsigned int addFace(unsigned int t1, unsigned int t2, unsigned int t3);
     virtual void removeFace(unsigned int f);
+    void removeFaces(const std::vector<unsigned int>& faces);
+    virtual void removeFaces(const std::vector<bool>& toRemove);
     bool isDegenerateTriangle(unsigned int f, double epsilon = CG3_EPSILON) const;
     virtual void removeDegenerateTriangles(double epsilon = CG3_EPSILON);
 	template <typename T, int ...A> void setVerticesMatrix(const Eigen::PlainObjectBase<T>& V);
@@ -120,36 +126,79 @@ public:
     void deserialize(std::ifstream& binaryFile);
 
 protected:
+    template <typename M> static void removeRow(M& m, unsigned int r, unsigned int n);
+    template <typename M> static void removeRows(M& m, const std::vector<bool>& toRemove, unsigned int n);
+
+    void invalidateCache();
+    void invalidateNormalsCache();
+    void updateVertexFacesCache() const;
+    void updateFaceNormalsCache() const;
+
+    /* V and F may have more rows than the vertices and faces of the mesh
+     * (reserved capacity): only the first nVertices rows of V and the first
+     * nFaces rows of F are valid. */
     Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor> V;
     Eigen::Matrix<int, Eigen::Dynamic, 3, Eigen::RowMajor> F;
+    unsigned int nVertices;
+    unsigned int nFaces;
+
+    /* Lazily built caches, used by vertexNormal(). The faces incident to the vertex v
+     * are vfFaces[vfOffsets[v]], ..., vfFaces[vfOffsets[v+1]-1] (CSR layout).
+     * Every change of the faces or of the number of vertices invalidates both the
+     * caches, a change of the coordinates invalidates only the face normals. */
+    mutable std::vector<unsigned int> vfOffsets;
+    mutable std::vector<unsigned int> vfFaces;
+    mutable Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor> faceNormalsCache;
+    mutable bool vfCacheValid;
+    mutable bool normalsCacheValid;
 };
 
 /**
  * SimpleEigenMesh
  */
 
-inline SimpleEigenMesh::SimpleEigenMesh()
+inline SimpleEigenMesh::SimpleEigenMesh() :
+    nVertices(0),
+    nFaces(0),
+    vfCacheValid(false),
+    normalsCacheValid(false)
 {
 }
 
-inline SimpleEigenMesh::SimpleEigenMesh(const char* filename)
+inline SimpleEigenMesh::SimpleEigenMesh(const char* filename) :
+    nVertices(0),
+    nFaces(0),
+    vfCacheValid(false),
+    normalsCacheValid(false)
 {
 	loadFromFile(filename);
 }
 
-inline SimpleEigenMesh::SimpleEigenMesh(const std::string &filename)
+inline SimpleEigenMesh::SimpleEigenMesh(const std::string &filename) :
+    nVertices(0),
+    nFaces(0),
+    vfCacheValid(false),
+    normalsCacheValid(false)
 {
     loadFromFile(filename);
 }
 
 template <typename T, typename U>
-SimpleEigenMesh::SimpleEigenMesh(const Eigen::PlainObjectBase<T> &V, const Eigen::PlainObjectBase<U> &F) : V(V), F(F)
+SimpleEigenMesh::SimpleEigenMesh(const Eigen::PlainObjectBase<T> &V, const Eigen::PlainObjectBase<U> &F) :
+    V(V),
+    F(F),
+    nVertices(V.rows()),
+    nFaces(F.rows()),
+    vfCacheValid(false),
+    normalsCacheValid(false)
 {
 }
 
 #ifdef TRIMESH_DEFINED
 template <typename T>
-inline SimpleEigenMesh::SimpleEigenMesh(const Trimesh<T>& trimesh)
+inline SimpleEigenMesh::SimpleEigenMesh(const Trimesh<T>& trimesh) :
+    vfCacheValid(false),
+    normalsCacheValid(false)
 {
     int numV=trimesh.numVertices();
     int numF=trimesh.numTriangles();
@@ -157,6 +206,8 @@ inline SimpleEigenMesh::SimpleEigenMesh(const Trimesh<T>& trimesh)
     clear();
     V.resize(numV,3);
     F.resize(numF,3);
+    nVertices = numV;
+    nFaces = numF;
 
     for(int i=0;i<numV;++i) {
         V(i,0)=trimesh.vertex(i).x();
@@ -172,35 +223,45 @@ inline SimpleEigenMesh::SimpleEigenMesh(const Trimesh<T>& trimesh)
 }
 #endif
 
-inline const Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor>& SimpleEigenMesh::getVerticesMatrix() const
+/**
+ * @brief Returns the matrix of the coordinates of the vertices, one row for each vertex.
+ * The returned map refers to the storage of the mesh: it is invalidated by the
+ * next insertion or removal.
+ */
+inline Eigen::Map<const Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor> > SimpleEigenMesh::getVerticesMatrix() const
 {
-    return V;
+    return Eigen::Map<const Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor> >(V.data(), nVertices, 3);
 }
 
-inline const Eigen::Matrix<int, Eigen::Dynamic, 3, Eigen::RowMajor>& SimpleEigenMesh::getFacesMatrix() const
+/**
+ * @brief Returns the matrix of the vertex indices of the faces, one row for each face.
+ * The returned map refers to the storage of the mesh: it is invalidated by the
+ * next insertion or removal.
+ */
+inline Eigen::Map<const Eigen::Matrix<int, Eigen::Dynamic, 3, Eigen::RowMajor> > SimpleEigenMesh::getFacesMatrix() const
 {
-    return F;
+    return Eigen::Map<const Eigen::Matrix<int, Eigen::Dynamic, 3, Eigen::RowMajor> >(F.data(), nFaces, 3);
 }
 
 inline unsigned int SimpleEigenMesh::numberVertices() const
 {
-    return V.rows();
+    return nVertices;
 }
 
 inline unsigned int SimpleEigenMesh::numberFaces() const
 {
-    return F.rows();
+    return nFaces;
 }
 
 inline Point3d SimpleEigenMesh::vertex(unsigned int i) const
 {
-    assert(i < (unsigned int)V.rows());
+    assert(i < nVertices);
     return Point3d(V(i,0), V(i,1), V(i,2));
 }
 
 inline Point3i SimpleEigenMesh::face(unsigned int i) const
 {
-    assert (i < (unsigned int)F.rows());
+    assert (i < nFaces);
     return Point3i(F(i,0), F(i,1), F(i,2));
 }
 
@@ -212,9 +273,9 @@ inline double SimpleEigenMesh::faceArea(unsigned int f) const
 
 inline void SimpleEigenMesh::boundingBox(Eigen::RowVector3d& BBmin, Eigen::RowVector3d& BBmax) const
 {
-    if (V.rows() > 0){
-        BBmin = V.colwise().minCoeff();
-        BBmax = V.colwise().maxCoeff();
+    if (nVertices > 0){
+        BBmin = V.topRows(nVertices).colwise().minCoeff();
+        BBmax = V.topRows(nVertices).colwise().maxCoeff();
     }
     else {
         BBmin = Eigen::RowVector3d();
@@ -225,10 +286,10 @@ inline void SimpleEigenMesh::boundingBox(Eigen::RowVector3d& BBmin, Eigen::RowVe
 inline BoundingBox3 SimpleEigenMesh::boundingBox() const
 {
     BoundingBox3  bb;
-    if (V.rows() > 0){
+    if (nVertices > 0){
         Eigen::RowVector3d BBmin, BBmax;
-        BBmin = V.colwise().minCoeff();
-        BBmax = V.colwise().maxCoeff();
+        BBmin = V.topRows(nVertices).colwise().minCoeff();
+        BBmax = V.topRows(nVertices).colwise().maxCoeff();
         bb.setMin(BBmin(0), BBmin(1), BBmin(2));
         bb.setMax(BBmax(0), BBmax(1), BBmax(2));
     }
@@ -237,7 +298,7 @@ inline BoundingBox3 SimpleEigenMesh::boundingBox() const
 
 inline Point3d SimpleEigenMesh::barycenter() const
 {
-    Point3d bc(V.col(0).mean(), V.col(1).mean(), V.col(2).mean());
+    Point3d bc(V.col(0).head(nVertices).mean(), V.col(1).head(nVertices).mean(), V.col(2).head(nVertices).mean());
     return bc;
 }
 
@@ -245,91 +306,194 @@ inline void SimpleEigenMesh::clear()
 {
     V.resize(0,Eigen::NoChange);
     F.resize(0,Eigen::NoChange);
+    nVertices = 0;
+    nFaces = 0;
+    invalidateCache();
+}
+
+/**
+ * @brief Makes room for at least nv vertices and nf faces, so that the next
+ * insertions up to these sizes do not reallocate the storage of the mesh.
+ * The number of vertices and faces of the mesh does not change.
+ */
+inline void SimpleEigenMesh::reserve(unsigned int nv, unsigned int nf)
+{
+    if (nv > (unsigned int)V.rows())
+        V.conservativeResize(nv, Eigen::NoChange);
+    if (nf > (unsigned int)F.rows())
+        F.conservativeResize(nf, Eigen::NoChange);
+}
+
+/**
+ * @brief Releases the capacity reserved by reserve() or by the insertions.
+ */
+inline void SimpleEigenMesh::shrinkToFit()
+{
+    V.conservativeResize(nVertices, Eigen::NoChange);
+    F.conservativeResize(nFaces, Eigen::NoChange);
 }
 
 inline void SimpleEigenMesh::resizeVertices(unsigned int nv)
 {
     V.conservativeResize(nv,Eigen::NoChange);
+    nVertices = nv;
+    invalidateCache();
 }
 
 inline void SimpleEigenMesh::setVertex(unsigned int i, const Eigen::VectorXd& p)
 {
-    assert (i < (unsigned int)V.rows());
+    assert (i < nVertices);
     assert (p.size() == 3);
     V.row(i) =  p;
+    invalidateNormalsCache();
 }
 
 inline void SimpleEigenMesh::setVertex(unsigned int i, const Point3d& p)
 {
-    assert (i < (unsigned int)V.rows());
+    assert (i < nVertices);
     V(i,0) = p.x(); V(i,1) = p.y(); V(i,2) = p.z();
+    invalidateNormalsCache();
 }
 
 inline void SimpleEigenMesh::setVertex(unsigned int i, double x, double y, double z)
 {
-    assert (i < (unsigned int)V.rows());
+    assert (i < nVertices);
     V(i, 0) = x; V(i, 1) = y; V(i, 2) = z;
+    invalidateNormalsCache();
 }
 
 inline unsigned int SimpleEigenMesh::addVertex(const Eigen::VectorXd& p)
 {
     assert (p.size() == 3);
-    V.conservativeResize(V.rows()+1, Eigen::NoChange);
-    V.row(V.rows()-1) = p;
-    return (unsigned int)V.rows()-1;
+    return SimpleEigenMesh::addVertex(p(0), p(1), p(2));
 }
 
 inline unsigned int SimpleEigenMesh::addVertex(const Point3d& p)
 {
-    V.conservativeResize(V.rows()+1, Eigen::NoChange);
-    V(V.rows()-1, 0) = p.x(); V(V.rows()-1, 1) = p.y(); V(V.rows()-1, 2) = p.z();
-    return (unsigned int)V.rows()-1;
+    return SimpleEigenMesh::addVertex(p.x(), p.y(), p.z());
 }
 
+/**
+ * @brief Appends a vertex to the mesh and returns its index.
+ * When the storage is full, its capacity is doubled: the insertion takes
+ * amortized constant time.
+ */
 inline unsigned int SimpleEigenMesh::addVertex(double x, double y, double z)
 {
-    V.conservativeResize(V.rows()+1, Eigen::NoChange);
-    V(V.rows()-1, 0) = x; V(V.rows()-1, 1) = y; V(V.rows()-1, 2) = z;
-    return (unsigned int)V.rows()-1;
+    if (nVertices == (unsigned int)V.rows())
+        reserve(std::max(2 * nVertices, 16u), F.rows());
+    V(nVertices, 0) = x; V(nVertices, 1) = y; V(nVertices, 2) = z;
+    invalidateCache();
+    return nVertices++;
 }
 
 inline void SimpleEigenMesh::resizeFaces(unsigned int nf)
 {
     F.conservativeResize(nf,Eigen::NoChange);
+    nFaces = nf;
+    invalidateCache();
 }
 
 inline void SimpleEigenMesh::setFace(unsigned int i, const Eigen::VectorXi& f)
 {
-    assert (i < (unsigned int)F.rows());
+    assert (i < nFaces);
     assert (f.size() == 3);
     F.row(i) =  f;
+    invalidateCache();
 }
 
 inline void SimpleEigenMesh::setFace(unsigned int i, unsigned int t1, unsigned int t2, unsigned int t3)
 {
-    assert (i < (unsigned int)F.rows());
+    assert (i < nFaces);
     F(i, 0) = t1; F(i, 1) = t2; F(i, 2) = t3;
+    invalidateCache();
 }
 
 inline unsigned int SimpleEigenMesh::addFace(const Eigen::VectorXi& f)
 {
     assert (f.size() == 3);
-    F.conservativeResize(F.rows()+1, Eigen::NoChange);
-    F.row(F.rows()-1) = f;
-    return (unsigned int)F.rows()-1;
+    return SimpleEigenMesh::addFace(f(0), f(1), f(2));
 }
 
+/**
+ * @brief Appends a face to the mesh and returns its index.
+ * When the storage is full, its capacity is doubled: the insertion takes
+ * amortized constant time.
+ */
 inline unsigned int SimpleEigenMesh::addFace(unsigned int t1, unsigned int t2, unsigned int t3)
 {
-    F.conservativeResize(F.rows()+1, Eigen::NoChange);
-    F(F.rows()-1, 0) = t1; F(F.rows()-1, 1) = t2; F(F.rows()-1, 2) = t3;
-    return (unsigned int)F.rows()-1;
+    if (nFaces == (unsigned int)F.rows())
+        reserve(V.rows(), std::max(2 * nFaces, 16u));
+    F(nFaces, 0) = t1; F(nFaces, 1) = t2; F(nFaces, 2) = t3;
+    invalidateCache();
+    return nFaces++;
 }
 
 inline void SimpleEigenMesh::removeFace(unsigned int f)
 {
-    assert(f < (unsigned int)F.rows());
-    cg3::removeRowFromEigenMatrix(F, f);
+    assert(f < nFaces);
+    removeRow(F, f, nFaces);
+    nFaces--;
+    invalidateCache();
+}
+
+/**
+ * @brief Removes all the given faces with a single compaction of the faces
+ * matrix. The faces can be given in any order, duplicates are ignored.
+ * The remaining faces keep their relative order.
+ *
+ * @par Complexity:
+ *      \e O(number of faces)
+ */
+inline void SimpleEigenMesh::removeFaces(const std::vector<unsigned int>& faces)
+{
+    std::vector<bool> toRemove(nFaces, false);
+    for (unsigned int f : faces){
+        assert(f < nFaces);
+        toRemove[f] = true;
+    }
+    removeFaces(toRemove);
+}
+
+/**
+ * @brief Removes the row r from the first n rows of the row major matrix m,
+ * shifting up the following rows. The capacity of m does not change.
+ */
+template <typename M>
+inline void SimpleEigenMesh::removeRow(M& m, unsigned int r, unsigned int n)
+{
+    if (r < n)
+        std::copy(m.data() + (r+1) * m.cols(), m.data() + n * m.cols(), m.data() + r * m.cols());
+}
+
+/**
+ * @brief Removes from the first n rows of the row major matrix m the rows r
+ * such that toRemove[r] is true, compacting the other rows in a single pass.
+ * The capacity of m does not change.
+ */
+template <typename M>
+inline void SimpleEigenMesh::removeRows(M& m, const std::vector<bool>& toRemove, unsigned int n)
+{
+    const unsigned int c = m.cols();
+    unsigned int k = 0;
+    for (unsigned int r = 0; r < n; r++){
+        if (!toRemove[r]){
+            if (k != r)
+                std::copy(m.data() + r * c, m.data() + (r+1) * c, m.data() + k * c);
+            k++;
+        }
+    }
+}
+
+inline void SimpleEigenMesh::invalidateCache()
+{
+    vfCacheValid = false;
+    normalsCacheValid = false;
+}
+
+inline void SimpleEigenMesh::invalidateNormalsCache()
+{
+    normalsCacheValid = false;
 }
 
 
@@ -337,22 +501,35 @@ template <typename T, int ...A>
 inline void SimpleEigenMesh::setVerticesMatrix(const Eigen::PlainObjectBase<T>& V)
 {
     this->V = V;
+    nVertices = this->V.rows();
+    invalidateCache();
 }
 
 template <typename U, int ...A>
 inline void SimpleEigenMesh::setFacesMatrix(const Eigen::PlainObjectBase<U>& F)
 {
     this->F = F;
+    nFaces = this->F.rows();
+    invalidateCache();
 }
 
 inline void SimpleEigenMesh::serialize(std::ofstream& binaryFile) const
 {
+    if (nVertices != (unsigned int)V.rows() || nFaces != (unsigned int)F.rows()){
+        SimpleEigenMesh m(*this);
+        m.SimpleEigenMesh::shrinkToFit();
+        m.SimpleEigenMesh::serialize(binaryFile);
+        return;
+    }
     serializeObjectAttributes("cg3SimpleEigenMesh", binaryFile, V, F);
 }
 
 inline void SimpleEigenMesh::deserialize(std::ifstream& binaryFile)
 {
     deserializeObjectAttributes("cg3SimpleEigenMesh", binaryFile, V, F);
+    nVertices = V.rows();
+    nFaces = F.rows();
+    invalidateCache();
 }
 
 } //namespace cg3
@@ -0,0 +1,36 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#ifndef CG3_PARALLEL_H
+#define CG3_PARALLEL_H
+
+#include "thread_pool.h"
+
+#include <cstddef>
+
+namespace cg3 {
+
+template <typename Function>
+void parallelForChunks(
+        std::size_t size,
+        std::size_t grainSize,
+        Function f,
+        unsigned int nThreads = numberOfThreads());
+
+template <typename Function>
+void parallelFor(
+        std::size_t begin,
+        std::size_t end,
+        Function f,
+        std::size_t grainSize = 1024,
+        unsigned int nThreads = numberOfThreads());
+
+} //namespace cg3
+
+#include "parallel.inl"
+
+#endif // CG3_PARALLEL_H
@@ -0,0 +1,76 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#include "parallel.h"
+
+#include <algorithm>
+
+namespace cg3 {
+
+/**
+ * @ingroup cg3core
+ * @brief Splits the range [0, size) in consecutive chunks of grainSize
+ * elements (the last one may be smaller) and calls f(chunk, begin, end)
+ * for every chunk, distributing the chunks among at most nThreads threads:
+ * the calling thread and the threads of defaultThreadPool(). No thread is
+ * created at each call.
+ *
+ * The subdivision in chunks depends only on size and grainSize, and not on
+ * the number of threads: partial results stored per chunk and then reduced
+ * in chunk order give the same result for any number of threads.
+ *
+ * The calling thread takes part to the computation, so the function can be
+ * called also by a task running on defaultThreadPool(). If f throws, the
+ * remaining chunks are skipped and the first exception is rethrown.
+ */
+template <typename Function>
+void parallelForChunks(
+        std::size_t size,
+        std::size_t grainSize,
+        Function f,
+        unsigned int nThreads)
+{
+    if (grainSize == 0)
+        grainSize = 1;
+    const std::size_t nChunks = numberOfChunks(size, grainSize);
+
+    //sequential calls do not create the default pool
+    if (nThreads <= 1 || nChunks <= 1){
+        for (std::size_t c = 0; c < nChunks; ++c)
+            f(c, c * grainSize, std::min(size, (c+1) * grainSize));
+        return;
+    }
+    internal::parallelForChunksHelper(defaultThreadPool(), size, grainSize, f, nThreads);
+}
+
+/**
+ * @ingroup cg3core
+ * @brief Calls f(i) for every i in [begin, end), using nThreads threads.
+ * Indices are processed in chunks of grainSize consecutive elements.
+ * @see parallelForChunks
+ */
+template <typename Function>
+void parallelFor(
+        std::size_t begin,
+        std::size_t end,
+        Function f,
+        std::size_t grainSize,
+        unsigned int nThreads)
+{
+    if (end <= begin)
+        return;
+    parallelForChunks(
+        end - begin,
+        grainSize,
+        [&](std::size_t, std::size_t b, std::size_t e) {
+            for (std::size_t i = begin + b; i < begin + e; ++i)
+                f(i);
+        },
+        nThreads);
+}
+
+} //namespace cg3
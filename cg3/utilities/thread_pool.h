@@ -0,0 +1,98 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#ifndef CG3_THREAD_POOL_H
+#define CG3_THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace cg3 {
+
+unsigned int numberOfThreads();
+
+std::size_t numberOfChunks(std::size_t size, std::size_t grainSize);
+
+/**
+ * @ingroup cg3core
+ * @brief A fixed set of threads that execute the submitted tasks in FIFO
+ * order.
+ *
+ * Unlike parallelFor, which splits a single computation and returns when it
+ * is complete, submit() returns immediately a std::future of the result of
+ * the task:
+ *
+ * @code
+ * cg3::ThreadPool pool(4);
+ * std::future<double> f = pool.submit([&]() { return longComputation(); });
+ * ... // something else
+ * double res = f.get();
+ * @endcode
+ *
+ * The destructor waits for all the submitted tasks to be completed.
+ *
+ * parallelForChunks splits a computation among the threads of a pool:
+ * parallelFor and the other parallel algorithms of the library use the
+ * threads of defaultThreadPool().
+ */
+class ThreadPool
+{
+public:
+    ThreadPool(unsigned int nThreads = numberOfThreads());
+    ThreadPool(const ThreadPool& other) = delete;
+    ~ThreadPool();
+
+    ThreadPool& operator= (const ThreadPool& other) = delete;
+
+    unsigned int size() const;
+
+    template <typename Function>
+    auto submit(Function f) -> std::future<decltype(f())>;
+
+private:
+    void run();
+
+    std::vector<std::thread> threads;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool stopping;
+};
+
+ThreadPool& defaultThreadPool();
+
+template <typename Function>
+void parallelForChunks(
+        ThreadPool& pool,
+        std::size_t size,
+        std::size_t grainSize,
+        Function f);
+
+namespace internal {
+
+template <typename Function>
+void parallelForChunksHelper(
+        ThreadPool& pool,
+        std::size_t size,
+        std::size_t grainSize,
+        Function& f,
+        unsigned int nThreads);
+
+} //namespace cg3::internal
+
+} //namespace cg3
+
+#include "thread_pool.inl"
+
+#endif // CG3_THREAD_POOL_H
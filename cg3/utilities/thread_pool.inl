@@ -0,0 +1,225 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace cg3 {
+
+/**
+ * @ingroup cg3core
+ * @brief Returns the number of threads used by default by the parallel
+ * algorithms of the library, that is the number of hardware threads
+ * (at least 1).
+ */
+inline unsigned int numberOfThreads()
+{
+    unsigned int n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : n;
+}
+
+/**
+ * @ingroup cg3core
+ * @brief Returns the number of chunks in which parallelForChunks() splits
+ * a range of the given size.
+ */
+inline std::size_t numberOfChunks(std::size_t size, std::size_t grainSize)
+{
+    if (grainSize == 0)
+        grainSize = 1;
+    return (size + grainSize - 1) / grainSize;
+}
+
+/**
+ * @brief Creates a pool of nThreads threads (at least 1).
+ */
+inline ThreadPool::ThreadPool(unsigned int nThreads) :
+    stopping(false)
+{
+    if (nThreads == 0)
+        nThreads = 1;
+    threads.reserve(nThreads);
+    for (unsigned int i = 0; i < nThreads; ++i)
+        threads.emplace_back([this]() { run(); });
+}
+
+/**
+ * @brief Waits for the completion of all the submitted tasks, and then
+ * stops the threads.
+ */
+inline ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    condition.notify_all();
+    for (std::thread& t : threads)
+        t.join();
+}
+
+/**
+ * @brief Returns the number of threads of the pool.
+ */
+inline unsigned int ThreadPool::size() const
+{
+    return (unsigned int)threads.size();
+}
+
+/**
+ * @brief Queues the execution of f() on a thread of the pool, and returns
+ * the future of its result. If f throws, the exception is stored in the
+ * future and rethrown by std::future::get().
+ */
+template <typename Function>
+auto ThreadPool::submit(Function f) -> std::future<decltype(f())>
+{
+    typedef decltype(f()) Result;
+    //std::function requires a copyable function, packaged_task is move only
+    std::shared_ptr<std::packaged_task<Result()>> task =
+            std::make_shared<std::packaged_task<Result()>>(std::move(f));
+    std::future<Result> future = task->get_future();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push([task]() { (*task)(); });
+    }
+    condition.notify_one();
+    return future;
+}
+
+inline void ThreadPool::run()
+{
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            if (tasks.empty())
+                return; //stopping, and nothing left to do
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+        task();
+    }
+}
+
+/**
+ * @ingroup cg3core
+ * @brief Returns the pool shared by the parallel algorithms of the library
+ * that do not receive a pool. It is created at the first call, with
+ * numberOfThreads() threads.
+ */
+inline ThreadPool& defaultThreadPool()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+/**
+ * @ingroup cg3core
+ * @brief Splits the range [0, size) in consecutive chunks of grainSize
+ * elements and calls f(chunk, begin, end) for every chunk, like
+ * parallelForChunks(size, grainSize, f, nThreads), but distributing the chunks
+ * among the threads of the given pool instead of the ones of
+ * defaultThreadPool().
+ *
+ * The calling thread takes part to the computation and the function returns
+ * when all the chunks have been processed, even if the threads of the pool
+ * are busy with other tasks: it can be called also by a task of the same
+ * pool. If f throws, the remaining chunks are skipped and the first exception
+ * is rethrown.
+ */
+template <typename Function>
+void parallelForChunks(
+        ThreadPool& pool,
+        std::size_t size,
+        std::size_t grainSize,
+        Function f)
+{
+    internal::parallelForChunksHelper(pool, size, grainSize, f, pool.size());
+}
+
+namespace internal {
+
+/**
+ * @brief Splits the range [0, size) in chunks of grainSize elements and calls
+ * f(chunk, begin, end) for every chunk, using at most nThreads threads: the
+ * calling thread and nThreads-1 threads of the pool.
+ */
+template <typename Function>
+void parallelForChunksHelper(
+        ThreadPool& pool,
+        std::size_t size,
+        std::size_t grainSize,
+        Function& f,
+        unsigned int nThreads)
+{
+    if (grainSize == 0)
+        grainSize = 1;
+    const std::size_t nChunks = numberOfChunks(size, grainSize);
+    //the calling thread is one of the workers
+    const std::size_t nWorkers = std::min<std::size_t>(std::min(pool.size(), nThreads), nChunks);
+    const std::size_t nHelpers = nWorkers > 1 ? nWorkers - 1 : 0;
+
+    if (nHelpers == 0){
+        for (std::size_t c = 0; c < nChunks; ++c)
+            f(c, c * grainSize, std::min(size, (c+1) * grainSize));
+        return;
+    }
+
+    //The state is shared with the tasks, which may start after the function
+    //returned: they find no chunk left and do not touch f
+    struct State {
+        std::atomic<std::size_t> nextChunk;
+        std::atomic<bool> failed;
+        std::size_t remaining; //chunks not completed yet
+        std::exception_ptr exception;
+        std::mutex mutex;
+        std::condition_variable done;
+    };
+    std::shared_ptr<State> state = std::make_shared<State>();
+    state->nextChunk = 0;
+    state->failed = false;
+    state->remaining = nChunks;
+
+    Function* pf = &f;
+    auto worker = [state, pf, nChunks, size, grainSize]() {
+        std::size_t c;
+        while ((c = state->nextChunk++) < nChunks){
+            std::exception_ptr exception;
+            if (!state->failed){
+                try {
+                    (*pf)(c, c * grainSize, std::min(size, (c+1) * grainSize));
+                }
+                catch(...) {
+                    exception = std::current_exception();
+                    state->failed = true;
+                }
+            }
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (exception && !state->exception)
+                state->exception = exception;
+            if (--state->remaining == 0)
+                state->done.notify_all();
+        }
+    };
+
+    for (std::size_t i = 0; i < nHelpers; ++i)
+        pool.submit(worker);
+    worker();
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->done.wait(lock, [&state]() { return state->remaining == 0; });
+    if (state->exception)
+        std::rethrow_exception(state->exception);
+}
+
+} //namespace cg3::internal
+
+} //namespace cg3
@@ -164,75 +164,35 @@ CG3_INLINE void DrawableDcel::update()
         vi++;
     }
 
-    unsigned int actualTriangle = 0;
-    #ifdef CG3_CGAL_DEFINED
     for (const Dcel::Face* f : faceIterator()) {
         for (const Dcel::HalfEdge* he : f->incidentHalfEdgeIterator()) {
             unsigned int p1, p2;
-                p1 = v_ids[he->fromVertex()->id()];
-                p2 = v_ids[he->toVertex()->id()];
-                std::pair<unsigned int, unsigned int> edge(p1,p2);
-                facesWireframe.push_back(edge);
-            }
-
-
-        if (f->isTriangle()){
-            for (const Dcel::Vertex* v : f->incidentVertexIterator())
-                triangles.push_back(v_ids[v->id()]);
-            triangleColors.push_back(f->color().redF());
-            triangleColors.push_back(f->color().greenF());
-            triangleColors.push_back(f->color().blueF());
-            triangleNormals.push_back(f->normal().x());
-            triangleNormals.push_back(f->normal().y());
-            triangleNormals.push_back(f->normal().z());
-            trianglesFacesMap.push_back(f->id());
-            facesTrianglesMap[f->id()] = actualTriangle++;
-        }
-        else {
-            facesTrianglesMap[f->id()] = actualTriangle;
-            //Si ottiene la triangolazione della faccia e si inseriscono i triangoli
-            //prodotti nell'array tris.
-            std::vector<std::array<const Dcel::Vertex*, 3> > face_triangles;
-            f->triangulation(face_triangles);
-            std::array<const Dcel::Vertex*, 3> t;
-            for(unsigned int i = 0; i<face_triangles.size(); ++i){
-                t = face_triangles[i];
-                const Dcel::Vertex* v1 = t[0];
-                const Dcel::Vertex* v2 = t[1];
-                const Dcel::Vertex* v3 = t[2];
-                triangles.push_back(v_ids[v1->id()]);
-                triangles.push_back(v_ids[v3->id()]);
-                triangles.push_back(v_ids[v2->id()]);
-                trianglesFacesMap.push_back(f->id());
-                triangleColors.push_back(f->color().redF());
-                triangleColors.push_back(f->color().greenF());
-                triangleColors.push_back(f->color().blueF());
-                triangleNormals.push_back(f->normal().x());
-                triangleNormals.push_back(f->normal().y());
-                triangleNormals.push_back(f->normal().z());
-                actualTriangle++;
-            }
-            /***********************************************************************/
+            p1 = v_ids[he->fromVertex()->id()];
+            p2 = v_ids[he->toVertex()->id()];
+            std::pair<unsigned int, unsigned int> edge(p1,p2);
+            facesWireframe.push_back(edge);
         }
     }
-    #else
-    for (const Dcel::Face* f : faceIterator()) {
-        Dcel::Face::ConstIncidentVertexIterator vit = f->incidentVertexBegin();
-        triangles.push_back(v_ids[(*vit)->id()]);
-        ++vit;
-        triangles.push_back(v_ids[(*vit)->id()]);
-        ++vit;
-        triangles.push_back(v_ids[(*vit)->id()]);
+
+    //Si ottiene la triangolazione di tutte le facce (i triangoli sono ordinati
+    //per id della faccia) e si inseriscono i triangoli prodotti nell'array tris.
+    std::vector<unsigned int> faceTriangles, triangleFaces;
+    triangulation(faceTriangles, triangleFaces);
+    for (unsigned int t = 0; t < triangleFaces.size(); ++t) {
+        const Dcel::Face* f = face(triangleFaces[t]);
+        if (t == 0 || triangleFaces[t-1] != triangleFaces[t])
+            facesTrianglesMap[f->id()] = t;
+        triangles.push_back(v_ids[faceTriangles[3*t]]);
+        triangles.push_back(v_ids[faceTriangles[3*t+1]]);
+        triangles.push_back(v_ids[faceTriangles[3*t+2]]);
+        trianglesFacesMap.push_back(f->id());
         triangleColors.push_back(f->color().redF());
         triangleColors.push_back(f->color().greenF());
         triangleColors.push_back(f->color().blueF());
         triangleNormals.push_back(f->normal().x());
         triangleNormals.push_back(f->normal().y());
         triangleNormals.push_back(f->normal().z());
-        trianglesFacesMap.push_back(f->id());
-        facesTrianglesMap[f->id()] = actualTriangle++;
     }
-    #endif
     for (cg3::Dcel::HalfEdge* he : halfEdgeIterator()){
         if (he->twin() != nullptr) {
             if (he->id() < he->twin()->id()){
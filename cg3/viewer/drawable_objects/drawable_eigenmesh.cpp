@@ -37,7 +37,7 @@ CG3_INLINE DrawableEigenMesh::DrawableEigenMesh(const std::string& filename)  :
 
 CG3_INLINE void DrawableEigenMesh::draw() const
 {
-    DrawableMesh::draw(V.rows(), F.rows(), V.data(), F.data(), NV.data(), CV.data(), NF.data(), CF.data(), bb.min(), bb.max());
+    DrawableMesh::draw(numberVertices(), numberFaces(), V.data(), F.data(), NV.data(), CV.data(), NF.data(), CF.data(), bb.min(), bb.max());
 }
 
 CG3_INLINE Point3d DrawableEigenMesh::sceneCenter() const
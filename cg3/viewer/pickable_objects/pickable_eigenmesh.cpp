@@ -31,7 +31,7 @@ CG3_INLINE void PickableEigenMesh::drawWithNames() const
     glEnableClientState(GL_NORMAL_ARRAY);
     glNormalPointer(GL_DOUBLE, 0, NV.data());
     std::array<double,3> vertex;
-    for(unsigned int i = 0; i<F.rows();i++){
+    for(unsigned int i = 0; i<numberFaces();i++){
         glPushMatrix();
         glPushName(i);
 
@@ -150,6 +150,55 @@ int main(int argc, char *argv[])
 
 
 
+	/* ----- STATIC MODE ----- */
+
+	//If the tree is not going to change, a flat hierarchy makes the queries faster.
+	//It is discarded by the next insert/erase
+	std::cout << "Building the static hierarchy..." << std::endl;
+	aabbTree.buildStatic();
+
+	std::cout << "AABB overlaps (static): segment ([0,3], [8,10]) -> ";
+	std::vector<AABBTree::iterator> staticQueryResults;
+	aabbTree.aabbOverlapQuery(
+				Segment2D(Point2D(0,3),Point2D(8,10)),
+				std::back_inserter(staticQueryResults));
+
+	for (AABBTree::iterator& it : staticQueryResults) {
+		std::cout << *it << " | ";
+	}
+	std::cout << std::endl;
+
+	//Callback query: results are not collected in any container
+	std::cout << "AABB overlaps (callback): segment ([0,3], [8,10]) -> ";
+	aabbTree.aabbOverlapQueryCallback(
+				Segment2D(Point2D(0,3),Point2D(8,10)),
+				[](AABBTree::iterator it) {
+					std::cout << *it << " | ";
+				});
+	std::cout << std::endl;
+
+	//Batch query: queries are executed on multiple threads, the results of
+	//the i-th query are batchResults[batchOffsets[i]] ... batchResults[batchOffsets[i+1]-1]
+	std::vector<Segment2D> batchKeys;
+	batchKeys.push_back(Segment2D(Point2D(0,3),Point2D(8,10)));
+	batchKeys.push_back(Segment2D(Point2D(20,30),Point2D(80,10)));
+	std::vector<size_t> batchOffsets;
+	std::vector<AABBTree::const_iterator> batchResults;
+	const AABBTree& constAabbTree = aabbTree;
+	constAabbTree.batchOverlapQuery(batchKeys, batchOffsets, batchResults);
+
+	for (size_t i = 0; i < batchKeys.size(); i++) {
+		std::cout << "AABB overlaps (batch), query " << i << " -> ";
+		for (size_t j = batchOffsets[i]; j < batchOffsets[i+1]; j++) {
+			std::cout << *batchResults[j] << " | ";
+		}
+		std::cout << std::endl;
+	}
+
+	std::cout << std::endl;
+
+
+
 	/* ----- OTHER FUNCTIONS ----- */
 
 	//Get min and max (through iterators)
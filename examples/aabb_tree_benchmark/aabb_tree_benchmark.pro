@@ -0,0 +1,8 @@
+CONFIG += CG3_CORE
+
+include (../../cg3.pri)
+
+# Uncomment to benchmark the scalar box comparisons of the static tree
+#DEFINES += CG3_AABB_NO_SIMD
+
+SOURCES += main.cpp
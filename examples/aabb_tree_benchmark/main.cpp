@@ -0,0 +1,138 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Stefano Nuvoli (stefano.nuvoli@gmail.com)
+ */
+
+/*
+ * Benchmark of the AABB queries of AABBTree: the AVL tree is compared with
+ * the flat hierarchy created by buildStatic(), on random boxes in 2D and 3D.
+ *
+ * The box comparisons of the flat hierarchy use AVX or SSE2 when available.
+ * The aabb_tree_benchmark_scalar target is the same program compiled with
+ * CG3_AABB_NO_SIMD, to compare the scalar and the SIMD paths; AVX is used
+ * when compiling with -mavx (e.g. CMAKE_CXX_FLAGS=-mavx).
+ *
+ * Usage: aabb_tree_benchmark [number of boxes (default 1M)] [number of queries (default 100k)]
+ */
+
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <cg3/data_structures/trees/aabbtree.h>
+
+#if defined(__AVX__) && !defined(CG3_AABB_NO_SIMD)
+const char* comparisonPath = "AVX";
+#elif (defined(__SSE2__) || defined(_M_X64)) && !defined(CG3_AABB_NO_SIMD)
+const char* comparisonPath = "SSE2";
+#else
+const char* comparisonPath = "scalar";
+#endif
+
+typedef std::chrono::steady_clock Clock;
+
+double elapsedMs(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+template <int D>
+struct Box {
+	std::array<double, D> min;
+	std::array<double, D> max;
+
+	bool operator<(const Box& other) const
+	{
+		return min < other.min || (min == other.min && max < other.max);
+	}
+};
+
+template <int D>
+double boxValueExtractor(const Box<D>& box, const cg3::AABBValueType& valueType, const int& dim)
+{
+	return valueType == cg3::MIN ? box.min[dim-1] : box.max[dim-1];
+}
+
+/*
+ * Random boxes in [0, 1000]^D, with sides up to maxSide
+ */
+template <int D>
+std::vector<Box<D>> randomBoxes(std::size_t n, double maxSide, std::mt19937& rng)
+{
+	std::uniform_real_distribution<double> position(0, 1000), side(0, maxSide);
+	std::vector<Box<D>> boxes(n);
+	for (Box<D>& b : boxes){
+		for (int d = 0; d < D; ++d){
+			b.min[d] = position(rng);
+			b.max[d] = b.min[d] + side(rng);
+		}
+	}
+	return boxes;
+}
+
+template <int D>
+void benchmark(std::size_t nBoxes, std::size_t nQueries)
+{
+	typedef cg3::AABBTree<D, Box<D>> Tree;
+
+	std::mt19937 rng(0);
+	std::vector<Box<D>> boxes = randomBoxes<D>(nBoxes, D == 2 ? 1 : 10, rng);
+	std::vector<Box<D>> queries = randomBoxes<D>(nQueries, D == 2 ? 5 : 20, rng);
+
+	std::cout << "D = " << D << ": " << nBoxes << " boxes, " << nQueries << " queries" << std::endl;
+
+	Clock::time_point t = Clock::now();
+	Tree tree(boxes, &boxValueExtractor<D>);
+	std::cout << "\tAVL construction: " << elapsedMs(t) << " ms" << std::endl;
+
+	const Tree& constTree = tree;
+	std::size_t avlResults = 0, avlChecks = 0;
+	t = Clock::now();
+	for (const Box<D>& q : queries)
+		constTree.aabbOverlapQueryCallback(q, [&](typename Tree::const_iterator) { avlResults++; });
+	double avlQuery = elapsedMs(t);
+	t = Clock::now();
+	for (const Box<D>& q : queries)
+		avlChecks += constTree.aabbOverlapCheck(q);
+	double avlCheck = elapsedMs(t);
+
+	t = Clock::now();
+	tree.buildStatic();
+	std::cout << "\tbuildStatic: " << elapsedMs(t) << " ms" << std::endl;
+
+	std::size_t staticResults = 0, staticChecks = 0;
+	t = Clock::now();
+	for (const Box<D>& q : queries)
+		constTree.aabbOverlapQueryCallback(q, [&](typename Tree::const_iterator) { staticResults++; });
+	double staticQuery = elapsedMs(t);
+	t = Clock::now();
+	for (const Box<D>& q : queries)
+		staticChecks += constTree.aabbOverlapCheck(q);
+	double staticCheck = elapsedMs(t);
+
+	std::cout << "\taabbOverlapQuery: AVL " << avlQuery << " ms, static " << staticQuery
+			  << " ms (" << avlQuery / staticQuery << "x), results " << avlResults
+			  << (avlResults == staticResults ? " (equal)" : " (DIFFERENT)") << std::endl;
+	std::cout << "\taabbOverlapCheck: AVL " << avlCheck << " ms, static " << staticCheck
+			  << " ms (" << avlCheck / staticCheck << "x), overlapping queries " << avlChecks
+			  << (avlChecks == staticChecks ? " (equal)" : " (DIFFERENT)") << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+	std::size_t nBoxes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+	std::size_t nQueries = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100000;
+
+	std::cout << "------ AABBTree benchmark ------" << std::endl << std::endl;
+	std::cout << "Box comparisons of the static tree: " << comparisonPath << std::endl << std::endl;
+
+	benchmark<2>(nBoxes, nQueries);
+	benchmark<3>(nBoxes, nQueries);
+
+	return 0;
+}
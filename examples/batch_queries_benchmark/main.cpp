@@ -0,0 +1,184 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Stefano Nuvoli (stefano.nuvoli@gmail.com)
+ */
+
+/*
+ * Benchmark of the batch queries of AABBTree (batchOverlapQuery) and
+ * RangeTree (batchRangeQuery) on thread pools with 1 to N threads. The
+ * batches are compared with the same queries executed one after the other,
+ * on both the dynamic and the static version of each tree.
+ *
+ * Usage: batch_queries_benchmark [number of entries (default 1M)] [number of queries (default 100k)]
+ *                                [maximum number of threads (default: hardware threads, at least 4)]
+ */
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <cg3/data_structures/trees/aabbtree.h>
+#include <cg3/data_structures/trees/rangetree.h>
+#include <cg3/utilities/thread_pool.h>
+
+typedef std::chrono::steady_clock Clock;
+
+double elapsedMs(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+struct Box {
+	std::array<double, 2> min;
+	std::array<double, 2> max;
+
+	bool operator<(const Box& other) const
+	{
+		return min < other.min || (min == other.min && max < other.max);
+	}
+};
+
+double boxValueExtractor(const Box& box, const cg3::AABBValueType& valueType, const int& dim)
+{
+	return valueType == cg3::MIN ? box.min[dim-1] : box.max[dim-1];
+}
+
+/*
+ * Random boxes in [0, 1000]^2, with sides up to maxSide
+ */
+std::vector<Box> randomBoxes(std::size_t n, double maxSide, std::mt19937& rng)
+{
+	std::uniform_real_distribution<double> position(0, 1000), side(0, maxSide);
+	std::vector<Box> boxes(n);
+	for (Box& b : boxes){
+		for (int d = 0; d < 2; ++d){
+			b.min[d] = position(rng);
+			b.max[d] = b.min[d] + side(rng);
+		}
+	}
+	return boxes;
+}
+
+/*
+ * Run batchQuery(pool, offsets, results) with 1..maxThreads threads, and
+ * compare the time and the results with the sequential queries
+ */
+template <class Iterator, class Sequential, class Batch>
+void benchmarkBatch(
+		const std::string& name,
+		unsigned int maxThreads,
+		Sequential sequential,
+		Batch batchQuery)
+{
+	std::vector<std::size_t> sequentialOffsets;
+	std::vector<Iterator> sequentialResults;
+	Clock::time_point t = Clock::now();
+	sequential(sequentialOffsets, sequentialResults);
+	double sequentialTime = elapsedMs(t);
+	std::cout << "\t" << name << ": sequential " << sequentialTime << " ms, "
+			  << sequentialResults.size() << " results" << std::endl;
+
+	for (unsigned int nThreads = 1; nThreads <= maxThreads; nThreads++){
+		cg3::ThreadPool pool(nThreads);
+		std::vector<std::size_t> offsets;
+		std::vector<Iterator> results;
+		t = Clock::now();
+		batchQuery(pool, offsets, results);
+		double batchTime = elapsedMs(t);
+		std::cout << "\t\t" << nThreads << " threads: " << batchTime << " ms ("
+				  << sequentialTime / batchTime << "x)"
+				  << (offsets == sequentialOffsets && results == sequentialResults ? "" : " DIFFERENT RESULTS")
+				  << std::endl;
+	}
+}
+
+void benchmarkAABBTree(std::size_t nBoxes, std::size_t nQueries, unsigned int maxThreads)
+{
+	typedef cg3::AABBTree<2, Box> Tree;
+
+	std::mt19937 rng(0);
+	std::vector<Box> boxes = randomBoxes(nBoxes, 1, rng);
+	std::vector<Box> queries = randomBoxes(nQueries, 5, rng);
+
+	std::cout << "AABBTree: " << nBoxes << " boxes, " << nQueries << " queries" << std::endl;
+
+	Tree tree(boxes, &boxValueExtractor);
+	const Tree& constTree = tree;
+
+	auto sequential = [&](std::vector<std::size_t>& offsets, std::vector<Tree::const_iterator>& results) {
+		offsets.assign(1, 0);
+		results.clear();
+		for (const Box& q : queries){
+			constTree.aabbOverlapQuery(q, std::back_inserter(results));
+			offsets.push_back(results.size());
+		}
+	};
+	auto batch = [&](cg3::ThreadPool& pool, std::vector<std::size_t>& offsets, std::vector<Tree::const_iterator>& results) {
+		constTree.batchOverlapQuery(queries, offsets, results, nullptr, pool);
+	};
+
+	benchmarkBatch<Tree::const_iterator>("AVL tree", maxThreads, sequential, batch);
+	tree.buildStatic();
+	benchmarkBatch<Tree::const_iterator>("static tree", maxThreads, sequential, batch);
+}
+
+void benchmarkRangeTree(std::size_t nPoints, std::size_t nQueries, unsigned int maxThreads)
+{
+	typedef cg3::RangeTree2D Tree;
+
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<double> position(0, 1000), side(0, 5);
+	std::vector<cg3::Point2d> points(nPoints);
+	for (cg3::Point2d& p : points)
+		p = cg3::Point2d(position(rng), position(rng));
+	std::vector<cg3::Point2d> starts(nQueries), ends(nQueries);
+	for (std::size_t i = 0; i < nQueries; i++){
+		starts[i] = cg3::Point2d(position(rng), position(rng));
+		ends[i] = starts[i] + cg3::Point2d(side(rng), side(rng));
+	}
+
+	std::cout << "RangeTree: " << nPoints << " points, " << nQueries << " queries" << std::endl;
+
+	Tree tree(points);
+	const Tree& constTree = tree;
+
+	auto sequential = [&](std::vector<std::size_t>& offsets, std::vector<Tree::const_iterator>& results) {
+		offsets.assign(1, 0);
+		results.clear();
+		for (std::size_t i = 0; i < nQueries; i++){
+			constTree.rangeQuery(starts[i], ends[i], std::back_inserter(results));
+			offsets.push_back(results.size());
+		}
+	};
+	auto batch = [&](cg3::ThreadPool& pool, std::vector<std::size_t>& offsets, std::vector<Tree::const_iterator>& results) {
+		constTree.batchRangeQuery(starts, ends, offsets, results, pool);
+	};
+
+	benchmarkBatch<Tree::const_iterator>("dynamic tree", maxThreads, sequential, batch);
+	tree.buildStatic();
+	benchmarkBatch<Tree::const_iterator>("static tree", maxThreads, sequential, batch);
+}
+
+int main(int argc, char *argv[])
+{
+	std::size_t nEntries = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+	std::size_t nQueries = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100000;
+	unsigned int maxThreads = argc > 3 ?
+				(unsigned int) std::strtoul(argv[3], nullptr, 10) :
+				std::max(4u, std::thread::hardware_concurrency());
+
+	std::cout << "------ Batch queries benchmark ------" << std::endl << std::endl;
+	std::cout << "Hardware threads: " << std::thread::hardware_concurrency() << std::endl << std::endl;
+
+	benchmarkAABBTree(nEntries, nQueries, maxThreads);
+	benchmarkRangeTree(nEntries, nQueries, maxThreads);
+
+	return 0;
+}
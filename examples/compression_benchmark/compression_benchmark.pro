@@ -0,0 +1,7 @@
+CONFIG += CG3_CORE
+
+include (../../cg3.pri)
+
+DEFINES += SOURCE_PATH=$$PWD
+
+SOURCES += main.cpp
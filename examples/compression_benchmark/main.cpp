@@ -0,0 +1,134 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+/*
+ * Benchmark of the compressed serialization (CompressedOfstream and
+ * CompressedIfstream) on a Dcel, a Graph and a RegularLattice3D.
+ *
+ * Usage: compression_benchmark [mesh file] [number of threads]
+ *
+ * For every payload, the compression ratio and the speed (in MB/s of
+ * uncompressed data) of serialization and deserialization are reported, and
+ * compared with the plain std::fstream serialization.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include <cg3/cg3lib.h>
+#include <cg3/io/serialize_compressed.h>
+#include <cg3/meshes/dcel/dcel.h>
+#include <cg3/data_structures/graphs/graph.h>
+#include <cg3/data_structures/lattices/regular_lattice.h>
+
+typedef std::chrono::steady_clock Clock;
+
+double elapsedMs(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+long long int fileSize(const std::string& filename)
+{
+	std::ifstream file(filename, std::ios::binary | std::ios::ate);
+	return file.tellg();
+}
+
+/*
+ * Serializes and deserializes object on a plain and on a compressed file,
+ * and prints size, ratio and speed.
+ */
+template <typename T>
+void benchmark(const std::string& name, const T& object, unsigned int nThreads)
+{
+	const std::string plainName = "compression_benchmark.bin";
+	const std::string compressedName = "compression_benchmark.bin.cz";
+
+	Clock::time_point t = Clock::now();
+	{
+		std::ofstream file(plainName, std::ios::binary);
+		object.serialize(file);
+	}
+	double plainWrite = elapsedMs(t);
+	t = Clock::now();
+	{
+		T copy;
+		std::ifstream file(plainName, std::ios::binary);
+		copy.deserialize(file);
+	}
+	double plainRead = elapsedMs(t);
+
+	t = Clock::now();
+	{
+		cg3::CompressedOfstream file(compressedName, nThreads);
+		object.serialize(file);
+		file.close();
+	}
+	double compressedWrite = elapsedMs(t);
+	t = Clock::now();
+	{
+		T copy;
+		cg3::CompressedIfstream file(compressedName, nThreads);
+		copy.deserialize(file);
+	}
+	double compressedRead = elapsedMs(t);
+
+	const double mb = fileSize(plainName) / 1e6;
+	const double compressedMb = fileSize(compressedName) / 1e6;
+	std::cout << name << ": " << mb << " MB, compressed " << compressedMb << " MB (ratio "
+			  << mb / compressedMb << ")" << std::endl;
+	std::cout << "\tplain:      write " << mb / (plainWrite / 1000) << " MB/s, read "
+			  << mb / (plainRead / 1000) << " MB/s" << std::endl;
+	std::cout << "\tcompressed: write " << mb / (compressedWrite / 1000) << " MB/s, read "
+			  << mb / (compressedRead / 1000) << " MB/s" << std::endl;
+
+	std::remove(plainName.c_str());
+	std::remove(compressedName.c_str());
+}
+
+int main(int argc, char *argv[])
+{
+	std::string meshFile = argc > 1 ? argv[1] : CG3_STRINGIFY(SOURCE_PATH) "/../../shared/bunny.obj";
+	unsigned int nThreads = argc > 2 ? std::atoi(argv[2]) : cg3::numberOfThreads();
+
+	std::cout << "------ Compressed serialization benchmark (" << nThreads << " threads) ------"
+			  << std::endl << std::endl;
+
+	//Dcel
+	cg3::Dcel dcel;
+	if (dcel.loadFromFile(meshFile))
+		benchmark("Dcel (" + std::to_string(dcel.numberFaces()) + " faces)", dcel, nThreads);
+	else
+		std::cout << "Unable to load " << meshFile << ": Dcel skipped" << std::endl << std::endl;
+
+	//Graph: nodes connected to random nodes, with integer weights
+	const unsigned int nNodes = 200000;
+	std::mt19937 rng(0);
+	cg3::Graph<int> graph(cg3::Graph<int>::GraphType::UNDIRECTED);
+	for (unsigned int i = 0; i < nNodes; ++i)
+		graph.addNode(i);
+	for (unsigned int i = 0; i < nNodes; ++i)
+		for (unsigned int k = 0; k < 4; ++k)
+			graph.addEdge(i, rng() % nNodes, rng() % 100);
+	benchmark("Graph (" + std::to_string(nNodes) + " nodes)", graph, nThreads);
+
+	//RegularLattice3D: distance field from the center of the box
+	cg3::BoundingBox3 bb(cg3::Point3d(-1, -1, -1), cg3::Point3d(1, 1, 1));
+	cg3::RegularLattice3D<double> lattice(bb, 0.01);
+	for (unsigned int i = 0; i < lattice.resX(); ++i)
+		for (unsigned int j = 0; j < lattice.resY(); ++j)
+			for (unsigned int k = 0; k < lattice.resZ(); ++k)
+				lattice.setVertexProperty(i, j, k, std::round(lattice.vertex(i, j, k).length() * 1000) / 1000);
+	benchmark("RegularLattice3D (" + std::to_string(lattice.resX()) + "^3 doubles)", lattice, nThreads);
+
+	return 0;
+}
@@ -0,0 +1,177 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+/*
+ * Benchmark of the construction of a Dcel from an indexed triangle mesh
+ * with DcelBuilder: the triangles are inserted one at a time with
+ * addFace(points), which finds the vertices by their coordinates, with
+ * addFace(ids) after adding all the vertices, and all at once with
+ * build(coords, tris).
+ *
+ * The same mesh is then built with Dcel::fromIndexedTriangles, which links
+ * the twin half edges with a radix sort instead of a map, and with the
+ * Dcel(SimpleEigenMesh) constructor, which uses it. Reversed triangle fans
+ * with a growing number of triangles check that the time is linear also
+ * when a vertex has a large valence.
+ *
+ * Usage: dcel_builder_benchmark [obj file (default: a grid of 180k triangles)]
+ */
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <cg3/meshes/dcel/dcel_builder.h>
+#include <cg3/meshes/eigenmesh/simpleeigenmesh.h>
+#include <cg3/io/load_save_obj.h>
+
+typedef std::chrono::steady_clock Clock;
+
+double elapsedMs(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+/*
+ * Triangulated grid of n x n squares on a bumpy surface
+ */
+void grid(unsigned int n, std::vector<double>& coords, std::vector<unsigned int>& tris)
+{
+	for (unsigned int i = 0; i <= n; i++){
+		for (unsigned int j = 0; j <= n; j++){
+			coords.push_back(i);
+			coords.push_back(j);
+			coords.push_back(std::sin(i * 0.1) * std::cos(j * 0.1));
+		}
+	}
+	for (unsigned int i = 0; i < n; i++){
+		for (unsigned int j = 0; j < n; j++){
+			unsigned int v = i * (n+1) + j;
+			tris.insert(tris.end(), {v, v + n + 1, v + 1});
+			tris.insert(tris.end(), {v + 1, v + n + 1, v + n + 2});
+		}
+	}
+}
+
+/*
+ * Fan of n triangles around the vertex 0, listed in reverse order
+ */
+void reversedFan(unsigned int n, std::vector<double>& coords, std::vector<unsigned int>& tris)
+{
+	coords.assign(3, 0);
+	for (unsigned int i = 0; i <= n; i++){
+		double angle = i * 3.0 / n;
+		coords.push_back(std::cos(angle));
+		coords.push_back(std::sin(angle));
+		coords.push_back(0);
+	}
+	tris.clear();
+	for (unsigned int i = n; i > 0; i--)
+		tris.insert(tris.end(), {0, i, i + 1});
+}
+
+/*
+ * Number of half edges with a twin
+ */
+unsigned int numberTwins(const cg3::Dcel& d)
+{
+	unsigned int n = 0;
+	for (const cg3::Dcel::HalfEdge* he : d.halfEdgeIterator())
+		if (he->twin() != nullptr)
+			n++;
+	return n;
+}
+
+void printResult(const std::string& name, double ms, const cg3::Dcel& d)
+{
+	std::cout << "\t" << name << ": " << ms << " ms (" << d.numberVertices() << " vertices, "
+			  << d.numberHalfEdges() << " half edges, " << d.numberFaces() << " faces)" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+	std::vector<double> coords;
+	std::vector<unsigned int> tris;
+	if (argc > 1){
+		if (!cg3::loadTriangleMeshFromObj(argv[1], coords, tris)){
+			std::cerr << "Unable to load " << argv[1] << std::endl;
+			return 1;
+		}
+	}
+	else {
+		grid(300, coords, tris);
+	}
+	const std::size_t nv = coords.size() / 3;
+	const std::size_t nt = tris.size() / 3;
+
+	std::cout << "------ DcelBuilder benchmark: " << nv << " vertices, " << nt << " triangles ------"
+			  << std::endl << std::endl;
+
+	std::vector<cg3::Point3d> points(nv);
+	for (std::size_t i = 0; i < nv; i++)
+		points[i] = cg3::Point3d(coords[3*i], coords[3*i+1], coords[3*i+2]);
+
+	std::cout << "DcelBuilder" << std::endl;
+	{
+		Clock::time_point t = Clock::now();
+		cg3::DcelBuilder builder;
+		for (std::size_t i = 0; i < nt; i++)
+			builder.addFace(points[tris[3*i]], points[tris[3*i+1]], points[tris[3*i+2]]);
+		builder.finalize();
+		printResult("addFace(points)", elapsedMs(t), builder.dcel());
+	}
+	{
+		Clock::time_point t = Clock::now();
+		cg3::DcelBuilder builder;
+		for (std::size_t i = 0; i < nv; i++)
+			builder.addVertex(points[i]);
+		for (std::size_t i = 0; i < nt; i++)
+			builder.addFace(tris[3*i], tris[3*i+1], tris[3*i+2]);
+		builder.finalize();
+		printResult("addVertex + addFace(ids)", elapsedMs(t), builder.dcel());
+	}
+	{
+		Clock::time_point t = Clock::now();
+		cg3::DcelBuilder builder;
+		builder.build(coords, tris);
+		builder.finalize();
+		printResult("build(coords, tris)", elapsedMs(t), builder.dcel());
+	}
+
+	std::cout << "Dcel" << std::endl;
+	{
+		Clock::time_point t = Clock::now();
+		cg3::Dcel d = cg3::Dcel::fromIndexedTriangles(coords, tris);
+		printResult("fromIndexedTriangles", elapsedMs(t), d);
+	}
+	{
+		Eigen::MatrixXd V = Eigen::Map<const Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor>>(coords.data(), nv, 3);
+		Eigen::MatrixXi F = Eigen::Map<const Eigen::Matrix<unsigned int, Eigen::Dynamic, 3, Eigen::RowMajor>>(tris.data(), nt, 3).cast<int>();
+		cg3::SimpleEigenMesh m(V, F);
+		Clock::time_point t = Clock::now();
+		cg3::Dcel d(m);
+		printResult("Dcel(SimpleEigenMesh)", elapsedMs(t), d);
+	}
+
+	std::cout << "Reversed fans, fromIndexedTriangles" << std::endl;
+	for (unsigned int n = 10000; n <= 80000; n *= 2){
+		std::vector<double> fanCoords;
+		std::vector<unsigned int> fanTris;
+		reversedFan(n, fanCoords, fanTris);
+		Clock::time_point t = Clock::now();
+		cg3::Dcel d = cg3::Dcel::fromIndexedTriangles(fanCoords, fanTris);
+		double ms = elapsedMs(t);
+		//all the inner edges (n-1) have two twin half edges
+		unsigned int twins = numberTwins(d);
+		std::cout << "	" << n << " triangles: " << ms << " ms"
+				  << (twins == 2 * (n-1) ? "" : " WRONG TWINS") << std::endl;
+	}
+
+	return 0;
+}
@@ -0,0 +1,131 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+/*
+ * Benchmark of the parallel update of the geometry of the Dcel.
+ *
+ * Dcel::updateGeometry(nThreads) recomputes face normals and areas, vertex
+ * normals and bounding box in two parallel sweeps. It is compared with the
+ * sequence of updateFaceNormals(), updateFaceAreas(), updateVertexNormals()
+ * and updateBoundingBox(), and run with 1, 2, 4... up to numberOfThreads()
+ * threads. The results must be the same for every number of threads.
+ *
+ * The parallelFor primitive is also measured on its own, on a loop that
+ * does a few operations per element.
+ *
+ * Usage: dcel_geometry_benchmark [mesh file (default: a grid of 2M triangles)]
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include <cg3/meshes/dcel/dcel.h>
+#include <cg3/utilities/parallel.h>
+
+typedef std::chrono::steady_clock Clock;
+
+double elapsedMs(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+/*
+ * Triangulated grid of n x n squares on a bumpy surface
+ */
+cg3::Dcel gridDcel(unsigned int n)
+{
+	std::vector<double> coords;
+	std::vector<unsigned int> tris;
+	coords.reserve(3 * (n+1) * (n+1));
+	tris.reserve(6 * n * n);
+	for (unsigned int i = 0; i <= n; i++){
+		for (unsigned int j = 0; j <= n; j++){
+			coords.push_back(i);
+			coords.push_back(j);
+			coords.push_back(std::sin(i * 0.1) * std::cos(j * 0.1));
+		}
+	}
+	for (unsigned int i = 0; i < n; i++){
+		for (unsigned int j = 0; j < n; j++){
+			unsigned int v = i * (n+1) + j;
+			tris.insert(tris.end(), {v, v + n + 1, v + 1});
+			tris.insert(tris.end(), {v + 1, v + n + 1, v + n + 2});
+		}
+	}
+	return cg3::Dcel::fromIndexedTriangles(coords, tris);
+}
+
+bool sameGeometry(const cg3::Dcel& d1, const cg3::Dcel& d2)
+{
+	return std::memcmp(d1.vertexNormalData(), d2.vertexNormalData(), d1.numberVertices() * sizeof(cg3::Vec3d)) == 0 &&
+			std::memcmp(d1.faceNormalData(), d2.faceNormalData(), d1.numberFaces() * sizeof(cg3::Vec3d)) == 0;
+}
+
+int main(int argc, char *argv[])
+{
+	cg3::Dcel d;
+	if (argc > 1){
+		if (!d.loadFromFile(argv[1])){
+			std::cerr << "Unable to load " << argv[1] << std::endl;
+			return 1;
+		}
+	}
+	else {
+		d = gridDcel(1000);
+	}
+
+	std::cout << "------ Dcel geometry benchmark: " << d.numberVertices() << " vertices, "
+			  << d.numberFaces() << " faces, " << cg3::numberOfThreads() << " hardware threads ------"
+			  << std::endl << std::endl;
+
+	Clock::time_point t = Clock::now();
+	d.updateFaceNormals();
+	d.updateFaceAreas();
+	d.updateVertexNormals();
+	d.updateBoundingBox();
+	double separate = elapsedMs(t);
+	std::cout << "Separate updates: " << separate << " ms" << std::endl;
+
+	std::cout << "updateGeometry" << std::endl;
+	cg3::Dcel reference;
+	for (unsigned int nThreads = 1; ; nThreads *= 2){
+		nThreads = std::min(nThreads, cg3::numberOfThreads());
+		cg3::Dcel copy = d;
+		t = Clock::now();
+		copy.updateGeometry(nThreads);
+		double ms = elapsedMs(t);
+		bool same = true;
+		if (nThreads == 1)
+			reference = copy;
+		else
+			same = sameGeometry(reference, copy);
+		std::cout << "\t" << nThreads << " threads: " << ms << " ms (" << separate / ms << "x)"
+				  << (same ? "" : " DIFFERENT RESULTS") << std::endl;
+		if (nThreads == cg3::numberOfThreads())
+			break;
+	}
+
+	std::cout << "parallelFor, " << d.numberFaces() << " elements" << std::endl;
+	std::vector<double> values(d.numberFaces()), results(d.numberFaces());
+	for (std::size_t i = 0; i < values.size(); i++)
+		values[i] = i * 0.001;
+	for (unsigned int nThreads = 1; ; nThreads *= 2){
+		nThreads = std::min(nThreads, cg3::numberOfThreads());
+		t = Clock::now();
+		cg3::parallelFor(0, values.size(), [&](std::size_t i) {
+			results[i] = std::sqrt(values[i] * values[i] + 1);
+		}, 1024, nThreads);
+		std::cout << "\t" << nThreads << " threads: " << elapsedMs(t) << " ms" << std::endl;
+		if (nThreads == cg3::numberOfThreads())
+			break;
+	}
+
+	return 0;
+}
@@ -0,0 +1,158 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+/*
+ * Benchmark of the pool storage of the elements of the Dcel.
+ *
+ * The Dcel builds its vertices, half edges and faces in the slabs of
+ * internal::DcelPool. The allocation of the same number of objects with one
+ * new/delete each (what the Dcel did before) is the reference. Then a Dcel
+ * is filled with addVertex/addHalfEdge/addFace, with and without reserve(),
+ * and copied, half of its elements are deleted and added again (reusing the
+ * freed slots), and the Dcel is cleared.
+ *
+ * Usage: dcel_pool_benchmark [number of vertices (default 1M)]
+ * (the benchmark adds three half edges and one face per vertex)
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <cg3/meshes/dcel/dcel.h>
+
+typedef std::chrono::steady_clock Clock;
+
+double elapsedMs(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+/*
+ * Object of the same size of an element of the Dcel
+ */
+template <class Element>
+struct Placeholder {
+	char data[sizeof(Element)];
+};
+
+/*
+ * Allocates n objects of the size of Element with new, and deletes them
+ */
+template <class Element>
+void newDeleteBenchmark(const std::string& name, std::size_t n)
+{
+	typedef Placeholder<Element> P;
+	std::vector<P*> objects(n);
+
+	Clock::time_point t = Clock::now();
+	for (std::size_t i = 0; i < n; i++)
+		objects[i] = new P();
+	double allocation = elapsedMs(t);
+
+	t = Clock::now();
+	for (std::size_t i = 0; i < n; i++)
+		delete objects[i];
+	double deallocation = elapsedMs(t);
+
+	std::cout << "\t" << name << ": new " << allocation << " ms, delete " << deallocation << " ms" << std::endl;
+}
+
+/*
+ * Allocates n slots of the pool of Element, and clears the pool
+ */
+template <class Element>
+void poolBenchmark(const std::string& name, std::size_t n)
+{
+	cg3::internal::DcelPool<Element> pool;
+	std::vector<void*> objects(n);
+
+	Clock::time_point t = Clock::now();
+	for (std::size_t i = 0; i < n; i++)
+		objects[i] = pool.allocate();
+	double allocation = elapsedMs(t);
+
+	t = Clock::now();
+	pool.clear();
+	double deallocation = elapsedMs(t);
+
+	std::cout << "\t" << name << ": allocate " << allocation << " ms, clear " << deallocation << " ms" << std::endl;
+}
+
+/*
+ * Adds nv vertices, 3*nv half edges and nv faces to the Dcel
+ */
+double fillDcel(cg3::Dcel& d, std::size_t nv)
+{
+	Clock::time_point t = Clock::now();
+	for (std::size_t i = 0; i < nv; i++){
+		d.addVertex(cg3::Point3d(i, i, i));
+		d.addHalfEdge();
+		d.addHalfEdge();
+		d.addHalfEdge();
+		d.addFace();
+	}
+	return elapsedMs(t);
+}
+
+int main(int argc, char *argv[])
+{
+	std::size_t nv = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+	std::cout << "------ Dcel pool benchmark: " << nv << " vertices, "
+			  << 3 * nv << " half edges, " << nv << " faces ------" << std::endl << std::endl;
+
+	std::cout << "One new/delete per element" << std::endl;
+	newDeleteBenchmark<cg3::Dcel::Vertex>("vertices", nv);
+	newDeleteBenchmark<cg3::Dcel::HalfEdge>("half edges", 3 * nv);
+	newDeleteBenchmark<cg3::Dcel::Face>("faces", nv);
+
+	std::cout << "internal::DcelPool" << std::endl;
+	poolBenchmark<cg3::Dcel::Vertex>("vertices", nv);
+	poolBenchmark<cg3::Dcel::HalfEdge>("half edges", 3 * nv);
+	poolBenchmark<cg3::Dcel::Face>("faces", nv);
+
+	std::cout << "Dcel" << std::endl;
+	{
+		cg3::Dcel d;
+		std::cout << "\tadd elements: " << fillDcel(d, nv) << " ms" << std::endl;
+	}
+	{
+		cg3::Dcel d;
+		Clock::time_point t = Clock::now();
+		d.reserve(nv, 3 * nv, nv);
+		double reserve = elapsedMs(t);
+		double fill = fillDcel(d, nv);
+		std::cout << "\treserve + add elements: " << reserve + fill << " ms" << std::endl;
+
+		t = Clock::now();
+		{
+			cg3::Dcel copy(d);
+			std::cout << "\tcopy: " << elapsedMs(t) << " ms" << std::endl;
+			t = Clock::now();
+		}
+		std::cout << "\tdestruction of the copy: " << elapsedMs(t) << " ms" << std::endl;
+
+		//the freed slots are reused by the next insertions
+		t = Clock::now();
+		for (std::size_t i = 0; i < nv; i += 2)
+			d.deleteVertex((unsigned int)i);
+		double deletion = elapsedMs(t);
+		t = Clock::now();
+		for (std::size_t i = 0; i < nv; i += 2)
+			d.addVertex(cg3::Point3d(i, i, i));
+		std::cout << "\tdelete half of the vertices: " << deletion << " ms, add them again: "
+				  << elapsedMs(t) << " ms" << std::endl;
+
+		t = Clock::now();
+		d.clear();
+		std::cout << "\tclear: " << elapsedMs(t) << " ms" << std::endl;
+	}
+
+	return 0;
+}
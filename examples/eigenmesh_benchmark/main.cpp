@@ -0,0 +1,113 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+/*
+ * Benchmark of the insertion of vertices and faces in SimpleEigenMesh and
+ * EigenMesh, one at a time.
+ *
+ * The matrices of the meshes keep spare rows, and their capacity is doubled
+ * when it is exhausted: an insertion costs O(1) amortized. The growth of
+ * Eigen matrices by one row per insertion with conservativeResize (what the
+ * meshes did before) is the reference. The insertions are also measured
+ * after reserve(), and followed by shrinkToFit().
+ *
+ * Usage: eigenmesh_benchmark [number of vertices (default 1M)]
+ * (the benchmark adds two faces per vertex)
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <cg3/meshes/eigenmesh/eigenmesh.h>
+
+typedef std::chrono::steady_clock Clock;
+
+double elapsedMs(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+/*
+ * Appends nv rows to V and nf rows to F, growing the matrices by one row
+ * at a time
+ */
+void conservativeResizeBenchmark(unsigned int nv, unsigned int nf)
+{
+	Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor> V(0, 3);
+	Eigen::Matrix<int, Eigen::Dynamic, 3, Eigen::RowMajor> F(0, 3);
+
+	Clock::time_point t = Clock::now();
+	for (unsigned int i = 0; i < nv; i++){
+		V.conservativeResize(V.rows() + 1, Eigen::NoChange);
+		V.row(i) << i, i, i;
+	}
+	double vertices = elapsedMs(t);
+
+	t = Clock::now();
+	for (unsigned int i = 0; i < nf; i++){
+		F.conservativeResize(F.rows() + 1, Eigen::NoChange);
+		F.row(i) << i % nv, (i+1) % nv, (i+2) % nv;
+	}
+	double faces = elapsedMs(t);
+
+	std::cout << "\tvertices: " << vertices << " ms, faces: " << faces << " ms" << std::endl;
+}
+
+/*
+ * Adds nv vertices and nf faces to an empty mesh, after reserving nrv
+ * vertices and nrf faces
+ */
+template <class Mesh>
+void insertionBenchmark(unsigned int nv, unsigned int nf, unsigned int nrv, unsigned int nrf)
+{
+	Mesh m;
+	Clock::time_point t = Clock::now();
+	m.reserve(nrv, nrf);
+	for (unsigned int i = 0; i < nv; i++)
+		m.addVertex(i, i, i);
+	double vertices = elapsedMs(t);
+
+	t = Clock::now();
+	for (unsigned int i = 0; i < nf; i++)
+		m.addFace(i % nv, (i+1) % nv, (i+2) % nv);
+	double faces = elapsedMs(t);
+
+	t = Clock::now();
+	m.shrinkToFit();
+	double shrink = elapsedMs(t);
+
+	std::cout << "\tvertices: " << vertices << " ms, faces: " << faces << " ms, shrinkToFit: " << shrink << " ms"
+			  << (m.numberVertices() == nv && m.numberFaces() == nf ? "" : " WRONG SIZE") << std::endl;
+}
+
+template <class Mesh>
+void meshBenchmark(const std::string& name, unsigned int nv, unsigned int nf)
+{
+	std::cout << name << std::endl;
+	insertionBenchmark<Mesh>(nv, nf, 0, 0);
+	std::cout << name << ", after reserve" << std::endl;
+	insertionBenchmark<Mesh>(nv, nf, nv, nf);
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned int nv = argc > 1 ? (unsigned int)std::strtoul(argv[1], nullptr, 10) : 1000000;
+	unsigned int nf = 2 * nv;
+
+	std::cout << "------ EigenMesh benchmark: " << nv << " vertices, " << nf << " faces ------"
+			  << std::endl << std::endl;
+
+	std::cout << "Eigen conservativeResize, one row at a time" << std::endl;
+	conservativeResizeBenchmark(nv, nf);
+
+	meshBenchmark<cg3::SimpleEigenMesh>("SimpleEigenMesh", nv, nf);
+	meshBenchmark<cg3::EigenMesh>("EigenMesh", nv, nf);
+
+	return 0;
+}
@@ -4,16 +4,26 @@ CONFIG += ordered
 
 SUBDIRS += \
 	aabb_tree \
+	aabb_tree_benchmark \
 	adding_manager \
 	n_dim_array \
+	batch_queries_benchmark \
 	bipartite_graph \
 	bst_tree \
+	compression_benchmark \
 	convex_hull_2d \
 	convex_hull_3d \
+	dcel_builder_benchmark \
+	dcel_geometry_benchmark \
 	dcel_manipulation \
+	dcel_pool_benchmark \
+	eigenmesh_benchmark \
 	graph \
 	laplacian_smoothing \
 	libigl_booleans \
 	mesh_picking \
+	obj_loader_benchmark \
 	range_tree \
+	range_tree_benchmark \
+	serialize_benchmark \
 	viewer
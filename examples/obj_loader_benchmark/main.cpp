@@ -0,0 +1,260 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+/*
+ * Benchmark of the ASCII number parsing and of the OBJ loader.
+ *
+ * The in-place parsers of io/ascii_numbers.h are compared with std::strtod
+ * and with std::stod/std::stoi on std::string tokens (what the loaders did
+ * before), and must give the same values of std::strtod.
+ *
+ * Then an OBJ file is loaded with loadTriangleMeshFromObj, which maps the
+ * file in memory and parses it in a single pass, and with a reference
+ * loader that reads the file line by line, splits the lines in
+ * std::strings and accumulates the values in std::lists (what the library
+ * did before). The two loaders must give the same matrices.
+ *
+ * Usage: obj_loader_benchmark [obj file (default: a generated grid of 2M triangles)]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <list>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <cg3/io/ascii_numbers.h>
+#include <cg3/io/load_save_obj.h>
+
+typedef std::chrono::steady_clock Clock;
+
+double elapsedMs(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void printResult(const std::string& name, double ms, double bytes)
+{
+	std::cout << "\t" << name << ": " << ms << " ms, " << bytes / 1e6 / (ms / 1000) << " MB/s" << std::endl;
+}
+
+/*
+ * Text of n random numbers separated by spaces: doubles written with six
+ * decimals, as mesh exporters do, or integers
+ */
+std::string randomNumbers(std::size_t n, bool integers)
+{
+	std::mt19937 rng(0);
+	std::uniform_real_distribution<double> distribution(-1000, 1000);
+	std::string text;
+	char buffer[64];
+	for (std::size_t i = 0; i < n; i++){
+		double d = distribution(rng);
+		if (integers)
+			std::snprintf(buffer, sizeof(buffer), "%d ", (int)(d * 1000));
+		else
+			std::snprintf(buffer, sizeof(buffer), "%.6f ", d);
+		text += buffer;
+	}
+	return text;
+}
+
+void doubleBenchmark(std::size_t n)
+{
+	std::string text = randomNumbers(n, false);
+	std::vector<double> reference, values;
+	reference.reserve(n);
+	values.reserve(n);
+
+	std::cout << "Doubles (" << n << ")" << std::endl;
+
+	Clock::time_point t = Clock::now();
+	for (const char* p = text.c_str(); *p != '\0'; ){
+		char* next;
+		reference.push_back(std::strtod(p, &next));
+		p = next + 1;
+	}
+	printResult("std::strtod", elapsedMs(t), text.size());
+
+	t = Clock::now();
+	{
+		std::istringstream stream(text);
+		std::string token;
+		while (stream >> token)
+			values.push_back(std::stod(token));
+	}
+	printResult("std::string + std::stod", elapsedMs(t), text.size());
+	values.clear();
+
+	t = Clock::now();
+	const char* end = text.c_str() + text.size();
+	for (const char* p = text.c_str(); p != end; p = cg3::internal::skipAsciiBlanks(p, end)){
+		double d;
+		if (!cg3::internal::parseAsciiDouble(p, end, d))
+			break;
+		values.push_back(d);
+	}
+	double ms = elapsedMs(t);
+	printResult("parseAsciiDouble", ms, text.size());
+	if (values != reference)
+		std::cout << "\tDIFFERENT VALUES" << std::endl;
+}
+
+void integerBenchmark(std::size_t n)
+{
+	std::string text = randomNumbers(n, true);
+	std::vector<long long> reference, values;
+	reference.reserve(n);
+	values.reserve(n);
+
+	std::cout << "Integers (" << n << ")" << std::endl;
+
+	Clock::time_point t = Clock::now();
+	{
+		std::istringstream stream(text);
+		std::string token;
+		while (stream >> token)
+			reference.push_back(std::stoi(token));
+	}
+	printResult("std::string + std::stoi", elapsedMs(t), text.size());
+
+	t = Clock::now();
+	const char* end = text.c_str() + text.size();
+	for (const char* p = text.c_str(); p != end; p = cg3::internal::skipAsciiBlanks(p, end)){
+		long long v;
+		if (!cg3::internal::parseAsciiInteger(p, end, v))
+			break;
+		values.push_back(v);
+	}
+	printResult("parseAsciiInteger", elapsedMs(t), text.size());
+	if (values != reference)
+		std::cout << "\tDIFFERENT VALUES" << std::endl;
+}
+
+/*
+ * Loads the vertices and the triangles of an OBJ file reading it line by line
+ */
+bool referenceObjLoader(
+		const std::string& filename,
+		std::vector<double>& coords,
+		std::vector<unsigned int>& tris)
+{
+	std::ifstream file(filename);
+	if (!file.is_open())
+		return false;
+	std::list<double> coordList;
+	std::list<unsigned int> triList;
+	std::string line, token;
+	while (std::getline(file, line)){
+		std::istringstream stream(line);
+		if (!(stream >> token))
+			continue;
+		if (token == "v"){
+			for (int i = 0; i < 3 && stream >> token; i++)
+				coordList.push_back(std::stod(token));
+		}
+		else if (token == "f"){
+			//only the vertex index of v, v/vt and v/vt/vn
+			for (int i = 0; i < 3 && stream >> token; i++)
+				triList.push_back(std::stoi(token.substr(0, token.find('/'))) - 1);
+		}
+	}
+	coords.assign(coordList.begin(), coordList.end());
+	tris.assign(triList.begin(), triList.end());
+	return true;
+}
+
+/*
+ * Saves a triangulated grid of n x n squares on a bumpy surface
+ */
+bool saveGrid(unsigned int n, const std::string& filename)
+{
+	std::vector<double> coords;
+	std::vector<unsigned int> tris;
+	for (unsigned int i = 0; i <= n; i++){
+		for (unsigned int j = 0; j <= n; j++){
+			coords.push_back(i * 0.01);
+			coords.push_back(j * 0.01);
+			coords.push_back(std::sin(i * 0.1) * std::cos(j * 0.1));
+		}
+	}
+	for (unsigned int i = 0; i < n; i++){
+		for (unsigned int j = 0; j < n; j++){
+			unsigned int v = i * (n+1) + j;
+			tris.insert(tris.end(), {v, v + n + 1, v + 1});
+			tris.insert(tris.end(), {v + 1, v + n + 1, v + n + 2});
+		}
+	}
+	return cg3::saveMeshOnObj(filename, coords.size() / 3, tris.size() / 3, coords.data(), tris.data());
+}
+
+void objBenchmark(const std::string& filename)
+{
+	std::ifstream file(filename, std::ios::binary | std::ios::ate);
+	double bytes = file.tellg();
+
+	std::vector<double> referenceCoords, coords;
+	std::vector<unsigned int> referenceTris, tris;
+
+	Clock::time_point t = Clock::now();
+	if (!referenceObjLoader(filename, referenceCoords, referenceTris)){
+		std::cerr << "Unable to load " << filename << std::endl;
+		return;
+	}
+	double referenceMs = elapsedMs(t);
+
+	//best of 10
+	double ms = 0;
+	for (int i = 0; i < 10; i++){
+		t = Clock::now();
+		coords.clear();
+		tris.clear();
+		if (!cg3::loadTriangleMeshFromObj(filename, coords, tris)){
+			std::cerr << "Unable to load " << filename << std::endl;
+			return;
+		}
+		double m = elapsedMs(t);
+		ms = i == 0 ? m : std::min(ms, m);
+	}
+
+	std::cout << "OBJ " << filename << " (" << coords.size() / 3 << " vertices, " << tris.size() / 3
+			  << " triangles, " << bytes / 1e6 << " MB)" << std::endl;
+	printResult("line by line, std::list", referenceMs, bytes);
+	printResult("loadTriangleMeshFromObj", ms, bytes);
+	std::cout << "\t" << referenceMs / ms << "x"
+			  << (coords == referenceCoords && tris == referenceTris ? "" : " DIFFERENT MESHES") << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+	std::cout << "------ ASCII parsing benchmark ------" << std::endl << std::endl;
+
+	doubleBenchmark(10000000);
+	integerBenchmark(10000000);
+
+	if (argc > 1){
+		objBenchmark(argv[1]);
+	}
+	else {
+		std::string filename = "obj_loader_benchmark.obj";
+		if (!saveGrid(1000, filename)){
+			std::cerr << "Unable to save " << filename << std::endl;
+			return 1;
+		}
+		objBenchmark(filename);
+		std::remove(filename.c_str());
+	}
+
+	return 0;
+}
@@ -26,6 +26,7 @@ int main(int argc, char *argv[])
 
 	//Defining an alias for range tree for 2-dimensional points
 	typedef cg3::RangeTree2D RangeTree2D;
+	typedef cg3::StaticRangeTree2D StaticRangeTree2D;
 
 
 	//Note that there is also a range tree for 3D points: cg3::RangeTree3D
@@ -83,6 +84,36 @@ int main(int argc, char *argv[])
 	}
 	std::cout << std::endl;
 
+	//If the tree is not going to change, a static range tree makes the queries
+	//faster. It is discarded by the next insert/erase
+	std::cout << "Range query (static) for the interval [3 - 99, 15.99 - 65.0]" << std::endl << "    ";
+	rangeTree2D.buildStatic();
+	std::vector<RangeTree2D::iterator> staticQueryResults;
+	rangeTree2D.rangeQuery(
+				Point2d(3,15.99),
+				Point2d(99,65.0),
+				std::back_inserter(staticQueryResults));
+
+	for (RangeTree2D::iterator it : staticQueryResults) {
+		std::cout << *it << " ";
+	}
+	std::cout << std::endl;
+
+	//Static range tree with the dimension as template argument: it cannot
+	//be changed after the construction
+	std::cout << "Range query (StaticRangeTree2D) for the interval [3 - 99, 15.99 - 65.0]" << std::endl << "    ";
+	StaticRangeTree2D staticRangeTree2D(std::vector<Point2d>(rangeTree2D.begin(), rangeTree2D.end()));
+	std::vector<StaticRangeTree2D::const_iterator> staticRangeTreeResults;
+	staticRangeTree2D.rangeQuery(
+				Point2d(3,15.99),
+				Point2d(99,65.0),
+				std::back_inserter(staticRangeTreeResults));
+
+	for (StaticRangeTree2D::const_iterator it : staticRangeTreeResults) {
+		std::cout << *it << " ";
+	}
+	std::cout << std::endl;
+
 	//Iteration with explicit iterators
 	std::cout << "The range tree contains:" << std::endl << "    ";
 	for (RangeTree2D::iterator it = rangeTree2D.begin(); it != rangeTree2D.end(); it++) {
@@ -0,0 +1,206 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Stefano Nuvoli (stefano.nuvoli@gmail.com)
+ */
+
+/*
+ * Benchmark of the range queries on random points in 2D, 3D and 4D: the
+ * dynamic RangeTree is compared with the layered range tree created by its
+ * buildStatic(), and with StaticRangeTree, which has the dimension as a
+ * template argument.
+ *
+ * The dynamic tree needs O(n log^(d-1) n) nodes, so the 4D benchmark uses
+ * a tenth of the points.
+ *
+ * Usage: range_tree_benchmark [number of points (default 100k)] [number of queries (default 100k)]
+ */
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <cg3/data_structures/trees/rangetree.h>
+#include <cg3/data_structures/trees/static_rangetree.h>
+
+typedef std::chrono::steady_clock Clock;
+
+double elapsedMs(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+template <int D>
+using Point = std::array<double, D>;
+
+/*
+ * Comparator of the I-th coordinate of the points, for RangeTree
+ */
+template <int D, int I>
+bool dimensionComparator(const Point<D>& p1, const Point<D>& p2)
+{
+	if (p1[I] < p2[I])
+		return true;
+	if (p2[I] < p1[I])
+		return false;
+
+	return p1 < p2;
+}
+
+/*
+ * Append the comparators of the coordinates I, ..., D-1 to a vector
+ */
+template <int D, int I = 0>
+struct DimensionComparators
+{
+	static void append(std::vector<typename cg3::RangeTree<Point<D>>::DefaultComparator>& comparators)
+	{
+		comparators.push_back(&dimensionComparator<D, I>);
+		DimensionComparators<D, I+1>::append(comparators);
+	}
+};
+
+template <int D>
+struct DimensionComparators<D, D>
+{
+	static void append(std::vector<typename cg3::RangeTree<Point<D>>::DefaultComparator>&)
+	{
+	}
+};
+
+/*
+ * Random point with coordinates in [0, max]
+ */
+template <int D>
+Point<D> randomPoint(double max, std::mt19937& rng)
+{
+	std::uniform_real_distribution<double> distribution(0, max);
+	Point<D> p;
+	for (int d = 0; d < D; d++)
+		p[d] = distribution(rng);
+	return p;
+}
+
+/*
+ * Values of the results of each query, sorted: the trees report the results
+ * of a query in different orders
+ */
+template <int D, class Iterator>
+std::vector<Point<D>> sortedResults(
+		const std::vector<Iterator>& results,
+		const std::vector<std::size_t>& offsets)
+{
+	std::vector<Point<D>> values;
+	for (const Iterator& it : results)
+		values.push_back(*it);
+	for (std::size_t i = 0; i + 1 < offsets.size(); i++)
+		std::sort(values.begin() + offsets[i], values.begin() + offsets[i+1]);
+	return values;
+}
+
+/*
+ * Run the queries on a tree, storing the results of the i-th query in
+ * results[offsets[i]], ..., results[offsets[i+1]-1]
+ */
+template <class Tree, class Iterator, class Key>
+double runQueries(
+		const Tree& tree,
+		const std::vector<Key>& starts,
+		const std::vector<Key>& ends,
+		std::vector<std::size_t>& offsets,
+		std::vector<Iterator>& results)
+{
+	offsets.assign(1, 0);
+	results.clear();
+	Clock::time_point t = Clock::now();
+	for (std::size_t i = 0; i < starts.size(); i++){
+		tree.rangeQuery(starts[i], ends[i], std::back_inserter(results));
+		offsets.push_back(results.size());
+	}
+	return elapsedMs(t);
+}
+
+/*
+ * Compare the trees on nPoints random points in [0, 1000]^D, with nQueries
+ * random queries with sides up to querySide
+ */
+template <int D>
+void benchmark(std::size_t nPoints, std::size_t nQueries, double querySide)
+{
+	typedef cg3::RangeTree<Point<D>> Tree;
+	typedef cg3::StaticRangeTree<D, Point<D>> StaticTree;
+
+	std::mt19937 rng(0);
+	std::vector<Point<D>> points(nPoints);
+	for (Point<D>& p : points)
+		p = randomPoint<D>(1000, rng);
+	std::vector<Point<D>> starts(nQueries), ends(nQueries);
+	for (std::size_t i = 0; i < nQueries; i++){
+		starts[i] = randomPoint<D>(1000, rng);
+		Point<D> side = randomPoint<D>(querySide, rng);
+		for (int d = 0; d < D; d++)
+			ends[i][d] = starts[i][d] + side[d];
+	}
+
+	std::cout << "D = " << D << ": " << nPoints << " points, " << nQueries << " queries" << std::endl;
+
+	std::vector<typename Tree::DefaultComparator> comparators;
+	DimensionComparators<D>::append(comparators);
+
+	Clock::time_point t = Clock::now();
+	Tree tree(D, points, comparators);
+	std::cout << "\tRangeTree construction: " << elapsedMs(t) << " ms" << std::endl;
+
+	std::vector<std::size_t> dynamicOffsets, staticOffsets, templateOffsets;
+	std::vector<typename Tree::const_iterator> dynamicResults, staticResults;
+	std::vector<typename StaticTree::const_iterator> templateResults;
+
+	double dynamicQuery = runQueries(tree, starts, ends, dynamicOffsets, dynamicResults);
+
+	t = Clock::now();
+	tree.buildStatic();
+	std::cout << "\tRangeTree::buildStatic: " << elapsedMs(t) << " ms" << std::endl;
+
+	double staticQuery = runQueries(tree, starts, ends, staticOffsets, staticResults);
+
+	t = Clock::now();
+	StaticTree staticTree(points);
+	std::cout << "\tStaticRangeTree construction: " << elapsedMs(t) << " ms" << std::endl;
+
+	double templateQuery = runQueries(staticTree, starts, ends, templateOffsets, templateResults);
+
+	std::vector<Point<D>> dynamicValues = sortedResults<D>(dynamicResults, dynamicOffsets);
+	bool staticEqual = staticOffsets == dynamicOffsets &&
+			sortedResults<D>(staticResults, staticOffsets) == dynamicValues;
+	bool templateEqual = templateOffsets == dynamicOffsets &&
+			sortedResults<D>(templateResults, templateOffsets) == dynamicValues;
+
+	std::cout << "\trangeQuery (" << dynamicResults.size() << " results):" << std::endl;
+	std::cout << "\t\tRangeTree: " << dynamicQuery << " ms" << std::endl;
+	std::cout << "\t\tRangeTree static: " << staticQuery << " ms ("
+			  << dynamicQuery / staticQuery << "x)"
+			  << (staticEqual ? "" : " DIFFERENT RESULTS") << std::endl;
+	std::cout << "\t\tStaticRangeTree: " << templateQuery << " ms ("
+			  << dynamicQuery / templateQuery << "x, "
+			  << staticQuery / templateQuery << "x over RangeTree static)"
+			  << (templateEqual ? "" : " DIFFERENT RESULTS") << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+	std::size_t nPoints = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+	std::size_t nQueries = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100000;
+
+	std::cout << "------ RangeTree benchmark ------" << std::endl << std::endl;
+
+	benchmark<2>(nPoints, nQueries, 10);
+	benchmark<3>(nPoints, nQueries, 50);
+	benchmark<4>(nPoints / 10, nQueries, 200);
+
+	return 0;
+}
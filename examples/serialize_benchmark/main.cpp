@@ -0,0 +1,153 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+/*
+ * Benchmark of the serialization of large containers of primitive types,
+ * which are written and read with a single write/read of their data block.
+ *
+ * Usage: serialize_benchmark [number of doubles (default 100M)] [file]
+ *
+ * The bulk path of cg3::serialize(std::vector<double>) is compared with the
+ * same data serialized one element at a time (what the library did before),
+ * and with a plain std::ofstream::write of the data (the speed of the disk).
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <cg3/io/serialize.h>
+#include <cg3/io/serialize_std.h>
+#include <cg3/io/serialize_eigen.h>
+#include <cg3/data_structures/arrays/arrays.h>
+
+typedef std::chrono::steady_clock Clock;
+
+double elapsedMs(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void printResult(const std::string& name, double ms, double bytes)
+{
+	std::cout << "\t" << name << ": " << ms << " ms, " << bytes / 1e6 / (ms / 1000) << " MB/s" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+	std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000000;
+	std::string filename = argc > 2 ? argv[2] : "serialize_benchmark.bin";
+	const double bytes = (double)n * sizeof(double);
+
+	std::cout << "------ Serialization benchmark: " << n << " doubles (" << bytes / 1e6 << " MB) ------" << std::endl << std::endl;
+
+	std::vector<double> v(n), w;
+	for (std::size_t i = 0; i < n; ++i)
+		v[i] = i * 0.5;
+
+	//plain write and read of the data block
+	std::cout << "Raw std::fstream" << std::endl;
+	Clock::time_point t = Clock::now();
+	{
+		std::ofstream file(filename, std::ios::binary);
+		file.write((const char*)v.data(), bytes);
+	}
+	printResult("write", elapsedMs(t), bytes);
+	w.resize(n);
+	t = Clock::now();
+	{
+		std::ifstream file(filename, std::ios::binary);
+		file.read((char*)w.data(), bytes);
+	}
+	printResult("read", elapsedMs(t), bytes);
+
+	//bulk path of the library
+	std::cout << "cg3::serialize(std::vector<double>)" << std::endl;
+	t = Clock::now();
+	{
+		std::ofstream file(filename, std::ios::binary);
+		cg3::serialize(v, file);
+	}
+	printResult("serialize", elapsedMs(t), bytes);
+	w.clear();
+	t = Clock::now();
+	{
+		std::ifstream file(filename, std::ios::binary);
+		cg3::deserialize(w, file);
+	}
+	printResult("deserialize", elapsedMs(t), bytes);
+	std::cout << "\tequal: " << (v == w) << std::endl;
+
+	//one element at a time, with the same file format
+	std::cout << "one cg3::serialize(double) for each element" << std::endl;
+	t = Clock::now();
+	{
+		std::ofstream file(filename, std::ios::binary);
+		cg3::serialize(n, file);
+		for (const double& d : v)
+			cg3::serialize(d, file);
+	}
+	printResult("serialize", elapsedMs(t), bytes);
+	t = Clock::now();
+	{
+		std::ifstream file(filename, std::ios::binary);
+		std::size_t size;
+		cg3::deserialize(size, file);
+		w.resize(size);
+		for (double& d : w)
+			cg3::deserialize(d, file);
+	}
+	printResult("deserialize", elapsedMs(t), bytes);
+	std::cout << "\tequal: " << (v == w) << std::endl;
+	std::vector<double>().swap(v);
+	std::vector<double>().swap(w);
+
+	//containers which use the same path
+	std::size_t rows = std::max<std::size_t>(n / 1000, 1);
+	std::cout << "cg3::Array<double, 2> and Eigen::MatrixXd " << rows << "x1000" << std::endl;
+	cg3::Array<double, 2> array(rows, 1000);
+	Eigen::MatrixXd matrix(rows, 1000);
+	for (std::size_t i = 0; i < rows; ++i){
+		for (std::size_t j = 0; j < 1000; ++j){
+			array(i, j) = i + j * 0.5;
+			matrix(i, j) = i + j * 0.5;
+		}
+	}
+	const double matrixBytes = (double)rows * 1000 * sizeof(double);
+	t = Clock::now();
+	{
+		std::ofstream file(filename, std::ios::binary);
+		array.serialize(file);
+	}
+	printResult("Array serialize", elapsedMs(t), matrixBytes);
+	t = Clock::now();
+	{
+		cg3::Array<double, 2> array2;
+		std::ifstream file(filename, std::ios::binary);
+		array2.deserialize(file);
+	}
+	printResult("Array deserialize", elapsedMs(t), matrixBytes);
+	t = Clock::now();
+	{
+		std::ofstream file(filename, std::ios::binary);
+		cg3::serialize(matrix, file);
+	}
+	printResult("MatrixXd serialize", elapsedMs(t), matrixBytes);
+	t = Clock::now();
+	{
+		Eigen::MatrixXd matrix2;
+		std::ifstream file(filename, std::ios::binary);
+		cg3::deserialize(matrix2, file);
+	}
+	printResult("MatrixXd deserialize", elapsedMs(t), matrixBytes);
+
+	std::remove(filename.c_str());
+	return 0;
+}
@@ -0,0 +1,41 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#ifndef CG3_TEST_H
+#define CG3_TEST_H
+
+#include <iostream>
+
+/*
+ * Minimal checks for the tests of the library: every test is an executable
+ * that returns the number of failed checks, so that ctest reports it as
+ * failed when at least one check fails.
+ */
+
+namespace cg3 {
+namespace test {
+
+inline int& failures()
+{
+	static int n = 0;
+	return n;
+}
+
+inline void check(bool condition, const char* expression, const char* file, int line)
+{
+	if (!condition){
+		std::cerr << file << ":" << line << ": check failed: " << expression << std::endl;
+		++failures();
+	}
+}
+
+} //namespace cg3::test
+} //namespace cg3
+
+#define CG3_CHECK(condition) cg3::test::check((condition), #condition, __FILE__, __LINE__)
+
+#endif // CG3_TEST_H
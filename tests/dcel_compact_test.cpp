@@ -0,0 +1,93 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#include "cg3_test.h"
+
+#include <vector>
+
+#include <cg3/meshes/dcel/dcel.h>
+
+/*
+ * A n x n grid of squares, each one split in two triangles
+ */
+cg3::Dcel grid(unsigned int n)
+{
+	std::vector<double> coords;
+	std::vector<unsigned int> tris;
+	for (unsigned int i = 0; i <= n; ++i)
+		for (unsigned int j = 0; j <= n; ++j)
+			coords.insert(coords.end(), {(double)i, (double)j, 0});
+	for (unsigned int i = 0; i < n; ++i){
+		for (unsigned int j = 0; j < n; ++j){
+			unsigned int v = i * (n + 1) + j;
+			tris.insert(tris.end(), {v, v + n + 1, v + 1, v + 1, v + n + 1, v + n + 2});
+		}
+	}
+	return cg3::Dcel::fromIndexedTriangles(coords, tris);
+}
+
+/*
+ * All the pointers of the elements refer to elements of the Dcel with the right id
+ */
+bool isLinked(cg3::Dcel& d)
+{
+	for (cg3::Dcel::Vertex* v : d.vertexIterator()){
+		const cg3::Dcel::HalfEdge* he = v->incidentHalfEdge();
+		if (he != nullptr && (d.halfEdge(he->id()) != he || he->fromVertex() != v))
+			return false;
+	}
+	for (cg3::Dcel::HalfEdge* he : d.halfEdgeIterator()){
+		if (d.vertex(he->fromVertex()->id()) != he->fromVertex() ||
+				d.vertex(he->toVertex()->id()) != he->toVertex() ||
+				he->next()->prev() != he || he->next()->fromVertex() != he->toVertex() ||
+				(he->twin() != nullptr && he->twin()->twin() != he) ||
+				(he->face() != nullptr && d.face(he->face()->id()) != he->face()))
+			return false;
+	}
+	for (cg3::Dcel::Face* f : d.faceIterator()){
+		const cg3::Dcel::HalfEdge* he = f->outerHalfEdge();
+		if (d.halfEdge(he->id()) != he || he->face() != f)
+			return false;
+	}
+	return true;
+}
+
+/*
+ * After deleting half of the faces, compact() renumbers densely the ids and
+ * keeps the Dcel consistent
+ */
+void testCompact()
+{
+	cg3::Dcel d = grid(40);
+	const unsigned int nv = d.numberVertices(), nhe = d.numberHalfEdges();
+	for (unsigned int i = 0; i < 3200; i += 2)
+		d.deleteFace(i);
+	CG3_CHECK(d.numberFaces() == 1600);
+
+	d.compact();
+	CG3_CHECK(d.numberVertices() == nv);
+	CG3_CHECK(d.numberHalfEdges() == nhe);
+	CG3_CHECK(d.numberFaces() == 1600);
+	unsigned int i = 0;
+	for (const cg3::Dcel::Face* f : d.faceIterator())
+		CG3_CHECK(f->id() == i++);
+	CG3_CHECK(i == 1600);
+	CG3_CHECK(d.vertex(42)->coordinate() == cg3::Point3d(1, 1, 0));
+	CG3_CHECK(isLinked(d));
+
+	//the Dcel can still grow
+	cg3::Dcel::Face* f = d.addFace();
+	CG3_CHECK(f->id() == 1600);
+	CG3_CHECK(d.addVertex(cg3::Point3d(1, 2, 3))->id() == nv);
+	CG3_CHECK(d.numberFaces() == 1601);
+}
+
+int main()
+{
+	testCompact();
+	return cg3::test::failures();
+}
@@ -0,0 +1,54 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#include "cg3_test.h"
+
+#include <vector>
+
+#include <cg3/meshes/dcel/dcel.h>
+
+/*
+ * An open pyramid with faces of different areas, so that a weighted and a not
+ * weighted mean of the face normals give different vertex normals
+ */
+cg3::Dcel pyramid()
+{
+	std::vector<double> coords = {
+		0, 0, 0,   4, 0, 0,   4, 1, 0,   0, 1, 0,   1, 0.5, 2};
+	std::vector<unsigned int> tris = {
+		0, 1, 4,   1, 2, 4,   2, 3, 4,   3, 0, 4};
+	return cg3::Dcel::fromIndexedTriangles(coords, tris);
+}
+
+/*
+ * updateGeometry computes the same normals of updateFaceNormals and updateVertexNormals
+ */
+void testSameNormals()
+{
+	cg3::Dcel d = pyramid();
+	d.updateGeometry(2);
+	std::vector<cg3::Vec3d> faceNormals, vertexNormals;
+	for (const cg3::Dcel::Face* f : d.faceIterator())
+		faceNormals.push_back(f->normal());
+	for (const cg3::Dcel::Vertex* v : d.vertexIterator())
+		vertexNormals.push_back(v->normal());
+
+	d.updateFaceNormals();
+	d.updateVertexNormals();
+	unsigned int i = 0;
+	for (const cg3::Dcel::Face* f : d.faceIterator())
+		CG3_CHECK(f->normal() == faceNormals[i++]);
+	i = 0;
+	for (const cg3::Dcel::Vertex* v : d.vertexIterator())
+		CG3_CHECK(v->normal() == vertexNormals[i++]);
+}
+
+int main()
+{
+	testSameNormals();
+	return cg3::test::failures();
+}
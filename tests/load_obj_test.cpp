@@ -0,0 +1,93 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#include "cg3_test.h"
+
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+#include <cg3/io/load_save_obj.h>
+#include <cg3/io/mesh_stream_reader.h>
+
+const char* filename = "load_obj_test.obj";
+
+void writeFile(const char* content)
+{
+	std::ofstream file(filename);
+	file << content;
+}
+
+bool load(std::vector<double>& coords, std::vector<unsigned int>& triangles)
+{
+	return cg3::loadTriangleMeshFromObj(filename, coords, triangles);
+}
+
+/*
+ * Absolute and relative indices, with texture and normal indices
+ */
+void testValidFaces()
+{
+	writeFile("v 0 0 0\nv 1 0 0\nv 0 1 0\nv 1 1 0\n"
+			  "f 1 2 3\n"
+			  "f -3/1 -1/1/1 -2//1\n");
+	std::vector<double> coords;
+	std::vector<unsigned int> triangles;
+	CG3_CHECK(load(coords, triangles));
+	CG3_CHECK(coords.size() == 12);
+	CG3_CHECK((triangles == std::vector<unsigned int>{0, 1, 2, 1, 3, 2}));
+}
+
+/*
+ * An empty file is an empty mesh, a missing file fails the load
+ */
+void testEmptyFile()
+{
+	writeFile("");
+	std::vector<double> coords = {0, 0, 0};
+	std::vector<unsigned int> triangles;
+	CG3_CHECK(load(coords, triangles));
+	CG3_CHECK(coords.empty());
+
+	std::remove(filename);
+	CG3_CHECK(!load(coords, triangles));
+}
+
+/*
+ * Indices that do not refer to a preceding vertex fail the load
+ */
+void testOutOfRangeFaces()
+{
+	std::vector<double> coords;
+	std::vector<unsigned int> triangles;
+
+	writeFile("v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 4\n");
+	CG3_CHECK(!load(coords, triangles));
+
+	writeFile("v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 -4\n");
+	CG3_CHECK(!load(coords, triangles));
+
+	//the vertex exists, but is defined after the face
+	writeFile("v 0 0 0\nv 1 0 0\nf 1 2 3\nv 0 1 0\n");
+	CG3_CHECK(!load(coords, triangles));
+
+	writeFile("v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 4000000000\n");
+	cg3::MeshStreamReader reader(filename);
+	std::vector<unsigned int> faces, faceSizes;
+	CG3_CHECK(reader.isOpen());
+	CG3_CHECK(reader.readFaces(faces, faceSizes) == 0);
+	CG3_CHECK(reader.error());
+}
+
+int main()
+{
+	testValidFaces();
+	testEmptyFile();
+	testOutOfRangeFaces();
+	std::remove(filename);
+	return cg3::test::failures();
+}
@@ -0,0 +1,63 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#include "cg3_test.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include <cg3/io/mapped_file.h>
+
+const char* filename = "mapped_file_test.txt";
+
+/*
+ * A missing file is not opened
+ */
+void testMissingFile()
+{
+	std::remove(filename);
+	cg3::MappedFile file(filename);
+	CG3_CHECK(!file.isOpen());
+	CG3_CHECK(file.size() == 0);
+}
+
+/*
+ * An empty file is opened, with size 0
+ */
+void testEmptyFile()
+{
+	std::ofstream(filename).close();
+	cg3::MappedFile file(filename);
+	CG3_CHECK(file.isOpen());
+	CG3_CHECK(file.size() == 0);
+
+	cg3::MappedFile moved(std::move(file));
+	CG3_CHECK(moved.isOpen());
+	CG3_CHECK(!file.isOpen());
+	moved.close();
+	CG3_CHECK(!moved.isOpen());
+}
+
+void testContent()
+{
+	std::ofstream(filename) << "content";
+	cg3::MappedFile file;
+	CG3_CHECK(file.open(filename));
+	CG3_CHECK(file.isOpen());
+	CG3_CHECK(file.size() == 7);
+	CG3_CHECK(std::memcmp(file.data(), "content", 7) == 0);
+}
+
+int main()
+{
+	testMissingFile();
+	testEmptyFile();
+	testContent();
+	std::remove(filename);
+	return cg3::test::failures();
+}
@@ -0,0 +1,164 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#include "cg3_test.h"
+
+#include <set>
+#include <vector>
+
+#include <cg3/geometry/polygon_triangulator.h>
+#include <cg3/meshes/dcel/dcel.h>
+
+//outer border, then the borders of two holes
+const std::vector<cg3::Point3d> polygonWithHoles = {
+	{18, 0, 0}, {21, 39, 0}, {6, 48, 0}, {-15, 45, 0}, {-24, 0, 0},
+	{-30, -27, 0}, {-15, -27, 0}, {-18, -39, 0}, {-3, -30, 0},
+	{-3, 12, 0}, {-6, 9, 0}, {0, 6, 0}, {3, 6, 0}, {3, 9, 0}, {0, 12, 0},
+	{3, -6, 0}, {-3, -6, 0}, {-3, -12, 0}, {3, -12, 0}};
+const std::vector<unsigned int> polygonWithHolesSizes = {9, 6, 4};
+
+//the last edge crosses the second one: no ear can be clipped
+const std::vector<cg3::Point3d> selfIntersecting = {
+	{4, 0, 0}, {3, 0, 0}, {3, 4, 0}, {4, 4, 0}, {0, 1, 0}};
+
+//a square with a hole that lies outside of it
+const std::vector<cg3::Point3d> square = {
+	{0, 0, 0}, {4, 0, 0}, {4, 4, 0}, {0, 4, 0}};
+const std::vector<cg3::Point3d> outsideHole = {
+	{10, 1, 0}, {10, 2, 0}, {11, 1, 0}};
+
+double area(
+		const std::vector<cg3::Point3d>& points,
+		const std::vector<unsigned int>& triangles)
+{
+	double a = 0;
+	for (unsigned int i = 0; i < triangles.size(); i += 3){
+		const cg3::Point3d& p = points[triangles[i]];
+		a += (points[triangles[i+1]] - p).cross(points[triangles[i+2]] - p).length() / 2;
+	}
+	return a;
+}
+
+/*
+ * Adds to the Dcel a border of the face f, with the given points
+ * @return the first half edge of the border
+ */
+cg3::Dcel::HalfEdge* addBorder(
+		cg3::Dcel& d,
+		cg3::Dcel::Face* f,
+		const std::vector<cg3::Point3d>& points)
+{
+	std::vector<cg3::Dcel::Vertex*> vs;
+	std::vector<cg3::Dcel::HalfEdge*> hes;
+	for (const cg3::Point3d& p : points){
+		vs.push_back(d.addVertex(p));
+		hes.push_back(d.addHalfEdge());
+	}
+	const unsigned int n = points.size();
+	for (unsigned int i = 0; i < n; ++i){
+		hes[i]->setFromVertex(vs[i]);
+		hes[i]->setToVertex(vs[(i+1)%n]);
+		hes[i]->setNext(hes[(i+1)%n]);
+		hes[i]->setPrev(hes[(i+n-1)%n]);
+		hes[i]->setFace(f);
+		vs[i]->setIncidentHalfEdge(hes[i]);
+	}
+	return hes[0];
+}
+
+/*
+ * Every half edge belongs to exactly one border of its face
+ */
+bool isConsistent(const cg3::Dcel& d)
+{
+	std::set<const cg3::Dcel::HalfEdge*> visited;
+	auto visitBorder = [&](const cg3::Dcel::Face* f, const cg3::Dcel::HalfEdge* start) {
+		const cg3::Dcel::HalfEdge* he = start;
+		do {
+			if (he->face() != f || he->next()->prev() != he || !visited.insert(he).second)
+				return false;
+			he = he->next();
+		} while (he != start);
+		return true;
+	};
+	for (const cg3::Dcel::Face* f : d.faceIterator()){
+		if (!visitBorder(f, f->outerHalfEdge()))
+			return false;
+		for (const cg3::Dcel::HalfEdge* he : f->innerHalfEdgeIterator())
+			if (!visitBorder(f, he))
+				return false;
+	}
+	return visited.size() == d.numberHalfEdges();
+}
+
+void testPolygonWithHoles()
+{
+	cg3::PolygonTriangulator triangulator;
+	std::vector<unsigned int> triangles;
+	unsigned int nt = triangulator.triangulate(polygonWithHoles, polygonWithHolesSizes, triangles);
+	CG3_CHECK(nt == 21);
+	CG3_CHECK(triangles.size() == 63);
+	CG3_CHECK(area(polygonWithHoles, triangles) == 2758.5);
+}
+
+void testFailures()
+{
+	cg3::PolygonTriangulator triangulator;
+	std::vector<unsigned int> triangles;
+	CG3_CHECK(triangulator.triangulate(selfIntersecting, triangles) == 0);
+	CG3_CHECK(triangles.empty());
+
+	std::vector<cg3::Point3d> points = square;
+	points.insert(points.end(), outsideHole.begin(), outsideHole.end());
+	CG3_CHECK(triangulator.triangulate(points, {4, 3}, triangles) == 0);
+	CG3_CHECK(triangles.empty());
+}
+
+/*
+ * A self intersecting face without holes is triangulated as a fan
+ */
+void testDcelSelfIntersectingFace()
+{
+	cg3::Dcel d;
+	cg3::Dcel::Face* f = d.addFace(cg3::Vec3d(0, 0, 1));
+	f->setOuterHalfEdge(addBorder(d, f, selfIntersecting));
+
+	CG3_CHECK(d.triangulate() == 0);
+	CG3_CHECK(d.numberFaces() == 3);
+	for (const cg3::Dcel::Face* t : d.faceIterator())
+		CG3_CHECK(t->isTriangle());
+	CG3_CHECK(isConsistent(d));
+}
+
+/*
+ * A face with a hole that cannot be bridged is left unchanged, and reported
+ */
+void testDcelUnbridgeableHole()
+{
+	cg3::Dcel d;
+	cg3::Dcel::Face* f = d.addFace(cg3::Vec3d(0, 0, 1));
+	f->setOuterHalfEdge(addBorder(d, f, square));
+	f->addInnerHalfEdge(addBorder(d, f, outsideHole));
+	cg3::Dcel::Face* g = d.addFace(cg3::Vec3d(0, 0, 1));
+	g->setOuterHalfEdge(addBorder(d, g, selfIntersecting));
+
+	CG3_CHECK(d.triangulateFace(f->id()) == 0);
+	CG3_CHECK(d.triangulate() == 1);
+	CG3_CHECK(d.numberFaces() == 4);
+	CG3_CHECK(f->numberInnerHalfEdges() == 1);
+	CG3_CHECK(f->numberIncidentVertices() == 4);
+	CG3_CHECK(isConsistent(d));
+}
+
+int main()
+{
+	testPolygonWithHoles();
+	testFailures();
+	testDcelSelfIntersectingFace();
+	testDcelUnbridgeableHole();
+	return cg3::test::failures();
+}
@@ -0,0 +1,69 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ *
+ * @author Alessandro Muntoni (muntoni.alessandro@gmail.com)
+ */
+
+#include "cg3_test.h"
+
+#include <cstdio>
+#include <vector>
+
+#include <cg3/io/serialize_compressed.h>
+#include <cg3/io/serialize_std.h>
+
+/*
+ * Data written and read back through the compressed streams
+ */
+void testRoundTrip()
+{
+	std::vector<double> v(300000), w;
+	for (std::size_t i = 0; i < v.size(); ++i)
+		v[i] = i % 1000 * 0.5;
+	{
+		cg3::CompressedOfstream file("serialize_compressed_test.bin", 2, 1 << 16);
+		cg3::serialize(v, file);
+		file.close();
+		CG3_CHECK(file.good());
+	}
+	{
+		cg3::CompressedIfstream file("serialize_compressed_test.bin", 2);
+		cg3::deserialize(w, file);
+		CG3_CHECK(file.good());
+		CG3_CHECK(v == w);
+	}
+	std::remove("serialize_compressed_test.bin");
+}
+
+/*
+ * Flushing or writing after close() fails instead of using the closed buffer
+ */
+void testCloseThenFlush()
+{
+	cg3::CompressedOfstream file("serialize_compressed_test.bin");
+	file << "data" << std::endl;
+	file.close();
+	CG3_CHECK(file.good());
+
+	//nothing to flush: as for a closed std::ofstream, it does nothing
+	file.flush();
+
+	file << "more data" << std::endl;
+	CG3_CHECK(file.bad());
+
+	//the stream can be opened again
+	file.clear();
+	file.open("serialize_compressed_test.bin");
+	file << "data" << std::endl;
+	file.close();
+	CG3_CHECK(file.good());
+	std::remove("serialize_compressed_test.bin");
+}
+
+int main()
+{
+	testRoundTrip();
+	testCloseThenFlush();
+	return cg3::test::failures();
+}